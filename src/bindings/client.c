@@ -192,6 +192,21 @@ static int read_nbytes(int fd, void* buf, size_t sz){
 	}
 }
 
+static int write_nbytes(int fd, const void* buf, size_t sz){
+	int wr;
+
+	while (sz > 0){
+		wr = PLATFORM_WRITE(fd, buf, sz);
+		if (wr <= 0 || wr > sz){
+			fprintf(stderr, "native write error\n");
+			return 0;
+		}
+		sz -= wr;
+		buf = (const char*)buf + wr;
+	}
+	return 1;
+}
+
 int HybmeshClientToServer_get_signal(int id, char* sig){
 	HybmeshClientToServer* con = hybmesh_connections + id;
 	*sig = '0';
@@ -226,9 +241,9 @@ int HybmeshClientToServer_send_signal(int id, char sig){
 
 int HybmeshClientToServer_send_data(int id, int sz, char* data){
 	HybmeshClientToServer* con = hybmesh_connections + id;
-	PLATFORM_WRITE(con->pipe_write, &sz, 4);
-	PLATFORM_WRITE(con->pipe_write, data, sz);
-	return 1;
+	/* raw array payloads could be large: pipe writes may be partial */
+	if (write_nbytes(con->pipe_write, &sz, 4) == 0) return 0;
+	return write_nbytes(con->pipe_write, data, sz);
 }
 
 int HybmeshClientToServer_delete(int id){
@@ -24,6 +24,10 @@ void send_data(int id, int sz, char* data){
 	if (err == 0) exception("native send_data() failed");
 }
 
+void send_raw(int id, int sz, void* data){
+	send_data(id, sz, (char*)data);
+}
+
 char get_signal(int id){
 	char ret;
 	int err = HybmeshClientToServer_get_signal(id, &ret);
@@ -63,6 +63,15 @@ static octave_value_list oct_send_data(const octave_value_list& args){
 	return octave_value_list();
 }
 
+static octave_value_list oct_send_raw(const octave_value_list& args){
+	int id = args(1).array_value()(0);
+	uint8NDArray data = args(2).uint8_array_value();
+	int sz = data.numel();
+	int err = HybmeshClientToServer_send_data(id, sz, (char*)data.fortran_vec());
+	check_err(err, "failed to send data to the pipe");
+	return octave_value_list();
+}
+
 static octave_value_list oct_break_connection(const octave_value_list& args){
 	int id = args(1).array_value()(0);
 	int err = HybmeshClientToServer_delete(id);
@@ -77,6 +86,7 @@ static octave_value_list oct_break_connection(const octave_value_list& args){
 //    4 - "get_data",           (id) => uint8 array
 //    5 - "send_data",          (id, char*)
 //    6 - "break_connection",   (id)
+//    7 - "send_raw",           (id, uint8 array)
 DEFUN_DLD(core_hmconnection_oct, args, nargsout, ""){
 	int code = args(0).array_value()(0);
 	switch (code){
@@ -86,6 +96,7 @@ DEFUN_DLD(core_hmconnection_oct, args, nargsout, ""){
 		case 4: return oct_get_data(args);
 		case 5: return oct_send_data(args);
 		case 6: return oct_break_connection(args);
+		case 7: return oct_send_raw(args);
 		default: check_err(0, "unknown instruction");
 	};
 	return octave_value_list();
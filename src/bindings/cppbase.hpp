@@ -60,7 +60,11 @@ private:
 		//data
 		int pipe_read, pipe_write;
 		intptr_t childid;
+		//raw arrays payload of the command being assembled
+		VecByte rawbuf;
+		int nraw;
 		void read_nbytes(char* buf, size_t sz);
+		void write_nbytes(const char* buf, size_t sz);
 		void find_hybmesh(const char* path, char* exepath);
 		//low level platform specific procedures
 		void require_connection(const char* path);
@@ -71,6 +75,7 @@ private:
 		void break_connection();
 		//server communication
 		void _send_command(const std::string& func, const std::string& com);
+		std::string _tos_raw(char tp, int n, const void* data, size_t sz);
 		char _wait_for_signal();
 		VecByte _read_buffer();
 	public:
@@ -78,7 +83,7 @@ private:
 		std::function<int(const std::string&, const std::string&,
 		                  double, double)> callback;
 		//constructor
-		Worker(std::string hybmeshpath){
+		Worker(std::string hybmeshpath): nraw(0){
 			if (hybmeshpath.size() == 0) require_connection(
 					DEFAULT_HYBMESH_EXE_PATH);
 			else require_connection(hybmeshpath.c_str());
@@ -348,23 +353,20 @@ std::string Hybmesh::Worker::_tos_vecbyte(const VecByte& comstr){
 	while (ret.size() > 0 && ret.back() == '\0') ret.resize(ret.size() - 1);
 	return ret;
 }
-std::string Hybmesh::Worker::_tos_vecint(const std::vector<int>& val){
+std::string Hybmesh::Worker::_tos_raw(char tp, int n, const void* data, size_t sz){
+	//entry of raw payload: type, number of entries, data
+	rawbuf.push_back(tp);
+	rawbuf.insert(rawbuf.end(), (const char*)&n, (const char*)&n + sizeof(int));
+	rawbuf.insert(rawbuf.end(), (const char*)data, (const char*)data + sz);
 	std::ostringstream os;
-	os<<'[';
-	for (size_t i=0; i<val.size(); ++i){
-		os<<val[i]<<", ";
-	}
-	os<<']';
+	os<<"_raw("<<nraw++<<')';
 	return os.str();
 }
+std::string Hybmesh::Worker::_tos_vecint(const std::vector<int>& val){
+	return _tos_raw('i', val.size(), val.data(), val.size()*sizeof(int));
+}
 std::string Hybmesh::Worker::_tos_vecdouble(const std::vector<double>& val){
-	std::ostringstream os; os.precision(17);
-	os<<'[';
-	for (size_t i=0; i<val.size(); ++i){
-		os<<val[i]<<", ";
-	}
-	os<<']';
-	return os.str();
+	return _tos_raw('d', val.size(), val.data(), val.size()*sizeof(double));
 }
 std::string Hybmesh::Worker::_tos_vecstring(const std::vector<std::string>& val){
 	std::ostringstream os;
@@ -376,13 +378,12 @@ std::string Hybmesh::Worker::_tos_vecstring(const std::vector<std::string>& val)
 	return os.str();
 }
 std::string Hybmesh::Worker::_tos_vecpoint(const std::vector<Point2>& val){
-	std::ostringstream os; os.precision(17);
-	os<<'[';
+	std::vector<double> flat(2*val.size());
 	for (size_t i=0; i<val.size(); ++i){
-		os<<_tos_point(val[i])<<", ";
+		flat[2*i] = val[i].x;
+		flat[2*i+1] = val[i].y;
 	}
-	os<<']';
-	return os.str();
+	return _tos_raw('p', val.size(), flat.data(), flat.size()*sizeof(double));
 }
 
 template<class Obj>
@@ -478,9 +479,12 @@ void Hybmesh::Worker::_apply_callback(const VecByte& buf){
 }
 
 void Hybmesh::Worker::_send_command(const std::string& func, const std::string& com){
-	send_signal('C');
-	send_data(func.size(), &func[0]);
-	send_data(com.size(), &com[0]);
+	send_signal('T');
+	send_data(func.size(), func.data());
+	send_data(com.size(), com.data());
+	send_data(rawbuf.size(), rawbuf.data());
+	rawbuf.clear();
+	nraw = 0;
 }
 
 char Hybmesh::Worker::_wait_for_signal(){
@@ -637,6 +641,18 @@ void Hybmesh::Worker::read_nbytes(char* buf, size_t sz){
 	}
 }
 
+void Hybmesh::Worker::write_nbytes(const char* buf, size_t sz){
+	int wr;
+	while (sz > 0){
+		wr = HMPLATFORM_WRITE(pipe_write, buf, sz);
+		if (wr <= 0 || (size_t)wr > sz){
+			throw Hybmesh::ERuntimeError("native write error");
+		}
+		sz -= wr;
+		buf += wr;
+	}
+}
+
 void Hybmesh::Worker::get_signal(char* sig){
 	*sig = '0';
 	read_nbytes(sig, 1);
@@ -652,8 +668,8 @@ void Hybmesh::Worker::send_signal(char sig){
 	HMPLATFORM_WRITE(pipe_write, &sig, 1);
 }
 void Hybmesh::Worker::send_data(int sz, const char* data){
-	HMPLATFORM_WRITE(pipe_write, (char*)(&sz), 4);
-	HMPLATFORM_WRITE(pipe_write, data, sz);
+	write_nbytes((char*)(&sz), 4);
+	write_nbytes(data, sz);
 }
 void Hybmesh::Worker::break_connection(){
 	send_signal('Q');
@@ -103,6 +103,9 @@ public class Hybmesh: IDisposable{
 	
 		// ==== communication library
 		private int connection = -1;
+		//raw arrays payload of the command being assembled
+		private MemoryStream rawbuf = new MemoryStream();
+		private int nraw = 0;
 		public void free(){
 			if (connection != -1){
 				break_connection(connection);
@@ -113,9 +116,22 @@ public class Hybmesh: IDisposable{
 		private void _send_command(string func, string com){
 			byte[] dtfunc = Encoding.UTF8.GetBytes(func);
 			byte[] dtcom = Encoding.UTF8.GetBytes(com);
-			send_signal(connection, (byte)'C');
+			byte[] dtraw = rawbuf.ToArray();
+			rawbuf.SetLength(0);
+			nraw = 0;
+			send_signal(connection, (byte)'T');
 			send_data(connection, dtfunc.Length, dtfunc);
 			send_data(connection, dtcom.Length, dtcom);
+			send_data(connection, dtraw.Length, dtraw);
+		}
+		//adds array to raw payload; returns its reference for com string
+		private string _tos_raw(char tp, int n, Array data, int sz){
+			byte[] bytes = new byte[sz];
+			Buffer.BlockCopy(data, 0, bytes, 0, sz);
+			rawbuf.WriteByte((byte)tp);
+			rawbuf.Write(BitConverter.GetBytes(n), 0, 4);
+			rawbuf.Write(bytes, 0, sz);
+			return "_raw(" + (nraw++).ToString() + ")";
 		}
 		private byte _wait_for_signal(){
 			return get_signal(connection);
@@ -284,14 +300,11 @@ public class Hybmesh: IDisposable{
 		}
 		public string _tos_vecint(int[] val){
 			if (val == null) return "None";
-			return '[' + string.Join(", ", val.Select(
-					p=>p.ToString()).ToArray()) + ']';
+			return _tos_raw('i', val.Length, val, val.Length*sizeof(int));
 		}
 		public string _tos_vecdouble(double[] val){
 			if (val == null) return "None";
-			return '[' + string.Join(", ", val.Select(
-				p=>p.ToString("G16", CultureInfo.InvariantCulture)).ToArray())
-				+ ']';
+			return _tos_raw('d', val.Length, val, val.Length*sizeof(double));
 		}
 		public string _tos_vecstring(string[] val){
 			if (val == null) return "None";
@@ -300,8 +313,12 @@ public class Hybmesh: IDisposable{
 		}
 		public string _tos_vecpoint(Hybmesh.Point2[] val){
 			if (val == null) return "None";
-			return '[' + string.Join(", ", val.Select(
-				p=>this._tos_point(p)).ToArray()) + ']';
+			double[] flat = new double[2*val.Length];
+			for (int i=0; i<val.Length; ++i){
+				flat[2*i] = val[i].x;
+				flat[2*i+1] = val[i].y;
+			}
+			return _tos_raw('p', val.Length, flat, flat.Length*sizeof(double));
 		}
 		public string _tos_object(Object val){
 			if (val == null) return "None";
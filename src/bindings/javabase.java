@@ -23,14 +23,36 @@ class Hybmesh implements AutoCloseable{
 		private native byte[] get_data(int con);
 		private native void send_data(int con, byte[] dt);
 		private native void break_connection(int con);
+		//raw arrays payload of the command being assembled
+		private ArrayList<ByteBuffer> rawbuf = new ArrayList<ByteBuffer>();
 	
 		//server communication
 		private void _send_command(String func, String com){
 			byte[] dt1 = func.getBytes(StandardCharsets.UTF_8);
 			byte[] dt2 = com.getBytes(StandardCharsets.UTF_8);
-			send_signal(connection, (byte)'C');
+			int rawlen = 0;
+			for (ByteBuffer b: rawbuf) rawlen += b.capacity();
+			byte[] dt3 = new byte[rawlen];
+			ByteBuffer raw = ByteBuffer.wrap(dt3);
+			for (ByteBuffer b: rawbuf) raw.put(b.array());
+			rawbuf.clear();
+			send_signal(connection, (byte)'T');
 			send_data(connection, dt1);
 			send_data(connection, dt2);
+			send_data(connection, dt3);
+		}
+		//adds array entry {type, size, data} of datalen bytes to raw payload.
+		//returns the entry for filling data and its reference for com string.
+		private ByteBuffer _raw_entry(char tp, int n, int datalen){
+			ByteBuffer ret = ByteBuffer.allocate(5 + datalen);
+			ret.order(ByteOrder.nativeOrder());
+			ret.put((byte)tp);
+			ret.putInt(n);
+			rawbuf.add(ret);
+			return ret;
+		}
+		private String _raw_ref(){
+			return "_raw(" + Integer.toString(rawbuf.size() - 1) + ")";
 		}
 		private byte _wait_for_signal(){
 			return get_signal(connection);
@@ -213,11 +235,13 @@ class Hybmesh implements AutoCloseable{
 		}
 		public String _tos_vecint(int[] val){
 			if (val == null) return "None";
-			return Arrays.toString(val);
+			_raw_entry('i', val.length, 4*val.length).asIntBuffer().put(val);
+			return _raw_ref();
 		}
 		public String _tos_vecdouble(double[] val){
 			if (val == null) return "None";
-			return Arrays.toString(val);
+			_raw_entry('d', val.length, 8*val.length).asDoubleBuffer().put(val);
+			return _raw_ref();
 		}
 		public String _tos_vecstring(String[] val){
 			if (val == null) return "None";
@@ -229,14 +253,12 @@ class Hybmesh implements AutoCloseable{
 		}
 		public String _tos_vecpoint(Point2[] val){
 			if (val == null) return "None";
-			StringBuilder sb = new StringBuilder();
-			sb.append('[');
+			ByteBuffer b = _raw_entry('p', val.length, 16*val.length);
 			for (int i=0; i<val.length; ++i){
-				sb.append(_tos_point(val[i]));
-				if (i != val.length - 1) sb.append(", ");
+				b.putDouble(val[i].x);
+				b.putDouble(val[i].y);
 			}
-			sb.append(']');
-			return sb.toString();
+			return _raw_ref();
 		}
 		public String _tos_object(Hybmesh.Object val){
 			if (val == null) return "None";
@@ -4,6 +4,7 @@
 int require_connection(const char* path);
 void send_signal(int id, char sig);
 void send_data(int id, int sz, char* data);
+void send_raw(int id, int sz, void* data);
 char get_signal(int id);
 int get_data1(int id);
 void get_data2(int id, int sz, void* data);
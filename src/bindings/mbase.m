@@ -22,6 +22,9 @@ classdef HybmeshCallerOctave
 		function send_data(self, data)
 			core_hmconnection_oct(5, self.connection, data);
 		end
+		function send_raw(self, data)
+			core_hmconnection_oct(7, self.connection, data);
+		end
 		function break_connection(self)
 			core_hmconnection_oct(6, self.connection);
 		end
@@ -72,6 +75,10 @@ classdef HybmeshCallerMatlab
 			calllib('libcore_hmconnection_matlab', ...
 				'send_data', self.connection, int32(length(data)), data);
 		end
+		function send_raw(self, data)
+			calllib('libcore_hmconnection_matlab', ...
+				'send_raw', self.connection, int32(length(data)), data);
+		end
 		function break_connection(self)
 			calllib('libcore_hmconnection_matlab', ...
 				'break_connection', self.connection);
@@ -82,15 +89,29 @@ end
 classdef HybmeshWorker < handle
 	properties(Access=private)
 		caller;
+		% raw arrays payload of the command being assembled
+		rawbuf = zeros(1, 0, 'uint8');
+		nraw = 0;
 	end
 	properties(Access={?Hybmesh})
 		callback = @(a, b, c, d) 0;
 	end
 	methods (Access=private)
 		function send_command(self, func, com)
-			self.caller.send_signal('C');
+			raw = self.rawbuf;
+			self.rawbuf = zeros(1, 0, 'uint8');
+			self.nraw = 0;
+			self.caller.send_signal('T');
 			self.caller.send_data(func);
 			self.caller.send_data(com);
+			self.caller.send_raw(raw);
+		end
+		% adds array to raw payload; returns its reference for com string
+		function ret=tos_raw(self, tp, n, data)
+			self.rawbuf = [self.rawbuf, uint8(tp), ...
+				typecast(int32(n), 'uint8'), typecast(data, 'uint8')];
+			ret = sprintf('_raw(%i)', self.nraw);
+			self.nraw = self.nraw + 1;
 		end
 		function ret=wait_for_signal(self)
 			ret=self.caller.get_signal();
@@ -319,21 +340,11 @@ classdef HybmeshWorker < handle
 		function ret=tos_vecbyte(~, val)
 			ret = cast(val, 'char');
 		end
-		function ret=tos_vecint(~, val)
-			if isempty(val)
-				ret = '[]';
-			else
-				as = sprintf('%i, ', val);
-				ret = strcat('[', as, ']');
-			end
+		function ret=tos_vecint(self, val)
+			ret = self.tos_raw('i', numel(val), int32(val(:)'));
 		end
-		function ret=tos_vecdouble(~, val)
-			if isempty(val)
-				ret = '[]';
-			else
-				as = sprintf('%.16g, ', val);
-				ret = strcat('[', as, ']');
-			end
+		function ret=tos_vecdouble(self, val)
+			ret = self.tos_raw('d', numel(val), double(val(:)'));
 		end
 		function ret=tos_vecstring(~, val)
 			if isempty(val)
@@ -346,11 +357,10 @@ classdef HybmeshWorker < handle
 		function ret=tos_vecpoint(self, val)
 			if self.isnone(val)
 				ret = 'None';
-			elseif isempty(val)
-				ret = '[]';
 			else
-				ret = sprintf('[%.16g, %.16g], ', val');
-				ret = strcat('[', ret, ']');
+				% points are rows of val: pass them row by row
+				v = double(val');
+				ret = self.tos_raw('p', size(val, 1), v(:)');
 			end
 		end
 		function ret=tos_object(self, val)
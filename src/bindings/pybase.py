@@ -17,6 +17,8 @@ class _Worker(object):
         self.connection = self.require_connection(Hybmesh.hybmesh_exec_path)
         self.c_char_data = None
         self.c_char_len = 0
+        # raw arrays payload of the command being assembled
+        self.rawbuf = []
 
     def free(self):
         if self.c_char_data is not None:
@@ -50,14 +52,27 @@ class _Worker(object):
         data = data.encode('utf-8')
         self.cport.send_data(ct.c_int(self.connection), ct.c_int(sz), data)
 
+    def send_raw(self, data):
+        self.cport.send_data(ct.c_int(self.connection),
+                             ct.c_int(len(data)), data)
+
     def break_connection(self):
         self.cport.break_connection(ct.c_int(self.connection))
 
     # server communication
     def _send_command(self, func, com):
-        self.send_signal('C')
+        raw = b''.join(self.rawbuf)
+        self.rawbuf = []
+        self.send_signal('T')
         self.send_data(len(func), func)
         self.send_data(len(com), com)
+        self.send_raw(raw)
+
+    def _tos_raw(self, tp, n, data):
+        """ adds array to raw payload; returns its reference for com string
+        """
+        self.rawbuf.append(struct.pack('=ci', tp, n) + data)
+        return '_raw({})'.format(len(self.rawbuf) - 1)
 
     def _read_buffer(self):
         return self.get_data()
@@ -200,13 +215,17 @@ class _Worker(object):
             "={}s".format(len(val)), val)[0].decode('utf-8')
 
     def _tos_vecint(self, val):
-        return str(val)
+        if val is None:
+            return "None"
+        return self._tos_raw(b'i', len(val),
+                             struct.pack('={}i'.format(len(val)),
+                                         *map(int, val)))
 
     def _tos_vecdouble(self, val):
         if val is None:
             return "None"
-        ret = ', '.join(map(lambda x: "{:.16g}".format(x), val))
-        return '[' + ret + ']'
+        return self._tos_raw(b'd', len(val),
+                             struct.pack('={}d'.format(len(val)), *val))
 
     def _tos_vecstring(self, val):
         if val is None:
@@ -216,8 +235,9 @@ class _Worker(object):
     def _tos_vecpoint(self, val):
         if val is None:
             return "None"
-        ret = ', '.join(map(self._tos_point, val))
-        return '[' + ret + ']'
+        flat = [x for p in val for x in p[:2]]
+        return self._tos_raw(b'p', len(val),
+                             struct.pack('={}d'.format(len(flat)), *flat))
 
     def _tos_object(self, obj):
         if obj is not None:
@@ -2,6 +2,7 @@
 #include "addalgo.hpp"
 #include "assert.h"
 #include "hmcompute.hpp"
+#include <numeric>
 
 std::array<double, 3> Point::line_eq(const Point& L1, const Point& L2) noexcept{
 	if (L1 == L2) return {0, 0, 0};
@@ -26,7 +27,7 @@ double Point::meas_section(const Point& p, const Point& L1, const Point& L2, dou
 }
 
 double Point::meas_section(const Point& p, const Point& L1, const Point& L2) noexcept{
-	static double k;
+	double k;
 	return meas_section(p, L1, L2, k);
 }
 
@@ -469,3 +470,116 @@ Point BoundingBoxFinder::sqr_center(int i) const{
 	return Point(x0 + (0.5 + ix)*hx, y0 + (0.5 + iy)*hy);
 }
 
+
+// ============================ BoundingBoxTree
+namespace{
+//Sort-Tile-Recursive ordering: ids are reordered so that
+//each consecutive group of nsz items forms a compact tile.
+template<class CenterFun>
+void str_order(vector<int>& ids, int nsz, CenterFun&& center){
+	int n = ids.size();
+	int ntiles = (n + nsz - 1)/nsz;
+	int slice = nsz * (int)std::ceil(sqrt((double)ntiles));
+	std::sort(ids.begin(), ids.end(), [&center](int a, int b){ return center(a).x < center(b).x; });
+	for (int i=0; i<n; i+=slice){
+		std::sort(ids.begin()+i, ids.begin()+std::min(n, i+slice),
+			[&center](int a, int b){ return center(a).y < center(b).y; });
+	}
+}
+}
+
+BoundingBoxTree::BoundingBoxTree(const vector<BoundingBox>& entries): boxes(entries){
+	if (boxes.size() == 0) return;
+	packed.emplace_back();
+	pack(0, boxes.size(), packed.back());
+	npacked = boxes.size();
+}
+
+void BoundingBoxTree::addentry(const BoundingBox& e){
+	boxes.push_back(e);
+	if ((int)boxes.size() - npacked < 4*NODE_SIZE) return;
+	//pack unindexed entries together with all trees which are not larger
+	int begin = npacked;
+	while (packed.size() > 0 && packed.back().end - packed.back().begin <= (int)boxes.size() - begin){
+		begin = packed.back().begin;
+		packed.pop_back();
+	}
+	packed.emplace_back();
+	pack(begin, boxes.size(), packed.back());
+	npacked = boxes.size();
+}
+
+void BoundingBoxTree::pack(int begin, int end, Packed& ret) const{
+	int n = end - begin;
+	ret.begin = begin;
+	ret.end = end;
+	ret.nodes.clear();
+	ret.order.resize(n);
+	std::iota(ret.order.begin(), ret.order.end(), begin);
+	vector<Point> cnt(n);
+	for (int i=0; i<n; ++i) cnt[i] = boxes[begin+i].center();
+	str_order(ret.order, NODE_SIZE, [&cnt, begin](int i)->const Point&{ return cnt[i-begin]; });
+
+	//leaves
+	for (int i=0; i<n; i+=NODE_SIZE){
+		Node nd {boxes[ret.order[i]], i, std::min(n, i+NODE_SIZE), true};
+		for (int k=i+1; k<nd.last; ++k) nd.box.widen(boxes[ret.order[k]]);
+		ret.nodes.push_back(nd);
+	}
+	//upper levels: nodes of each level are reordered to keep siblings contiguous
+	int lev0 = 0, lev1 = ret.nodes.size();
+	while (lev1 - lev0 > 1){
+		vector<int> ids(lev1 - lev0);
+		std::iota(ids.begin(), ids.end(), lev0);
+		cnt.resize(lev1 - lev0);
+		for (int i=lev0; i<lev1; ++i) cnt[i-lev0] = ret.nodes[i].box.center();
+		str_order(ids, NODE_SIZE, [&cnt, lev0](int i)->const Point&{ return cnt[i-lev0]; });
+		vector<Node> lev;
+		lev.reserve(ids.size());
+		for (int i: ids) lev.push_back(ret.nodes[i]);
+		std::copy(lev.begin(), lev.end(), ret.nodes.begin() + lev0);
+		for (int i=lev0; i<lev1; i+=NODE_SIZE){
+			Node nd {ret.nodes[i].box, i, std::min(lev1, i+NODE_SIZE), false};
+			for (int k=i+1; k<nd.last; ++k) nd.box.widen(ret.nodes[k].box);
+			ret.nodes.push_back(nd);
+		}
+		lev0 = lev1;
+		lev1 = ret.nodes.size();
+	}
+}
+
+bool BoundingBoxTree::segment_cross(const BoundingBox& a, const Point& p1, const Point& p2){
+	BoundingBox sb(std::min(p1.x, p2.x), std::min(p1.y, p2.y),
+	               std::max(p1.x, p2.x), std::max(p1.y, p2.y));
+	if (!box_cross(a, sb)) return false;
+	//box should not lie strictly at one side of the segment line
+	double A = p2.y - p1.y, B = p1.x - p2.x;
+	double C = -A*p1.x - B*p1.y;
+	double e = geps*sqrt(A*A + B*B);
+	double f[4] = {A*a.xmin + B*a.ymin + C, A*a.xmax + B*a.ymin + C,
+	               A*a.xmax + B*a.ymax + C, A*a.xmin + B*a.ymax + C};
+	if (f[0] > e && f[1] > e && f[2] > e && f[3] > e) return false;
+	if (f[0] < -e && f[1] < -e && f[2] < -e && f[3] < -e) return false;
+	return true;
+}
+
+vector<int> BoundingBoxTree::suspects(const BoundingBox& bb) const{
+	vector<int> ret;
+	visit(bb, [&ret](int i){ ret.push_back(i); return true; });
+	std::sort(ret.begin(), ret.end());
+	return ret;
+}
+
+vector<int> BoundingBoxTree::suspects(const Point& p) const{
+	vector<int> ret;
+	visit(p, [&ret](int i){ ret.push_back(i); return true; });
+	std::sort(ret.begin(), ret.end());
+	return ret;
+}
+
+vector<int> BoundingBoxTree::suspects(const Point& p1, const Point& p2) const{
+	vector<int> ret;
+	visit(p1, p2, [&ret](int i){ ret.push_back(i); return true; });
+	std::sort(ret.begin(), ret.end());
+	return ret;
+}
@@ -303,6 +303,64 @@ private:
 	int get_yend(double y) const;
 };
 
+//Adaptive spatial index of bounding boxes: R-tree packed by Sort-Tile-Recursive algorithm.
+//Unlike BoundingBoxFinder its resolution follows entries density,
+//so it suits grids with strongly graded cell sizes.
+//Entries are identified by the order of their addition.
+//Entries added one by one are packed into a sequence of trees with decreasing sizes
+//which are merged as a binary counter. So both addition and query costs stay logarithmic.
+class BoundingBoxTree{
+public:
+	BoundingBoxTree(){}
+	//bulk loading
+	explicit BoundingBoxTree(const vector<BoundingBox>& entries);
+
+	void addentry(const BoundingBox& e);
+	int nentries() const { return boxes.size(); }
+	const BoundingBox& entry(int i) const { return boxes[i]; }
+
+	//sorted indicies of entries which have common points with given object
+	vector<int> suspects(const BoundingBox& bb) const;
+	vector<int> suspects(const Point& p) const;
+	vector<int> suspects(const Point& p1, const Point& p2) const;
+
+	//Allocation free queries.
+	//bool fun(int ientry) is called for each suspect entry in unspecified order.
+	//If fun returns false the query stops.
+	//Entries should not be added during a query.
+	template<class Fun>
+	void visit(const BoundingBox& bb, Fun&& fun) const;
+	template<class Fun>
+	void visit(const Point& p, Fun&& fun) const;
+	template<class Fun>
+	void visit(const Point& p1, const Point& p2, Fun&& fun) const;
+private:
+	static const int NODE_SIZE = 8;
+	struct Node{
+		BoundingBox box;
+		int first, last;   //leaf: range in order array, otherwise range in nodes array
+		bool leaf;
+	};
+	struct Packed{
+		int begin, end;    //range of entries
+		vector<Node> nodes;//root is the last one
+		vector<int> order; //entries sorted by leaves
+	};
+	vector<BoundingBox> boxes;
+	vector<Packed> packed;
+	int npacked = 0;
+
+	void pack(int begin, int end, Packed& ret) const;
+	static bool box_cross(const BoundingBox& a, const BoundingBox& b){
+		return !(ISGREATER(a.xmin, b.xmax) || ISLOWER(a.xmax, b.xmin) ||
+		         ISGREATER(a.ymin, b.ymax) || ISLOWER(a.ymax, b.ymin));
+	}
+	//conservative segment/box intersection test
+	static bool segment_cross(const BoundingBox& a, const Point& p1, const Point& p2);
+	template<class Test, class Fun>
+	void traverse(Test&& test, Fun&& fun) const;
+};
+
 // ============================ template implementations
 template<class FirstIter, class LastIter>
 ScaleBase ScaleBase::doscale(FirstIter start, LastIter end, double a) noexcept{
@@ -326,4 +384,45 @@ ScaleBase ScaleBase::p_doscale(Iter start, Iter end, double a) noexcept{
 	return ret;
 }
 
+template<class Test, class Fun>
+void BoundingBoxTree::traverse(Test&& test, Fun&& fun) const{
+	//depth of a tree is less then 12, so 256 is enough for depth-first traversal
+	int stack[256];
+	for (auto& pk: packed){
+		int ns = 0;
+		stack[ns++] = pk.nodes.size()-1;
+		while (ns > 0){
+			const Node& nd = pk.nodes[stack[--ns]];
+			if (!test(nd.box)) continue;
+			if (nd.leaf){
+				for (int k=nd.first; k<nd.last; ++k){
+					int ie = pk.order[k];
+					if (test(boxes[ie]) && !fun(ie)) return;
+				}
+			} else {
+				for (int k=nd.last-1; k>=nd.first; --k) stack[ns++] = k;
+			}
+		}
+	}
+	for (int ie=npacked; ie<(int)boxes.size(); ++ie){
+		if (test(boxes[ie]) && !fun(ie)) return;
+	}
+}
+
+template<class Fun>
+void BoundingBoxTree::visit(const BoundingBox& bb, Fun&& fun) const{
+	traverse([&bb](const BoundingBox& b){ return box_cross(b, bb); }, fun);
+}
+
+template<class Fun>
+void BoundingBoxTree::visit(const Point& p, Fun&& fun) const{
+	BoundingBox bb(p.x, p.y, p.x, p.y);
+	traverse([&bb](const BoundingBox& b){ return box_cross(b, bb); }, fun);
+}
+
+template<class Fun>
+void BoundingBoxTree::visit(const Point& p1, const Point& p2, Fun&& fun) const{
+	traverse([&p1, &p2](const BoundingBox& b){ return segment_cross(b, p1, p2); }, fun);
+}
+
 #endif
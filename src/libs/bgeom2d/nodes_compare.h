@@ -2,124 +2,200 @@
 #define POINTS_COMPARE_H
 
 #include "bgeom2d.h"
-
-struct DWRef_{ public: double ref; };
-
-inline bool dwref_cmp1(const DWRef_& a, const DWRef_& b){ return a.ref<b.ref; }
-inline bool dwref_cmp2(const DWRef_& a, double b){ return a.ref<b; }
-inline bool dwref_cmp3(double a, const DWRef_& b){ return a<b.ref; }
-
-// ==================== 2D set
-template<class TPoint, class TProc>
-class Point2Set{
-	struct XData: public DWRef_{
-		vector<const TPoint*> subs;
-
-		XData(typename vector<const TPoint*>::iterator i0, typename vector<const TPoint*>::iterator i1): subs(i0, i1){
-			auto psorty = [](const TPoint* a, const TPoint* b){
-				return TProc::y(*a)<TProc::y(*b);
-			};
-			ref = TProc::x(**i0) + geps;
-			std::sort(subs.begin(), subs.end(), psorty);
+#include "hmparallel.hpp"
+
+// ==================== hashed point grid
+//Points are placed into cells of a hash grid with cell size larger than 2*geps.
+//So points which coincide with a given one within geps tolerance
+//lie in at most two neighboring cells along each axis.
+//Construction and search are linear in expected time
+//regardless of points distribution.
+template<int Dim>
+class PointHashGrid{
+	static double cellsize() { return 4*geps; }
+	struct Slot{
+		long long key[Dim];
+		int head;           //first point in cell or -1 for empty slot
+	};
+	vector<double> crd;     //point coordinates
+	vector<int> next;       //next point in the same cell or -1
+	vector<char> alive;     //false for removed points
+	vector<Slot> table;
+	size_t mask = 0;
+
+	static long long cellkey(double x){ return (long long)std::floor(x/cellsize()); }
+	static size_t hash(const long long* k){
+		unsigned long long h = 0;
+		for (int d=0; d<Dim; ++d){
+			h ^= (unsigned long long)k[d] + 0x9E3779B97F4A7C15ULL + (h<<6) + (h>>2);
 		}
-	
-		//search for equal point in current column
-		const TPoint* search_for_point(double x, double y) const{
-			auto fnd = std::upper_bound(subs.begin(), subs.end(), y-geps,
-				[](double a, const TPoint* b){ return a<TProc::y(*b);});
-			while (fnd != subs.end() && TProc::y(**fnd)-y < geps){
-				if (fabs(TProc::x(**fnd)-x)<geps) return *fnd;
-				++fnd;
-			}
-			return nullptr;
+		h ^= h >> 31;
+		h *= 0xBF58476D1CE4E5B9ULL;
+		h ^= h >> 29;
+		return h;
+	}
+	//slot containing key or empty slot where it should be placed
+	size_t find_slot(const long long* k) const{
+		size_t i = hash(k) & mask;
+		while (table[i].head >= 0 && !std::equal(k, k+Dim, table[i].key)) i = (i+1) & mask;
+		return i;
+	}
+	bool equal_points(const double* a, const double* b) const{
+		for (int d=0; d<Dim; ++d) if (fabs(a[d]-b[d]) >= geps) return false;
+		return true;
+	}
+	//calls fun(k) for all cells which intersect [p-geps, p+geps]
+	template<class Fun>
+	void visit_cells(const double* p, Fun&& fun) const{
+		long long k0[Dim], k1[Dim], k[Dim];
+		for (int d=0; d<Dim; ++d){
+			k0[d] = cellkey(p[d]-geps);
+			k1[d] = cellkey(p[d]+geps);
+			k[d] = k0[d];
 		}
-		vector<const TPoint*> search_for_points(double x, double y, int istart=0) const{
-			vector<const TPoint*> ret;
-			auto fnd = std::upper_bound(subs.begin() + istart, subs.end(), y-geps,
-				[](double a, const TPoint* b){ return a<TProc::y(*b);});
-			while (fnd != subs.end() && TProc::y(**fnd)-y < geps){
-				if (fabs(TProc::x(**fnd)-x)<geps) ret.push_back(*fnd);
-				++fnd;
-			}
-			return ret;
+		while (1){
+			fun(k);
+			int d = 0;
+			while (d<Dim && k[d] == k1[d]) { k[d] = k0[d]; ++d; }
+			if (d == Dim) break;
+			++k[d];
 		}
-	};
-	vector<XData> sdata;
-	const vector<TPoint>* pinput;
-	int gind(const TPoint* p) const { return p - &(*pinput)[0]; }
-public:
-	Point2Set(const vector<TPoint>& input): pinput(&input){
-		if (input.size() == 0) return;
-		auto psortx = [](const TPoint* a, const TPoint* b){
-			return TProc::x(*a)<TProc::x(*b);
-		};
-		vector<const TPoint*> vp(input.size());
-		for (int i=0; i<input.size(); ++i) vp[i] = &input[i];
-		std::sort(vp.begin(), vp.end(), psortx);
-		auto it=vp.begin();
+	}
+	//Order in which base points are chosen by verbose_unique.
+	//Points are split into columns of 2*geps width along the first axis,
+	//columns are sorted along the second axis.
+	vector<int> column_rank() const{
+		int n = size();
+		vector<int> vp(n);
+		for (int i=0; i<n; ++i) vp[i] = i;
+		std::sort(vp.begin(), vp.end(), [this](int a, int b){ return crd[Dim*a] < crd[Dim*b]; });
+		auto it = vp.begin();
 		while (it != vp.end()){
 			auto itend = it+1;
-			while (itend != vp.end() && TProc::x(**itend) - TProc::x(**it) < 2*geps) ++itend;
-			sdata.push_back(XData(it, itend));
+			while (itend != vp.end() && crd[Dim*(*itend)] - crd[Dim*(*it)] < 2*geps) ++itend;
+			std::sort(it, itend, [this](int a, int b){ return crd[Dim*a+1] < crd[Dim*b+1]; });
 			it = itend;
 		}
+		vector<int> ret(n);
+		for (int i=0; i<n; ++i) ret[vp[i]] = i;
+		return ret;
 	}
+public:
+	//coords = x0, y0, (z0), x1, y1, (z1), ...
+	explicit PointHashGrid(vector<double>&& coords): crd(std::move(coords)){
+		int n = size();
+		next.assign(n, -1);
+		alive.assign(n, 1);
+		size_t tsize = 16;
+		while (tsize < 2*(size_t)n) tsize *= 2;
+		mask = tsize - 1;
+		table.resize(tsize);
+		for (auto& s: table) s.head = -1;
+		long long k[Dim];
+		//reverse order gives cell chains sorted by point index
+		for (int i=n-1; i>=0; --i){
+			for (int d=0; d<Dim; ++d) k[d] = cellkey(crd[Dim*i+d]);
+			Slot& s = table[find_slot(k)];
+			if (s.head < 0) std::copy(k, k+Dim, s.key);
+			next[i] = s.head;
+			s.head = i;
+		}
+	}
+	int size() const { return crd.size()/Dim; }
+	const double* point(int i) const { return &crd[Dim*i]; }
+
+	//calls bool fun(int i) for each not removed point within geps from p.
+	//If fun returns false search stops.
+	template<class Fun>
+	void visit(const double* p, Fun&& fun) const{
+		if (table.size() == 0) return;
+		bool goon = true;
+		visit_cells(p, [&](const long long* k){
+			if (!goon) return;
+			for (int i=table[find_slot(k)].head; i>=0 && goon; i=next[i]){
+				if (alive[i] && equal_points(p, point(i))) goon = fun(i);
+			}
+		});
+	}
+
+	//lowest index of equal point or -1
+	int find(const double* p) const{
+		int ret = -1;
+		visit(p, [&ret](int i){
+			if (ret < 0 || i < ret) ret = i;
+			return true;
+		});
+		return ret;
+	}
+
 	//-> vector of <secondary, base> points.
-	//   All secondary points will be removed from the structure.
+	//Points are processed in column_rank() order. Each point which was not
+	//marked as secondary becomes a base for all following equal points.
+	//Secondary points are removed.
+	//Search of equal points is done in parallel.
 	std::vector<std::pair<int, int>> verbose_unique(){
-		std::vector<bool> is_unique(pinput->size(), true);
-		std::vector<std::pair<int, int>> ret;
-		std::vector<bool> rows_to_resize(sdata.size(), false);
-
-		auto add_doubled_point = [&](int from, int to, int irow){
-			if (is_unique[from] == false) return;
-			is_unique[from] = false;
-			ret.push_back(std::make_pair(from, to));
-			rows_to_resize[irow] = true;
-		};
-
-		//calculate doubled points
-		for (int i=0; i<sdata.size(); ++i){
-			for (int j=0; j<sdata[i].subs.size(); ++j){
-				const TPoint* p = sdata[i].subs[j];
-				int pindex = gind(p);
-				if (!is_unique[pindex]) continue;
-				//current column
-				for (auto p2: sdata[i].search_for_points(TProc::x(*p), TProc::y(*p), j+1)){
-					add_doubled_point(gind(p2), pindex, i);
-				}
-				//next column
-				if (TProc::x(*p)>sdata[i].ref && sdata[i+1].ref-TProc::x(*p)<2*geps)
-				for (auto p2: sdata[i+1].search_for_points(TProc::x(*p), TProc::y(*p), 0)){
-					add_doubled_point(gind(p2), pindex, i+1);
-				}
+		int n = size();
+		const int min_chunk = 20000;
+		//(i, k) pairs of equal points with i < k
+		vector<vector<std::pair<int, int>>> cpairs(HMParallel::NumChunks(n, min_chunk));
+		HMParallel::ForChunks(n, [&](int ib, int ie, int ichunk){
+			auto& cp = cpairs[ichunk];
+			for (int i=ib; i<ie; ++i) if (alive[i]){
+				visit(point(i), [&](int k){
+					if (k > i) cp.push_back(std::make_pair(i, k));
+					return true;
+				});
 			}
-		}
-		if (ret.size() == 0) return ret;
+		}, min_chunk);
+
+		vector<std::pair<int, int>> pairs;
+		for (auto& cp: cpairs) pairs.insert(pairs.end(), cp.begin(), cp.end());
+		if (pairs.size() == 0) return std::vector<std::pair<int, int>>();
 
-		//remove doubled points
-		for (int i=0; i<sdata.size(); ++i) if (rows_to_resize[i]){
-			vector<const TPoint*> subs2; subs2.reserve(sdata[i].subs.size());
-			for (int j=0; j<sdata[i].subs.size(); ++j){
-				if (is_unique[gind(sdata[i].subs[j])]) subs2.push_back(sdata[i].subs[j]);
+		vector<int> rank = column_rank();
+		for (auto& p: pairs) if (rank[p.second] < rank[p.first]) std::swap(p.first, p.second);
+		std::sort(pairs.begin(), pairs.end(),
+			[&rank](const std::pair<int, int>& a, const std::pair<int, int>& b){
+				if (a.first != b.first) return rank[a.first] < rank[b.first];
+				return rank[a.second] < rank[b.second];
+			});
+
+		std::vector<std::pair<int, int>> ret;
+		for (auto& p: pairs){
+			if (alive[p.first] && alive[p.second]){
+				alive[p.second] = 0;
+				ret.push_back(std::make_pair(p.second, p.first));
 			}
-			std::swap(subs2, sdata[i].subs);
 		}
+		return ret;
+	}
+};
 
+// ==================== 2D set
+template<class TPoint, class TProc>
+class Point2Set{
+	PointHashGrid<2> grid;
+
+	static vector<double> coords(const vector<TPoint>& input){
+		vector<double> ret(2*input.size());
+		for (size_t i=0; i<input.size(); ++i){
+			ret[2*i] = TProc::x(input[i]);
+			ret[2*i+1] = TProc::y(input[i]);
+		}
 		return ret;
 	}
+public:
+	Point2Set(const vector<TPoint>& input): grid(coords(input)){}
+
+	//-> vector of <secondary, base> points.
+	//   All secondary points will be removed from the structure.
+	std::vector<std::pair<int, int>> verbose_unique(){
+		return grid.verbose_unique();
+	}
 
 	int find(double x, double y) const{
-		auto xfnd = std::upper_bound(sdata.begin(), sdata.end(), x, dwref_cmp3);
-		if (xfnd != sdata.end() && xfnd->ref-x < 2*geps){
-			const TPoint* ret = xfnd->search_for_point(x, y);
-			if (ret != nullptr) return gind(ret);
-		}
-		if (xfnd != sdata.begin() && x-(xfnd-1)->ref < 2*geps){
-			const TPoint* ret = (xfnd-1)->search_for_point(x, y);
-			if (ret != nullptr) return gind(ret);
-		}
-		return -1;
+		double p[2] = {x, y};
+		return grid.find(p);
 	}
 };
 
@@ -148,97 +224,29 @@ Point2Set<TPoint, DirectPoint2Access<TPoint>> point2_set_coords(const std::vecto
 // ==================== 3D set
 template<class TPoint, class TProc>
 class Point3Set{
-	struct YData: public DWRef_{
-		vector<const TPoint*> subs;
-		YData(typename vector<const TPoint*>::iterator i0, typename vector<const TPoint*>::iterator i1):subs(i0, i1){
-			auto psortz = [](const TPoint* a, const TPoint* b){
-				return TProc::z(*a)<TProc::z(*b);
-			};
-			ref = TProc::y(**i0) + geps;
-			std::sort(subs.begin(), subs.end(), psortz);
-		}
-	
-		//search for equal point in current column
-		const TPoint* search_for_point(double x, double y, double z) const{
-			auto fnd = std::upper_bound(subs.begin(), subs.end(), z-geps,
-				[](double a, const TPoint* b){ return a<TProc::z(*b);});
-			while (fnd != subs.end() && TProc::z(**fnd)-z<geps){
-				if (fabs(TProc::x(**fnd)-x)<geps && fabs(TProc::y(**fnd)-y)<geps) return *fnd;
-				++fnd;
-			}
-			return nullptr;
-		}
-	};
-	struct XData: public DWRef_{
-		vector<YData> subs;
-
-		XData(typename vector<const TPoint*>::iterator i0, typename vector<const TPoint*>::iterator i1){
-			auto psorty = [](const TPoint* a, const TPoint* b){
-				return TProc::y(*a)<TProc::y(*b);
-			};
-			ref = TProc::x(**i0)+geps;
-			std::sort(i0, i1, psorty);
-			auto it = i0;
-			while (it != i1){
-				auto itend = it+1;
-				while (itend != i1 && TProc::y(**itend)-TProc::y(**it) < 2*geps) ++itend;
-				subs.push_back(YData(it, itend));
-				it = itend;
-			}
-		}
-		//search for equal point in current column
-		const TPoint* search_for_point(double x, double y, double z) const{
-			auto fnd = std::upper_bound(subs.begin(), subs.end(), y, dwref_cmp3);
-			if (fnd != subs.end() && fnd->ref - y < 2*geps){
-				const TPoint* ret = fnd->search_for_point(x, y, z);
-				if (ret != nullptr) return ret;
-			}
-			if (fnd != subs.begin() && y-(fnd-1)->ref < 2*geps){
-				const TPoint* ret = (fnd-1)->search_for_point(x, y, z);
-				if (ret != nullptr) return ret;
-			}
-			return nullptr;
-		}
-
-	};
-	vector<XData> sdata;
-	const vector<TPoint>* pinput;
-	int gind(const TPoint* p) const { return p-&(*pinput)[0];}
-public:
-	Point3Set(const std::vector<TPoint>& input): pinput(&input){
-		if (input.size() == 0) return;
-		auto psortx = [](const TPoint* a, const TPoint* b){
-			return TProc::x(*a)<TProc::x(*b);
-		};
-		//XData fill
-		vector<const TPoint*> vp(input.size());
-		for (int i=0; i<input.size(); ++i) vp[i] = &input[i];
-		std::sort(vp.begin(), vp.end(), psortx);
-		auto it=vp.begin();
-		while (it != vp.end()){
-			auto itend=it+1;
-			while (itend != vp.end() && TProc::x(**itend)-TProc::x(**it) < 2*geps) ++itend;
-			sdata.push_back(XData(it, itend));
-			it = itend;
+	PointHashGrid<3> grid;
+
+	static vector<double> coords(const vector<TPoint>& input){
+		vector<double> ret(3*input.size());
+		for (size_t i=0; i<input.size(); ++i){
+			ret[3*i] = TProc::x(input[i]);
+			ret[3*i+1] = TProc::y(input[i]);
+			ret[3*i+2] = TProc::z(input[i]);
 		}
+		return ret;
 	}
+public:
+	Point3Set(const std::vector<TPoint>& input): grid(coords(input)){}
+
 	//-> vector of <secondary, base> points.
 	//   All secondary points will be removed from the structure.
 	std::vector<std::pair<int, int>> verbose_unique(){
-		_THROW_NOT_IMP_;
+		return grid.verbose_unique();
 	}
 
 	int find(double x, double y, double z) const{
-		auto xfnd = std::upper_bound(sdata.begin(), sdata.end(), x, dwref_cmp3);
-		if (xfnd != sdata.end() && xfnd->ref-x < 2*geps){
-			const TPoint* ret = xfnd->search_for_point(x, y, z);
-			if (ret != nullptr) return gind(ret);
-		}
-		if (xfnd != sdata.begin() && x-(xfnd-1)->ref < 2*geps){
-			const TPoint* ret = (xfnd-1)->search_for_point(x, y, z);
-			if (ret != nullptr) return gind(ret);
-		}
-		return -1;
+		double p[3] = {x, y, z};
+		return grid.find(p);
 	}
 };
 
@@ -116,13 +116,14 @@ BufferGrid::BufferGrid(GridData& main, const EdgeData& source, double buffer_siz
 	for (auto c: inv.grid.vcells) if (c->id != 1) push_back(c);
 }
 
-const BoundingBoxFinder& BufferGrid::source_finder() const{
+const BoundingBoxTree& BufferGrid::source_finder() const{
 	if (_sfinder == nullptr){
-		auto bbox = BBox(*source);
-		_sfinder.reset(new BoundingBoxFinder(bbox, bbox.maxlen()/40));
+		vector<BoundingBox> ebb;
+		ebb.reserve(source->size());
 		for (auto& e: (*source)){
-			_sfinder->addentry(BoundingBox(*e->first(), *e->last()));
+			ebb.push_back(BoundingBox(*e->first(), *e->last()));
 		}
+		_sfinder.reset(new BoundingBoxTree(ebb));
 	}
 	return *_sfinder;
 }
@@ -390,8 +391,10 @@ Contour::Tree BufferGrid::triangulation_boundary(){
 void BufferGrid::update_original(int filler){
 	if (size()==0) return;
 	Contour::Tree tree = triangulation_boundary();
-	GridData g3 = (filler == 0) ? Mesher::UnstructuredTriangle(tree)
-	                            : Mesher::UnstructuredTriangleRecomb(tree);
+	//own mesher instances: buffers of different unite operations can be filled concurrently
+	HMCallback::FunctionWithCallback<Mesher::TUnstructuredTriangle> trimesher;
+	HMCallback::FunctionWithCallback<Mesher::TUnstructuredTriangleRecomb> recmesher;
+	GridData g3 = (filler == 0) ? trimesher(tree) : recmesher(tree);
 	aa::constant_ids_pvec(orig->vcells, 0);
 	aa::constant_ids_pvec(*this, 1);
 	Algos::RemoveCellsById(*orig, 1);
@@ -35,8 +35,8 @@ class BufferGrid: public CellData{
 	void rebuild_source_edges(EdgeData&, EdgeData&);
 	EdgeData define_source_edges(const EdgeData&) const;
 	int is_on_source(const Point& p) const; //0 - no, 1 - vertex, 2 - somewhere on the edge
-	const BoundingBoxFinder& source_finder() const;
-	mutable std::unique_ptr<BoundingBoxFinder> _sfinder;
+	const BoundingBoxTree& source_finder() const;
+	mutable std::unique_ptr<BoundingBoxTree> _sfinder;
 public:
 	//extracts cells lying outside const (to the right hand side) not further than buffer_size
 	BufferGrid(GridData& main, const EdgeData& source, double buffer_size, bool preserve_bp, double angle0);
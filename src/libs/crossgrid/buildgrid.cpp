@@ -2,6 +2,7 @@
 #include "modgrid.hpp"
 #include <unordered_map>
 #include "healgrid.hpp"
+#include "hmpool.hpp"
 
 using namespace HM2D;
 namespace hgc = HM2D::Grid::Constructor;
@@ -114,10 +115,11 @@ GridData hgc::Circle(Point p0, double rad, int narc, int nrad, bool tri_center){
 		double rad2 = rad*(1.0)/nrad;
 		ret = Ring(p0, rad, rad2, narc, nrad-1);
 	} else {
+		HMPool::Pool pool;
 		for (int i=0; i<narc; ++i){
 			double phi = 2.0*M_PI/narc*i;
-			ret.vvert.emplace_back(
-				new Vertex(rad*cos(phi) + p0.x, rad*sin(phi) + p0.y));
+			ret.vvert.push_back(
+				pool.make<Vertex>(rad*cos(phi) + p0.x, rad*sin(phi) + p0.y));
 		}
 	}
 	VertexData tmp(ret.vvert);
@@ -145,10 +147,16 @@ GridData hgc::Circle(Point p0, double rad, int narc, int nrad, bool tri_center){
 	return ret;
 }
 
+namespace{
+GridData from_tab(VertexData&& vert, const vector<vector<int>>& cell_vert, HMPool::Pool& pool);
+}
+
 GridData hgc::FromRaw(int npnt, int ncls, double* pnt, int* cls, int dim){
+	//all primitives are placed into a single arena
+	HMPool::Pool pool;
 	VertexData vv(npnt);
 	for (auto i=0; i<npnt; ++i){
-		vv[i] = std::make_shared<Vertex>(pnt[2*i], pnt[2*i+1]);
+		vv[i] = pool.make<Vertex>(pnt[2*i], pnt[2*i+1]);
 	}
 	vector<vector<int>> cell_vert(ncls);
 	int* itc = cls;
@@ -160,7 +168,7 @@ GridData hgc::FromRaw(int npnt, int ncls, double* pnt, int* cls, int dim){
 		}
 		++ic;
 	}
-	return FromTab(std::move(vv), cell_vert);
+	return from_tab(std::move(vv), cell_vert, pool);
 }
 
 //uses only those vert which present in vert_cell tabs
@@ -169,6 +177,12 @@ GridData hgc::FromTab(const VertexData& vert, const vector<vector<int>>& cell_ve
 }
 
 GridData hgc::FromTab(VertexData&& vert, const vector<vector<int>>& cell_vert){
+	HMPool::Pool pool;
+	return from_tab(std::move(vert), cell_vert, pool);
+}
+
+namespace{
+GridData from_tab(VertexData&& vert, const vector<vector<int>>& cell_vert, HMPool::Pool& pool){
 	GridData r;
 	r.vvert = std::move(vert);
 
@@ -203,15 +217,18 @@ GridData hgc::FromTab(VertexData&& vert, const vector<vector<int>>& cell_vert){
 	}
 
 	//edges
+	r.vedges.reserve(neds);
 	vector<int>::iterator it=edge_p1p2.begin();
 	while (it != edge_p1p2.end()){
 		auto p1 = r.vvert[*it++];
 		auto p2 = r.vvert[*it++];
-		r.vedges.push_back(std::make_shared<Edge>(p1, p2));
+		r.vedges.push_back(pool.make<Edge>(p1, p2));
 	}
 	//cells
+	r.vcells.reserve(celledge.size());
 	for (int i=0; i<celledge.size(); ++i){
-		r.vcells.push_back(std::make_shared<Cell>());
+		r.vcells.push_back(pool.make<Cell>());
+		r.vcells.back()->edges.reserve(celledge[i].size());
 		for (int j=0; j<celledge[i].size(); ++j){
 			r.vcells.back()->edges.push_back(r.vedges[celledge[i][j]]);
 		}
@@ -239,6 +256,7 @@ GridData hgc::FromTab(VertexData&& vert, const vector<vector<int>>& cell_vert){
 
 	return r;
 }
+}
 
 hgc::InvokeGrid::InvokeGrid(const CellData& data){
 	grid.vcells.reserve(data.size());
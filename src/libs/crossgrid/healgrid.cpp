@@ -32,25 +32,26 @@ bool check_cells(const GridData& g, double& sumarea){
 }
 
 bool check_edges_intersections(const GridData& g){
-	auto bb = HM2D::BBox(g.vvert);
-	BoundingBoxFinder bfinder(bb, bb.maxlen()/50);
 	vector<BoundingBox> ebb(g.vedges.size());
 	for (int i=0; i<g.vedges.size(); ++i){
 		ebb[i] = BoundingBox(*g.vedges[i]->pfirst(), *g.vedges[i]->plast());
-		bfinder.addentry(ebb[i]);
 	}
+	BoundingBoxTree bfinder(ebb);
 	double ksieta[2];
-	for (int i=0; i<g.vedges.size(); ++i)
-	for (int isus: bfinder.suspects(ebb[i])) if (isus > i){
+	bool ret = true;
+	for (int i=0; i<g.vedges.size() && ret; ++i)
+	bfinder.visit(ebb[i], [&](int isus){
+		if (isus <= i) return true;
 		auto& e0 = g.vedges[i];
 		auto& e1 = g.vedges[isus];
-		if (e0->pfirst() == e1->pfirst() || e0->pfirst() == e1->plast()) continue;
-		if (e0->plast() == e1->pfirst() || e0->plast() == e1->plast()) continue;
+		if (e0->pfirst() == e1->pfirst() || e0->pfirst() == e1->plast()) return true;
+		if (e0->plast() == e1->pfirst() || e0->plast() == e1->plast()) return true;
 		if (SectCross(*e0->pfirst(), *e0->plast(), *e1->pfirst(), *e1->plast(), ksieta)){
-			return false;
+			ret = false;
 		}
-	}
-	return true;
+		return ret;
+	});
+	return ret;
 }
 };
 
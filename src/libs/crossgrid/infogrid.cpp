@@ -253,17 +253,18 @@ CONTINUE1:
 	if (suspcells.size() > 0){
 		EdgeData suspedges = AllEdges(suspcells);
 		aa::constant_ids_pvec(suspedges, 0);
-		BoundingBox bb=HM2D::BBox(nted);
-		BoundingBoxFinder domainfinder(bb, bb.maxlen()/30);
+		vector<BoundingBox> ebb;
+		ebb.reserve(nted.size());
 		for (auto& e: nted){
-			domainfinder.addentry(BoundingBox(*e->pfirst(), *e->plast()));
+			ebb.push_back(BoundingBox(*e->pfirst(), *e->plast()));
 		}
+		BoundingBoxTree domainfinder(ebb);
 		double ksieta[2];
 		for (auto& e: suspedges){
 			//shrink edge to eliminate non-crossing intersection
 			Point p1 = Point::Weigh(*e->pfirst(), *e->plast(), 2.*geps);
 			Point p2 = Point::Weigh(*e->pfirst(), *e->plast(), 1.-2.*geps);
-			for (auto isus: domainfinder.suspects(BoundingBox(p1, p2))){
+			domainfinder.visit(BoundingBox(p1, p2), [&](int isus){
 				Point *n1 = nted[isus]->pfirst(), *n2 = nted[isus]->plast();
 				//ignore parallel sections
 				int w1 = LinePointWhereIs(p1, *n1, *n2);
@@ -271,9 +272,10 @@ CONTINUE1:
 				if ((w1 == 0 && w2 == 2) || (w2 == 0 && w1 == 2))
 				if (SectCross(*n1, *n2, p1, p2, ksieta)){
 					e->id = 1;
-					break;
+					return false;
 				}
-			}
+				return true;
+			});
 		}
 		for (auto& c: suspcells){
 
@@ -121,9 +121,8 @@ void Algos::MergeBoundaries(const GridData& from, GridData& to){
 	//assembling boundaries
 	auto bvfrom = AllVertices(ECol::Assembler::GridBoundary(from));
 	auto bedto = ECol::Assembler::GridBoundary(to);
-	auto bbox = HM2D::BBox(bedto);
 	//quick search for 'to' boundary edges
-	BoundingBoxFinder tofinder(bbox, bbox.maxlen()/30.);
+	BoundingBoxTree tofinder;
 	for (auto e: bedto){
 		tofinder.addentry(BoundingBox(*e->pfirst(), *e->plast()));
 	}
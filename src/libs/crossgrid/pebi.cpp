@@ -354,7 +354,8 @@ HMCallback::FunctionWithCallback<Mesher::TUnstructuredPebi> Mesher::Unstructured
 GridData Mesher::TUnstructuredPebi::_run(const Contour::Tree& source, const CoordinateMap2D<double>& embedded){
 	//triangulation
 	auto cb = callback->subrange(100, 100);
-	GridData tri = UnstructuredTriangle.UseCallback(cb, source, embedded);
+	HMCallback::FunctionWithCallback<TUnstructuredTriangle> trimesher;
+	GridData tri = trimesher.UseCallback(cb, source, embedded);
 	//build pebi
 	callback->step_after(10, "assembling polygons");
 	return Constructor::TriToPebi(tri);
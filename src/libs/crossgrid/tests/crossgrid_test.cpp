@@ -21,6 +21,7 @@
 #include "snap_grid2cont.hpp"
 #include "inscribe_grid.hpp"
 #include "partcont.hpp"
+#include "hmparallel.hpp"
 
 using HMTesting::add_check;
 using HMTesting::add_file_check;
@@ -809,6 +810,18 @@ void test23(){
 		dt.add_data(3, 4, true);
 		HM2D::Export::GridMSH(g3, "g3.msh", dt);
 		add_file_check(6149640790734922004U, "g3.msh", "fluent with 2 periodic boundaries");
+
+		HM2D::Export::GridMSH(g3, "g4.msh", [](int i){ return "boundary" + std::to_string(i); },
+				dt, true);
+		auto s1 = HMTesting::msh_sections("g3.msh"), s2 = HMTesting::msh_sections("g4.msh");
+		bool good = s1.size() == 9 && s1.size() == s2.size();
+		for (auto it1=s1.begin(), it2=s2.begin(); it1!=s1.end() && good; ++it1, ++it2){
+			good = it1->first == it2->first && it1->second.size() == it2->second.size();
+			for (size_t i=0; i<it1->second.size() && good; ++i){
+				good = fabs(it1->second[i] - it2->second[i]) < 1e-12;
+			}
+		}
+		add_check(good, "fluent binary sections");
 	}
 	{
 		HM2D::GridData g4 = HM2D::Grid::Constructor::Circle(Point(0.5, 0.5), 0.1, 10, 3, true);
@@ -1147,6 +1160,51 @@ void test29(){
 	//}
 }
 
+bool same_grids(const HM2D::GridData& g1, const HM2D::GridData& g2){
+	if (g1.vvert.size() != g2.vvert.size() || g1.vedges.size() != g2.vedges.size() ||
+	    g1.vcells.size() != g2.vcells.size()) return false;
+	aa::enumerate_ids_pvec(g1.vvert);
+	aa::enumerate_ids_pvec(g2.vvert);
+	for (size_t i=0; i<g1.vvert.size(); ++i){
+		if (*g1.vvert[i] != *g2.vvert[i]) return false;
+	}
+	for (size_t i=0; i<g1.vedges.size(); ++i){
+		auto &e1 = g1.vedges[i], &e2 = g2.vedges[i];
+		if (e1->first()->id != e2->first()->id || e1->last()->id != e2->last()->id ||
+		    e1->boundary_type != e2->boundary_type) return false;
+	}
+	return true;
+}
+
+void test30(){
+	std::cout<<"30. Concurrent triangulation"<<std::endl;
+	HM2D::Contour::Tree tree;
+	for (int i=0; i<3; ++i){
+		auto c = HM2D::Contour::Constructor::Circle(32, 1, Point(3*i, 0));
+		for (auto& e: c) e->boundary_type = i+1;
+		tree.add_contour(c);
+	}
+	auto h = HM2D::Contour::Constructor::Circle(16, 0.3, Point(3, 0.2));
+	tree.add_contour(h);
+
+	HM2D::GridData g1 = HM2D::Mesher::UnstructuredTriangle(tree);
+	HM2D::GridData r1 = HM2D::Mesher::UnstructuredTriangleRecomb(tree);
+
+	HMParallel::SetNumThreads(3);
+	HM2D::GridData g2 = HM2D::Mesher::UnstructuredTriangle(tree);
+	HM2D::GridData r2 = HM2D::Mesher::UnstructuredTriangleRecomb(tree);
+	add_check(same_grids(g1, g2) && same_grids(r1, r2), "subdomains meshing in worker processes");
+
+	vector<HM2D::GridData> gg(3);
+	HMParallel::ForChunks(3, [&](int ib, int ie, int){
+		HMCallback::FunctionWithCallback<HM2D::Mesher::TUnstructuredTriangle> mesher;
+		for (int i=ib; i<ie; ++i) gg[i] = mesher(tree);
+	}, 1);
+	add_check(same_grids(g1, gg[0]) && same_grids(g1, gg[1]) && same_grids(g1, gg[2]),
+		"triangulation jobs in parallel threads");
+	HMParallel::SetNumThreads(1);
+}
+
 int main(){
 	//test0();
 	//test1();
@@ -1178,6 +1236,7 @@ int main(){
 	//test27();
 	test28();
 	//test29();
+	test30();
 
 	HMTesting::check_final_report();
 	std::cout<<"DONE"<<std::endl;
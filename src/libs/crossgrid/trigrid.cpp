@@ -16,6 +16,8 @@
 #include "MLine.h"
 #include "nan_handler.h"
 #include "GmshMessage.h"
+#include "hmgmsh.hpp"
+#include "hmparallel.hpp"
 using namespace HM2D;
 
 HMCallback::FunctionWithCallback<Mesher::TUnstructuredTriangle> Mesher::UnstructuredTriangle;
@@ -528,11 +530,11 @@ void fill_model_with_2d(GModel& m, const GFace* fc){
 	//m.writeMSH("gmsh_geo.msh");
 }
 
-void fill_model_with_2d_recomb(GModel& m, GFace* fc){
+void fill_model_with_2d_recomb(GModel& m, GFace* fc, HMGmsh::Context& ctx){
 	//usage of delaunay for quads gives worse results for non-regular areas
 	//hence using auto algorithm
-	GmshSetOption("Mesh", "Algorithm", 2.0);
-	GmshSetOption("Mesh", "RecombinationAlgorithm", 1.0);
+	ctx.set_option("Mesh", "Algorithm", 2.0);
+	ctx.set_option("Mesh", "RecombinationAlgorithm", 1.0);
 	fc->meshAttributes.recombine = 1.0;
 	m.mesh(2);
 
@@ -544,8 +546,8 @@ void fill_model_with_2d_recomb(GModel& m, GFace* fc){
 		if (e->getNumVertices() == 4) { has4=true; break; }
 	}
 	if (!has4){
-		GmshSetOption("Mesh", "Algorithm", 2.0);
-		GmshSetOption("Mesh", "RecombinationAlgorithm", 0.0);
+		ctx.set_option("Mesh", "Algorithm", 2.0);
+		ctx.set_option("Mesh", "RecombinationAlgorithm", 0.0);
 		fc->meshAttributes.recombine = 1.0;
 		m.mesh(2);
 	}
@@ -553,12 +555,13 @@ void fill_model_with_2d_recomb(GModel& m, GFace* fc){
 
 GridData gmsh_fill(const Contour::Tree& tree, const CoordinateMap2D<double>& embedded,
 		int algo, HMCallback::Caller2& cb){
+	HMGmsh::Context ctx;
 	GModel m;
 	m.setFactory("Gmsh");
 	//2 - auto, 5 - delaunay, 6 - frontal, 8 - delaunay for quads
-	GmshSetOption("Mesh", "Algorithm", 2.0);
-	GmshSetOption("Mesh", "Optimize", 1.0);
-	GmshSetOption("General", "Verbosity", 0.0);
+	ctx.set_option("Mesh", "Algorithm", 2.0);
+	ctx.set_option("Mesh", "Optimize", 1.0);
+	ctx.set_option("General", "Verbosity", 0.0);
 	//GmshSetOption("General", "Verbosity", 100.0);
 	//GmshSetMessageHandler(&gmshcb);
 
@@ -592,11 +595,11 @@ GridData gmsh_fill(const Contour::Tree& tree, const CoordinateMap2D<double>& emb
 	//!! gmsh 2.11 doesn't work correctly without this line
 	//   if chararcteristic mesh size is not 1.0
 	auto bb = m.bounds();
-	GmshSetBoundingBox(bb.min()[0], bb.max()[0], bb.min()[1], bb.max()[1], 0, 0);
+	ctx.set_bounding_box(bb.min()[0], bb.max()[0], bb.min()[1], bb.max()[1], 0, 0);
 	//gmsh has some zero division operations hence we need to stop checking
 	NanSignalHandler::StopCheck();
 	if (algo == 0) fill_model_with_2d(m, gf);
-	else fill_model_with_2d_recomb(m, gf);
+	else fill_model_with_2d_recomb(m, gf, ctx);
 	//turn nan check on
 	NanSignalHandler::StartCheck();
 
@@ -613,6 +616,85 @@ GridData gmsh_fill(const Contour::Tree& tree, const CoordinateMap2D<double>& emb
 	return ret;
 }
 
+//gmsh_fill result passed from worker process as a byte string:
+//int table [nv, ne, nc, (v1, v2, left, right, btype)*ne, (ncedges, cedges...)*nc]
+//followed by vertex coordinates.
+//Primitives order is kept so the restored grid is identical to the packed one.
+std::string pack_grid(const GridData& g){
+	aa::enumerate_ids_pvec(g.vvert);
+	aa::enumerate_ids_pvec(g.vedges);
+	aa::enumerate_ids_pvec(g.vcells);
+	vector<int> vi {(int)g.vvert.size(), (int)g.vedges.size(), (int)g.vcells.size()};
+	for (auto& e: g.vedges){
+		vi.push_back(e->first()->id);
+		vi.push_back(e->last()->id);
+		vi.push_back(e->has_left_cell() ? e->left.lock()->id : -1);
+		vi.push_back(e->has_right_cell() ? e->right.lock()->id : -1);
+		vi.push_back(e->boundary_type);
+	}
+	for (auto& c: g.vcells){
+		vi.push_back(c->edges.size());
+		for (auto& e: c->edges) vi.push_back(e->id);
+	}
+	int ni = vi.size();
+	std::string ret(sizeof(int) + ni*sizeof(int) + 2*g.vvert.size()*sizeof(double), 0);
+	char* p = &ret[0];
+	memcpy(p, &ni, sizeof(int)); p += sizeof(int);
+	memcpy(p, vi.data(), ni*sizeof(int)); p += ni*sizeof(int);
+	for (auto& v: g.vvert){
+		memcpy(p, &v->x, sizeof(double)); p += sizeof(double);
+		memcpy(p, &v->y, sizeof(double)); p += sizeof(double);
+	}
+	return ret;
+}
+
+//throws if byte string doesn't match pack_grid format
+GridData unpack_grid(const std::string& s){
+	auto bad = [](){ return std::runtime_error("corrupted grid data from worker process"); };
+	const char* p = s.data();
+	int ni;
+	if (s.size() < sizeof(int)) throw bad();
+	memcpy(&ni, p, sizeof(int)); p += sizeof(int);
+	if (ni < 3 || (size_t)ni > (s.size() - sizeof(int))/sizeof(int)) throw bad();
+	vector<int> vi(ni);
+	memcpy(vi.data(), p, ni*sizeof(int)); p += ni*sizeof(int);
+	int nv = vi[0], ne = vi[1], nc = vi[2];
+	if (nv < 0 || ne < 0 || nc < 0 || (long long)ne*5 + nc > ni - 3) throw bad();
+	if (s.size() != sizeof(int) + ni*sizeof(int) + 2*(size_t)nv*sizeof(double)) throw bad();
+
+	GridData ret;
+	ret.vvert.resize(nv);
+	ret.vedges.resize(ne);
+	ret.vcells.resize(nc);
+	for (auto& v: ret.vvert){
+		double xy[2];
+		memcpy(xy, p, 2*sizeof(double)); p += 2*sizeof(double);
+		v.reset(new Vertex(xy[0], xy[1]));
+	}
+	for (auto& c: ret.vcells) c.reset(new Cell());
+	auto it = vi.begin() + 3;
+	for (auto& e: ret.vedges){
+		if (it[0] < 0 || it[0] >= nv || it[1] < 0 || it[1] >= nv ||
+		    it[2] < -1 || it[2] >= nc || it[3] < -1 || it[3] >= nc) throw bad();
+		e.reset(new Edge(ret.vvert[it[0]], ret.vvert[it[1]]));
+		if (it[2] >= 0) e->left = ret.vcells[it[2]];
+		if (it[3] >= 0) e->right = ret.vcells[it[3]];
+		e->boundary_type = it[4];
+		it += 5;
+	}
+	for (auto& c: ret.vcells){
+		if (it == vi.end()) throw bad();
+		int n = *it++;
+		if (n < 0 || n > vi.end() - it) throw bad();
+		for (int k=0; k<n; ++k){
+			if (*it < 0 || *it >= ne) throw bad();
+			c->edges.push_back(ret.vedges[*it++]);
+		}
+	}
+	if (it != vi.end()) throw bad();
+	return ret;
+}
+
 //uses 100 units of callback
 GridData gmsh_builder(const Contour::Tree& source, const CoordinateMap2D<double>& embedded, int algo,
 		shared_ptr<HMCallback::Caller2> callback){
@@ -624,7 +706,16 @@ GridData gmsh_builder(const Contour::Tree& source, const CoordinateMap2D<double>
 	vector<Contour::Tree> trees = build_cropped(source);
 
 	vector<GridData> gg;
-	for (int i=0; i<trees.size(); ++i){
+	if (trees.size() > 1 && HMParallel::NumThreads() > 1){
+		//independent subdomains are meshed by worker processes
+		//since gmsh is not reentrant
+		callback->step_after(80, "Meshing subdomains");
+		auto packed = HMParallel::ForProcesses(trees.size(), [&](int i){
+			HMCallback::Caller2 cb;
+			return pack_grid(gmsh_fill(trees[i], embedded, algo, cb));
+		});
+		for (auto& p: packed) gg.push_back(unpack_grid(p));
+	} else for (int i=0; i<trees.size(); ++i){
 		auto cb = callback->subrange(80./trees.size(), 100.);
 		gg.push_back(gmsh_fill(trees[i], embedded, algo, *cb));
 	}
@@ -773,11 +864,12 @@ void guarantee_edges(GridData& grid, const EdgeData& edges){
 		force_edges[i].second->id = i;
 	}
 	vector<int> bad_edges;
-	auto bb = HM2D::BBox(grid.vvert);
-	BoundingBoxFinder gefinder(bb, bb.maxlen()/3);
+	vector<BoundingBox> ebb;
+	ebb.reserve(grid.vedges.size());
 	for (auto& e: grid.vedges){
-		gefinder.addentry(BoundingBox(*e->pfirst(), *e->plast()));
+		ebb.push_back(BoundingBox(*e->pfirst(), *e->plast()));
 	}
+	BoundingBoxTree gefinder(ebb);
 	for (auto& fe: force_edges){
 		for (auto isus: gefinder.suspects(BoundingBox(*fe.first, *fe.second))){
 			auto& e = grid.vedges[isus];
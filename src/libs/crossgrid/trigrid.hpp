@@ -22,7 +22,11 @@ EdgeData RepartSourceById(const EdgeData& source, const vector<std::pair<Point,
 		int src_sort_algo=1);
 
 //unstructured meshing procedures fills domain using existing boundary segmentation.
-//all detached tree nodes will be treated as constraints
+//all detached tree nodes will be treated as constraints.
+//Meshing is thread safe: gmsh calls are done within HMGmsh::Context and
+//independent subdomains are meshed in worker processes if HMParallel::NumThreads() > 1.
+//Concurrent jobs should use their own FunctionWithCallback instances
+//since global ones share callback state.
 struct TUnstructuredTriangle: public HMCallback::ExecutorBase{
 	HMCB_SET_PROCNAME("Triangulation");
 	HMCB_SET_DEFAULT_DURATION(100);
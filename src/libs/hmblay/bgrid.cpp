@@ -10,6 +10,11 @@
 
 using namespace HMBlay::Impl;
 
+std::recursive_mutex& HMBlay::Impl::backend_mutex(){
+	static std::recursive_mutex m;
+	return m;
+}
+
 BGrid BGrid::MeshFullPath(const ExtPath& epath){
 	//1. divide by angles
 	vector<ExtPath> pths = ExtPath::DivideByAngle(epath,
@@ -103,10 +108,11 @@ BGrid BGrid::MeshFullPath(const ExtPath& epath){
 	return g;
 }
 
-BGrid BGrid::MeshSequence(vector<Options*>& data){ 
+BGrid BGrid::MeshSequence(vector<Options*>& data, HMCallback::Caller2& cb){ 
 	auto ret = BGrid();
 
 	//1) assemble extended path = path + boundaries + angles
+	cb.move_now(0, "Path assembling");
 	ExtPath fullpath = ExtPath::Assemble(data);
 
 	//2) if corner angle section is very short then
@@ -114,12 +120,15 @@ BGrid BGrid::MeshSequence(vector<Options*>& data){
 	ExtPath::ReinterpretCornerTp(fullpath);
 
 	//3) build grid for a path
+	cb.move_now(1, "Path meshing");
 	ret = BGrid::MeshFullPath(fullpath);
 
 	//4) guarantee no self-intersections.
 	//   Includes acute angle postprocessing.
+	cb.move_now(8, "Self intersections");
 	ret = NoSelfIntersections(ret, fullpath);
 
+	cb.fin();
 	return ret;
 }
 
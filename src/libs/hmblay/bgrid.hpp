@@ -4,10 +4,16 @@
 #include "options.hpp"
 #include "extpath.hpp"
 #include "primitives2d.hpp"
+#include "hmcallback.hpp"
+#include <mutex>
 
 namespace HMBlay{
 namespace Impl{
 
+//Conformal mappings used by boundary layer builder are not reentrant.
+//Their calls from concurrently built sequences are serialized by this mutex.
+std::recursive_mutex& backend_mutex();
+
 class BGrid: public HM2D::GridData{
 	static ExtPath AssembleExtendedPath(vector<Options*>& data);
 	static BGrid NoSelfIntersections(BGrid& g, const HM2D::EdgeData& source);
@@ -57,7 +63,7 @@ public:
 	}
 	
 	
-	static BGrid MeshSequence(vector<Options*>& data);
+	static BGrid MeshSequence(vector<Options*>& data, HMCallback::Caller2& cb);
 	static BGrid ImposeBGrids(ShpVector<BGrid>& gg);
 	static shared_ptr<BGrid> MoveFrom1(HM2D::GridData&& gg);
 	static BGrid MoveFrom2(HM2D::GridData&& gg);
@@ -9,6 +9,7 @@
 #include "healgrid.hpp"
 #include "finder2d.hpp"
 #include "modgrid.hpp"
+#include "hmparallel.hpp"
 
 using namespace HMBlay::Impl;
 
@@ -17,56 +18,64 @@ namespace{
 class ContactArea{
 	HM2D::Contour::Tree domain;
 	const BGrid* grid;
-	const int n_cfinder = 50; //partition for auxilliary grid
 	vector<HM2D::EdgeData> intersections; //intersection contours
-	std::map<int, int> intersect_results; //cell pair index -> intersection contour index
 	std::set<int> cells_in_area; //all cells which were involved in intersections
 
-	//unique integer for two cells
-	//!!! cells ids for should be set correctly
-	long long __cellcell(const HM2D::Cell* c1, const HM2D::Cell* c2){
-		long long i1 = c1->id, i2 = c2->id;
-		if (i1>i2) std::swap(i1, i2);
-		return i1*grid->vcells.size()+i2;
-	}
+	//broad phase: pairs of cells from different sources with crossed bounding boxes.
+	//Pairs are ordered by first and then by second cell index.
+	vector<std::pair<int, int>> CandidatePairs() const{
+		int nc = grid->vcells.size();
+		vector<BoundingBox> cbb(nc);
+		HMParallel::ForChunks(nc, [&](int ib, int ie, int){
+			for (int i=ib; i<ie; ++i){
+				auto& ed = grid->vcells[i]->edges;
+				cbb[i] = BoundingBox(*ed[0]->first());
+				for (auto& e: ed){
+					cbb[i].widen(*e->first());
+					cbb[i].widen(*e->last());
+				}
+			}
+		});
+		BoundingBoxTree tree(cbb);
+
+		vector<vector<std::pair<int, int>>> chpairs(HMParallel::NumChunks(nc, 200));
+		HMParallel::ForChunks(nc, [&](int ib, int ie, int ichunk){
+			vector<int> cand;
+			for (int i=ib; i<ie; ++i){
+				cand.clear();
+				tree.visit(cbb[i], [&](int j){
+					if (j > i && !grid->is_from_same_source(i, j)) cand.push_back(j);
+					return true;
+				});
+				std::sort(cand.begin(), cand.end());
+				for (int j: cand) chpairs[ichunk].emplace_back(i, j);
+			}
+		}, 200);
 
-	void __set_cells_intersection(const HM2D::Cell* c1, const HM2D::Cell* c2){
-		long long ind = __cellcell(c1, c2);
-		//if cells share the same feature they can not intersect
-		if (grid->is_from_same_source(c1, c2)) return;
-		//if result was already obtained
-		if (intersect_results.find(ind) != intersect_results.end()) return;
-		//apply intersection
-		auto res = HM2D::Contour::Clip::Intersection(c1->edges, c2->edges);
-		if (res.nodes.size() == 1){
-			cells_in_area.insert(c1->id);
-			cells_in_area.insert(c2->id);
-			intersect_results[ind] = intersections.size();
-			intersections.push_back(res.nodes[0]->contour);
-		} else {
-			intersect_results[ind] = -1;
-		}
+		vector<std::pair<int, int>> ret;
+		for (auto& it: chpairs) ret.insert(ret.end(), it.begin(), it.end());
+		return ret;
 	}
 
 	void FillDomain(){
-		//GGeom::Info::CellFinder cfinder(grid, n_cfinder, n_cfinder);
-		auto bb = HM2D::BBox(grid->vvert);
-		BoundingBoxFinder cfinder(bb, bb.maxlen()/n_cfinder);
-		for (int i=0; i<grid->vcells.size(); ++i){
-			auto cbb = HM2D::BBox(grid->vcells[i]->edges);
-			cfinder.addentry(cbb);
-		}
 		aa::enumerate_ids_pvec(grid->vcells);
-		for (int i=0; i<cfinder.nsqr(); ++i){
-			auto clist = cfinder.sqr_entries(i);
-			//check all pairs of cells positioned close to each other
-			for (int j=0; j<clist.size(); ++j){
-				for (int k=j+1; k<clist.size(); ++k){
-					__set_cells_intersection(
-						grid->vcells[clist[j]].get(),
-						grid->vcells[clist[k]].get());
-				}
+		auto pairs = CandidatePairs();
+		//narrow phase: exact intersections of cell pairs.
+		//Clipping only reads cell edges and builds new primitives,
+		//so pairs sharing a cell can be processed concurrently.
+		vector<HM2D::EdgeData> res(pairs.size());
+		HMParallel::ForChunks(pairs.size(), [&](int ib, int ie, int){
+			for (int i=ib; i<ie; ++i){
+				auto& c1 = grid->vcells[pairs[i].first]->edges;
+				auto& c2 = grid->vcells[pairs[i].second]->edges;
+				auto r = HM2D::Contour::Clip::Intersection(c1, c2);
+				if (r.nodes.size() == 1) res[i] = std::move(r.nodes[0]->contour);
 			}
+		}, 20);
+		for (size_t i=0; i<pairs.size(); ++i) if (res[i].size() > 0){
+			cells_in_area.insert(pairs[i].first);
+			cells_in_area.insert(pairs[i].second);
+			intersections.push_back(std::move(res[i]));
 		}
 		//unite all intersections
 		domain = HM2D::Contour::Clip::Union(intersections);
@@ -318,8 +327,8 @@ const HM2D::EdgeData* ClosedSource(const HM2D::EdgeData* src, const BGrid* grid)
 		{bbox.xmin, bbox.ymin, bbox.xmax, bbox.ymin,
 		 bbox.xmax, bbox.ymax, bbox.xmin, bbox.ymax}, true);
 	double sz = 1.1*sqrt(sqr(bbox.lenx()) + sqr(bbox.leny()));
+	double an = 0;
 	auto find_good_box_point = [&](Point& src)->shared_ptr<HM2D::Vertex>{
-		static double an = 0;
 		//trying different angles until we find non crossing section
 		for (int i=0; i<20; ++i){
 			Point p2 = src + Point(cos(an), sin(an)) * sz;
@@ -500,7 +509,9 @@ void NonIntersectingGrid(BGrid& grid,
 
 	//triangulate
 	delarea = HM2D::Mesher::PrepareSource(delarea);
-	auto fillg = HM2D::Mesher::UnstructuredTriangle(delarea);
+	//own mesher instance: global functor object shares callback state
+	HMCallback::FunctionWithCallback<HM2D::Mesher::TUnstructuredTriangle> mesher;
+	auto fillg = mesher(delarea);
 
 	//add triangle grid and return
 	HM2D::Grid::Algos::MergeBoundaries(fillg, grid);
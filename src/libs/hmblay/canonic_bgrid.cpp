@@ -241,6 +241,7 @@ RectForOpenArea::RectForOpenArea(HM2D::EdgeData& left, HM2D::EdgeData& right,
 			HM2D::EdgeData& bottom, HM2D::EdgeData& top,
 			int femn, bool use_rect_approx, bool force_rect_approx):
 			MappedRect(left, right, bottom, top, use_rect_approx){
+	std::lock_guard<std::recursive_mutex> lock(backend_mutex());
 	if (force_rect_approx){
 		core = HMMap::Conformal::Impl::RectApprox::Build(left, right, bottom, top);
 		return;
@@ -273,6 +274,7 @@ RectForOpenArea::RectForOpenArea(HM2D::EdgeData& left, HM2D::EdgeData& right,
 };
 
 HM2D::VertexData RectForOpenArea::MapToReal(const vector<const Point*>& p) const{
+	std::lock_guard<std::recursive_mutex> lock(backend_mutex());
 	vector<Point> ret(p.size());
 	double m = core->module();
 	//stretch to conformal rectangle
@@ -290,6 +292,7 @@ HM2D::VertexData RectForOpenArea::MapToReal(const vector<const Point*>& p) const
 }
 
 HM2D::VertexData RectForOpenArea::MapToSquare(const vector<const Point*>& p) const{
+	std::lock_guard<std::recursive_mutex> lock(backend_mutex());
 	vector<Point> ret(p.size());
 	std::transform(p.begin(), p.end(), ret.begin(), [](const Point* it){
 			return Point(it->x, it->y);
@@ -337,6 +340,7 @@ double RectForOpenArea::left2conf(double w) const{
 RectForClosedArea::RectForClosedArea(const HM2D::EdgeData& side, const HM2D::EdgeData& bottom,
 		const HM2D::EdgeData& top):
 		MappedRect(side, side, bottom, top, false){
+	std::lock_guard<std::recursive_mutex> lock(backend_mutex());
 	assert(HM2D::Contour::IsClosed(bottom));
 	assert(HM2D::Contour::IsClosed(top));
 	//collect points from top
@@ -394,6 +398,7 @@ RectForClosedArea::Build(const HM2D::EdgeData& bottom, const HM2D::EdgeData& top
 
 
 HM2D::VertexData RectForClosedArea::MapToReal(const vector<const Point*>& pnt) const{
+	std::lock_guard<std::recursive_mutex> lock(backend_mutex());
 	//length of curve of first point of inner circle
 	double phi0 = (top_is_outer) ? core->PhiInner(0) : core->PhiOuter(0);
 	//vector of points in canonic area
@@ -418,6 +423,7 @@ HM2D::VertexData RectForClosedArea::MapToReal(const vector<const Point*>& pnt) c
 }
 
 HM2D::VertexData RectForClosedArea::MapToSquare(const vector<const Point*>& pin) const{
+	std::lock_guard<std::recursive_mutex> lock(backend_mutex());
 	//map to canonic
 	vector<Point> pout(pin.size());
 	std::transform(pin.begin(), pin.end(), pout.begin(), [](const Point* p){ return *p; });
@@ -456,6 +462,7 @@ HM2D::VertexData RectForClosedArea::MapToSquare(const vector<const Point*>& pin)
 }
 
 Point RectForClosedArea::MapBndToReal(const Point& p) const{
+	std::lock_guard<std::recursive_mutex> lock(backend_mutex());
 	//length of curve of first point of inner circle
 	double phi0 = (top_is_outer) ? core->PhiInner(0) : core->PhiOuter(0);
 	//vector of points in canonic area
@@ -470,6 +477,7 @@ Point RectForClosedArea::MapBndToReal(const Point& p) const{
 	return core->MapToOriginalBnd(Point(r*cos(an), r*sin(an)));
 }
 Point RectForClosedArea::MapBndToSquare(const Point& p) const{
+	std::lock_guard<std::recursive_mutex> lock(backend_mutex());
 	//map to canonic
 	Point p2 = core->MapToAnnulusBnd(p);
 	//(x, y) -> (rad, phi)
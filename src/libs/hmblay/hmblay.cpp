@@ -1,12 +1,50 @@
 #include "hmblay.hpp"
 #include <memory>
 #include "bgrid.hpp"
+#include "hmparallel.hpp"
 
 using namespace HMBlay::Impl;
 
+namespace{
+
+//Sequences built from the same source edges share primitives
+//and should be meshed within a single task.
+//Returns indicies of sequences grouped by their sources.
+vector<vector<int>> independent_groups(const vector<vector<Options*>>& seqvec){
+	vector<int> gr(seqvec.size());
+	std::map<const HM2D::EdgeData*, int> src_group;
+	for (int i=0; i<(int)seqvec.size(); ++i){
+		gr[i] = i;
+		for (auto o: seqvec[i]){
+			auto er = src_group.emplace(o->edges, gr[i]);
+			if (er.second || er.first->second == gr[i]) continue;
+			//sequence joins two groups: relabel the latter one
+			int g1 = std::min(gr[i], er.first->second);
+			int g2 = std::max(gr[i], er.first->second);
+			for (int j=0; j<=i; ++j) if (gr[j] == g2) gr[j] = g1;
+			for (auto& it: src_group) if (it.second == g2) it.second = g1;
+		}
+	}
+	vector<vector<int>> ret;
+	std::map<int, int> group_index;
+	for (int i=0; i<(int)gr.size(); ++i){
+		auto er = group_index.emplace(gr[i], ret.size());
+		if (er.second) ret.emplace_back();
+		ret[er.first->second].push_back(i);
+	}
+	return ret;
+}
+
+}
+
 // ========================= Main Algo
 HM2D::GridData HMBlay::BuildBLayerGrid(const vector<HMBlay::Input>& orig_opt){
+	return BuildBLayerGrid(orig_opt, HMCallback::silent2);
+}
+
+HM2D::GridData HMBlay::BuildBLayerGrid(const vector<HMBlay::Input>& orig_opt, HMCallback::Fun2 cb){
 	if (orig_opt.size() == 0) return HM2D::GridData();
+	HMCallback::Caller2 callback("Boundary layer grid", 100, cb);
 	//0) check input
 	for (auto& o: orig_opt){
 		if (o.edges == 0 || o.edges->size() == 0){
@@ -28,26 +66,42 @@ HM2D::GridData HMBlay::BuildBLayerGrid(const vector<HMBlay::Input>& orig_opt){
 	}
 
 	//1,2) internal, non-dimensional copy of orig_options
+	callback.move_now(0, "Options assembling");
 	std::vector<Options> opt = Options::CreateFromParent(orig_opt);
 
 	//4) Sequences of PathOptions
 	//Organize options in a sequences depending on start/end points
 	auto seqvec = Options::BuildSequence(opt);
 
-	//5) Build Grid for each sequence
-	ShpVector<BGrid> gg;
-	for (auto& seq: seqvec){
-		auto a = BGrid::MeshSequence(seq);
-		gg.emplace_back(new BGrid(std::move(a)));
-	}
+	//5) Build Grid for each sequence.
+	//Independent groups of sequences are meshed concurrently.
+	//Results are stored by sequence index so that imposition
+	//doesn't depend on threads scheduling.
+	auto groups = independent_groups(seqvec);
+	ShpVector<BGrid> gg(seqvec.size());
+	callback.move_now(10, "Sequences meshing");
+	auto pcb = callback.parallel_subrange(80, seqvec.size(), "Sequences",
+			HMParallel::NumChunks(groups.size(), 1));
+	HMParallel::ForChunks(groups.size(), [&](int ib, int ie, int){
+		for (int ig=ib; ig<ie; ++ig)
+		for (int iseq: groups[ig]){
+			auto tcb = pcb->task(iseq, "Sequence " + std::to_string(iseq+1) + "/"
+					+ std::to_string(seqvec.size()), 10);
+			auto a = BGrid::MeshSequence(seqvec[iseq], *tcb);
+			gg[iseq].reset(new BGrid(std::move(a)));
+		}
+	}, 1);
+	pcb->stop();
 
 	//6) impose boundary grids
+	callback.move_now(90, "Grids imposition");
 	auto impres = BGrid::ImposeBGrids(gg);
 
 	//7) to original size
 	HM2D::Unscale(impres.vvert, *opt[0].get_scaling());
 
 	HM2D::GridData ret(std::move(impres));
+	callback.fin();
 	return ret;
 }
 
@@ -14,6 +14,9 @@ public:
 			std::string("Boundary Layer Build Error: ") + m){};
 };
 HM2D::GridData BuildBLayerGrid(const vector<Input>& opt);
+//Independent sequences are built concurrently (see HMParallel::SetNumThreads),
+//cb is called from a separate reporter thread during sequences meshing.
+HM2D::GridData BuildBLayerGrid(const vector<Input>& opt, HMCallback::Fun2 cb);
 
 struct TBuildStripeGrid: public HMCallback::ExecutorBase{
 	HMCB_SET_PROCNAME("Stripe grid building");
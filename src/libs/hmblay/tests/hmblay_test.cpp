@@ -10,6 +10,10 @@
 #include "modgrid.hpp"
 #include "unite_grids.hpp"
 #include "finder2d.hpp"
+#include "hmparallel.hpp"
+#include "hmtrace.hpp"
+#include <fstream>
+#include <thread>
 
 using HMTesting::add_check;
 
@@ -771,6 +775,121 @@ void test17(){
 		"same with ignore_all option");
 }
 
+void test18(){
+	std::cout<<"18. Concurrent building of independent sequences"<<std::endl;
+	auto c1 = HM2D::Contour::Constructor::Circle(16, 0.5, Point(0, 0));
+	auto c2 = HM2D::Contour::Constructor::Circle(16, 0.5, Point(2, 0));
+	auto c3 = HM2D::Contour::Constructor::FromPoints({0, 3, 1, 3.3, 2, 3.1, 3, 3.5}, false);
+	vector<HMBlay::Input> inp(4);
+	inp[0].edges = &c1;
+	inp[0].direction = HMBlay::DirectionFromString("OUTER");
+	inp[0].partition = {0, 0.05, 0.1, 0.2, 0.35};
+	inp[0].bnd_step_method = HMBlay::MethFromString("KEEP_SHAPE");
+	inp[0].bnd_step = 0.07;
+	inp[1] = inp[0];
+	inp[1].edges = &c2;
+	inp[2] = inp[0];
+	inp[2].edges = &c3;
+	inp[2].direction = HMBlay::DirectionFromString("LEFT");
+	inp[2].start = Point(0, 3);
+	inp[2].end = Point(1, 3.3);
+	inp[3] = inp[2];
+	inp[3].start = Point(1, 3.3);
+	inp[3].end = Point(3, 3.5);
+
+	HM2D::GridData g1 = HMBlay::BuildBLayerGrid(inp);
+
+	int ncalls = 0;
+	double lastprog = -1;
+	bool monotone = true;
+	HMCallback::Fun2 cb = [&](const char* s1, const char* s2, double p1, double p2){
+		++ncalls;
+		if (p1 < lastprog) monotone = false;
+		lastprog = p1;
+		return HMCallback::OK;
+	};
+	HMParallel::SetNumThreads(4);
+	HM2D::GridData g2 = HMBlay::BuildBLayerGrid(inp, cb);
+
+	bool same = g1.vvert.size() == g2.vvert.size() &&
+	            g1.vcells.size() == g2.vcells.size();
+	for (size_t i=0; same && i<g1.vvert.size(); ++i){
+		same = *g1.vvert[i] == *g2.vvert[i];
+	}
+	add_check(same, "grids built by 1 and 4 threads coincide");
+	add_check(ncalls >= 4 && monotone && lastprog == 1.0, "aggregated progress");
+
+	bool cancelled = false;
+	HMCallback::Fun2 cancel_cb = [&](const char* s1, const char* s2, double p1, double p2){
+		return (p1 > 0.3) ? HMCallback::CANCEL : HMCallback::OK;
+	};
+	try{
+		HMBlay::BuildBLayerGrid(inp, cancel_cb);
+	} catch (HMCallback::Cancelled& e){
+		cancelled = true;
+	}
+	add_check(cancelled, "cancellation of concurrent sequences");
+
+	//workers which are stopped by the reporter thread
+	HMCallback::Caller2 caller("Parallel loop", 1, cancel_cb);
+	auto pc = caller.parallel_subrange(1, 4);
+	std::atomic<int> nsteps(0);
+	cancelled = false;
+	try{
+		HMParallel::ForChunks(4, [&](int ib, int ie, int){
+			auto tcb = pc->task(ib, "Loop", 1000);
+			for (int k=0; k<1000; ++k){
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				tcb->move_now(k, "step");
+				++nsteps;
+			}
+		}, 1);
+	} catch (HMCallback::Cancelled& e){
+		cancelled = true;
+	}
+	pc->stop();
+	add_check(cancelled && nsteps < 4000 && pc->cancelled(), "cancellation token");
+	HMParallel::SetNumThreads(1);
+
+	//single worker: progress is reported by the calling thread
+	ncalls = 0;
+	lastprog = -1;
+	bool same_thread = true;
+	auto main_id = std::this_thread::get_id();
+	HMCallback::Fun2 sync_cb = [&](const char* s1, const char* s2, double p1, double p2){
+		++ncalls;
+		if (std::this_thread::get_id() != main_id) same_thread = false;
+		lastprog = p1;
+		return HMCallback::OK;
+	};
+	HMBlay::BuildBLayerGrid(inp, sync_cb);
+	add_check(ncalls >= 4 && same_thread && lastprog == 1.0, "synchronous progress");
+}
+
+void test19(){
+	std::cout<<"19. Procedures tracing"<<std::endl;
+	auto cont = HM2D::Contour::Constructor::FromPoints({0, 0, 1, 0.2, 2, 0}, false);
+	vector<double> part {0, 0.05, 0.1};
+	Point bl, br, tr, tl;
+	HMTrace::Enable(true);
+	HMBlay::BuildStripeGrid(cont, part, 0, bl, br, tr, tl);
+	HMTrace::Enable(false);
+	int nev = HMTrace::NumEvents();
+	HMTrace::ExportChrome("trace.json");
+	HMTrace::Clear();
+
+	std::ifstream fs("trace.json");
+	std::string js((std::istreambuf_iterator<char>(fs)), std::istreambuf_iterator<char>());
+	add_check(nev > 3 &&
+	          js.find("\"name\":\"Stripe grid building\",\"cat\":\"procedure\"") != std::string::npos &&
+	          js.find("\"name\":\"Upper grid\",\"cat\":\"subprocess\"") != std::string::npos &&
+	          js.find("\"name\":\"Lower grid\",\"cat\":\"subprocess\"") != std::string::npos,
+	          "stripe grid trace");
+
+	HMBlay::BuildStripeGrid(cont, part, 0, bl, br, tr, tl);
+	add_check(HMTrace::NumEvents() == 0, "disabled tracing");
+}
+
 int main(){
 	test01();
 	test02();
@@ -788,6 +907,8 @@ int main(){
 	test14();
 	test16();
 	test17();
+	test18();
+	test19();
 	
 	//UNDONE:
 	//test15();
@@ -0,0 +1,106 @@
+#include "cowgrid.hpp"
+#include <map>
+
+namespace{
+
+//Token is shared between all grids which share a set of primitives
+//of certain level. Set is shared if its token use_count > 1.
+typedef std::shared_ptr<char> Token;
+//tokens of each level. Concatenated grids hold several tokens per level.
+typedef vector<vector<Token>> Tokens;
+
+std::map<const void*, Tokens> registry;
+
+template<class TGrid> struct Levels;
+template<> struct Levels<HM2D::GridData>{ static const int n = 3; };
+template<> struct Levels<HM3D::GridData>{ static const int n = 4; };
+
+Token new_token(){ return Token(new char(0)); }
+
+Tokens& tokens(const void* g, int nlev){
+	auto fnd = registry.find(g);
+	if (fnd != registry.end()) return fnd->second;
+	Tokens& ret = registry[g];
+	ret.resize(nlev);
+	for (auto& t: ret) t.push_back(new_token());
+	return ret;
+}
+
+bool is_shared(const vector<Token>& t){
+	for (auto& it: t) if (it.use_count() > 1) return true;
+	return false;
+}
+
+bool have_common(const vector<Token>& t1, const vector<Token>& t2){
+	for (auto& a: t1)
+	for (auto& b: t2) if (a == b) return true;
+	return false;
+}
+
+template<class TGrid>
+TGrid* copy(const TGrid* g){
+	Tokens t = tokens(g, Levels<TGrid>::n);
+	TGrid* ret = new TGrid(*g);
+	registry[ret] = t;
+	return ret;
+}
+
+template<class A>
+void append(vector<A>& to, const vector<A>& from){
+	to.insert(to.end(), from.begin(), from.end());
+}
+void append(HM2D::GridData& to, const HM2D::GridData& from){
+	append(to.vvert, from.vvert);
+	append(to.vedges, from.vedges);
+	append(to.vcells, from.vcells);
+}
+void append(HM3D::GridData& to, const HM3D::GridData& from){
+	append(to.vvert, from.vvert);
+	append(to.vedges, from.vedges);
+	append(to.vfaces, from.vfaces);
+	append(to.vcells, from.vcells);
+}
+
+template<class TGrid>
+TGrid* concatenate(const vector<TGrid*>& gg){
+	TGrid* ret = new TGrid();
+	Tokens t(Levels<TGrid>::n);
+	for (auto g: gg){
+		append(*ret, *g);
+		Tokens& gt = tokens(g, Levels<TGrid>::n);
+		for (int i=0; i<Levels<TGrid>::n; ++i) append(t[i], gt[i]);
+	}
+	registry[ret] = t;
+	return ret;
+}
+
+template<class TGrid>
+void detach(TGrid* g, int level){
+	auto fnd = registry.find(g);
+	if (fnd == registry.end() || !is_shared(fnd->second[level])) return;
+	TGrid tmp;
+	DeepCopy(*g, tmp, level);
+	*g = std::move(tmp);
+	for (int i=0; i<=level; ++i) fnd->second[i] = {new_token()};
+}
+
+template<class TGrid>
+void separate(const vector<TGrid*>& gg){
+	for (auto g: gg) detach(g, Levels<TGrid>::n - 1);
+}
+
+}
+
+HM2D::GridData* CowGrid::Copy(const HM2D::GridData* g){ return copy(g); }
+HM3D::GridData* CowGrid::Copy(const HM3D::GridData* g){ return copy(g); }
+
+HM2D::GridData* CowGrid::Concatenate(const vector<HM2D::GridData*>& gg){ return concatenate(gg); }
+HM3D::GridData* CowGrid::Concatenate(const vector<HM3D::GridData*>& gg){ return concatenate(gg); }
+
+void CowGrid::Detach(HM2D::GridData* g, int level){ detach(g, level); }
+void CowGrid::Detach(HM3D::GridData* g, int level){ detach(g, level); }
+
+void CowGrid::Separate(const vector<HM2D::GridData*>& gg){ separate(gg); }
+void CowGrid::Separate(const vector<HM3D::GridData*>& gg){ separate(gg); }
+
+void CowGrid::Release(const void* g){ registry.erase(g); }
@@ -0,0 +1,39 @@
+#ifndef HMCPORT_COWGRID_HPP
+#define HMCPORT_COWGRID_HPP
+
+#include "primitives2d.hpp"
+#include "primitives3d.hpp"
+
+//Copy-on-write grid handles.
+//Copy() returns a grid which shares all primitives with the source.
+//Every in place modification of grid primitives should be preceded by Detach()
+//which copies shared primitives of the given level and all primitives referencing them.
+//Levels follow HM2D::DeepCopy/HM3D::DeepCopy conventions:
+//  2D: 0 - cells, 1 - edges, 2 - vertices;
+//  3D: 0 - cells, 1 - faces, 2 - edges, 3 - vertices.
+//So boundary type assignment duplicates only edges (faces) and cells
+//leaving vertices (and edges) shared with the snapshot.
+//Grids which were not obtained by Copy() or Concatenate() are never shared.
+namespace CowGrid{
+
+HM2D::GridData* Copy(const HM2D::GridData* g);
+HM3D::GridData* Copy(const HM3D::GridData* g);
+
+//result shares primitives with all sources
+HM2D::GridData* Concatenate(const vector<HM2D::GridData*>& gg);
+HM3D::GridData* Concatenate(const vector<HM3D::GridData*>& gg);
+
+void Detach(HM2D::GridData* g, int level=2);
+void Detach(HM3D::GridData* g, int level=3);
+
+//detaches vertices of all shared grids from the list.
+//Used before algorithms which scale inputs in place: scaling round trip
+//is not bit exact so it should not touch vertices of other snapshots.
+void Separate(const vector<HM2D::GridData*>& gg);
+void Separate(const vector<HM3D::GridData*>& gg);
+
+//removes grid from sharing registry. Should be called before deletion.
+void Release(const void* g);
+
+}
+#endif
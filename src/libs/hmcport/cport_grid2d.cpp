@@ -1,6 +1,7 @@
 #include "hmcport.h"
 #include "cport_grid2d.h"
 #include "primitives2d.hpp"
+#include "flatgrid2d.hpp"
 #include "infogrid.hpp"
 #include "assemble2d.hpp"
 #include "c2cpp_helper.hpp"
@@ -20,9 +21,12 @@
 #include "unite_grids.hpp"
 #include "export2d_fluent.hpp"
 #include "export2d_tecplot.hpp"
+#include "export2d_vtk.hpp"
 #include "export2d_hm.hpp"
 #include "snap_grid2cont.hpp"
 #include "treverter2d.hpp"
+#include "tabview.hpp"
+#include "cowgrid.hpp"
 
 
 int g2_dims(void* obj, int* ret){
@@ -99,9 +103,7 @@ int g2_skewness(void* obj, double threshold, double* maxskew, int* maxskewindex,
 }
 int g2_deepcopy(void* obj, void** ret){
 	try{
-		HM2D::GridData ret_;
-		HM2D::DeepCopy(*static_cast<HM2D::GridData*>(obj), ret_);
-		c2cpp::to_pp(ret_, ret);
+		*ret = CowGrid::Copy(static_cast<HM2D::GridData*>(obj));
 		return HMSUCCESS;
 	} catch (std::exception& e){
 		add_error_message(e.what());
@@ -110,6 +112,7 @@ int g2_deepcopy(void* obj, void** ret){
 }
 int g2_free(void* obj){
 	try{
+		CowGrid::Release(obj);
 		delete static_cast<HM2D::GridData*>(obj);
 		return HMSUCCESS;
 	} catch (std::exception& e){
@@ -120,13 +123,7 @@ int g2_free(void* obj){
 int g2_concatenate(int nobjs, void** objs, void** ret){
 	try{
 		auto gg = c2cpp::to_pvec<HM2D::GridData>(nobjs, objs);
-		HM2D::GridData ret_;
-		for (auto g: gg){
-			ret_.vvert.insert(ret_.vvert.end(), g->vvert.begin(), g->vvert.end());
-			ret_.vedges.insert(ret_.vedges.end(), g->vedges.begin(), g->vedges.end());
-			ret_.vcells.insert(ret_.vcells.end(), g->vcells.begin(), g->vcells.end());
-		}
-		c2cpp::to_pp(ret_, ret);
+		*ret = CowGrid::Concatenate(gg);
 		return HMSUCCESS;
 	} catch (std::exception& e){
 		add_error_message(e.what());
@@ -135,6 +132,7 @@ int g2_concatenate(int nobjs, void** objs, void** ret){
 }
 int g2_move(void* obj, double* dx){
 	try{
+		CowGrid::Detach(static_cast<HM2D::GridData*>(obj));
 		for (auto& v: static_cast<HM2D::GridData*>(obj)->vvert){
 			v->x += dx[0];
 			v->y += dx[1];
@@ -148,6 +146,7 @@ int g2_move(void* obj, double* dx){
 int g2_scale(void* obj, double* pc, double* p0){
 	try{
 		auto g = static_cast<HM2D::GridData*>(obj);
+		CowGrid::Detach(g);
 		double xc = pc[0] / 100., yc = pc[1] / 100.;
 		for (auto& p: g->vvert){
 			p->x -= p0[0]; p->x *= xc;
@@ -162,6 +161,7 @@ int g2_scale(void* obj, double* pc, double* p0){
 int g2_reflect(void* obj, double* v0, double* v1){
 	try{
 		auto g = static_cast<HM2D::GridData*>(obj);
+		CowGrid::Detach(g);
 		double lx = v1[0] - v0[0], ly = v1[1] - v0[1];
 		double r2 = sqrt(lx*lx + ly*ly);
 		lx /= r2; ly /= r2;
@@ -188,6 +188,7 @@ int g2_reflect(void* obj, double* v0, double* v1){
 int g2_rotate(void* obj, double* p0, double a){
 	try{
 		auto g = static_cast<HM2D::GridData*>(obj);
+		CowGrid::Detach(g);
 		double cs = cos(a / 180. * M_PI), sn = sin(a / 180. * M_PI);
 		for (auto& p: g->vvert){
 			double a = p->x - p0[0];
@@ -460,6 +461,8 @@ int g2_extract_contour(void* obj, void** ret){
 int g2_assign_boundary_types(void* obj, int* bnd, int** revdif){
 	try{
 		auto grid = static_cast<HM2D::GridData*>(obj);
+		//vertices are left shared with snapshots
+		CowGrid::Detach(grid, 1);
 		auto whole_assign = [&grid](int bt, std::map<int, int>& mp){
 			for (int k=0; k<grid->vedges.size(); ++k){
 				if (grid->vedges[k]->is_boundary()){
@@ -691,6 +694,7 @@ int g2_map_grid(void* base_obj, void* target_obj,
 	try{
 		HM2D::GridData* g = static_cast<HM2D::GridData*>(base_obj);
 		HM2D::EdgeData* cont = static_cast<HM2D::EdgeData*>(target_obj);
+		CowGrid::Detach(g);
 		//scaling
 		Autoscale::D2 gscale(g);
 		Autoscale::D2 cscale(cont);
@@ -763,6 +767,16 @@ int g2_point_at(void* obj, int index, double* ret){
 	}
 }
 
+int g2_tab_view(void* obj, const char* what, void** ret){
+	try{
+		auto g = static_cast<HM2D::GridData*>(obj);
+		*ret = new TabView(*g, TabView::split_names(what));
+		return HMSUCCESS;
+	} catch (std::exception& e){
+		add_error_message(e.what());
+		return HMERROR;
+	}
+}
 int g2_tab_btypes(void* obj, int* ret){
 	try{
 		auto g = static_cast<HM2D::GridData*>(obj);
@@ -814,16 +828,7 @@ int g2_tab_cellsizes(void* obj, int* ret){
 int g2_tab_cellvert(void* obj, int* nret, int** ret){
 	try{
 		auto g = static_cast<HM2D::GridData*>(obj);
-		vector<int> ret_;
-		aa::enumerate_ids_pvec(g->vvert);
-		for (auto& c: g->vcells){
-			for(auto& p: HM2D::Contour::OrderedPoints1(c->edges)){
-				ret_.push_back(p->id);
-			}
-		}
-		*nret = ret_.size();
-		*ret = new int[*nret];
-		std::copy(ret_.begin(), ret_.end(), *ret);
+		TabView(*g, {"cell_vert"}).get("cell_vert").copy_new(nret, ret);
 		return HMSUCCESS;
 	} catch (std::exception& e){
 		add_error_message(e.what());
@@ -852,15 +857,7 @@ int g2_tab_celledge(void* obj, int* nret, int** ret){
 int g2_tab_centers(void* obj, double* ret){
 	try{
 		auto g = static_cast<HM2D::GridData*>(obj);
-		for (auto& c: g->vcells){
-			Point p(0, 0);
-			for (auto& v: HM2D::AllVertices(c->edges)){
-				p+=*v;
-			}
-			p/=c->edges.size();
-			*ret++ = p.x;
-			*ret++ = p.y;
-		}
+		TabView(*g, {"cell_center"}).get("cell_center").copy(ret);
 		return HMSUCCESS;
 	} catch (std::exception& e){
 		add_error_message(e.what());
@@ -919,6 +916,7 @@ int g2_simplify_bnd(void* obj, double angle, void** ret){
 	try{
 		if (angle<-geps || angle>180+geps) throw std::runtime_error("invalid angle");
 		HM2D::GridData* g = static_cast<HM2D::GridData*>(obj);
+		CowGrid::Detach(g);
 		Autoscale::D2 sc(g);
 		HM2D::GridData ret_;
 		HM2D::DeepCopy(*g, ret_);
@@ -935,6 +933,7 @@ int g2_convex_cells(void* obj, double angle, void** ret){
 	try{
 		if (angle<-geps || angle>360+geps) throw std::runtime_error("invalid angle");
 		HM2D::GridData* g = static_cast<HM2D::GridData*>(obj);
+		CowGrid::Detach(g);
 		Autoscale::D2 sc(g);
 		HM2D::GridData ret_;
 		HM2D::DeepCopy(*g, ret_);
@@ -951,6 +950,7 @@ int g2_exclude_cont(void* obj, void* cont, int isinner, void** ret, hmcport_call
 	try{
 		HM2D::GridData* g0 = static_cast<HM2D::GridData*>(obj);
 		HM2D::EdgeData* e0 = static_cast<HM2D::EdgeData*>(cont);
+		CowGrid::Detach(g0);
 
 		//scaling
 		//using non-unity scaling to minimize risk of almost doubling points
@@ -978,6 +978,7 @@ int g2_unite_grids(void* obj1, void* obj2, double buf, int fixbnd,
 	try{
 		HM2D::GridData* g0 = static_cast<HM2D::GridData*>(obj1);
 		HM2D::GridData* g1 = static_cast<HM2D::GridData*>(obj2);
+		CowGrid::Separate(vector<HM2D::GridData*>{g0, g1});
 		//using non-unity scaling to minimize risk of almost doubling points
 		//when using uniform rectangles
 		double unity = 1.0 + sqrt(2.0)/100.0 + sqrt(3.0)/1000.0;
@@ -1016,7 +1017,8 @@ HM2D::Export::BNamesFun construct_bnames(const BoundaryNamesStruct& bnames){
 }
 }
 
-int g2_to_msh(void* obj, const char* fname, BoundaryNamesStruct btypes, int n_per_data, int* per_data){
+int g2_to_msh(void* obj, const char* fname, BoundaryNamesStruct btypes, int n_per_data, int* per_data,
+		int binary){
 	try{
 		auto g = static_cast<HM2D::GridData*>(obj);
 		auto fnames = construct_bnames(btypes);
@@ -1027,7 +1029,7 @@ int g2_to_msh(void* obj, const char* fname, BoundaryNamesStruct btypes, int n_pe
 			bool is_rev = (bool)(*per_data++);
 			pd.add_data(b1, b2, is_rev);
 		}
-		HM2D::Export::GridMSH(*g, fname, fnames, pd);
+		HM2D::Export::GridMSH(*g, fname, fnames, pd, binary != 0);
 		return HMSUCCESS;
 	} catch (std::exception& e){
 		add_error_message(e.what());
@@ -1045,6 +1047,18 @@ int g2_to_tecplot(void* obj, const char* fname, BoundaryNamesStruct btypes){
 		return HMERROR;
 	}
 }
+int g2_to_vtu(void* obj, const char* fname, int compress, int npieces){
+	try{
+		HMVtu::Options opt;
+		opt.compress = (compress != 0);
+		opt.npieces = npieces;
+		HM2D::Export::GridVTU(*static_cast<HM2D::GridData*>(obj), fname, opt);
+		return HMSUCCESS;
+	} catch (std::exception& e){
+		add_error_message(e.what());
+		return HMERROR;
+	}
+}
 int g2_to_hm(void* doc, void* node, void* obj, const char* name, const char* fmt, int naf, const char** af){
 	try{
 		HMXML::ReaderA* wr = static_cast<HMXML::ReaderA*>(doc);
@@ -1103,7 +1117,7 @@ int g2_boundary_layer(int nopt, BoundaryLayerGridOption* opt, void** ret, hmcpor
 				inp.bnd_step_basis.push_back(std::make_pair(Point(inp.end), opt_.step_end));
 			}
 		}
-		*ret = new HM2D::GridData(HMBlay::BuildBLayerGrid(vinp));
+		*ret = new HM2D::GridData(HMBlay::BuildBLayerGrid(vinp, cb));
 		return HMSUCCESS;
 	} catch (std::exception& e){
 		add_error_message(e.what());
@@ -1116,6 +1130,7 @@ int g2_snap_to_contour(void* grid, void* contour, double* gp1, double* gp2,
 	try{
 		HM2D::GridData* g2 = static_cast<HM2D::GridData*>(grid);
 		HM2D::EdgeData* c2 = static_cast<HM2D::EdgeData*>(contour);
+		CowGrid::Detach(g2);
 		Point p1(gp1[0], gp1[1]); Point p2(gp2[0], gp2[1]);
 		Point p3(cp1[0], cp1[1]); Point p4(cp2[0], cp2[1]);
 		//scale
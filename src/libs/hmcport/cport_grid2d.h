@@ -11,8 +11,11 @@ int g2_bnd_dims(void* obj, int* ret);
 int g2_bnd_length(void* obj, double** ret);
 int g2_skewness(void* obj, double threshold, double* maxskew, int* maxskewindex,
 		int* badnum, int** badindex, double** badvals);
+//copy-on-write snapshot: returned grid shares primitives with obj
+//until one of them is modified. Snapshots are released by g2_free.
 int g2_deepcopy(void* obj, void** ret);
 int g2_free(void* obj);
+//result shares primitives with objs in the same copy-on-write manner
 int g2_concatenate(int nobjs, void** objs, void** ret);
 int g2_move(void* obj, double* dx);
 int g2_scale(void* obj, double* pc, double* p0);
@@ -88,6 +91,9 @@ int g2_simplify_bnd(void* obj, double angle, void** ret);
 
 
 //tabs
+//builds tables listed in space separated what string in a single pass.
+//Returned object should be freed by free_tab_view.
+int g2_tab_view(void* obj, const char* what, void** ret);
 int g2_tab_btypes(void* obj, int* ret);
 int g2_tab_vertices(void* obj, double* ret);
 int g2_tab_edgevert(void* obj, int* ret);
@@ -106,8 +112,13 @@ int g2_exclude_cont(void* obj, void* cont, int isinner, void** ret, hmcport_call
 int g2_unite_grids(void* obj1, void* obj2, double buf, int fixbnd,
 		int emptyholes, double angle0, const char* filler,
 		void** ret, hmcport_callback cb);
-int g2_to_msh(void* obj, const char* fname, BoundaryNamesStruct btypes, int n_per_data, int* per_data);
+//binary=1 for Fluent binary sections
+int g2_to_msh(void* obj, const char* fname, BoundaryNamesStruct btypes, int n_per_data, int* per_data,
+		int binary);
 int g2_to_tecplot(void* obj, const char* fname, BoundaryNamesStruct btypes);
+//binary vtk xml output. compress=1 for zlib compression (if available),
+//npieces > 1 for *.pvtu collection of npieces *.vtu files
+int g2_to_vtu(void* obj, const char* fname, int compress, int npieces);
 int g2_to_hm(void* doc, void* node, void* obj, const char* name, const char* fmt, int naf, const char** af);
 
 // Build a boundary layer grid around a contour tree
@@ -16,10 +16,13 @@
 #include "export3d_gmsh.hpp"
 #include "export3d_tecplot.hpp"
 #include "export3d_hm.hpp"
+#include "tabview.hpp"
+#include "cowgrid.hpp"
 
 
 int g3_move(void* obj, double* dx){
 	try{
+		CowGrid::Detach(static_cast<HM3D::GridData*>(obj));
 		for (auto& v: static_cast<HM3D::GridData*>(obj)->vvert){
 			v->x += dx[0];
 			v->y += dx[1];
@@ -34,6 +37,7 @@ int g3_move(void* obj, double* dx){
 int g3_scale(void* obj, double* pc, double* p0){
 	try{
 		auto g = static_cast<HM3D::GridData*>(obj);
+		CowGrid::Detach(g);
 		double xc = pc[0] / 100., yc = pc[1] / 100., zc = pc[2] / 100.;
 		for (auto& p: g->vvert){
 			p->x -= p0[0]; p->x *= xc;
@@ -46,6 +50,17 @@ int g3_scale(void* obj, double* pc, double* p0){
 		return HMERROR;
 	}
 }
+int g3_tab_view(void* obj, const char* what, void** ret){
+	try{
+		auto g = static_cast<HM3D::GridData*>(obj);
+		*ret = new TabView(*g, TabView::split_names(what));
+		return HMSUCCESS;
+	} catch (std::exception& e){
+		add_error_message(e.what());
+		return HMERROR;
+	}
+}
+
 int g3_tab_btypes(void* obj, int* ret){
 	try{
 		auto g = static_cast<HM3D::GridData*>(obj);
@@ -56,7 +71,6 @@ int g3_tab_btypes(void* obj, int* ret){
 		return HMERROR;
 	}
 }
-
 int g3_tab_vertices(void* obj, double* ret){
 	try{
 		auto g = static_cast<HM3D::GridData*>(obj);
@@ -192,29 +206,7 @@ int g3_tab_cellface(void* obj, int* nret, int** ret2){
 int g3_tab_cellvert(void* obj, int* nret, int** ret2){
 	try{
 		auto g = static_cast<HM3D::GridData*>(obj);
-		std::vector<int> r;
-		aa::enumerate_ids_pvec(g->vvert);
-		HM3D::Export::vtkcell_expression exp;
-		for (auto& c: g->vcells){
-			std::vector<std::vector<int>> vv(c->faces.size());
-			for (int i=0; i<vv.size(); ++i)
-			for (auto& v: c->faces[i]->sorted_vertices()){
-				vv[i].push_back(v->id);
-			}
-			if (exp.try_tetrahedron(vv) ||
-			    exp.try_hexahedron(vv) ||
-			    exp.try_pyramid(vv) ||
-			    exp.try_wedge(vv)){
-				r.insert(r.end(), exp.pts.begin(), exp.pts.end());
-			} else {
-				for (auto& v: AllVertices(c->faces)){
-					r.push_back(v->id);
-				}
-			}
-		}
-		*nret = r.size();
-		*ret2 = new int[*nret];
-		std::copy(r.begin(), r.end(), *ret2);
+		TabView(*g, {"cell_vert"}).get("cell_vert").copy_new(nret, ret2);
 		return HMSUCCESS;
 	} catch (std::exception& e){
 		add_error_message(e.what());
@@ -278,9 +270,7 @@ int g3_point_at(void* obj, int index, double* ret){
 
 int g3_deepcopy(void* obj, void** ret){
 	try{
-		HM3D::GridData ret_;
-		HM3D::DeepCopy(*static_cast<HM3D::GridData*>(obj), ret_);
-		c2cpp::to_pp(ret_, ret);
+		*ret = CowGrid::Copy(static_cast<HM3D::GridData*>(obj));
 		return HMSUCCESS;
 	} catch (std::exception& e){
 		add_error_message(e.what());
@@ -290,14 +280,7 @@ int g3_deepcopy(void* obj, void** ret){
 int g3_concatenate(int nobjs, void** objs, void** ret){
 	try{
 		auto gg = c2cpp::to_pvec<HM3D::GridData>(nobjs, objs);
-		HM3D::GridData ret_;
-		for (auto g: gg){
-			ret_.vvert.insert(ret_.vvert.end(), g->vvert.begin(), g->vvert.end());
-			ret_.vedges.insert(ret_.vedges.end(), g->vedges.begin(), g->vedges.end());
-			ret_.vfaces.insert(ret_.vfaces.end(), g->vfaces.begin(), g->vfaces.end());
-			ret_.vcells.insert(ret_.vcells.end(), g->vcells.begin(), g->vcells.end());
-		}
-		c2cpp::to_pp(ret_, ret);
+		*ret = CowGrid::Concatenate(gg);
 		return HMSUCCESS;
 	} catch (std::exception& e){
 		add_error_message(e.what());
@@ -308,6 +291,7 @@ int g3_concatenate(int nobjs, void** objs, void** ret){
 //====== destructor
 int g3_free(void* obj){
 	try{
+		CowGrid::Release(obj);
 		delete static_cast<HM3D::GridData*>(obj);
 		return HMSUCCESS;
 	} catch (std::exception& e){
@@ -387,6 +371,7 @@ int g3_merge(void* obj1, void* obj2, void** ret, hmcport_callback cb){
 	try{
 		auto g1 = static_cast<HM3D::GridData*>(obj1);
 		auto g2 = static_cast<HM3D::GridData*>(obj2);
+		CowGrid::Separate(vector<HM3D::GridData*>{g1, g2});
 		Autoscale::D3 sc(vector<HM3D::GridData*>{g1, g2});
 		HM3D::GridData ret_ = HM3D::Grid::Algos::MergeGrids(*g1, *g2);
 		sc.unscale(&ret_);
@@ -433,6 +418,7 @@ int g3_revolve(void* obj, double* vec, int n_phi, double* phi,
 	try{
 		HM2D::GridData* g2 = static_cast<HM2D::GridData*>(obj);
 		Point pstart(vec[0], vec[1]), pend(vec[2], vec[3]);
+		CowGrid::Detach(g2);
 		Autoscale::D2 sc(g2);
 		sc.scale(pstart);
 		sc.scale(pend);
@@ -455,6 +441,7 @@ int g3_revolve(void* obj, double* vec, int n_phi, double* phi,
 int g3_tetrahedral_fill(int nsurf, void** surf,
 		int nconstr, void** constr,
 		int npts, double* pcoords, double* psizes,
+		const char* algo,
 		void** ret, hmcport_callback cb){
 	try{
 		//TODO constraints are not supported yet
@@ -464,9 +451,17 @@ int g3_tetrahedral_fill(int nsurf, void** surf,
 		//collect all input source surfaces
 		HM3D::FaceData source;
 		for (auto& s: surf_) source.insert(source.end(), s->begin(), s->end());
+		//internal points
+		HM3D::VertexData pinner(npts);
+		vector<double> sizes(psizes, psizes+npts);
+		for (int i=0; i<npts; ++i){
+			pinner[i].reset(new HM3D::Vertex(pcoords[3*i], pcoords[3*i+1], pcoords[3*i+2]));
+		}
+		sc.scale(pinner);
+		sc.scale(sizes);
 		//procedure
 		HM3D::GridData ret_ = HM3D::Mesher::UnstructuredTetrahedral.WithCallback(
-				cb, source);
+				cb, source, pinner, sizes, std::string(algo));
 		sc.unscale(&ret_);
 		c2cpp::to_pp(ret_, ret);
 		return HMSUCCESS;
@@ -489,6 +484,20 @@ int g3_to_vtk(void* obj, const char* fname, hmcport_callback f2){
 		return HMERROR;
 	}
 }
+int g3_to_vtu(void* obj, const char* fname, int compress, int npieces, hmcport_callback f2){
+	try{
+		HMVtu::Options opt;
+		opt.compress = (compress != 0);
+		opt.npieces = npieces;
+		HM3D::Export::GridVTU.WithCallback(f2,
+			*static_cast<HM3D::GridData*>(obj),
+			fname, opt);
+		return HMSUCCESS;
+	} catch (std::exception& e){
+		add_error_message(e.what());
+		return HMERROR;
+	}
+}
 int g3_surface_to_vtk(void* obj, const char* fname, hmcport_callback f2){
 	try{
 		HM3D::Export::BoundaryVTK.WithCallback(f2,
@@ -517,7 +526,7 @@ HM3D::Export::BFun construct_bnames(const BoundaryNamesStruct& bnames){
 }
 
 int g3_to_msh(void* obj, const char* fname, BoundaryNamesStruct bnames,
-		int n_periodic, double* data_periodic, hmcport_callback f2){
+		int n_periodic, double* data_periodic, int binary, hmcport_callback f2){
 	try{
 		// name function
 		auto nmfunc = construct_bnames(bnames);
@@ -536,7 +545,9 @@ int g3_to_msh(void* obj, const char* fname, BoundaryNamesStruct bnames,
 		}
 		//call function
 		auto g = static_cast<HM3D::GridData*>(obj);
-		if (pd.size() == 0){
+		if (binary){
+			HM3D::Export::GridMSH.WithCallback(f2, *g, fname, nmfunc, pd, true);
+		} else if (pd.size() == 0){
 			HM3D::Export::GridMSH.WithCallback(f2, *g, fname, nmfunc);
 		} else {
 			HM3D::Export::GridMSH.WithCallback(f2, *g, fname, nmfunc, pd);
@@ -620,6 +631,8 @@ int g3_to_hm(void* doc, void* node, void* obj, const char* name, const char* fmt
 int g3_assign_boundary_types(void* obj, int* bnd, int** revdif){
 	try{
 		auto grid = static_cast<HM3D::GridData*>(obj);
+		//vertices and edges are left shared with snapshots
+		CowGrid::Detach(grid, 1);
 		auto whole_assign = [&grid](int bt, std::map<int, int>& mp){
 			for (int k=0; k<grid->vfaces.size(); ++k){
 				if (grid->vfaces[k]->is_boundary()){
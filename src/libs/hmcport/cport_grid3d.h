@@ -9,7 +9,10 @@ int g3_move(void* obj, double* dx);
 int g3_scale(void* obj, double* pc, double* p0);
 int g3_point_at(void* obj, int index, double* ret);
 
+//copy-on-write snapshot: returned grid shares primitives with obj
+//until one of them is modified. Snapshots are released by g3_free.
 int g3_deepcopy(void* obj, void** ret);
+//result shares primitives with objs in the same copy-on-write manner
 int g3_concatenate(int nobjs, void** objs, void** ret);
 
 //====== destructor
@@ -22,6 +25,10 @@ int g3_dims(void* obj, int*);
 //n_vert, n_edges, n_faces
 int g3_bnd_dims(void* obj, int* dims);
 
+//builds tables listed in space separated what string in a single pass.
+//Returned object should be freed by free_tab_view.
+int g3_tab_view(void* obj, const char* what, void** ret);
+
 //fills ret array with 'number of faces' values
 int g3_tab_btypes(void* obj, int* ret);
 
@@ -70,18 +77,25 @@ int g3_revolve(void* obj, double* vec, int n_phi, double* phi,
 
 
 //======= unstructured fill
+//algo = 'gmsh', 'tetgen'
+//pcoords[3*npts], psizes[npts] - internal points with mesh sizes (used by 'tetgen')
 //0 on fail
 int g3_tetrahedral_fill(int nsurf, void** surf,
 		int nconstr, void** constr,
 		int npts, double* pcoords, double* psizes,
+		const char* algo,
 		void** ret, hmcport_callback cb);
 
 
 //====== exporters
 int g3_to_vtk(void* obj, const char* fname, hmcport_callback f2);
+//binary vtk xml output. compress=1 for zlib compression (if available),
+//npieces > 1 for *.pvtu collection of npieces *.vtu files
+int g3_to_vtu(void* obj, const char* fname, int compress, int npieces, hmcport_callback f2);
 int g3_surface_to_vtk(void* obj, const char* fname, hmcport_callback f2);
+//binary=1 for Fluent binary sections
 int g3_to_msh(void* obj, const char* fname, BoundaryNamesStruct bnames,
-		int n_periodic, double* data_periodic, hmcport_callback f2);
+		int n_periodic, double* data_periodic, int binary, hmcport_callback f2);
 int g3_to_gmsh(void* obj, const char* fname, BoundaryNamesStruct bnames,
 		hmcport_callback f2);
 int g3_to_tecplot(void* obj, const char* fname, BoundaryNamesStruct bnames,
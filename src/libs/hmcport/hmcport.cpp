@@ -2,6 +2,9 @@
 #include "hmtesting.hpp"
 #include <iostream>
 #include "c2cpp_helper.hpp"
+#include "hmparallel.hpp"
+#include "hmtrace.hpp"
+#include "tabview.hpp"
 
 int free_int_array(int* a){
 	try{
@@ -40,6 +43,65 @@ int free_voidp_array(void** a){
 	}
 }
 
+int tab_view_get(void* view, const char* what, int* n, void** ret){
+	try{
+		auto& tab = static_cast<TabView*>(view)->get(what);
+		*n = tab.size();
+		*ret = const_cast<void*>(tab.data());
+		return HMSUCCESS;
+	} catch (std::exception& e){
+		add_error_message(e.what());
+		return HMERROR;
+	}
+}
+int free_tab_view(void* view){
+	try{
+		delete static_cast<TabView*>(view);
+		return HMSUCCESS;
+	} catch (std::exception& e){
+		add_error_message(e.what());
+		return HMERROR;
+	}
+}
+
+int set_num_threads(int n){
+	try{
+		HMParallel::SetNumThreads(n);
+		return HMSUCCESS;
+	} catch (std::exception& e){
+		add_error_message(e.what());
+		return HMERROR;
+	}
+}
+int get_num_threads(int* n){
+	try{
+		*n = HMParallel::NumThreads();
+		return HMSUCCESS;
+	} catch (std::exception& e){
+		add_error_message(e.what());
+		return HMERROR;
+	}
+}
+int trace_enable(int on){
+	try{
+		HMTrace::Enable(on != 0);
+		return HMSUCCESS;
+	} catch (std::exception& e){
+		add_error_message(e.what());
+		return HMERROR;
+	}
+}
+int trace_export(const char* fname){
+	try{
+		HMTrace::ExportChrome(fname);
+		HMTrace::Clear();
+		return HMSUCCESS;
+	} catch (std::exception& e){
+		add_error_message(e.what());
+		return HMERROR;
+	}
+}
+
 namespace{
 vector<std::string> errors;
 }
@@ -28,6 +28,24 @@ int free_double_array(double* a);
 int free_char_array(char* a);
 int free_voidp_array(void** a);
 
+//access to tables built by g2_tab_view, g3_tab_view.
+//ret is the address of the first table entry (int or double depending on the table),
+//n is the number of entries. Data stays valid until free_tab_view call.
+int tab_view_get(void* view, const char* what, int* n, void** ret);
+int free_tab_view(void* view);
+
+//number of threads used by parallel algorithms.
+//n <= 0 sets number of hardware threads.
+int set_num_threads(int n);
+int get_num_threads(int* n);
+
+//procedures tracing. When enabled all procedures and their subprocesses
+//are recorded with wall time, thread, allocations and peak memory.
+int trace_enable(int on);
+//writes recorded events to fname in chrome trace json format
+//and clears the record.
+int trace_export(const char* fname);
+
 //returns last error message passed using add_error_message
 //by any of hmcport functions.
 int get_last_error_message(char** msg);
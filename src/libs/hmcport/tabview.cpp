@@ -0,0 +1,238 @@
+#include "tabview.hpp"
+#include "flatgrid2d.hpp"
+#include "flatgrid3d.hpp"
+#include "assemble2d.hpp"
+#include "export3d_vtk.hpp"
+#include "hmparallel.hpp"
+#include <set>
+
+namespace{
+
+const std::set<std::string> names2d {"vert", "edge_vert", "edge_cell",
+	"cell_dim", "cell_vert", "cell_edge", "cell_center", "bnd", "bt", "bnd_bt"};
+const std::set<std::string> names3d {"vert", "edge_vert", "face_dim", "face_edge",
+	"face_vert", "face_cell", "cell_fdim", "cell_vdim", "cell_face", "cell_vert",
+	"bt", "bnd", "bnd_bt"};
+
+std::set<std::string> check_names(const vector<std::string>& what,
+		const std::set<std::string>& known, std::string dim){
+	std::set<std::string> ret;
+	for (auto& w: what){
+		if (known.count(w) == 0)
+			throw std::runtime_error("unknown " + dim + " grid table: " + w);
+		ret.insert(w);
+	}
+	return ret;
+}
+
+//sizes of CSR table entries
+vector<int> csr_sizes(const vector<int>& start){
+	int n = start.size() > 0 ? start.size() - 1 : 0;
+	vector<int> ret(n);
+	HMParallel::ForChunks(n, [&](int ib, int ie, int){
+		for (int i=ib; i<ie; ++i) ret[i] = start[i+1] - start[i];
+	});
+	return ret;
+}
+
+//concatenates per entity lists
+vector<int> concat(const vector<vector<int>>& v){
+	vector<int> start(v.size()+1, 0);
+	for (size_t i=0; i<v.size(); ++i) start[i+1] = start[i] + v[i].size();
+	vector<int> ret(start.back());
+	HMParallel::ForChunks(v.size(), [&](int ib, int ie, int){
+		for (int i=ib; i<ie; ++i){
+			std::copy(v[i].begin(), v[i].end(), ret.begin() + start[i]);
+		}
+	});
+	return ret;
+}
+
+//unique vertices of 3d cell in order of their appearance in faces->edges->vertices
+void cell_unique_vertices(const HM3D::FlatGrid& fg, int icell, vector<int>& ret){
+	ret.clear();
+	for (const int* f=fg.cell_faces_begin(icell); f!=fg.cell_faces_end(icell); ++f)
+	for (const int* e=fg.face_edges_begin(*f); e!=fg.face_edges_end(*f); ++e)
+	for (int k=0; k<2; ++k){
+		int v = fg.edge_vert[2*(*e)+k];
+		if (std::find(ret.begin(), ret.end(), v) == ret.end()) ret.push_back(v);
+	}
+}
+
+}
+
+void TabView::Tab::copy(int* ret) const{
+	std::copy(idata.begin(), idata.end(), ret);
+}
+void TabView::Tab::copy(double* ret) const{
+	std::copy(ddata.begin(), ddata.end(), ret);
+}
+void TabView::Tab::copy_new(int* nret, int** ret) const{
+	*nret = idata.size();
+	*ret = new int[*nret];
+	copy(*ret);
+}
+
+const TabView::Tab& TabView::get(std::string what) const{
+	auto fnd = tabs.find(what);
+	if (fnd == tabs.end()) throw std::runtime_error("table " + what + " was not built");
+	return fnd->second;
+}
+
+vector<std::string> TabView::split_names(const char* what){
+	vector<std::string> ret;
+	std::string cur;
+	for (const char* c=what; ; ++c){
+		if (*c == ' ' || *c == ',' || *c == 0){
+			if (cur.size() > 0) ret.push_back(cur);
+			cur.clear();
+			if (*c == 0) break;
+		} else cur.push_back(*c);
+	}
+	return ret;
+}
+
+TabView::TabView(const HM2D::GridData& g, const vector<std::string>& what){
+	auto w = check_names(what, names2d, "2d");
+	auto has = [&w](const char* s){ return w.count(s) > 0; };
+
+	//boundary edges in contour order
+	HM2D::EdgeData bnd;
+	if (has("bnd") || has("bnd_bt")) bnd = HM2D::ECol::Assembler::GridBoundary(g);
+	//all other tables are derived from flat grid. Edges ids are also set here.
+	HM2D::FlatGrid fg = HM2D::Flatten(g);
+
+	if (has("bnd")){
+		auto& r = tabs["bnd"].idata;
+		r.resize(bnd.size());
+		for (size_t i=0; i<bnd.size(); ++i) r[i] = bnd[i]->id;
+	}
+	if (has("bnd_bt")){
+		auto& r = tabs["bnd_bt"].idata;
+		r.resize(2*bnd.size());
+		for (size_t i=0; i<bnd.size(); ++i){
+			r[2*i] = bnd[i]->id;
+			r[2*i+1] = bnd[i]->boundary_type;
+		}
+	}
+	if (has("cell_dim")) tabs["cell_dim"].idata = csr_sizes(fg.cell_edge_start);
+
+	//number of cell vertices equals number of cell edges
+	vector<int> cell_vert;
+	if (has("cell_vert") || has("cell_center")){
+		cell_vert.resize(fg.cell_edge.size());
+		HMParallel::ForChunks(fg.n_cells(), [&](int ib, int ie, int){
+			vector<int> cv;
+			for (int i=ib; i<ie; ++i){
+				cv.clear();
+				fg.cell_vert(i, cv);
+				std::copy(cv.begin(), cv.end(), cell_vert.begin() + fg.cell_edge_start[i]);
+			}
+		});
+	}
+	if (has("cell_center")){
+		auto& r = tabs["cell_center"].ddata;
+		r.resize(2*fg.n_cells());
+		HMParallel::ForChunks(fg.n_cells(), [&](int ib, int ie, int){
+			for (int i=ib; i<ie; ++i){
+				double x=0, y=0;
+				for (int k=fg.cell_edge_start[i]; k<fg.cell_edge_start[i+1]; ++k){
+					x += fg.vert[2*cell_vert[k]];
+					y += fg.vert[2*cell_vert[k]+1];
+				}
+				r[2*i] = x/fg.cell_size(i);
+				r[2*i+1] = y/fg.cell_size(i);
+			}
+		});
+	}
+
+	//flat grid tables are moved
+	if (has("cell_vert")) tabs["cell_vert"].idata = std::move(cell_vert);
+	if (has("vert")) tabs["vert"].ddata = std::move(fg.vert);
+	if (has("edge_vert")) tabs["edge_vert"].idata = std::move(fg.edge_vert);
+	if (has("edge_cell")) tabs["edge_cell"].idata = std::move(fg.edge_cell);
+	if (has("bt")) tabs["bt"].idata = std::move(fg.btypes);
+	if (has("cell_edge")) tabs["cell_edge"].idata = std::move(fg.cell_edge);
+}
+
+TabView::TabView(const HM3D::GridData& g, const vector<std::string>& what){
+	auto w = check_names(what, names3d, "3d");
+	auto has = [&w](const char* s){ return w.count(s) > 0; };
+
+	HM3D::FlatGrid fg = HM3D::Flatten(g);
+
+	if (has("face_dim")) tabs["face_dim"].idata = csr_sizes(fg.face_edge_start);
+	if (has("cell_fdim")) tabs["cell_fdim"].idata = csr_sizes(fg.cell_face_start);
+	if (has("bnd") || has("bnd_bt")){
+		vector<int> bnd = HM3D::Flat::BoundaryFaces(fg);
+		if (has("bnd_bt")){
+			auto& r = tabs["bnd_bt"].idata;
+			r.resize(2*bnd.size());
+			for (size_t i=0; i<bnd.size(); ++i){
+				r[2*i] = bnd[i];
+				r[2*i+1] = fg.btypes[bnd[i]];
+			}
+		}
+		if (has("bnd")) tabs["bnd"].idata = std::move(bnd);
+	}
+
+	//number of face vertices equals number of face edges
+	vector<int> face_vert;
+	if (has("face_vert") || has("cell_vert")){
+		face_vert.resize(fg.face_edge.size());
+		HMParallel::ForChunks(fg.n_faces(), [&](int ib, int ie, int){
+			vector<int> fv;
+			for (int i=ib; i<ie; ++i){
+				fv.clear();
+				fg.face_vert(i, fv);
+				std::copy(fv.begin(), fv.end(), face_vert.begin() + fg.face_edge_start[i]);
+			}
+		});
+	}
+	if (has("cell_vdim")){
+		auto& r = tabs["cell_vdim"].idata;
+		r.resize(fg.n_cells());
+		HMParallel::ForChunks(fg.n_cells(), [&](int ib, int ie, int){
+			vector<int> cv;
+			for (int i=ib; i<ie; ++i){
+				cell_unique_vertices(fg, i, cv);
+				r[i] = cv.size();
+			}
+		});
+	}
+	if (has("cell_vert")){
+		//vtk ordered vertices for known cell types,
+		//unique vertices in order of appearance otherwise.
+		vector<vector<int>> cv(fg.n_cells());
+		HMParallel::ForChunks(fg.n_cells(), [&](int ib, int ie, int){
+			HM3D::Export::vtkcell_expression exp;
+			vector<vector<int>> vv;
+			for (int i=ib; i<ie; ++i){
+				vv.resize(fg.cell_size(i));
+				for (int j=0; j<fg.cell_size(i); ++j){
+					int f = fg.cell_faces_begin(i)[j];
+					vv[j].assign(face_vert.begin() + fg.face_edge_start[f],
+					             face_vert.begin() + fg.face_edge_start[f+1]);
+				}
+				if (exp.try_tetrahedron(vv) ||
+				    exp.try_hexahedron(vv) ||
+				    exp.try_pyramid(vv) ||
+				    exp.try_wedge(vv)){
+					cv[i] = exp.pts;
+				} else {
+					cell_unique_vertices(fg, i, cv[i]);
+				}
+			}
+		});
+		tabs["cell_vert"].idata = concat(cv);
+	}
+
+	//flat grid tables are moved
+	if (has("face_vert")) tabs["face_vert"].idata = std::move(face_vert);
+	if (has("vert")) tabs["vert"].ddata = std::move(fg.vert);
+	if (has("edge_vert")) tabs["edge_vert"].idata = std::move(fg.edge_vert);
+	if (has("face_edge")) tabs["face_edge"].idata = std::move(fg.face_edge);
+	if (has("face_cell")) tabs["face_cell"].idata = std::move(fg.face_cell);
+	if (has("cell_face")) tabs["cell_face"].idata = std::move(fg.cell_face);
+	if (has("bt")) tabs["bt"].idata = std::move(fg.btypes);
+}
@@ -0,0 +1,47 @@
+#ifndef HMCPORT_TABVIEW_HPP
+#define HMCPORT_TABVIEW_HPP
+
+#include "primitives2d.hpp"
+#include "primitives3d.hpp"
+#include <map>
+
+//Plain connectivity tables of a grid.
+//All requested tables are built from a single flat representation of the grid,
+//per entity loops are run in parallel.
+//Table data addresses are stable for the lifetime of the object,
+//so they could be passed to clients without copying.
+struct TabView{
+	struct Tab{
+		vector<int> idata;
+		vector<double> ddata;
+
+		//number of entries and address of the first one
+		int size() const { return ddata.size() > 0 ? ddata.size() : idata.size(); }
+		const void* data() const { return ddata.size() > 0 ? (const void*)ddata.data()
+		                                                   : (const void*)idata.data(); }
+		//copies data to preallocated array
+		void copy(int* ret) const;
+		void copy(double* ret) const;
+		//copies data to new[] allocated array
+		void copy_new(int* nret, int** ret) const;
+	};
+
+	//what is a list of table names. Throws if any of them is unknown.
+	//2D tables: vert, edge_vert, edge_cell, cell_dim, cell_vert,
+	//           cell_edge, cell_center, bnd, bt, bnd_bt;
+	//3D tables: vert, edge_vert, face_dim, face_edge, face_vert, face_cell,
+	//           cell_fdim, cell_vdim, cell_face, cell_vert, bt, bnd, bnd_bt.
+	//Ids of grid primitives are changed.
+	TabView(const HM2D::GridData& g, const vector<std::string>& what);
+	TabView(const HM3D::GridData& g, const vector<std::string>& what);
+
+	//throws if table was not built
+	const Tab& get(std::string what) const;
+
+	//splits space or comma separated list of table names
+	static vector<std::string> split_names(const char* what);
+private:
+	std::map<std::string, Tab> tabs;
+};
+
+#endif
@@ -102,6 +102,13 @@ D3::D3(const vector<HM3D::FaceData*>& vd, double a){
 	_finp = vd;
 }
 
+void D3::scale(HM3D::VertexData& pts){
+	sc.p_scale(pts.begin(), pts.end());
+}
+void D3::scale(vector<double>& lens){
+	for (auto& v: lens){ v/=sc.L; }
+}
+
 void D3::unscale(HM3D::GridData* g){
 	HM3D::Unscale(g->vvert, sc);
 }
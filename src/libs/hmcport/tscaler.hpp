@@ -68,8 +68,9 @@ public:
 	D3(const vector<HM3D::GridData*>& vd, double a=1.);
 	D3(const vector<HM3D::FaceData*>& vd, double a=1.);
 
-	//scale other objects
-	//...
+	//simple scale other objects
+	void scale(HM3D::VertexData& pts);
+	void scale(vector<double>& lens);
 	//unscale other objects
 	void unscale(HM3D::GridData* g);
 
@@ -1,13 +1,16 @@
 #include "buildgrid3d.hpp"
 #include "debug3d.hpp"
+#include "hmpool.hpp"
 using namespace HM3D;
 
 namespace cns = Grid::Constructor;
 
 GridData cns::Cuboid(Vertex leftp, double lx, double ly, double lz, int nx, int ny, int nz){
 	GridData ret;
+	//all primitives are placed into a single arena
+	HMPool::Pool pool;
 	//Vertices
-	VertexData vert; vert.reserve(nx*ny*nz);
+	VertexData vert; vert.reserve((nx+1)*(ny+1)*(nz+1));
 	double hx = lx/(nx), hy = ly/(ny), hz = lz/(nz);
 	vector<double> x(nx+1), y(ny+1), z(nz+1);
 	for (int i=0; i<nx+1; ++i) x[i] = leftp.x + i*hx;
@@ -16,7 +19,7 @@ GridData cns::Cuboid(Vertex leftp, double lx, double ly, double lz, int nx, int
 	for (int k=0; k<nz+1; ++k)
 	for (int j=0; j<ny+1; ++j)
 	for (int i=0; i<nx+1; ++i){
-		vert.emplace_back(new Vertex(x[i], y[j], z[k]));
+		vert.push_back(pool.make<Vertex>(x[i], y[j], z[k]));
 	}
 	int sx=1, sy=nx+1, sz=(nx+1)*(ny+1), N=(nx+1)*(ny+1)*(nz+1);
 	ret.vvert = vert;
@@ -30,17 +33,17 @@ GridData cns::Cuboid(Vertex leftp, double lx, double ly, double lz, int nx, int
 		//x edge
 		if (i<nx){
 			auto p2 = vert[gi+sx];
-			xedges[gi].reset(new Edge(p1, p2));
+			xedges[gi] = pool.make<Edge>(p1, p2);
 		}
 		//y edge
 		if (j<ny){
 			auto p2 = vert[gi+sy];
-			yedges[gi].reset(new Edge(p1, p2));
+			yedges[gi] = pool.make<Edge>(p1, p2);
 		}
 		//z edge
 		if (k<nz){
 			auto p2 = vert[gi+sz];
-			zedges[gi].reset(new Edge(p1, p2));
+			zedges[gi] = pool.make<Edge>(p1, p2);
 		}
 		++gi;
 	}
@@ -59,17 +62,17 @@ GridData cns::Cuboid(Vertex leftp, double lx, double ly, double lz, int nx, int
 		//z face
 		if (i<nx && j<ny){
 			auto e1=yedges[gi], e2=xedges[gi+sy], e3=yedges[gi+sx], e4=xedges[gi];
-			zfaces[gi].reset(new Face({e1, e2, e3, e4}));
+			zfaces[gi] = pool.make<Face>(EdgeData{e1, e2, e3, e4});
 		}
 		//y face
 		if (i<nx && k<nz){
 			auto e1=xedges[gi], e2=zedges[gi+sx], e3=xedges[gi+sz], e4=zedges[gi];
-			yfaces[gi].reset(new Face({e1, e2, e3, e4}));
+			yfaces[gi] = pool.make<Face>(EdgeData{e1, e2, e3, e4});
 		};
 		//x face
 		if (j<ny && k<nz){
 			auto e1=zedges[gi], e2=yedges[gi+sz], e3=zedges[gi+sy], e4=yedges[gi];
-			xfaces[gi].reset(new Face({e1, e2, e3, e4}));
+			xfaces[gi] = pool.make<Face>(EdgeData{e1, e2, e3, e4});
 		}
 		++gi;
 	}
@@ -85,7 +88,7 @@ GridData cns::Cuboid(Vertex leftp, double lx, double ly, double lz, int nx, int
 	for (int j=0; j<ny; ++j)
 	for (int i=0; i<nx; ++i){
 		gi = i*sx + j*sy + k*sz;
-		ret.vcells.emplace_back(new Cell);
+		ret.vcells.push_back(pool.make<Cell>());
 		auto c = ret.vcells.back();
 		auto xleft = xfaces[gi]; xleft->left = c;
 		auto xright = xfaces[gi+sx]; xright->right = c;
@@ -135,123 +138,119 @@ GridData cns::SweepGrid2D(const HM2D::GridData& g, const vector<double>& zcoords
 		std::function<int(int)> bottom_bt,
 		std::function<int(int)> top_bt,
 		std::function<int(int)> side_bt){
+	return Unflatten(SweepFlatGrid2D(HM2D::Flatten(g), zcoords, bottom_bt, top_bt, side_bt));
+}
 
-	GridData ret;
-	
-	//Needed Data
-	auto& e2d = g.vedges;
-	int n2p = g.vvert.size(), n2c = g.vcells.size(), n2e = e2d.size(), nz = zcoords.size();
-	g.enumerate_all();
-	vector<vector<int>> cell_edges2d; cell_edges2d.reserve(n2c);
-	for (auto c: g.vcells){
-		cell_edges2d.emplace_back();
-		for (auto e: c->edges) cell_edges2d.back().push_back(e->id);
-	}
+FlatGrid cns::SweepFlatGrid2D(const HM2D::FlatGrid& g, const vector<double>& zcoords,
+		std::function<int(int)> bottom_bt,
+		std::function<int(int)> top_bt,
+		std::function<int(int)> side_bt){
+	FlatGrid ret;
+
+	int n2p = g.n_vert(), n2c = g.n_cells(), n2e = g.n_edges(), nz = zcoords.size();
+	int nxye = n2e*nz, nxyf = n2c*nz;
+	auto xyedge = [&](int layer, int e2){ return layer*n2e + e2; };
+	auto zedge = [&](int layer, int p2){ return nxye + layer*n2p + p2; };
+	auto xyface = [&](int layer, int c2){ return layer*n2c + c2; };
+	auto zface = [&](int layer, int e2){ return nxyf + layer*n2e + e2; };
 
 	//Vertices
-	ShpVector<Vertex>& vert = ret.vvert; vert.reserve(n2p*nz);
+	ret.vert.resize(3*n2p*nz);
 	{
+		auto it = ret.vert.begin();
 		for (int i=0; i<nz; ++i){
 			double z = zcoords[i];
 			for (int j=0; j<n2p; ++j){
-				auto& p = g.vvert[j];
-				vert.emplace_back(new Vertex(p->x, p->y, z));
+				*it++ = g.vert[2*j];
+				*it++ = g.vert[2*j+1];
+				*it++ = z;
 			}
 		}
 	}
 
-	//Edges
-	ShpVector<Edge> xyedges(n2e*nz), zedges((nz-1)*n2p);
+	//Edges: xy edges, z edges
+	ret.edge_vert.resize(2*(nxye + (nz-1)*n2p));
 	{
-		//xy edges
-		int j=0;
+		auto it = ret.edge_vert.begin();
 		for (int i=0; i<nz; ++i){
-			for (auto& e: e2d){
-				int i1 = i*n2p + e->first()->id;
-				int i2 = i*n2p + e->last()->id;
-				xyedges[j++].reset(new Edge(vert[i1], vert[i2]));
+			for (int j=0; j<n2e; ++j){
+				*it++ = i*n2p + g.edge_vert[2*j];
+				*it++ = i*n2p + g.edge_vert[2*j+1];
 			}
 		}
-		//z edges
-		int k=0;
 		for (int i=0; i<nz-1; ++i){
 			for (int j=0; j<n2p; ++j){
-				int i1 = i*n2p + j;
-				int i2 = (i+1)*n2p + j;
-				zedges[k++].reset(new Edge(vert[i1], vert[i2]));
+				*it++ = i*n2p + j;
+				*it++ = (i+1)*n2p + j;
 			}
 		}
 	}
-	ret.vedges.insert(ret.vedges.end(), xyedges.begin(), xyedges.end());
-	ret.vedges.insert(ret.vedges.end(), zedges.begin(), zedges.end());
 
-	//Faces
-	ShpVector<Face> xyfaces; xyfaces.reserve(n2c*nz);
-	ShpVector<Face> zfaces; zfaces.reserve(n2e*(nz-1));
+	//Faces: xy faces, z faces
+	int nfaces = nxyf + n2e*(nz-1);
+	ret.face_edge_start.resize(nfaces+1);
+	ret.face_edge.reserve(nz*g.cell_edge.size() + 4*n2e*(nz-1));
+	ret.face_edge_start[0] = 0;
 	{
-		//xyfaces
+		int k = 0;
 		for (int i=0; i<nz; ++i){
 			for (int j=0; j<n2c; ++j){
-				Face* f = new Face();
-				for (auto k: cell_edges2d[j]){
-					f->edges.push_back(xyedges[i*n2e+k]);
+				for (const int* e=g.cell_edges_begin(j); e!=g.cell_edges_end(j); ++e){
+					ret.face_edge.push_back(xyedge(i, *e));
 				}
-				xyfaces.emplace_back(f);
+				ret.face_edge_start[++k] = ret.face_edge.size();
 			}
 		}
-		//zfaces
 		for (int i=0; i<nz-1; ++i){
 			for (int j=0; j<n2e; ++j){
-				int i12d = e2d[j]->first()->id;
-				int i22d = e2d[j]->last()->id;
-				Face* f = new Face();
-				auto e1 = xyedges[j + i*n2e];
-				auto e2 = zedges[i22d + i*n2p];
-				auto e3 = xyedges[j+ (i+1)*n2e];
-				auto e4 = zedges[i12d + i*n2p];
-				f->edges = {e1, e2, e3, e4};
-				zfaces.emplace_back(f);
+				ret.face_edge.push_back(xyedge(i, j));
+				ret.face_edge.push_back(zedge(i, g.edge_vert[2*j+1]));
+				ret.face_edge.push_back(xyedge(i+1, j));
+				ret.face_edge.push_back(zedge(i, g.edge_vert[2*j]));
+				ret.face_edge_start[++k] = ret.face_edge.size();
 			}
 		}
 	}
-	ret.vfaces.insert(ret.vfaces.end(), xyfaces.begin(), xyfaces.end());
-	ret.vfaces.insert(ret.vfaces.end(), zfaces.begin(), zfaces.end());
 
 	//Cells
+	ret.face_cell.resize(2*nfaces, -1);
+	ret.cell_face_start.resize(n2c*(nz-1)+1);
+	ret.cell_face.reserve((nz-1)*(2*n2c + g.cell_edge.size()));
+	ret.cell_face_start[0] = 0;
 	{
-		ret.vcells.reserve(n2c*(nz-1));
+		int ic = 0;
 		for (int i=0; i<nz-1; ++i){
 			for (int j=0; j<n2c; ++j){
-				ret.vcells.emplace_back(new Cell());
-				auto& c = ret.vcells.back();
-				int ifc = i*n2c + j;
-				auto bot = xyfaces[ifc]; bot->right = c;
-				auto top = xyfaces[ifc + n2c]; top->left = c;
-				c->faces = {bot, top};
-				for (int k: cell_edges2d[j]){
-					auto f1 = zfaces[k + n2e*i];
-					c->faces.push_back(f1);
-					bool isleft = (e2d[k]->has_left_cell() && e2d[k]->left.lock()->id == j);
-					if (isleft) f1->left = c;
-					else f1->right = c;
+				int bot = xyface(i, j), top = xyface(i+1, j);
+				ret.face_cell[2*bot+1] = ic;
+				ret.face_cell[2*top] = ic;
+				ret.cell_face.push_back(bot);
+				ret.cell_face.push_back(top);
+				for (const int* e=g.cell_edges_begin(j); e!=g.cell_edges_end(j); ++e){
+					int f1 = zface(i, *e);
+					ret.cell_face.push_back(f1);
+					bool isleft = (g.edge_cell[2*(*e)] == j);
+					if (isleft) ret.face_cell[2*f1] = ic;
+					else ret.face_cell[2*f1+1] = ic;
 				}
+				ret.cell_face_start[++ic] = ret.cell_face.size();
 			}
 		}
 	}
 
 	//Boundary Types
+	ret.btypes.resize(nfaces, 0);
 	{
 		//top, bottom
-		int j = n2c*(nz-1);
 		for (int i=0; i<n2c; ++i){
-			xyfaces[i]->boundary_type = bottom_bt(i);
-			xyfaces[j++]->boundary_type = top_bt(i);
+			ret.btypes[xyface(0, i)] = bottom_bt(i);
+			ret.btypes[xyface(nz-1, i)] = top_bt(i);
 		}
 		//sides
-		for (int i=0; i<n2e; ++i) if (e2d[i]->is_boundary()){
+		for (int i=0; i<n2e; ++i) if (g.is_boundary_edge(i)){
 			int bt = side_bt(i);
 			for (int k=0; k<nz-1; ++k){
-				zfaces[i + k*n2e]->boundary_type = bt;
+				ret.btypes[zface(k, i)] = bt;
 			}
 		}
 	}
@@ -3,6 +3,8 @@
 
 #include "serialize3d.hpp"
 #include "primitives2d.hpp"
+#include "flatgrid2d.hpp"
+#include "flatgrid3d.hpp"
 
 namespace HM3D{ namespace Grid{ namespace Constructor{
 
@@ -38,6 +40,13 @@ HM3D::GridData SweepGrid2D(const HM2D::GridData& g2d, const vector<double>& zcoo
 		std::function<int(int)> top_bt,        //(g2d cell index) -> boundary type
 		int side_bt);                          //constant side boundary type
 
+//sweep procedure which builds compact grid from compact 2d grid
+//without assembling shared pointers structures.
+//Resulting primitives ordering and boundary types are the same as in SweepGrid2D.
+HM3D::FlatGrid SweepFlatGrid2D(const HM2D::FlatGrid& g2d, const vector<double>& zcoords,
+		std::function<int(int)> bottom_bt,     //(g2d cell index) -> boundary type
+		std::function<int(int)> top_bt,        //(g2d cell index) -> boundary type
+		std::function<int(int)> side_bt);      //(g2d edge index) -> boundary type
 
 }}}
 
@@ -13,7 +13,7 @@ struct revolve_builder{
  
 //input data:
 	vector<double> phi;
-	const HM2D::GridData* g2;
+	const HM2D::FlatGrid* g2;
 	Vertex rot_vec, rot_p0;
 	int Nsurf, Nsurf_wc; //number of surfaces, number of surfaces with 3d cell layer
 	vector<vector<int>> cell_edges;
@@ -39,7 +39,7 @@ struct revolve_builder{
 	std::map<int, vector<int>> boundary_types;
 	vector<double> edge_curvature;
 
-	revolve_builder(const HM2D::GridData& g2d, const vector<double>& phi_deg,
+	revolve_builder(const HM2D::FlatGrid& g2d, const vector<double>& phi_deg,
 			Point pstart, Point pend){
 		//prepare
 		_0_fill_input(g2d, phi_deg, pstart, pend);
@@ -64,19 +64,47 @@ struct revolve_builder{
 		_8_fill_axis_cells();
 		icell.push_back(cells.size());
 	}
-	GridData build_ess(){
-		GridData ret;
-		fill_primitives(ret);
+	FlatGrid build_flat(){
+		FlatGrid ret;
+		ret.vert = vertices;
+		ret.edge_vert = edges;
+		//faces
+		int nfaces = iface.size()-1;
+		ret.face_edge_start.resize(nfaces+1);
+		ret.face_edge_start[0] = 0;
+		ret.face_cell.resize(2*nfaces);
+		auto fit = faces.begin();
+		for (int i=0; i<nfaces; ++i){
+			int n = *fit++;
+			ret.face_edge.insert(ret.face_edge.end(), fit, fit+n);
+			ret.face_edge_start[i+1] = ret.face_edge.size();
+			fit += n;
+			ret.face_cell[2*i] = *fit++;
+			ret.face_cell[2*i+1] = *fit++;
+		}
+		//cells
+		int ncells = icell.size()-1;
+		ret.cell_face_start.resize(ncells+1);
+		ret.cell_face_start[0] = 0;
+		auto cit = cells.begin();
+		for (int i=0; i<ncells; ++i){
+			int n = *cit++;
+			ret.cell_face.insert(ret.cell_face.end(), cit, cit+n);
+			ret.cell_face_start[i+1] = ret.cell_face.size();
+			cit += n;
+		}
+		//boundary types
+		ret.btypes.resize(nfaces, 0);
 		for (auto& v: boundary_types){
 			for (auto& find: v.second){
-				ret.vfaces[find]->boundary_type = v.first;
+				ret.btypes[find] = v.first;
 			}
 		}
 		return ret;
 	}
 	void side_boundary(){
-		for (int i=0; i<g2->vedges.size(); ++i) if (g2->vedges[i]->is_boundary()){
-			int b = g2->vedges[i]->boundary_type;
+		for (int i=0; i<g2->n_edges(); ++i) if (g2->is_boundary_edge(i)){
+			int b = g2->btypes[i];
 			auto emp = boundary_types.emplace(b, vector<int>());
 			vector<int>& inp = emp.first->second;
 			for (int j=0; j<Nsurf_wc; ++j){
@@ -86,7 +114,7 @@ struct revolve_builder{
 		}
 	}
 	void afirst_boundary(int f){
-		for (int i=0; i<g2->vcells.size(); ++i){
+		for (int i=0; i<g2->n_cells(); ++i){
 			int b = f;
 			auto emp = boundary_types.emplace(b, vector<int>());
 			vector<int>& inp = emp.first->second;
@@ -95,7 +123,7 @@ struct revolve_builder{
 		}
 	}
 	void alast_boundary(int f){
-		for (int i=0; i<g2->vcells.size(); ++i){
+		for (int i=0; i<g2->n_cells(); ++i){
 			int b = f;
 			auto emp = boundary_types.emplace(b, vector<int>());
 			vector<int>& inp = emp.first->second;
@@ -104,7 +132,7 @@ struct revolve_builder{
 		}
 	}
 protected:
-	void _0_fill_input(const HM2D::GridData& g2d, const vector<double>& phi_deg,
+	void _0_fill_input(const HM2D::FlatGrid& g2d, const vector<double>& phi_deg,
 			Point pstart, Point pend){
 		g2 = &g2d;
 		phi.resize(phi_deg.size());
@@ -123,27 +151,18 @@ protected:
 		iscomplete = false;
 		if (ISZERO(phi.back() - phi[0] - 2*M_PI)) {--Nsurf; iscomplete=true;}
 		//cell->edges connectivity
-		g2d.enumerate_all();
-		cell_edges.reserve(g2d.vcells.size());
-		for (auto c: g2d.vcells){
-			cell_edges.emplace_back();
-			for (auto e: c->edges){
-				cell_edges.back().push_back(e->id);
-			}
-		}
-
-		//cell->edges->is_left
-		cell_edges_isleft.resize(g2d.vcells.size());
-		for (int i=0; i<cell_edges_isleft.size(); ++i){
-			auto& il = cell_edges_isleft[i];
-			for (int j=0; j<cell_edges[i].size(); ++j){
-				il.push_back(g2d.vcells[i]->edges[j]->left.lock() == g2d.vcells[i]);
+		cell_edges.resize(g2d.n_cells());
+		cell_edges_isleft.resize(g2d.n_cells());
+		for (int i=0; i<g2d.n_cells(); ++i){
+			cell_edges[i].assign(g2d.cell_edges_begin(i), g2d.cell_edges_end(i));
+			for (int e: cell_edges[i]){
+				cell_edges_isleft[i].push_back(g2d.edge_cell[2*e] == i);
 			}
 		}
 	}
 	void _1_sort_out_2d_data(){
 		//vertices
-		vector<bool> is_normal_vertex(g2->vvert.size());
+		vector<bool> is_normal_vertex(g2->n_vert());
 		double x0 = rot_p0.x, y0 = rot_p0.y;
 		std::array<double, 3> A = Point::line_eq(Point(0, 0), Point(rot_vec.x, rot_vec.y));
 		auto meas_line = [A, x0, y0](const Point& p) -> double{
@@ -151,9 +170,9 @@ protected:
 			return SIGN(d0)*d0*d0;
 		};
 		int sgn=0;
-		vertex_measure.resize(g2->vvert.size());
-		for (int i=0; i<g2->vvert.size(); ++i){
-			double m = meas_line(*g2->vvert[i]);
+		vertex_measure.resize(g2->n_vert());
+		for (int i=0; i<g2->n_vert(); ++i){
+			double m = meas_line(g2->vertex(i));
 			vertex_measure[i] = m;
 			if (fabs(m) < geps*geps) {
 				is_normal_vertex[i] = false;
@@ -169,11 +188,11 @@ protected:
 		}
 	
 		//edges
-		vector<bool> is_normal_edge(g2->vedges.size());
-		edge_type.resize(g2->vedges.size());
-		for (int i=0; i<g2->vedges.size(); ++i){
-			int p1 = g2->vedges[i]->first()->id,
-			    p2 = g2->vedges[i]->last()->id;
+		vector<bool> is_normal_edge(g2->n_edges());
+		edge_type.resize(g2->n_edges());
+		for (int i=0; i<g2->n_edges(); ++i){
+			int p1 = g2->edge_vert[2*i],
+			    p2 = g2->edge_vert[2*i+1];
 			bool n1 = is_normal_vertex[p1], n2 = is_normal_vertex[p2];
 			if (!n1 && !n2){
 				is_normal_edge[i] = false;
@@ -188,7 +207,7 @@ protected:
 			}
 		}
 		//cells
-		for (int i=0; i<g2->vcells.size(); ++i){
+		for (int i=0; i<g2->n_cells(); ++i){
 			bool isnormal = true;
 			for (int j=0; j<cell_edges[i].size(); ++j){
 				if (!is_normal_edge[cell_edges[i][j]]){
@@ -207,8 +226,8 @@ protected:
 		detect_edges_revolution();
 	}
 	virtual void detect_edges_revolution(){
-		do_revolve_edge.resize(g2->vedges.size());
-		for (int i=0; i<g2->vedges.size(); ++i){
+		do_revolve_edge.resize(g2->n_edges());
+		for (int i=0; i<g2->n_edges(); ++i){
 			do_revolve_edge[i] = (edge_type[i] != 0);
 		}
 	}
@@ -231,8 +250,8 @@ protected:
 			double M32 = (1-cosa) * rot_vec.y * rot_vec.z + sina * rot_vec.x;
 			//double M33 = cosa + (1-cosa) * rot_vec.z * rot_vec.z;
 			for (int i=0; i<normal_vertex.size(); ++i){
-				auto p = g2->vvert[normal_vertex[i]];
-				double x = p->x - rot_p0.x, y = p->y - rot_p0.y, z = 0;
+				Point p = g2->vertex(normal_vertex[i]);
+				double x = p.x - rot_p0.x, y = p.y - rot_p0.y, z = 0;
 				*it++ = M11 * x + M12 * y + rot_p0.x;
 				*it++ = M21 * x + M22 * y + rot_p0.y;
 				*it++ = M31 * x + M32 * y;
@@ -241,9 +260,9 @@ protected:
 		}
 		//axis vertices
 		for (int i=0; i<axis_vertex.size(); ++i){
-			auto p = g2->vvert[axis_vertex[i]];
-			*it++ = p->x;
-			*it++ = p->y;
+			Point p = g2->vertex(axis_vertex[i]);
+			*it++ = p.x;
+			*it++ = p.y;
 			*it++ = 0;
 			for (int j=0; j<Nsurf; ++j) vertices3[j][axis_vertex[i]] = n;
 			++n;
@@ -253,13 +272,13 @@ protected:
 		int Nedges = Nsurf * normal_edge.size() + axis_edge.size();
 		edges.resize(Nedges*2);
 		edge_curvature.resize(Nedges, 0.0);
-		planar_edge3.resize(Nsurf, vector<int>(g2->vedges.size()));
+		planar_edge3.resize(Nsurf, vector<int>(g2->n_edges()));
 		int n=0;
 		auto it = edges.begin();
 		//normal edges
 		for (int i=0; i<normal_edge.size(); ++i){
 			int ed = normal_edge[i];
-			int p1 = g2->vedges[ed]->first()->id, p2 = g2->vedges[ed]->last()->id;
+			int p1 = g2->edge_vert[2*ed], p2 = g2->edge_vert[2*ed+1];
 			for (int j=0; j<Nsurf; ++j){
 				int v1 = vertices3[j][p1], v2 = vertices3[j][p2];
 				*it++ = v1;
@@ -270,7 +289,7 @@ protected:
 		//axis edges
 		for (int i=0; i<axis_edge.size(); ++i){
 			int ed = axis_edge[i];
-			int p1 = g2->vedges[ed]->first()->id, p2 = g2->vedges[ed]->last()->id;
+			int p1 = g2->edge_vert[2*ed], p2 = g2->edge_vert[2*ed+1];
 			int v1 = vertices3[0][p1], v2 = vertices3[0][p2];
 			*it++ = v1;
 			*it++ = v2;
@@ -283,7 +302,7 @@ protected:
 		int n = edges.size() / 2;
 		edges.resize(2*n + 2*Nedges);
 		edge_curvature.resize(n+Nedges, 0);
-		perp_edge3.resize(Nsurf_wc, vector<int>(g2->vvert.size()));
+		perp_edge3.resize(Nsurf_wc, vector<int>(g2->n_vert()));
 		auto it = edges.begin() + 2 * n;
 		for (int i=0; i<normal_vertex.size(); ++i){
 			int v = normal_vertex[i];
@@ -304,11 +323,11 @@ protected:
 		for (auto& v: cell_edges) sz+=(v.size() + 3);
 		faces.resize(Nsurf * sz);
 		planar_face3.resize(Nsurf, vector<int>(cell_edges.size(), -1));
-		iface.resize(Nsurf*g2->vcells.size());
+		iface.resize(Nsurf*g2->n_cells());
 		//fill
 		int n=0;
 		auto it = faces.begin();
-		for (int i=0; i<g2->vcells.size(); ++i){
+		for (int i=0; i<g2->n_cells(); ++i){
 			int ned = cell_edges[i].size();
 			for (int j=0; j<Nsurf; ++j){
 				iface[n] = it - faces.begin();
@@ -329,11 +348,11 @@ protected:
 		int oldlen = faces.size();
 		faces.resize(oldlen + Nsurf_wc*normal_edge_nn.size()*7);
 		auto it = faces.begin() + oldlen;
-		perp_face3.resize(Nsurf_wc, vector<int>(g2->vedges.size(), -1));
+		perp_face3.resize(Nsurf_wc, vector<int>(g2->n_edges(), -1));
 		for (int i=0; i<normal_edge_nn.size(); ++i){
 			int ed_2d = normal_edge_nn[i];
-			int pstart_2d = g2->vedges[ed_2d]->first()->id;
-			int pend_2d = g2->vedges[ed_2d]->last()->id;
+			int pstart_2d = g2->edge_vert[2*ed_2d];
+			int pend_2d = g2->edge_vert[2*ed_2d+1];
 			for (int j=0; j<Nsurf_wc; ++j){
 				iface[n] = it - faces.begin();
 				*it++ = 4;
@@ -355,8 +374,8 @@ protected:
 		auto it = faces.begin() + oldlen;
 		for (int i=0; i<normal_edge_n.size(); ++i){
 			int ed_2d = normal_edge_n[i];
-			int pstart_2d = g2->vedges[ed_2d]->first()->id;
-			int pend_2d = g2->vedges[ed_2d]->last()->id;
+			int pstart_2d = g2->edge_vert[2*ed_2d];
+			int pend_2d = g2->edge_vert[2*ed_2d+1];
 			for (int j=0; j<Nsurf_wc; ++j){
 				iface[n] = it - faces.begin();
 				*it++ = 3;
@@ -458,79 +477,24 @@ protected:
 	void add_rface_adj(int index_cell, int index_face){
 		faces[iface[index_face+1]-1] = index_cell;
 	}
-
-	void fill_primitives(HM3D::GridData& ret){
-		auto& rvert = ret.vvert;
-		auto& redge = ret.vedges;
-		auto& rface = ret.vfaces;
-		auto& rcell = ret.vcells;
-		//vertices
-		rvert.resize(vertices.size()/3);
-		auto vit = vertices.begin();
-		for (int i=0; i<rvert.size(); ++i){
-			rvert[i].reset(new Vertex(*vit, *(vit+1), *(vit+2)));
-			vit+=3;
-		}
-		//edges
-		redge.resize(edges.size()/2);
-		auto eit = edges.begin();
-		auto curvit = edge_curvature.begin();
-		for (int i=0; i<redge.size(); ++i){
-			auto p1=rvert[*eit++];
-			auto p2=rvert[*eit++];
-			double curv = *curvit++;
-			redge[i].reset(new HM3D::Edge(p1, p2));
-		}
-		//faces init
-		rface.resize(iface.size()-1);
-		for (int i=0; i<rface.size(); ++i) rface[i].reset(new Face());
-		//cells init
-		rcell.resize(icell.size()-1);
-		for (int i=0; i<rcell.size(); ++i) rcell[i].reset(new HM3D::Cell());
-		//faces
-		auto fit = faces.begin();
-		for (int i=0; i<rface.size(); ++i){
-			auto& f = rface[i];
-			int n = *fit++;
-			for (int k=0; k<n; ++k){
-				f->edges.push_back(redge[*fit++]);
-			}
-			int c1 = *fit++;
-			int c2 = *fit++;
-			if (c1>=0) f->left = rcell[c1];
-			if (c2>=0) f->right = rcell[c2];
-		}
-		//cells
-		auto cit = cells.begin();
-		for (int i=0; i<rcell.size(); ++i){
-			auto& c = rcell[i];
-			int n = *cit++;
-			for (int k=0; k<n; ++k){
-				c->faces.push_back(rface[*cit++]);
-			}
-		}
-	}
 };
 
 class revolve_builder_no_tri: public revolve_builder{
 public:
-	revolve_builder_no_tri(const HM2D::GridData& g2d, const vector<double>& phi_deg,
+	revolve_builder_no_tri(const HM2D::FlatGrid& g2d, const vector<double>& phi_deg,
 			Point pstart, Point pend): revolve_builder(g2d, phi_deg, pstart, pend){}
 protected:
 	void detect_edges_revolution() override {
-		do_revolve_edge.resize(g2->vedges.size());
-		for (int i=0; i<g2->vedges.size(); ++i){
+		do_revolve_edge.resize(g2->n_edges());
+		for (int i=0; i<g2->n_edges(); ++i){
 			switch (edge_type[i]){
 				case 0: do_revolve_edge[i] = false; break;
 				case 1: do_revolve_edge[i] = true; break;
 				case 2: case 3: 
 				{
-					int c1 = g2->vedges[i]->has_left_cell() ?
-					         g2->vedges[i]->left.lock()->id :
-					         g2->vedges[i]->right.lock()->id;
-					int c2 = g2->vedges[i]->has_right_cell() ?
-					         g2->vedges[i]->right.lock()->id :
-					         g2->vedges[i]->left.lock()->id;
+					int c1 = g2->edge_cell[2*i], c2 = g2->edge_cell[2*i+1];
+					if (c1 < 0) c1 = c2;
+					if (c2 < 0) c2 = c1;
 					do_revolve_edge[i] = (cell_type[c1] == 1 || cell_type[c2] == 1);
 				}
 			}
@@ -545,12 +509,12 @@ protected:
 			for (int i=0; i<normal_edge_n.size(); ++i){
 				int ed_2d = normal_edge_n[i];
 				if (do_revolve_edge[ed_2d]){
-					int axisnode = (edge_type[ed_2d] == 2) ? g2->vedges[ed_2d]->last()->id
-					                                       : g2->vedges[ed_2d]->first()->id;
+					int axisnode = (edge_type[ed_2d] == 2) ? g2->edge_vert[2*ed_2d+1]
+					                                       : g2->edge_vert[2*ed_2d];
 					if (used.emplace(axisnode).second == false) continue;
-					auto p = g2->vvert[axisnode];
-					vertices.push_back(p->x);
-					vertices.push_back(p->y);
+					Point p = g2->vertex(axisnode);
+					vertices.push_back(p.x);
+					vertices.push_back(p.y);
 					vertices.push_back(0);
 					for (int j=0; j<Nsurf; ++j) vertices3[j][axisnode] = n;
 					++n;
@@ -560,7 +524,7 @@ protected:
 	}
 	void _3_fill_planar_edges() override {
 		int Nedges = 0;
-		for (int i=0; i<g2->vedges.size(); ++i){
+		for (int i=0; i<g2->n_edges(); ++i){
 			if (do_revolve_edge[i]) Nedges += Nsurf;
 			else {
 				if (!iscomplete){
@@ -571,13 +535,13 @@ protected:
 		}
 		edges.resize(Nedges*2);
 		edge_curvature.resize(Nedges, 0.0);
-		planar_edge3.resize(Nsurf, vector<int>(g2->vedges.size()));
+		planar_edge3.resize(Nsurf, vector<int>(g2->n_edges()));
 		int n=0;
 		auto it = edges.begin();
 		for (int i=0; i<normal_edge.size(); ++i){
 			int ed = normal_edge[i];
 			if (!do_revolve_edge[ed] && iscomplete) continue;
-			int p1 = g2->vedges[ed]->first()->id, p2 = g2->vedges[ed]->last()->id;
+			int p1 = g2->edge_vert[2*ed], p2 = g2->edge_vert[2*ed+1];
 			for (int j=0; j<Nsurf; ++j){
 				if (!do_revolve_edge[ed] && j!=0 && j!=Nsurf-1) continue;
 				int v1 = vertices3[j][p1], v2 = vertices3[j][p2];
@@ -589,7 +553,7 @@ protected:
 		//axis edges
 		if (!iscomplete) for (int i=0; i<axis_edge.size(); ++i){
 			int ed = axis_edge[i];
-			int p1 = g2->vedges[ed]->first()->id, p2 = g2->vedges[ed]->last()->id;
+			int p1 = g2->edge_vert[2*ed], p2 = g2->edge_vert[2*ed+1];
 			int v1 = vertices3[0][p1], v2 = vertices3[0][p2];
 			*it++ = v1;
 			*it++ = v2;
@@ -604,11 +568,11 @@ protected:
 		for (auto& v: cell_edges) sz+=(v.size() + 3);
 		faces.resize(Nsurf * sz);
 		planar_face3.resize(Nsurf, vector<int>(cell_edges.size(), -1));
-		iface.resize(Nsurf*g2->vcells.size());
+		iface.resize(Nsurf*g2->n_cells());
 		//fill
 		int n=0;
 		auto it = faces.begin();
-		for (int i=0; i<g2->vcells.size(); ++i){
+		for (int i=0; i<g2->n_cells(); ++i){
 			if (iscomplete && cell_type[i] != 1) continue;
 			int ned = cell_edges[i].size();
 			for (int j=0; j<Nsurf; ++j){
@@ -638,8 +602,8 @@ protected:
 		auto it = faces.begin() + oldlen;
 		for (int i=0; i<normal_edge_n.size(); ++i){
 			int ed_2d = normal_edge_n[i];
-			int pend_2d = g2->vedges[ed_2d]->last()->id;
-			int pstart_2d = g2->vedges[ed_2d]->first()->id;
+			int pend_2d = g2->edge_vert[2*ed_2d+1];
+			int pstart_2d = g2->edge_vert[2*ed_2d];
 			if (!do_revolve_edge[ed_2d]){
 				iface[n] = it-faces.begin();
 				*it++ = (iscomplete) ? Nsurf_wc : Nsurf_wc + 2;
@@ -709,43 +673,37 @@ protected:
 	}
 };
 
-shared_ptr<revolve_builder> revolve_builder_factory(const HM2D::GridData& g2d, const vector<double>& phi_coords,
+shared_ptr<revolve_builder> revolve_builder_factory(const HM2D::FlatGrid& g2d, const vector<double>& phi_coords,
 		Point pstart, Point pend, bool is_trian){
 	if (is_trian) return std::make_shared<revolve_builder>(revolve_builder(g2d, phi_coords, pstart, pend));
 	else return std::make_shared<revolve_builder_no_tri>(revolve_builder_no_tri(g2d, phi_coords, pstart, pend));
 }
 
-struct EdRevert{
-	HM2D::GridData* g2;
-	vector<bool> reverted_edges;
-	EdRevert(const HM2D::GridData& g2d){
-		g2 = const_cast<HM2D::GridData*>(&g2d);
-		g2d.enumerate_all();
-		reverted_edges.resize(g2d.vedges.size(), false);
-		for (int i=0; i<g2d.vedges.size(); ++i){
-			if (g2d.vedges[i]->first()->id > g2d.vedges[i]->last()->id){
-				reverted_edges[i] = true;
-			}
-		}
-		dorevert();
-	}
-	~EdRevert(){ dorevert(); }
-	void dorevert(){
-		for (int i=0; i<g2->vedges.size(); ++i){
-			if (reverted_edges[i]) g2->vedges[i]->reverse();
-		}
+//copy of g2d with edges reverted so that: edge_vert[2*i] < edge_vert[2*i+1]
+//for backward compatibility
+HM2D::FlatGrid sorted_edges(const HM2D::FlatGrid& g2d){
+	HM2D::FlatGrid ret(g2d);
+	for (int i=0; i<ret.n_edges(); ++i) if (ret.edge_vert[2*i] > ret.edge_vert[2*i+1]){
+		std::swap(ret.edge_vert[2*i], ret.edge_vert[2*i+1]);
+		std::swap(ret.edge_cell[2*i], ret.edge_cell[2*i+1]);
 	}
-};
+	return ret;
+}
 
 };
 
 HM3D::GridData cns::RevolveGrid2D(const HM2D::GridData& g2d, const vector<double>& phi_coords,
 		Point pstart, Point pend, bool is_trian,
 		int bt1, int bt2){
-	//temporary revert edges of g2 so that: first()->id < last()->id for backward compatibility
-	EdRevert er(g2d);
+	return Unflatten(RevolveFlatGrid2D(HM2D::Flatten(g2d), phi_coords, pstart, pend, is_trian, bt1, bt2));
+}
+
+HM3D::FlatGrid cns::RevolveFlatGrid2D(const HM2D::FlatGrid& g2d, const vector<double>& phi_coords,
+		Point pstart, Point pend, bool is_trian,
+		int bt1, int bt2){
+	HM2D::FlatGrid g2 = sorted_edges(g2d);
 	//topology
-	auto dt = revolve_builder_factory(g2d, phi_coords, pstart, pend, is_trian);
+	auto dt = revolve_builder_factory(g2, phi_coords, pstart, pend, is_trian);
 	dt->process();
 	//boundary condition
 	dt->side_boundary();
@@ -754,5 +712,5 @@ HM3D::GridData cns::RevolveGrid2D(const HM2D::GridData& g2d, const vector<double
 		dt->alast_boundary(bt2);
 	}
 	//assemble grid
-	return dt->build_ess();
+	return dt->build_flat();
 }
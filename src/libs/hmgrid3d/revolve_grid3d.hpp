@@ -3,6 +3,8 @@
 
 #include "primitives2d.hpp"
 #include "primitives3d.hpp"
+#include "flatgrid2d.hpp"
+#include "flatgrid3d.hpp"
 
 namespace HM3D{namespace Grid{ namespace Constructor{
 
@@ -13,6 +15,13 @@ HM3D::GridData RevolveGrid2D(const HM2D::GridData& g2d,
 		Point pstart, Point pend, bool is_trian=true,
 		int bt1 = 2, int bt2 = 3);
 
+//revolution which builds compact grid from compact 2d grid.
+//Resulting primitives ordering and boundary types are the same as in RevolveGrid2D.
+HM3D::FlatGrid RevolveFlatGrid2D(const HM2D::FlatGrid& g2d,
+		const vector<double>& phi_coords,
+		Point pstart, Point pend, bool is_trian=true,
+		int bt1 = 2, int bt2 = 3);
+
 
 }}}
 #endif
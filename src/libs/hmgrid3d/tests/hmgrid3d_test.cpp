@@ -3,6 +3,7 @@
 #include "debug3d.hpp"
 #include "hmtesting.hpp"
 #include "hmtimer.hpp"
+#include "nan_handler.h"
 #include "buildgrid.hpp"
 #include "unite_grids.hpp"
 #include "healgrid.hpp"
@@ -15,6 +16,11 @@
 #include "debug2d.hpp"
 #include "export2d_fluent.hpp"
 #include "export2d_vtk.hpp"
+#include "flatgrid3d.hpp"
+#include "hmparallel.hpp"
+#include "cport_grid2d.h"
+#include "cport_grid3d.h"
+#include "modgrid.hpp"
 using namespace HMTesting;
 
 void old_numering(HM2D::GridData& g){
@@ -164,6 +170,17 @@ void test04(){
 		HM3D::Export::GridMSH(g3d, "_o1.msh", pd); 
 		add_file_check(1901761016274060527U, "_o1.msh", "simple 2x2x2");
 
+		HM3D::Export::GridMSH(g3d, "_o1b.msh", HM3D::Export::def_bfun, pd, true);
+		auto s1 = msh_sections("_o1.msh"), s2 = msh_sections("_o1b.msh");
+		bool good = s1.size() == 6 && s1.size() == s2.size();
+		for (auto it1=s1.begin(), it2=s2.begin(); it1!=s1.end() && good; ++it1, ++it2){
+			good = it1->first == it2->first && it1->second.size() == it2->second.size();
+			for (size_t i=0; i<it1->second.size() && good; ++i){
+				good = fabs(it1->second[i] - it2->second[i]) < 1e-12;
+			}
+		}
+		add_check(good, "binary sections");
+
 		pd.data[0].reversed = false;
 		HM3D::Export::GridMSH(g3d, "_o2.msh", pd); 
 		add_file_check(17909037251898648897U, "_o2.msh", "2x2x2 without reverse");
@@ -519,6 +536,451 @@ void test10(){
 	}
 }
 
+void test11(){
+	std::cout<<"11. Compact grid sweep"<<std::endl;
+	auto g2 = HM2D::Grid::Constructor::RegularHexagonal(Point(1, 1), 10., 2.);
+	vector<double> zsweep {0., 1., 3., 5.};
+	auto f2 = HM2D::Flatten(g2);
+	auto f3 = HM3D::Grid::Constructor::SweepFlatGrid2D(f2, zsweep,
+			[](int){ return 1; }, [](int){ return 2; }, [](int){ return 3; });
+	//3 layers over a 2d grid of 37 hexagons with 42 boundary edges
+	int nv2 = f2.n_vert(), ne2 = f2.n_edges(), nc2 = f2.n_cells();
+	add_check(nv2 == 96 && ne2 == 132 && nc2 == 37 &&
+			f3.n_vert() == 4*nv2 && f3.n_edges() == 4*ne2 + 3*nv2 &&
+			f3.n_faces() == 4*nc2 + 3*ne2 && f3.n_cells() == 3*nc2,
+			"compact sweep primitives count");
+	//hexagon with side 2 has area 6*sqrt(3), total height is 5
+	double vol = 37*6*sqrt(3)*5;
+	int nb[4] = {0, 0, 0, 0};
+	for (auto b: f3.btypes) if (b >= 0 && b < 4) ++nb[b];
+	bool ok = true;
+	vector<int> fv;
+	for (int i=0; i<f3.n_faces() && ok; ++i){
+		fv.clear();
+		f3.face_vert(i, fv);
+		ok = (int)fv.size() == f3.face_size(i);
+	}
+	add_check(ok && nb[1] == nc2 && nb[2] == nc2 && nb[3] == 3*42 &&
+			HM3D::Flat::BoundaryFaces(f3).size() == 2*nc2 + 3*42,
+			"compact sweep boundary");
+	auto g4 = HM3D::Unflatten(f3);
+	auto g3 = HM3D::Grid::Constructor::SweepGrid2D(g2, zsweep);
+	add_check(fabs(HM3D::SumVolumes(g4.vcells) - vol) < 1e-8 &&
+			fabs(HM3D::SumVolumes(g3.vcells) - vol) < 1e-8 &&
+			g3.vvert.size() == 384 && g3.vedges.size() == 816 &&
+			g3.vfaces.size() == 544 && g3.vcells.size() == 111,
+			"compact grid to shared pointers");
+	HM3D::Export::GridVTK(f3, "g1.vtk");
+	add_file_check(17870419829891734470U, "g1.vtk", "compact grid vtk export");
+}
+
+void test12(){
+	std::cout<<"12. Native format import"<<std::endl;
+	//libxml2 xpath initialization raises floating point exceptions
+	NanSignalHandler::StopCheck();
+	auto g2 = HM2D::Grid::Constructor::RegularHexagonal(Point(1, 1), 10., 2.);
+	auto g3 = HM3D::Grid::Constructor::SweepGrid2D(g2, {0., 1., 3., 5.});
+	HM3D::Ser::Grid sg(g3);
+	aa::enumerate_ids_pvec(sg.grid.vfaces);
+	vector<vector<int>> cell_face;
+	for (auto& c: sg.grid.vcells){
+		cell_face.emplace_back();
+		for (auto& f: c->faces) cell_face.back().push_back(f->id);
+	}
+	auto write = [&](std::string fn, std::string tp, size_t maxbuf){
+		HMXML::ReaderA writer = HMXML::ReaderA::create("HybMeshData");
+		writer.max_buffer_size = maxbuf;
+		HM3D::Export::GridWriter gw(sg, &writer, &writer, "g1", tp);
+		gw.AddCellFaceConnectivity();
+		vector<double> cdata(sg.n_cells());
+		for (int i=0; i<sg.n_cells(); ++i) cdata[i] = 0.5*i;
+		gw.AddCellData("cdata", cdata, tp == "bin");
+		vector<vector<double>> vvec(sg.n_vert(), vector<double>{1, 2, 3});
+		gw.AddVertexData("vvec", vvec, tp == "bin");
+		writer.write(fn);
+		writer.Free();
+	};
+	auto check_read = [&](std::string fn, size_t min_chunk)->bool{
+		HMXML::ReaderA reader(fn, "</HybMeshData>");
+		reader.min_parse_chunk = min_chunk;
+		HMXML::Reader gnode = reader.find_by_path("GRID3D[@name='g1']", true);
+		auto rd = HM3D::Import::ReadHMG(&reader, &gnode);
+		auto& r = *rd->result;
+		bool ret = r.vert().size() == sg.vert().size();
+		for (size_t i=0; i<sg.vert().size() && ret; ++i){
+			ret = fabs(r.vert()[i] - sg.vert()[i]) < 1e-14;
+		}
+		ret = ret && r.edge_vert() == sg.edge_vert() &&
+			r.face_edge() == sg.face_edge() && r.face_cell() == sg.face_cell();
+		ret = ret && rd->read_cells_vecfield<int>("__cell_faces__") == cell_face;
+		auto cdata = rd->read_cells_field<double>("cdata");
+		ret = ret && cdata.size() == sg.n_cells() && cdata.back() == 0.5*(sg.n_cells()-1);
+		auto vvec = rd->read_vertices_vecfield<double>("vvec");
+		ret = ret && vvec.size() == sg.n_vert() && vvec.back() == vector<double>{1, 2, 3};
+		reader.Free();
+		return ret;
+	};
+	write("g1.hmg", "bin", 1<<24);
+	add_check(check_read("g1.hmg", 1<<20), "read from mapped file");
+	//binary data is flushed to a temporary file after each field
+	write("g3.hmg", "bin", 0);
+	{
+		std::ifstream f1("g1.hmg", std::ios::binary), f3("g3.hmg", std::ios::binary);
+		std::string s1((std::istreambuf_iterator<char>(f1)), std::istreambuf_iterator<char>());
+		std::string s3((std::istreambuf_iterator<char>(f3)), std::istreambuf_iterator<char>());
+		add_check(s1.size() > 0 && s1 == s3, "streamed binary output");
+	}
+	write("g2.hmg", "ascii", 1<<24);
+	add_check(check_read("g2.hmg", 1<<20), "read ascii fields");
+	//ascii fields are split into many chunks parsed by several threads
+	HMParallel::SetNumThreads(4);
+	add_check(check_read("g2.hmg", 64), "read ascii fields by parallel chunks");
+	HMParallel::SetNumThreads(1);
+
+	//corrupted variable vector length is rejected before allocation
+	{
+		std::ofstream fs("g4.hmg");
+		fs<<"<HybMeshData><FIELD type=\"int\" dim=\"variable\" format=\"ascii\">"
+		    "2 1 2 2000000000 1 2</FIELD></HybMeshData>";
+	}
+	{
+		HMXML::ReaderA reader("g4.hmg", "</HybMeshData>");
+		HMXML::Reader fnode = reader.find_by_path("FIELD", true);
+		bool thrown = false;
+		try{
+			reader.read_num_content(fnode, 2);
+		} catch (std::runtime_error& e){
+			thrown = true;
+		}
+		add_check(thrown, "corrupted ascii vector length");
+		reader.Free();
+	}
+
+	//add data to the opened document and overwrite the mapped file
+	{
+		HMXML::ReaderA reader("g1.hmg", "</HybMeshData>");
+		HMXML::Reader gnode = reader.find_by_path("GRID3D[@name='g1']", true);
+		HMXML::Reader vnode = gnode.find_by_path("VERTICES", true);
+		HMXML::Reader fnode = vnode.new_child("FIELD");
+		fnode.new_attribute("name", "vdata");
+		reader.set_num_content(vector<int>(sg.n_vert(), 3), fnode, true);
+		reader.write("g1.hmg");
+		reader.Free();
+	}
+	HMXML::ReaderA reader("g1.hmg", "</HybMeshData>");
+	HMXML::Reader gnode = reader.find_by_path("GRID3D[@name='g1']", true);
+	auto rd = HM3D::Import::ReadHMG(&reader, &gnode);
+	add_check(check_read("g1.hmg", 1<<20) &&
+		rd->read_vertices_field<int>("vdata") == vector<int>(sg.n_vert(), 3),
+		"rewrite mapped file");
+	reader.Free();
+	NanSignalHandler::StartCheck();
+}
+
+void test13(){
+	std::cout<<"13. Binary vtk export"<<std::endl;
+	auto g2 = HM2D::Grid::Constructor::RegularHexagonal(Point(1, 1), 10., 2.);
+	auto g3 = HM3D::Grid::Constructor::SweepGrid2D(g2, {0., 1., 3., 5.});
+	HM3D::FlatGrid fg = HM3D::Flatten(g3);
+	vector<int> fvstart, fv;
+	HM3D::Flat::FaceVert(fg, fvstart, fv);
+	auto cells = HM3D::Export::vtkcell_expression::cell_assembler(fg, fvstart, fv);
+
+	auto readfile = [](std::string fn)->std::string{
+		std::ifstream f(fn, std::ios::binary);
+		return std::string((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+	};
+	//arrays of appended section in order of appearance
+	auto appended = [](const std::string& s)->vector<std::string>{
+		vector<std::string> ret;
+		size_t pos = s.find("<AppendedData encoding=\"raw\">\n_");
+		if (pos == std::string::npos) return ret;
+		pos = s.find('_', pos) + 1;
+		while (pos + sizeof(uint64_t) < s.size()){
+			uint64_t n;
+			memcpy(&n, &s[pos], sizeof(uint64_t));
+			pos += sizeof(uint64_t);
+			if (pos + n > s.size()) break;
+			ret.push_back(s.substr(pos, n));
+			pos += n;
+		}
+		return ret;
+	};
+	auto ints = [](const std::string& s)->vector<int>{
+		vector<int> ret(s.size()/sizeof(int));
+		if (ret.size() > 0) memcpy(&ret[0], s.data(), s.size());
+		return ret;
+	};
+
+	HM3D::Export::GridVTU.Silent(fg, "g1.vtu");
+	auto arr = appended(readfile("g1.vtu"));
+	bool good = arr.size() == 6;
+	if (good){
+		vector<double> pts(fg.vert.size());
+		memcpy(&pts[0], arr[0].data(), std::min(arr[0].size(), pts.size()*sizeof(double)));
+		vector<int> faces = ints(arr[4]), faceoffsets = ints(arr[5]);
+		vector<int> pfaces;
+		good = pts == fg.vert && arr[3].size() == cells.size() &&
+			faceoffsets.size() == cells.size();
+		for (size_t i=0; i<cells.size() && good; ++i){
+			good = (int)arr[3][i] == cells[i].celltype;
+			if (cells[i].celltype == 42){
+				pfaces.insert(pfaces.end(), cells[i].pts.begin(), cells[i].pts.end());
+				good = good && faceoffsets[i] == pfaces.size();
+			} else good = good && faceoffsets[i] == -1;
+		}
+		good = good && pfaces == faces && ints(arr[2]).back() == ints(arr[1]).size();
+	}
+	add_check(good, "polyhedral cells vtu");
+
+	//grid which is large enough to be split into parallel chunks
+	auto g2big = HM2D::Grid::Constructor::RegularHexagonal(Point(1, 1), 10., 0.3);
+	HM3D::FlatGrid fgbig = HM3D::Flatten(HM3D::Grid::Constructor::SweepGrid2D(g2big, {0., 1., 3., 5.}));
+	HM3D::Export::GridVTU.Silent(fgbig, "g1.vtu");
+	HMParallel::SetNumThreads(4);
+	int nchunks = HMParallel::NumChunks(fgbig.n_cells());
+	HM3D::Export::GridVTU.Silent(fgbig, "g2.vtu");
+	HMVtu::Options opt;
+	opt.npieces = 3;
+	HM3D::Export::GridVTU.Silent(g3, "g3.pvtu", opt);
+	HMParallel::SetNumThreads(1);
+	add_check(nchunks > 1 && readfile("g1.vtu") == readfile("g2.vtu"), "parallel vtu assembling");
+
+	std::string pv = readfile("g3.pvtu");
+	int nc = 0;
+	for (int i=0; i<3; ++i){
+		std::string fn = "g3_" + std::to_string(i) + ".vtu";
+		std::string s = readfile(fn);
+		size_t pos = s.find("NumberOfCells=\"");
+		if (pv.find(fn) == std::string::npos || pos == std::string::npos) break;
+		nc += std::stoi(s.substr(pos + 15));
+	}
+	add_check(nc == fg.n_cells(), "pvtu pieces");
+
+	if (HMVtu::HasCompression()){
+		opt.npieces = 1;
+		opt.compress = true;
+		HM3D::Export::GridVTU.Silent(fgbig, "g4.vtu", opt);
+		std::string s = readfile("g4.vtu");
+		add_check(s.find("vtkZLibDataCompressor") != std::string::npos &&
+			s.size() < readfile("g1.vtu").size(), "compressed vtu");
+	}
+}
+
+void test14(){
+	std::cout<<"14. tetgen unstructured meshing"<<std::endl;
+	HM3D::VertexData nopts;
+	vector<double> nosizes;
+	{
+		auto g1 = HM3D::Grid::Constructor::Cuboid({0, 0, 0}, 1, 1, 1, 5, 5, 5);
+		auto s1 = HM3D::Surface::Assembler::GridSurface(g1);
+		auto g2 = HM3D::Mesher::UnstructuredTetrahedral(s1, nopts, nosizes, "tetgen");
+		add_check(g2.vcells.size() > 0 && ISEQ(HM3D::SumVolumes(g2.vcells), 1),
+				"tetgen grid in cubic domain");
+		bool good = true;
+		for (auto& f: g2.vfaces) if (!f->has_left_cell()) good = false;
+		for (auto& c: g2.vcells) if (c->volume() <= 0) good = false;
+		add_check(good, "tetgen grid connectivity");
+	}
+	{
+		auto g1 = HM3D::Grid::Constructor::Cuboid({0, 0, 0}, 3, 3, 3, 6, 6, 6);
+		auto g2 = HM3D::Grid::Constructor::Cuboid({1, 1, 1}, 1, 1, 1, 4, 4, 4);
+		HM3D::FaceData srf;
+		for (auto f: g1.vfaces) if (f->is_boundary()) srf.push_back(f);
+		for (auto f: g2.vfaces) if (f->is_boundary()) srf.push_back(f);
+		auto res = HM3D::Mesher::UnstructuredTetrahedral(srf, nopts, nosizes, "tetgen");
+		add_check(ISEQ(HM3D::SumVolumes(res.vcells), 26), "tetgen multiply connected domain");
+	}
+	{
+		auto g1 = HM3D::Grid::Constructor::Cuboid({0, 0, 0}, 1, 1, 1, 3, 3, 3);
+		auto s1 = HM3D::Surface::Assembler::GridSurface(g1);
+		auto r1 = HM3D::Mesher::UnstructuredTetrahedral(s1, nopts, nosizes, "tetgen");
+		HM3D::VertexData pinner {std::make_shared<HM3D::Vertex>(0.5, 0.5, 0.5)};
+		vector<double> psizes {0.05};
+		auto r2 = HM3D::Mesher::UnstructuredTetrahedral(s1, pinner, psizes, "tetgen");
+		add_check(ISEQ(HM3D::SumVolumes(r2.vcells), 1) &&
+				r2.vcells.size() > 1.5*r1.vcells.size(), "tetgen internal size points");
+	}
+}
+
+void test15(){
+	std::cout<<"15. Table views against legacy tables"<<std::endl;
+	//view table as vector
+	auto view_tab = [](void* view, const char* what)->vector<double>{
+		int n;
+		void* data;
+		if (tab_view_get(view, what, &n, &data) != HMSUCCESS) return {};
+		if (std::string(what) == "vert" || std::string(what) == "cell_center"){
+			double* d = static_cast<double*>(data);
+			return vector<double>(d, d+n);
+		} else {
+			int* d = static_cast<int*>(data);
+			return vector<double>(d, d+n);
+		}
+	};
+	//legacy tables of known size
+	auto fixed_tab = [](int n, std::function<int(int*)> f)->vector<double>{
+		vector<int> r(n);
+		if (f(r.data()) != HMSUCCESS) return {};
+		return vector<double>(r.begin(), r.end());
+	};
+	auto fixed_dtab = [](int n, std::function<int(double*)> f)->vector<double>{
+		vector<double> r(n);
+		if (f(r.data()) != HMSUCCESS) return {};
+		return r;
+	};
+	//legacy tables allocated on c side
+	auto alloc_tab = [](std::function<int(int*, int**)> f)->vector<double>{
+		int n;
+		int* r;
+		if (f(&n, &r) != HMSUCCESS) return {};
+		vector<double> ret(r, r+n);
+		free_int_array(r);
+		return ret;
+	};
+
+	//2d grid with triangle, quadrangle and hexagonal cells
+	auto g2a = HM2D::Grid::Constructor::RegularHexagonal(Point(1, 1), 5., 1.);
+	auto g2b = HM2D::Grid::Constructor::Circle(Point(-20, -20), 3., 16, 4, true);
+	HM2D::GridData g2;
+	HM2D::Grid::Algos::ShallowAdd(g2a, g2);
+	HM2D::Grid::Algos::ShallowAdd(g2b, g2);
+	for (int i=0; i<g2.vedges.size(); ++i) if (g2.vedges[i]->is_boundary()) g2.vedges[i]->boundary_type = i % 3;
+	{
+		void* obj = &g2;
+		int d[3];
+		g2_dims(obj, d);
+		void* view;
+		add_check(g2_tab_view(obj, "vert edge_vert edge_cell cell_dim cell_vert "
+				"cell_edge cell_center bnd bt bnd_bt", &view) == HMSUCCESS, "2d table view");
+		bool ok = true;
+		ok = ok && view_tab(view, "vert") == fixed_dtab(2*d[0],
+			[&](double* r){ return g2_tab_vertices(obj, r); });
+		ok = ok && view_tab(view, "edge_vert") == fixed_tab(2*d[1],
+			[&](int* r){ return g2_tab_edgevert(obj, r); });
+		ok = ok && view_tab(view, "edge_cell") == fixed_tab(2*d[1],
+			[&](int* r){ return g2_tab_edgecell(obj, r); });
+		ok = ok && view_tab(view, "cell_dim") == fixed_tab(d[2],
+			[&](int* r){ return g2_tab_cellsizes(obj, r); });
+		ok = ok && view_tab(view, "cell_center") == fixed_dtab(2*d[2],
+			[&](double* r){ return g2_tab_centers(obj, r); });
+		ok = ok && view_tab(view, "bt") == fixed_tab(d[1],
+			[&](int* r){ return g2_tab_btypes(obj, r); });
+		ok = ok && view_tab(view, "cell_vert") == alloc_tab(
+			[&](int* n, int** r){ return g2_tab_cellvert(obj, n, r); });
+		ok = ok && view_tab(view, "cell_edge") == alloc_tab(
+			[&](int* n, int** r){ return g2_tab_celledge(obj, n, r); });
+		ok = ok && view_tab(view, "bnd") == alloc_tab(
+			[&](int* n, int** r){ return g2_tab_bedges(obj, n, r); });
+		ok = ok && view_tab(view, "bnd_bt") == alloc_tab(
+			[&](int* n, int** r){ return g2_tab_bndbt(obj, n, r); });
+		add_check(ok && view_tab(view, "cell_dim").size() == g2.vcells.size(),
+				"2d table view equals legacy tables");
+		free_tab_view(view);
+	}
+
+	//3d grid with prism and hexahedral cells
+	auto g3 = HM3D::Grid::Constructor::SweepGrid2D(g2, {0, 0.5, 1.5});
+	for (int i=0; i<g3.vfaces.size(); ++i) if (g3.vfaces[i]->is_boundary()) g3.vfaces[i]->boundary_type = i % 4;
+	{
+		void* obj = &g3;
+		int d[4];
+		g3_dims(obj, d);
+		void* view;
+		add_check(g3_tab_view(obj, "vert edge_vert face_dim face_edge face_vert face_cell "
+				"cell_fdim cell_vdim cell_face cell_vert bt bnd bnd_bt", &view) == HMSUCCESS,
+				"3d table view");
+		bool ok = true;
+		ok = ok && view_tab(view, "vert") == fixed_dtab(3*d[0],
+			[&](double* r){ return g3_tab_vertices(obj, r); });
+		ok = ok && view_tab(view, "edge_vert") == fixed_tab(2*d[1],
+			[&](int* r){ return g3_tab_edgevert(obj, r); });
+		ok = ok && view_tab(view, "face_dim") == fixed_tab(d[2],
+			[&](int* r){ return g3_tab_facedim(obj, r); });
+		ok = ok && view_tab(view, "face_cell") == fixed_tab(2*d[2],
+			[&](int* r){ return g3_tab_facecell(obj, r); });
+		ok = ok && view_tab(view, "bt") == fixed_tab(d[2],
+			[&](int* r){ return g3_tab_btypes(obj, r); });
+		ok = ok && view_tab(view, "cell_fdim") == fixed_tab(d[3],
+			[&](int* r){ return g3_tab_cellfdim(obj, r); });
+		ok = ok && view_tab(view, "cell_vdim") == fixed_tab(d[3],
+			[&](int* r){ return g3_tab_cellvdim(obj, r); });
+		ok = ok && view_tab(view, "face_edge") == alloc_tab(
+			[&](int* n, int** r){ return g3_tab_faceedge(obj, n, r); });
+		ok = ok && view_tab(view, "face_vert") == alloc_tab(
+			[&](int* n, int** r){ return g3_tab_facevert(obj, n, r); });
+		ok = ok && view_tab(view, "cell_face") == alloc_tab(
+			[&](int* n, int** r){ return g3_tab_cellface(obj, n, r); });
+		ok = ok && view_tab(view, "cell_vert") == alloc_tab(
+			[&](int* n, int** r){ return g3_tab_cellvert(obj, n, r); });
+		ok = ok && view_tab(view, "bnd") == alloc_tab(
+			[&](int* n, int** r){ return g3_tab_bnd(obj, n, r); });
+		ok = ok && view_tab(view, "bnd_bt") == alloc_tab(
+			[&](int* n, int** r){ return g3_tab_bndbt(obj, n, r); });
+		add_check(ok && view_tab(view, "cell_fdim").size() == g3.vcells.size(),
+				"3d table view equals legacy tables");
+		free_tab_view(view);
+	}
+}
+
+void test16(){
+	std::cout<<"16. Compact grid revolution export"<<std::endl;
+	//libxml2 initialization raises floating point exceptions
+	NanSignalHandler::StopCheck();
+	auto readfile = [](std::string fn)->std::string{
+		std::ifstream f(fn, std::ios::binary);
+		return std::string((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+	};
+	auto g2 = HM2D::Grid::Constructor::RectGrid(Point(0, 0), Point(2, 1), 4, 3);
+	for (size_t i=0; i<g2.vedges.size(); ++i) g2.vedges[i]->boundary_type = i % 3;
+	vector<double> phi {0, 90, 110, 180};
+	auto g3 = HM3D::Grid::Constructor::RevolveGrid2D(g2, phi, Point(0, 0), Point(0, 1), true, 5, 6);
+	auto f3 = HM3D::Grid::Constructor::RevolveFlatGrid2D(HM2D::Flatten(g2), phi,
+			Point(0, 0), Point(0, 1), true, 5, 6);
+	//volumes are computed on copies since volume calculation alters source grid data
+	add_check(f3.n_vert() == g3.vvert.size() && f3.n_edges() == g3.vedges.size() &&
+			f3.n_faces() == g3.vfaces.size() && f3.n_cells() == g3.vcells.size() &&
+			fabs(HM3D::SumVolumes(HM3D::Unflatten(f3).vcells) -
+			     HM3D::SumVolumes(HM3D::Unflatten(HM3D::Flatten(g3)).vcells)) < 1e-12,
+			"compact revolution");
+
+	HM3D::Export::GridMSH.Silent(g3, "g1.msh");
+	HM3D::Export::GridMSH.Silent(f3, "g2.msh");
+	add_check(readfile("g1.msh").size() > 0 && readfile("g1.msh") == readfile("g2.msh"),
+			"compact grid to fluent");
+	HM3D::Export::GridMSH.Silent(g3, "g1.msh", HM3D::Export::def_bfun,
+			HM3D::Export::PeriodicData(), true);
+	HM3D::Export::GridMSH.Silent(f3, "g2.msh", HM3D::Export::def_bfun,
+			HM3D::Export::PeriodicData(), true);
+	add_check(readfile("g1.msh") == readfile("g2.msh"), "compact grid to binary fluent");
+	HM3D::Export::GridGMSH.Silent(g3, "g1.msh");
+	HM3D::Export::GridGMSH.Silent(f3, "g2.msh");
+	add_check(readfile("g1.msh").size() > 0 && readfile("g1.msh") == readfile("g2.msh"),
+			"compact grid to gmsh");
+	HM3D::Export::GridTecplot.Silent(g3, "g1.dat");
+	HM3D::Export::GridTecplot.Silent(f3, "g2.dat");
+	add_check(readfile("g1.dat").size() > 0 && readfile("g1.dat") == readfile("g2.dat"),
+			"compact grid to tecplot");
+
+	auto write = [](HM3D::Export::GridWriter& gw, HMXML::ReaderA& writer, std::string fn){
+		gw.AddFaceVertexConnectivity();
+		gw.AddCellFaceConnectivity();
+		gw.AddCellVertexConnectivity();
+		gw.AddLinFemConnectivity();
+		writer.write(fn);
+	};
+	for (std::string tp: {"ascii", "bin"}){
+		HMXML::ReaderA w1 = HMXML::ReaderA::create("HybMeshData");
+		HM3D::Export::GridWriter gw1(g3, &w1, &w1, "g1", tp);
+		write(gw1, w1, "g1.hmg");
+		HMXML::ReaderA w2 = HMXML::ReaderA::create("HybMeshData");
+		HM3D::Export::GridWriter gw2(f3, &w2, &w2, "g1", tp);
+		write(gw2, w2, "g2.hmg");
+		add_check(readfile("g1.hmg").size() > 0 && readfile("g1.hmg") == readfile("g2.hmg"),
+				"compact grid to native format, " + tp);
+	}
+	NanSignalHandler::StartCheck();
+}
 
 int main(){
 	test01();
@@ -531,6 +993,12 @@ int main(){
 	test08();
 	test09();
 	test10();
+	test11();
+	test12();
+	test13();
+	test14();
+	test15();
+	test16();
 	
 	check_final_report();
 	std::cout<<"DONE"<<std::endl;
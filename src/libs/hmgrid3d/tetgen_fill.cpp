@@ -0,0 +1,250 @@
+#include "tetgen_fill.hpp"
+#include "tetramesh_preproc.hpp"
+#include <limits>
+#define TETLIBRARY
+#include "tetgen.h"
+using namespace HM3D::Mesher;
+using namespace HM3D;
+
+namespace{
+
+typedef std::array<int, 3> TriKey;
+TriKey tri_key(int a, int b, int c){
+	TriKey ret {a, b, c};
+	std::sort(ret.begin(), ret.end());
+	return ret;
+}
+
+//vertices of tetrahedron face opposite to given corner.
+//Order is taken from gmsh element convention:
+//for positive tetrahedron face left normal looks inside.
+const int face_corners[4][3] = {{1, 2, 3}, {0, 3, 2}, {0, 1, 3}, {0, 2, 1}};
+
+//boundary vertices are followed by internal points
+void fill_tetgen_input(const SurfacePreprocess& presurf,
+		const VertexData& pinner, const vector<double>& psizes,
+		tetgenio& in, vector<TriKey>& surftri){
+	if (psizes.size() != pinner.size())
+		throw std::runtime_error("Sizes should be given for all internal points");
+	int nsurf = presurf.av.size();
+	in.firstnumber = 0;
+	in.numberofpoints = nsurf + pinner.size();
+	in.pointlist = new REAL[3*in.numberofpoints];
+	in.numberofpointmtrs = 1;
+	in.pointmtrlist = new REAL[in.numberofpoints];
+	for (int i=0; i<in.numberofpoints; ++i){
+		auto& v = (i < nsurf) ? *presurf.av[i] : *pinner[i-nsurf];
+		in.pointlist[3*i] = v.x;
+		in.pointlist[3*i+1] = v.y;
+		in.pointlist[3*i+2] = v.z;
+		in.pointmtrlist[i] = (i < nsurf) ? std::numeric_limits<double>::max()
+		                                 : psizes[i-nsurf];
+	}
+	//size at boundary vertex is the minimum adjacent edge length
+	for (auto& e: presurf.ae){
+		double len = e->length();
+		for (auto& v: e->vertices){
+			double& m = in.pointmtrlist[v->id];
+			if (len < m) m = len;
+		}
+	}
+
+	int nf = 0;
+	for (auto& ds: presurf.decomposed_surfs)
+	for (auto& s: ds) nf += s.size();
+	in.numberoffacets = nf;
+	in.facetlist = new tetgenio::facet[nf];
+	surftri.reserve(nf);
+	int k = 0;
+	for (auto& ds: presurf.decomposed_surfs)
+	for (auto& s: ds)
+	for (auto& f: s){
+		auto sv = f->sorted_vertices();
+		if (sv.size() != 3) throw std::runtime_error(
+			"Only triangle surface faces are allowed for tetgen mesher");
+		tetgenio::facet& tf = in.facetlist[k++];
+		tetgenio::init(&tf);
+		tf.numberofpolygons = 1;
+		tf.polygonlist = new tetgenio::polygon[1];
+		tetgenio::init(tf.polygonlist);
+		tf.polygonlist[0].numberofvertices = 3;
+		tf.polygonlist[0].vertexlist = new int[3];
+		for (int j=0; j<3; ++j) tf.polygonlist[0].vertexlist[j] = sv[j]->id;
+		surftri.push_back(tri_key(sv[0]->id, sv[1]->id, sv[2]->id));
+	}
+	std::sort(surftri.begin(), surftri.end());
+}
+
+//builds grid out of tetgen output.
+//Tetrahedra inside inner surfaces are dropped.
+//Returns vertices which correspond to first nsurf tetgen input points
+VertexData grid_from_tetgen(const tetgenio& out, const vector<TriKey>& surftri,
+		int nsurf, GridData& ret){
+	ret.clear();
+	int nt = out.numberoftetrahedra;
+	const int* tet = out.tetrahedronlist;
+	const REAL* pts = out.pointlist;
+	if (nt == 0 || out.numberofcorners != 4)
+		throw std::runtime_error("Tetrahedral meshing failed");
+
+	//neighbours by opposite corner. Tetgen neighbour order is not relied upon.
+	vector<int> nbc(4*nt, -1);
+	for (int t=0; t<nt; ++t){
+		const int* tv = tet + 4*t;
+		for (int j=0; j<4; ++j){
+			int n = out.neighborlist[4*t+j];
+			if (n < 0) continue;
+			const int* nv = tet + 4*n;
+			for (int c=0; c<4; ++c)
+			if (tv[c] != nv[0] && tv[c] != nv[1] && tv[c] != nv[2] && tv[c] != nv[3]){
+				nbc[4*t+c] = n;
+				break;
+			}
+		}
+	}
+	auto is_surface = [&](int t, int c)->bool{
+		const int* tv = tet + 4*t;
+		const int* fc = face_corners[c];
+		return std::binary_search(surftri.begin(), surftri.end(),
+				tri_key(tv[fc[0]], tv[fc[1]], tv[fc[2]]));
+	};
+
+	//domain tetrahedra: flood from outer hull through non surface faces.
+	//Exterior ones have already been removed by tetgen,
+	//areas inside level 1 surfaces are not reachable.
+	vector<char> keep(nt, 0);
+	vector<int> stack;
+	for (int t=0; t<nt; ++t)
+	for (int c=0; c<4; ++c) if (nbc[4*t+c] < 0){
+		keep[t] = 1;
+		stack.push_back(t);
+		break;
+	}
+	while (stack.size() > 0){
+		int t = stack.back(); stack.pop_back();
+		for (int c=0; c<4; ++c){
+			int n = nbc[4*t+c];
+			if (n < 0 || keep[n] || is_surface(t, c)) continue;
+			keep[n] = 1;
+			stack.push_back(n);
+		}
+	}
+
+	//cells with positive corners order
+	vector<int> cind(nt, -1);
+	vector<std::array<int, 4>> ctet;
+	vector<int> vind(out.numberofpoints, -1);
+	for (int t=0; t<nt; ++t) if (keep[t]){
+		cind[t] = ctet.size();
+		std::array<int, 4> tv {tet[4*t], tet[4*t+1], tet[4*t+2], tet[4*t+3]};
+		auto p = [&](int i){ return Point3(pts[3*tv[i]], pts[3*tv[i]+1], pts[3*tv[i]+2]); };
+		if (tetrahedron_volume(p(0), p(1), p(2), p(3)) < 0){
+			std::swap(tv[1], tv[2]);
+			std::swap(nbc[4*t+1], nbc[4*t+2]);
+		}
+		ctet.push_back(tv);
+		for (int i=0; i<4; ++i) vind[tv[i]] = 0;
+	}
+	//vertices in tetgen order, so boundary vertices come first
+	for (int i=0; i<out.numberofpoints; ++i) if (vind[i] == 0){
+		vind[i] = ret.vvert.size();
+		ret.vvert.emplace_back(new HM3D::Vertex(pts[3*i], pts[3*i+1], pts[3*i+2]));
+	}
+	VertexData bvert(nsurf);
+	for (int i=0; i<nsurf; ++i){
+		if (vind[i] < 0) throw std::runtime_error("Tetrahedral meshing failed");
+		bvert[i] = ret.vvert[vind[i]];
+	}
+
+	//edges: sorted unique vertex pairs
+	vector<std::pair<int, int>> ekeys;
+	ekeys.reserve(6*ctet.size());
+	for (auto& tv: ctet)
+	for (int i=0; i<4; ++i)
+	for (int j=i+1; j<4; ++j){
+		int a = vind[tv[i]], b = vind[tv[j]];
+		ekeys.push_back(a<b ? std::make_pair(a, b) : std::make_pair(b, a));
+	}
+	std::sort(ekeys.begin(), ekeys.end());
+	ekeys.resize(std::unique(ekeys.begin(), ekeys.end()) - ekeys.begin());
+	ret.vedges.reserve(ekeys.size());
+	for (auto& k: ekeys){
+		ret.vedges.emplace_back(new HM3D::Edge(ret.vvert[k.first], ret.vvert[k.second]));
+	}
+	auto find_edge = [&](int a, int b)->shared_ptr<HM3D::Edge>&{
+		auto k = a<b ? std::make_pair(a, b) : std::make_pair(b, a);
+		return ret.vedges[std::lower_bound(ekeys.begin(), ekeys.end(), k) - ekeys.begin()];
+	};
+
+	//faces: each inner face is built by the lower indexed cell
+	ret.vcells.resize(ctet.size());
+	for (auto& c: ret.vcells) c.reset(new HM3D::Cell());
+	for (int t=0; t<nt; ++t) if (keep[t]){
+		int ic = cind[t];
+		auto& tv = ctet[ic];
+		for (int c=0; c<4; ++c){
+			int n = nbc[4*t+c];
+			if (n >= 0 && !keep[n]) n = -1;
+			if (n >= 0 && n < t) continue;
+			auto f = std::make_shared<HM3D::Face>();
+			const int* fc = face_corners[c];
+			for (int i=0; i<3; ++i){
+				int a = vind[tv[fc[i]]], b = vind[tv[fc[(i+1)%3]]];
+				f->edges.push_back(find_edge(a, b));
+			}
+			f->left = ret.vcells[ic];
+			ret.vcells[ic]->faces.push_back(f);
+			if (n >= 0){
+				f->right = ret.vcells[cind[n]];
+				ret.vcells[cind[n]]->faces.push_back(f);
+			}
+			ret.vfaces.push_back(f);
+		}
+	}
+	return bvert;
+}
+
+}
+
+HM3D::GridData HM3D::Mesher::TetgenFill(const Surface::Tree& tree,
+		const VertexData& pinner, const vector<double>& psizes,
+		HMCallback::Caller2& cb){
+	//decomposition
+	cb.step_after(10, "Boundary preprocessing");
+	SurfacePreprocess presurf(tree, 30);
+	//if whole area is meshed with pyramids
+	if (presurf.decomposed_surfs.size() == 0){
+		cb.fin();
+		return presurf.bnd_grid;
+	}
+
+	cb.step_after(5, "Fill tetgen input");
+	aa::enumerate_ids_pvec(presurf.av);
+	tetgenio in, out;
+	vector<TriKey> surftri;
+	fill_tetgen_input(presurf, pinner, psizes, in, surftri);
+	//p - piecewise linear complex, Y - keep boundary, q - quality,
+	//m - sizes from metric, n - neighbours, z - zero based indexing,
+	//J - keep input points numbering, Q - quiet.
+	//Internal points are passed as isolated complex vertices
+	//since points added by 'i' switch are rejected near sized boundary vertices.
+	char sw[] = "pYqmnzJQ";
+
+	cb.step_after(50, "Build 3D mesh");
+	try{
+		tetrahedralize(sw, &in, &out);
+	} catch (int code){
+		throw std::runtime_error("TetGen meshing failed with code " + std::to_string(code));
+	}
+
+	cb.step_after(25, "Assemble mesh");
+	HM3D::GridData ret;
+	VertexData bvert = grid_from_tetgen(out, surftri, presurf.av.size(), ret);
+
+	//restore boundary types from tree
+	cb.step_after(10, "Restore boundary");
+	presurf.Restore(ret, bvert, presurf.av);
+
+	cb.fin();
+	return ret;
+}
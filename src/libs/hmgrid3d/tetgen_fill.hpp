@@ -0,0 +1,21 @@
+#ifndef HMGRID3D_TETGEN_FILL_HPP
+#define HMGRID3D_TETGEN_FILL_HPP
+
+#include "hmcallback.hpp"
+#include "surface_tree.hpp"
+
+namespace HM3D{ namespace Mesher{
+
+//Fills tree (root with level 1 children) using TetGen library.
+//Triangulated boundary is passed to tetgenio arrays directly and resulting
+//grid is assembled from tetgen output arrays without intermediate structures.
+//Boundary triangulation is preserved (no steiner points on surfaces).
+//Sizes at boundary vertices equal minimum adjacent edge length,
+//pinner points with psizes are added as isolated vertices with given sizes.
+GridData TetgenFill(const Surface::Tree& tree,
+		const VertexData& pinner, const vector<double>& psizes,
+		HMCallback::Caller2& cb);
+
+}}
+
+#endif
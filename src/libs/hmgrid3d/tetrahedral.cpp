@@ -12,6 +12,8 @@
 #include "debug3d.hpp"
 #include "treverter3d.hpp"
 #include "nodes_compare.h"
+#include "hmgmsh.hpp"
+#include "tetgen_fill.hpp"
 using namespace HM3D::Mesher;
 using namespace HM3D;
 
@@ -231,13 +233,13 @@ vector<vector<GEdge*>> fill_model_with_1d(
 	return ret;
 }
 
-void fill_model_with_3d(GModel& m, const vector<vector<GFace*>>& fc){
+void fill_model_with_3d(GModel& m, const vector<vector<GFace*>>& fc, HMGmsh::Context& ctx){
 	//Mesh3D
 	auto volume = m.addVolume(fc);
 	//m.writeGEO("gmsh_geo.geo");
 	//m.writeMSH("gmsh_geo.msh");
 	auto bb = m.bounds();
-	GmshSetBoundingBox(bb.min()[0], bb.max()[0], bb.min()[1], bb.max()[1], bb.min()[2], bb.max()[2]);
+	ctx.set_bounding_box(bb.min()[0], bb.max()[0], bb.min()[1], bb.max()[1], bb.min()[2], bb.max()[2]);
 	NanSignalHandler::StopCheck();
 	m.mesh(3);
 	NanSignalHandler::StartCheck();
@@ -298,11 +300,12 @@ void equal_vertices(const HM3D::GridData& grid, GFace* gf, const FaceData& surf,
 HM3D::GridData gmsh_fill(const Surface::Tree& tree, const FaceData& cond,
 		const HM3D::VertexData& pcond, const vector<double>& psizes,
 		HMCallback::Caller2& cb){
+	HMGmsh::Context ctx;
 	GModel m;
 	m.setFactory("Gmsh");
-	GmshSetOption("General", "Verbosity", 0.0);
-	GmshSetOption("Mesh", "Optimize", 1.0);
-	//GmshSetOption("Mesh", "OptimizeNetgen", 1.0);
+	ctx.set_option("General", "Verbosity", 0.0);
+	ctx.set_option("Mesh", "Optimize", 1.0);
+	//ctx.set_option("Mesh", "OptimizeNetgen", 1.0);
 	
 	//decomposition
 	cb.step_after(10, "Boundary preprocessing");
@@ -342,7 +345,7 @@ HM3D::GridData gmsh_fill(const Surface::Tree& tree, const FaceData& cond,
 
 	//mesh3d
 	cb.step_after(35, "Build 3D mesh");
-	fill_model_with_3d(m, g_faces);
+	fill_model_with_3d(m, g_faces, ctx);
 
 	HM3D::GridData ret;
 	cb.step_after(30, "Assemble mesh");
@@ -374,13 +377,22 @@ HM3D::GridData gmsh_fill(const Surface::Tree& tree, const FaceData& cond,
 	cb.fin();
 	return ret;
 }
+HM3D::GridData gmsh_fill_tree(const Surface::Tree& tree,
+		const HM3D::VertexData& pcond, const vector<double>& psizes,
+		HMCallback::Caller2& cb){
+	return gmsh_fill(tree, FaceData(), pcond, psizes, cb);
+}
 };
 
 HMCallback::FunctionWithCallback<TUnstructuredTetrahedral> HM3D::Mesher::UnstructuredTetrahedral;
 
 HM3D::GridData TUnstructuredTetrahedral::_run(const FaceData& source,
 		const FaceData& sinner,
-		const VertexData& pinner, const vector<double>& psizes){
+		const VertexData& pinner, const vector<double>& psizes,
+		std::string algo){
+	if (algo != "gmsh" && algo != "tetgen")
+		throw std::runtime_error("unknown tetrahedral mesher " + algo);
+	auto filler = (algo == "tetgen") ? &TetgenFill : &gmsh_fill_tree;
 	callback->step_after(20, "Surfaces nesting");
 	//main tree
 	Surface::Tree stree = Surface::Tree::Assemble(source);
@@ -404,9 +416,9 @@ HM3D::GridData TUnstructuredTetrahedral::_run(const FaceData& source,
 	HM3D::GridData ret;
 	for (int i=0; i<trees.size(); ++i){
 		auto cb = callback->subrange(75./trees.size(), 100.);
-		if (i == 0) ret = gmsh_fill(trees[i], cond, pinner, psizes, *cb);
+		if (i == 0) ret = filler(trees[i], pinner, psizes, *cb);
 		else {
-			HM3D::GridData sg = gmsh_fill(trees[i], cond, pinner, psizes, *cb);
+			HM3D::GridData sg = filler(trees[i], pinner, psizes, *cb);
 			std::copy(sg.vvert.begin(), sg.vvert.end(), std::back_inserter(ret.vvert));
 			std::copy(sg.vedges.begin(), sg.vedges.end(), std::back_inserter(ret.vedges));
 			std::copy(sg.vfaces.begin(), sg.vfaces.end(), std::back_inserter(ret.vfaces));
@@ -443,3 +455,7 @@ HM3D::GridData TUnstructuredTetrahedral::_run(const FaceData& source,
 		const VertexData& pinner, const vector<double>& psizes){
 	return _run(source, FaceData(), pinner, psizes);
 }
+HM3D::GridData TUnstructuredTetrahedral::_run(const FaceData& source,
+		const VertexData& pinner, const vector<double>& psizes, std::string algo){
+	return _run(source, FaceData(), pinner, psizes, algo);
+}
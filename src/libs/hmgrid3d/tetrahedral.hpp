@@ -10,13 +10,17 @@ struct TUnstructuredTetrahedral: public HMCallback::ExecutorBase{
 	HMCB_SET_PROCNAME("Tetrahedral meshing");
 	HMCB_SET_DEFAULT_DURATION(100);
 
+	//algo: "gmsh" or "tetgen"
 	GridData _run(const FaceData& source, const FaceData& sinner,
-			const VertexData& pinner, const vector<double>& psizes);
+			const VertexData& pinner, const vector<double>& psizes,
+			std::string algo="gmsh");
 
 	GridData _run(const FaceData& source);
 	GridData _run(const FaceData& source, const FaceData& sinner);
 	GridData _run(const FaceData& source, const VertexData& pinner,
 			const vector<double>& psizes);
+	GridData _run(const FaceData& source, const VertexData& pinner,
+			const vector<double>& psizes, std::string algo);
 };
 extern HMCallback::FunctionWithCallback<TUnstructuredTetrahedral> UnstructuredTetrahedral;
 
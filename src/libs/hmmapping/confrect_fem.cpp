@@ -16,8 +16,8 @@ namespace{
 
 double IntegralGrad2(const HM2D::GridData* grid, const vector<double>& v){
 	using namespace HMFem;
-	shared_ptr<HMMath::Mat> ddx = Assemble::DDx(*grid);
-	shared_ptr<HMMath::Mat> ddy = Assemble::DDy(*grid);
+	shared_ptr<HMMath::CsrMat> ddx = Assemble::DDx(*grid);
+	shared_ptr<HMMath::CsrMat> ddy = Assemble::DDy(*grid);
 	vector<double> vdx(ddx->rows()), vdy(ddx->rows()), mass = Assemble::LumpMass(*grid);
 	ddx->MultVec(v, vdx); 
 	ddy->MultVec(v, vdy);
@@ -32,8 +32,8 @@ double IntegralGrad2(const HM2D::GridData* grid, const vector<double>& v){
 void GradVectors(const HM2D::GridData* grid, const vector<double>& v,
 		vector<double>& dx, vector<double>& dy){
 	using namespace HMFem;
-	shared_ptr<HMMath::Mat> ddx = Assemble::DDx(*grid);
-	shared_ptr<HMMath::Mat> ddy = Assemble::DDy(*grid);
+	shared_ptr<HMMath::CsrMat> ddx = Assemble::DDx(*grid);
+	shared_ptr<HMMath::CsrMat> ddy = Assemble::DDy(*grid);
 	vector<double> mass = Assemble::LumpMass(*grid);
 	dx.resize(grid->vvert.size()); dy.resize(grid->vvert.size());
 	ddx->MultVec(v, dx); 
@@ -152,22 +152,18 @@ void ToRect::TBuild::BuildInverse(ToRect& r){
 }
 
 vector<Point> ToRect::MapToPolygon(const vector<Point>& input) const{
-	vector<Point> ret;
+	vector<Point> ret(input.size());
 	vector<const vector<double>*> funs {&inv_u, &inv_v};
-	for (auto& p: input){
-		auto s = inv_approx->Vals(p, funs);
-		ret.push_back(Point(s[0], s[1]));
-	}
+	auto s = inv_approx->Vals(inv_approx->Locate(input), funs);
+	for (int i=0; i<ret.size(); ++i) ret[i].set(s[0][i], s[1][i]);
 	return ret;
 }
 
 vector<Point> ToRect::MapToRectangle(const vector<Point>& input) const{
-	vector<Point> ret;
+	vector<Point> ret(input.size());
 	vector<const vector<double>*> funs {&u, &v};
-	for (auto& p: input){
-		auto s = approx->Vals(p, funs);
-		ret.push_back(Point(s[0], s[1]));
-	}
+	auto s = approx->Vals(approx->Locate(input), funs);
+	for (int i=0; i<ret.size(); ++i) ret[i].set(s[0][i], s[1][i]);
 	return ret;
 }
 
@@ -268,9 +264,10 @@ HM2D::CellData get_inside_cells(const HM2D::CellData& cd, const BoundingBox& bb)
 
 HM2D::EdgeData get_eline(const HM2D::EdgeData& from, const HM2D::EdgeData& what){
 	HM2D::EdgeData ret;
-	auto bb = HM2D::BBox(from);
-	BoundingBoxFinder finder(bb, bb.maxlen()/30);
-	for (auto e: what) finder.addentry(BoundingBox(*e->pfirst(), *e->plast()));
+	vector<BoundingBox> ebb;
+	ebb.reserve(what.size());
+	for (auto e: what) ebb.push_back(BoundingBox(*e->pfirst(), *e->plast()));
+	BoundingBoxTree finder(ebb);
 	for (auto e: from){
 		BoundingBox bb1(*e->pfirst(), *e->plast());
 		for (auto isus: finder.suspects(bb1)){
@@ -501,36 +498,41 @@ vector<Point> ToAnnulus::OuterCirclePoints() const{
 }
 
 vector<Point> ToAnnulus::MapToAnnulus(const vector<Point>& input) const{
-	vector<Point> ret;
+	vector<Point> ret(input.size());
 	vector<const vector<double>*> funs {&u, &v};
-	for (auto& p: input){
-		auto s = approx->Vals(p, funs);
-		double x = s[0]*cos(s[1]);
-		double y = s[0]*sin(s[1]);
-		ret.push_back(Point(x, y));
+	auto s = approx->Vals(approx->Locate(input), funs);
+	for (int i=0; i<ret.size(); ++i){
+		ret[i].set(s[0][i]*cos(s[1][i]), s[0][i]*sin(s[1][i]));
 	}
 	return ret;
 }
 
 vector<Point> ToAnnulus::MapToOriginal(const vector<Point>& input) const{
-	vector<Point> ret;
+	vector<Point> ret(input.size());
 	vector<const vector<double>*> funs {&inv_u, &inv_v};
-	vector<double> s(2);
-	for (auto& p: input){
-		try{
-			s = inv_approx->Vals(p, funs);
-		} catch (HMFem::Grid43::Approximator::EOutOfArea& e){
-			//if point was not found due to circle geom. approximation error
-			//project point to inv_grid boundary and try again
-			double rad = vecLen(p);
-			Point pnew;
-			if (fabs(rad-1.0)<geps || fabs(rad-_module)<geps){
-				pnew = HM2D::Finder::ClosestEPoint(*InvGridContour(), p);
-				s = inv_approx->Vals(pnew, funs);
-			} else throw;
+	auto loc = inv_approx->Locate(input);
+	//if point was not found due to circle geom. approximation error
+	//project point to inv_grid boundary and try again
+	vector<int> lost;
+	vector<Point> pnew;
+	for (int i=0; i<input.size(); ++i) if (loc.cell[i] < 0){
+		auto& p = input[i];
+		double rad = vecLen(p);
+		if (fabs(rad-1.0)<geps || fabs(rad-_module)<geps){
+			lost.push_back(i);
+			pnew.push_back(HM2D::Finder::ClosestEPoint(*InvGridContour(), p));
+		} else throw HMFem::Grid43::Approximator::EOutOfArea();
+	}
+	if (lost.size() > 0){
+		auto loc2 = inv_approx->Locate(pnew);
+		for (int k=0; k<lost.size(); ++k){
+			loc.cell[lost[k]] = loc2.cell[k];
+			loc.ksi[lost[k]] = loc2.ksi[k];
+			loc.eta[lost[k]] = loc2.eta[k];
 		}
-		ret.push_back(Point(s[0], s[1]));
 	}
+	auto s = inv_approx->Vals(loc, funs);
+	for (int i=0; i<ret.size(); ++i) ret[i].set(s[0][i], s[1][i]);
 	return ret;
 }
 
@@ -49,16 +49,21 @@ HM2D::GridData DoMapping::run(HMCallback::Caller2& cb){
 	for (auto p: bp) is_boundary[p->id] = true;
 	auto approx = std::make_shared<HMFem::Grid43::Approximator>(g3.get());
 	//do mappings
+	vector<int> inner;
+	vector<Point> inner_pts;
 	for (int i=0; i<ret.vvert.size(); ++i){
 		HM2D::Vertex* p = ret.vvert[i].get();
 		if (is_boundary[i]){
 			p->set(mcol.map_from_base(*p));
 		} else {
-			double x = approx->Val(*p, u);
-			double y = approx->Val(*p, v);
-			p->set(x, y);
+			inner.push_back(i);
+			inner_pts.push_back(*p);
 		}
 	}
+	auto s = approx->Vals(approx->Locate(inner_pts), {&u, &v});
+	for (int k=0; k<inner.size(); ++k){
+		ret.vvert[inner[k]]->set(s[0][k], s[1][k]);
+	}
 
 	cb.step_after(5, "Check grid");
 	if (mcol.is_reversed()){
@@ -0,0 +1,322 @@
+#include "hmatrix.hpp"
+#include "hmparallel.hpp"
+#include <numeric>
+#include <limits>
+
+using namespace HMMath;
+
+// ===================== clusters
+double HMatrix::Cluster::diam() const{
+	return sqrt((x1-x0)*(x1-x0) + (y1-y0)*(y1-y0));
+}
+
+double HMatrix::Cluster::dist(const Cluster& o) const{
+	double dx = std::max(0.0, std::max(x0 - o.x1, o.x0 - x1));
+	double dy = std::max(0.0, std::max(y0 - o.y1, o.y0 - y1));
+	return sqrt(dx*dx + dy*dy);
+}
+
+void HMatrix::build_clusters(const vector<double>& box, int leaf,
+		vector<Cluster>& clust, vector<int>& perm){
+	int n = box.size()/4;
+	perm.resize(n);
+	std::iota(perm.begin(), perm.end(), 0);
+	clust.clear();
+	if (n == 0) return;
+	clust.push_back(Cluster{0, n, 0, 0, 0, 0, {-1, -1}});
+	//clusters are processed in the order of their creation,
+	//children are appended to the end of the list
+	for (size_t ic=0; ic<clust.size(); ++ic){
+		int b = clust[ic].begin, e = clust[ic].end;
+		double x0, y0, x1, y1, cx0, cy0, cx1, cy1;
+		x0 = y0 = cx0 = cy0 = std::numeric_limits<double>::max();
+		x1 = y1 = cx1 = cy1 = -std::numeric_limits<double>::max();
+		for (int k=b; k<e; ++k){
+			const double* bx = &box[4*perm[k]];
+			x0 = std::min(x0, bx[0]); y0 = std::min(y0, bx[1]);
+			x1 = std::max(x1, bx[2]); y1 = std::max(y1, bx[3]);
+			double cx = (bx[0]+bx[2])/2.0, cy = (bx[1]+bx[3])/2.0;
+			cx0 = std::min(cx0, cx); cy0 = std::min(cy0, cy);
+			cx1 = std::max(cx1, cx); cy1 = std::max(cy1, cy);
+		}
+		clust[ic].x0 = x0; clust[ic].y0 = y0;
+		clust[ic].x1 = x1; clust[ic].y1 = y1;
+		if (e - b <= leaf) continue;
+
+		//median split across the longest extent of box centers
+		int dim = (cx1 - cx0 >= cy1 - cy0) ? 0 : 1;
+		int mid = (b + e)/2;
+		std::nth_element(perm.begin()+b, perm.begin()+mid, perm.begin()+e,
+			[&box, dim](int i, int j){
+				return box[4*i+dim] + box[4*i+dim+2] < box[4*j+dim] + box[4*j+dim+2];
+			});
+		clust[ic].child[0] = clust.size();
+		clust[ic].child[1] = clust.size()+1;
+		clust.push_back(Cluster{b, mid, 0, 0, 0, 0, {-1, -1}});
+		clust.push_back(Cluster{mid, e, 0, 0, 0, 0, {-1, -1}});
+	}
+}
+
+// ===================== blocks
+void HMatrix::build_blocks(int r, int c){
+	const Cluster& R = rclust[r];
+	const Cluster& C = cclust[c];
+	double d = R.dist(C);
+	bool rleaf = R.child[0] < 0, cleaf = C.child[0] < 0;
+	if (d > 0 && std::min(R.diam(), C.diam()) <= opt.eta*d){
+		blocks.push_back(Block{r, c, 0, {}, {}});
+	} else if (rleaf && cleaf){
+		blocks.push_back(Block{r, c, -1, {}, {}});
+	} else if (rleaf){
+		build_blocks(r, C.child[0]);
+		build_blocks(r, C.child[1]);
+	} else if (cleaf){
+		build_blocks(R.child[0], c);
+		build_blocks(R.child[1], c);
+	} else {
+		for (int i=0; i<2; ++i)
+		for (int j=0; j<2; ++j) build_blocks(R.child[i], C.child[j]);
+	}
+}
+
+void HMatrix::fill_block(Block& b, const TEntry& entry) const{
+	if (b.rank == 0 && fill_aca(b, entry)) return;
+	const Cluster& R = rclust[b.row];
+	const Cluster& C = cclust[b.col];
+	int m = R.size(), n = C.size();
+	b.rank = -1;
+	b.a.resize(m*n);
+	b.b.clear();
+	auto it = b.a.begin();
+	for (int i=0; i<m; ++i)
+	for (int j=0; j<n; ++j){
+		*it++ = entry(rperm[R.begin+i], cperm[C.begin+j]);
+	}
+}
+
+//adaptive cross approximation with partial pivoting.
+//Returns false if approximation is not cheaper than dense storage.
+bool HMatrix::fill_aca(Block& b, const TEntry& entry) const{
+	const Cluster& R = rclust[b.row];
+	const Cluster& C = cclust[b.col];
+	int m = R.size(), n = C.size();
+	const int* rp = &rperm[R.begin];
+	const int* cp = &cperm[C.begin];
+	int kmax = (m*n)/(m+n);
+	if (kmax < 1) return false;
+
+	vector<double>& U = b.a;
+	vector<double>& V = b.b;
+	U.clear(); V.clear();
+	vector<bool> used(m, false);
+	vector<double> row(n), col(m);
+	double norm2 = 0, maxabs = 0;
+	int k = 0, i = 0, nref = 0;
+	bool converged = false;
+	while (k < kmax){
+		used[i] = true;
+		int jp = 0;
+		for (int j=0; j<n; ++j){
+			double v = entry(rp[i], cp[j]);
+			maxabs = std::max(maxabs, fabs(v));
+			for (int l=0; l<k; ++l) v -= U[l*m+i]*V[l*n+j];
+			row[j] = v;
+			if (fabs(v) > fabs(row[jp])) jp = j;
+		}
+		if (fabs(row[jp]) <= 1e-14*maxabs){
+			//Row is already approximated. Pivot search continues from the largest entry
+			//of a reference column. If it is also approximated the block is assumed to be done.
+			//This prevents full evaluation of zero blocks.
+			int jref = (n/2 + nref++*(n/3+1)) % n;
+			i = -1;
+			for (int ii=0; ii<m; ++ii) if (!used[ii]){
+				double v = entry(rp[ii], cp[jref]);
+				maxabs = std::max(maxabs, fabs(v));
+				for (int l=0; l<k; ++l) v -= U[l*m+ii]*V[l*n+jref];
+				col[ii] = v;
+				if (i < 0 || fabs(v) > fabs(col[i])) i = ii;
+			}
+			if (i < 0 || fabs(col[i]) <= 1e-14*maxabs) { converged = true; break; }
+			continue;
+		}
+		double piv = row[jp];
+		for (auto& v: row) v /= piv;
+		for (int ii=0; ii<m; ++ii){
+			double v = entry(rp[ii], cp[jp]);
+			for (int l=0; l<k; ++l) v -= U[l*m+ii]*V[l*n+jp];
+			col[ii] = v;
+		}
+		double nu2 = std::inner_product(col.begin(), col.end(), col.begin(), 0.0);
+		double nv2 = std::inner_product(row.begin(), row.end(), row.begin(), 0.0);
+		double cross = 0;
+		for (int l=0; l<k; ++l){
+			cross += std::inner_product(col.begin(), col.end(), U.begin()+l*m, 0.0)*
+			         std::inner_product(row.begin(), row.end(), V.begin()+l*n, 0.0);
+		}
+		norm2 += nu2*nv2 + 2.0*cross;
+		U.insert(U.end(), col.begin(), col.end());
+		V.insert(V.end(), row.begin(), row.end());
+		++k;
+		if (nu2*nv2 <= opt.eps*opt.eps*norm2) { converged = true; break; }
+
+		//next pivot row: largest entry of the last column
+		i = -1;
+		for (int ii=0; ii<m; ++ii) if (!used[ii]){
+			if (i < 0 || fabs(col[ii]) > fabs(col[i])) i = ii;
+		}
+		if (i < 0) { converged = true; break; }
+	}
+	if (!converged) return false;
+	b.rank = k;
+	U.shrink_to_fit();
+	V.shrink_to_fit();
+	return true;
+}
+
+// ===================== HMatrix
+HMatrix::HMatrix(const vector<double>& rowbox, const vector<double>& colbox,
+		const TEntry& entry, const Options& opt): opt(opt){
+	nrows = rowbox.size()/4;
+	ncols = colbox.size()/4;
+	build_clusters(rowbox, opt.leaf_size, rclust, rperm);
+	build_clusters(colbox, opt.leaf_size, cclust, cperm);
+	if (nrows == 0 || ncols == 0) return;
+	build_blocks(0, 0);
+	HMParallel::ForChunks(blocks.size(), [&](int ib, int ie, int){
+		for (int i=ib; i<ie; ++i) fill_block(blocks[i], entry);
+	}, 1);
+}
+
+void HMatrix::MultVec(const vector<double>& u, vector<double>& res) const{
+	res.assign(nrows, 0);
+	int nchunks = HMParallel::NumChunks(blocks.size(), 16);
+	//each thread accumulates its own result which are summed in a fixed order
+	vector<vector<double>> acc(nchunks - 1, vector<double>(nrows, 0));
+	HMParallel::ForChunks(blocks.size(), [&](int ib, int ie, int ichunk){
+		vector<double>& r = (ichunk == 0) ? res : acc[ichunk-1];
+		vector<double> x, y, t;
+		for (int ib2=ib; ib2<ie; ++ib2){
+			const Block& b = blocks[ib2];
+			const Cluster& R = rclust[b.row];
+			const Cluster& C = cclust[b.col];
+			int m = R.size(), n = C.size();
+			x.resize(n);
+			y.assign(m, 0);
+			for (int j=0; j<n; ++j) x[j] = u[cperm[C.begin+j]];
+			if (b.rank < 0){
+				const double* a = b.a.data();
+				for (int i=0; i<m; ++i, a+=n){
+					y[i] = std::inner_product(a, a+n, x.begin(), 0.0);
+				}
+			} else {
+				t.resize(b.rank);
+				for (int l=0; l<b.rank; ++l){
+					t[l] = std::inner_product(x.begin(), x.end(), b.b.begin()+l*n, 0.0);
+				}
+				for (int l=0; l<b.rank; ++l){
+					const double* ul = &b.a[l*m];
+					for (int i=0; i<m; ++i) y[i] += ul[i]*t[l];
+				}
+			}
+			for (int i=0; i<m; ++i) r[rperm[R.begin+i]] += y[i];
+		}
+	}, 16);
+	for (auto& a: acc)
+	for (int i=0; i<nrows; ++i) res[i] += a[i];
+}
+
+size_t HMatrix::memory_usage() const{
+	size_t ret = 0;
+	for (auto& b: blocks) ret += b.a.size() + b.b.size();
+	return ret;
+}
+
+double HMatrix::compression() const{
+	if (nrows == 0 || ncols == 0) return 0;
+	return (double)memory_usage()/nrows/ncols;
+}
+
+int HMatrix::n_lowrank_blocks() const{
+	return std::count_if(blocks.begin(), blocks.end(), [](const Block& b){ return b.rank >= 0; });
+}
+
+int HMatrix::n_dense_blocks() const{
+	return blocks.size() - n_lowrank_blocks();
+}
+
+// ===================== GMRES
+int HMMath::Gmres(const std::function<void(const vector<double>&, vector<double>&)>& mult,
+		const vector<double>& diag, const vector<double>& rhs, vector<double>& x,
+		const GmresOptions& opt){
+	int n = rhs.size();
+	x.resize(n, 0);
+	auto prec = [&diag](vector<double>& v){
+		if (!diag.empty()) for (size_t i=0; i<v.size(); ++i) v[i] /= diag[i];
+	};
+	auto norm = [](const vector<double>& v){
+		return sqrt(std::inner_product(v.begin(), v.end(), v.begin(), 0.0));
+	};
+	vector<double> w = rhs;
+	prec(w);
+	double bnorm = norm(w);
+	if (bnorm == 0){
+		std::fill(x.begin(), x.end(), 0);
+		return 0;
+	}
+
+	int m = std::max(1, opt.restart);
+	vector<vector<double>> V(m+1, vector<double>(n));
+	vector<double> H((m+1)*m), cs(m), sn(m), g(m+1), y(m);
+	int it = 0;
+	while (1){
+		//residual
+		mult(x, w);
+		for (int i=0; i<n; ++i) V[0][i] = rhs[i] - w[i];
+		prec(V[0]);
+		double beta = norm(V[0]);
+		if (beta <= opt.tol*bnorm) return it;
+		if (it >= opt.maxit) break;
+		for (auto& v: V[0]) v /= beta;
+		std::fill(g.begin(), g.end(), 0);
+		g[0] = beta;
+
+		//arnoldi process with modified Gram-Schmidt orthogonalization
+		int j = 0;
+		while (j < m && it < opt.maxit){
+			mult(V[j], w);
+			prec(w);
+			for (int i=0; i<=j; ++i){
+				double h = std::inner_product(w.begin(), w.end(), V[i].begin(), 0.0);
+				H[i*m+j] = h;
+				for (int k=0; k<n; ++k) w[k] -= h*V[i][k];
+			}
+			double hn = norm(w);
+			H[(j+1)*m+j] = hn;
+			if (hn != 0) for (int k=0; k<n; ++k) V[j+1][k] = w[k]/hn;
+			//Givens rotations
+			for (int i=0; i<j; ++i){
+				double t = cs[i]*H[i*m+j] + sn[i]*H[(i+1)*m+j];
+				H[(i+1)*m+j] = -sn[i]*H[i*m+j] + cs[i]*H[(i+1)*m+j];
+				H[i*m+j] = t;
+			}
+			double r = sqrt(H[j*m+j]*H[j*m+j] + hn*hn);
+			cs[j] = H[j*m+j]/r;
+			sn[j] = hn/r;
+			H[j*m+j] = r;
+			g[j+1] = -sn[j]*g[j];
+			g[j] = cs[j]*g[j];
+			++j; ++it;
+			if (fabs(g[j]) <= opt.tol*bnorm || hn == 0) break;
+		}
+
+		//x += V*y, H*y = g
+		for (int i=j-1; i>=0; --i){
+			double s = g[i];
+			for (int k=i+1; k<j; ++k) s -= H[i*m+k]*y[k];
+			y[i] = s/H[i*m+i];
+		}
+		for (int i=0; i<j; ++i)
+		for (int k=0; k<n; ++k) x[k] += y[i]*V[i][k];
+	}
+	throw std::runtime_error("GMRES failed to converge");
+}
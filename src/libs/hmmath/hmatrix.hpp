@@ -0,0 +1,93 @@
+#ifndef HYBMESH_HMATRIX_HPP
+#define HYBMESH_HMATRIX_HPP
+
+#include "hmproject.h"
+#include <functional>
+
+namespace HMMath{
+
+//Hierarchical matrix for kernels which are smooth for distant rows and columns
+//(boundary element methods, potential evaluation).
+//Rows and columns are clustered geometrically. Blocks of well separated clusters
+//are approximated by low rank products built by adaptive cross approximation (ACA),
+//other blocks are stored as dense ones.
+//Memory and matrix-vector product costs are O(N log N) for typical boundary discretizations.
+class HMatrix{
+public:
+	//returns (i, j) matrix element. Called concurrently from different threads.
+	typedef std::function<double(int, int)> TEntry;
+
+	struct Options{
+		Options(){}
+		//maximum size of a cluster which is not subdivided
+		int leaf_size = 32;
+		//blocks with min(diam1, diam2) <= eta*dist are approximated
+		double eta = 1.0;
+		//relative accuracy of low rank approximation
+		double eps = 1e-7;
+	};
+
+	//i-th row (column) is associated with geometric box
+	//{x0, y0, x1, y1} = rowbox[4*i], ..., rowbox[4*i+3].
+	//For point collocations x0=x1, y0=y1.
+	HMatrix(const vector<double>& rowbox, const vector<double>& colbox,
+			const TEntry& entry, const Options& opt=Options());
+
+	int rows() const { return nrows; }
+	int cols() const { return ncols; }
+	//res = A*u
+	void MultVec(const vector<double>& u, vector<double>& res) const;
+
+	//number of stored doubles
+	size_t memory_usage() const;
+	//memory_usage() related to rows()*cols()
+	double compression() const;
+	int n_lowrank_blocks() const;
+	int n_dense_blocks() const;
+private:
+	struct Cluster{
+		int begin, end;
+		double x0, y0, x1, y1;
+		int child[2];
+
+		int size() const { return end - begin; }
+		double diam() const;
+		double dist(const Cluster& other) const;
+	};
+	struct Block{
+		int row, col;             //clusters indicies
+		int rank;                 //-1 for dense block
+		vector<double> a;         //dense: row-major; low rank: columns of U
+		vector<double> b;         //low rank: rows of V^T
+	};
+	int nrows, ncols;
+	Options opt;
+	vector<Cluster> rclust, cclust;
+	vector<int> rperm, cperm;
+	vector<Block> blocks;
+
+	static void build_clusters(const vector<double>& box, int leaf,
+			vector<Cluster>& clust, vector<int>& perm);
+	void build_blocks(int r, int c);
+	void fill_block(Block& b, const TEntry& entry) const;
+	bool fill_aca(Block& b, const TEntry& entry) const;
+};
+
+struct GmresOptions{
+	GmresOptions(){}
+	double tol = 1e-8;
+	int restart = 100;
+	int maxit = 2000;
+};
+
+//Restarted GMRES with Jacobi preconditioning.
+//mult(u, res) should compute res = A*u; diag is the diagonal of A (no preconditioning if empty).
+//x is used as an initial guess and is resized if needed.
+//Iterations stop when preconditioned residual norm is below tol*|D^-1 rhs|.
+//Returns number of iterations. Throws if tolerance was not reached.
+int Gmres(const std::function<void(const vector<double>&, vector<double>&)>& mult,
+		const vector<double>& diag, const vector<double>& rhs, vector<double>& x,
+		const GmresOptions& opt=GmresOptions());
+
+}
+#endif
@@ -1,4 +1,5 @@
 #include "spmat.hpp"
+#include "hmparallel.hpp"
 #include "cholmod.h"
 #include "umfpack.h"
 #include "SuiteSparseQR_C.h"
@@ -110,6 +111,195 @@ void LocMat4Sym::ToMat(const vector<int>& pind, Mat& target) const {
 	target.add(pind[3], pind[3], (*this)[9]);
 }
 
+// ====================== CsrMat
+CsrMat CsrMat::Pattern(int n, const vector<int>& elem_start, const vector<int>& elem_nodes){
+	int nelem = elem_start.size() - 1;
+	//node -> elements connectivity
+	vector<int> ne_start(n+1, 0), ne(elem_nodes.size());
+	for (auto v: elem_nodes) ++ne_start[v+1];
+	for (int i=0; i<n; ++i) ne_start[i+1] += ne_start[i];
+	vector<int> pos(ne_start.begin(), ne_start.end()-1);
+	for (int ie=0; ie<nelem; ++ie)
+	for (int k=elem_start[ie]; k<elem_start[ie+1]; ++k){
+		ne[pos[elem_nodes[k]]++] = ie;
+	}
+
+	//row patterns
+	CsrMat ret;
+	ret.start.resize(n+1);
+	ret.start[0] = 0;
+	ret.cols.reserve(elem_nodes.size()*2);
+	vector<int> mark(n, -1);
+	for (int i=0; i<n; ++i){
+		for (int k=ne_start[i]; k<ne_start[i+1]; ++k){
+			int ie = ne[k];
+			for (int m=elem_start[ie]; m<elem_start[ie+1]; ++m){
+				int j = elem_nodes[m];
+				if (mark[j] != i){
+					mark[j] = i;
+					ret.cols.push_back(j);
+				}
+			}
+		}
+		ret.start[i+1] = ret.cols.size();
+		std::sort(ret.cols.begin() + ret.start[i], ret.cols.end());
+	}
+	ret.vals.resize(ret.cols.size(), 0.0);
+	ret.symbolic = std::make_shared<SymbolicCache>();
+	return ret;
+}
+
+// ======================= SymbolicCache
+shared_ptr<void> SymbolicCache::get(Backend b, int rows, int nnz) const{
+	std::lock_guard<std::mutex> lock(mtx);
+	const Entry& e = entry(b);
+	if (e.rows != rows || e.nnz != nnz) return nullptr;
+	return e.data;
+}
+
+void SymbolicCache::set(Backend b, int rows, int nnz, shared_ptr<void> data){
+	std::lock_guard<std::mutex> lock(mtx);
+	Entry& e = entry(b);
+	e.data = data;
+	e.rows = rows;
+	e.nnz = nnz;
+}
+
+CsrMat CsrMat::FromMat(const Mat& m){
+	CsrMat ret;
+	ret.start.resize(m.rows()+1);
+	ret.start[0] = 0;
+	for (int i=0; i<m.rows(); ++i) ret.start[i+1] = ret.start[i] + m.row_size(i);
+	ret.cols.reserve(ret.start.back());
+	ret.vals.reserve(ret.start.back());
+	for (auto& row: m.data)
+	for (auto& cv: row){
+		ret.cols.push_back(cv.first);
+		ret.vals.push_back(cv.second);
+	}
+	ret.symbolic = std::make_shared<SymbolicCache>();
+	return ret;
+}
+
+int CsrMat::find(int i, int j) const{
+	if (i < 0 || i >= rows()) return -1;
+	auto b = cols.begin() + start[i], e = cols.begin() + start[i+1];
+	auto fnd = std::lower_bound(b, e, j);
+	if (fnd == e || *fnd != j) return -1;
+	else return fnd - cols.begin();
+}
+
+double CsrMat::get(int i, int j) const{
+	int k = find(i, j);
+	return (k < 0) ? 0 : vals[k];
+}
+
+void CsrMat::set(int i, int j, double val){
+	int k = find(i, j);
+	if (k < 0) throw std::runtime_error("sparse matrix entry is out of pattern");
+	vals[k] = val;
+}
+
+void CsrMat::add(int i, int j, double val){
+	int k = find(i, j);
+	if (k < 0) throw std::runtime_error("sparse matrix entry is out of pattern");
+	vals[k] += val;
+}
+
+void CsrMat::clear_row(int i){
+	std::fill(vals.begin() + start[i], vals.begin() + start[i+1], 0.0);
+}
+
+vector<double> CsrMat::diag() const{
+	vector<double> ret(rows(), 0.0);
+	for (int i=0; i<rows(); ++i){
+		int k = find(i, i);
+		if (k >= 0) ret[i] = vals[k];
+	}
+	return ret;
+}
+
+bool CsrMat::is_symmetric(double eps) const{
+	for (int i=0; i<rows(); ++i)
+	for (int k=start[i]; k<start[i+1]; ++k){
+		int j = cols[k];
+		if (j <= i) continue;
+		int kt = find(j, i);
+		double vt = (kt < 0) ? 0 : vals[kt];
+		if (fabs(vt - vals[k]) > eps) return false;
+	}
+	return true;
+}
+
+double CsrMat::RowMultVec(const vector<double>& u, int irow) const{
+	assert(irow < rows());
+	double ret = 0;
+	const int* c = cols.data();
+	const double* v = vals.data();
+	for (int k=start[irow]; k<start[irow+1]; ++k) ret += v[k]*u[c[k]];
+	return ret;
+}
+
+void CsrMat::MultVec(const vector<double>& u, vector<double>& res) const{
+	const int* c = cols.data();
+	const double* v = vals.data();
+	const double* x = u.data();
+	HMParallel::ForChunks(rows(), [&](int ib, int ie, int){
+		for (int i=ib; i<ie; ++i){
+			double s = 0;
+			for (int k=start[i]; k<start[i+1]; ++k) s += v[k]*x[c[k]];
+			res[i] = s;
+		}
+	}, 20000);
+}
+
+void CsrMat::add_dense(int n, const int* pind, const double* a){
+	const int* c = cols.data();
+	for (int i=0; i<n; ++i){
+		const int* b = c + start[pind[i]];
+		const int* e = c + start[pind[i]+1];
+		for (int j=0; j<n; ++j){
+			const int* fnd = std::lower_bound(b, e, pind[j]);
+			if (fnd == e || *fnd != pind[j])
+				throw std::runtime_error("sparse matrix entry is out of pattern");
+			vals[fnd - c] += a[n*i+j];
+		}
+	}
+}
+
+namespace{
+//adds n x n local matrix given by val(i, j) to target.
+//Pattern of target should contain all (pind[i], pind[j]) entries.
+template<class TFun>
+void csr_add_local(const vector<int>& pind, CsrMat& target, TFun&& val){
+	int n = pind.size();
+	const int* c = target.cols.data();
+	for (int i=0; i<n; ++i){
+		const int* b = c + target.start[pind[i]];
+		const int* e = c + target.start[pind[i]+1];
+		for (int j=0; j<n; ++j){
+			const int* fnd = std::lower_bound(b, e, pind[j]);
+			if (fnd == e || *fnd != pind[j])
+				throw std::runtime_error("sparse matrix entry is out of pattern");
+			target.vals[fnd - c] += val(i, j);
+		}
+	}
+}
+}
+
+void LocMat3Sym::ToMat(const vector<int>& pind, CsrMat& target) const{
+	static const int sym[3][3] = {{0, 1, 2}, {1, 3, 4}, {2, 4, 5}};
+	csr_add_local(pind, target, [this](int i, int j){ return (*this)[sym[i][j]]; });
+}
+
+void LocMat3::ToMat(const vector<int>& pind, CsrMat& target) const{
+	csr_add_local(pind, target, [this](int i, int j){ return (*this)[3*i+j]; });
+}
+
+void LocMat4Sym::ToMat(const vector<int>& pind, CsrMat& target) const{
+	static const int sym[4][4] = {{0, 1, 2, 3}, {1, 4, 5, 6}, {2, 5, 7, 8}, {3, 6, 8, 9}};
+	csr_add_local(pind, target, [this](int i, int j){ return (*this)[sym[i][j]]; });
+}
 
 // ====================== Matrix Solvers
 shared_ptr<MatSolve>
@@ -124,8 +314,33 @@ MatSolve::Factory(const Mat& m, Options opt){
 	return ret;
 }
 
+shared_ptr<MatSolve>
+MatSolve::Factory(const CsrMat& m, Options opt){
+	shared_ptr<MatSolve> ret;
+	vector<double> diag = m.diag();
+	bool spd = std::all_of(diag.begin(), diag.end(), [](double x){ return x>0; })
+		&& m.is_symmetric();
+	if (m.nnz() < opt.direct_solver_max_nnz){
+		if (spd) try{
+			ret.reset(new CholmodSolver(m, opt));
+		} catch (std::runtime_error& e){
+			//not positive definite. Use LU.
+			ret.reset();
+		}
+	} else if (spd){
+		ret.reset(new PcgSolver(m, opt));
+	}
+	if (!ret) try{
+		ret.reset(new UmfpackSolver(m, opt));
+	} catch (std::runtime_error& e){
+		//singular matrix (e.g. no Dirichlet conditions). Use QR.
+		ret.reset(new SuiteSparseQRSolver(m, opt));
+	}
+	return ret;
+}
+
 // ======================= Seidel solver
-SeidelSolver::SeidelSolver(const Mat& m, Options opt): MatSolve(m){
+SeidelSolver::SeidelSolver(const Mat& m, Options opt): m(&m){
 	MaxIt = opt.iter_maxit;
 	tol = opt.iter_tol;
 }
@@ -180,6 +395,19 @@ struct SPQR{
 		A = cholmod_l_triplet_to_sparse(T, 0, &common);
 		cholmod_l_free_triplet(&T, &common);
 	}
+	void InitMat(const CsrMat& m){
+		cholmod_triplet *T = cholmod_l_allocate_triplet(
+			m.rows(), m.rows(), m.nnz(), 0, CHOLMOD_REAL, &common);
+		for (int i=0; i<m.rows(); ++i)
+		for (int k=m.start[i]; k<m.start[i+1]; ++k){
+			((SuiteSparse_long*)T->i)[k] = i;
+			((SuiteSparse_long*)T->j)[k] = m.cols[k];
+			((double*)T->x)[k] = m.vals[k];
+		}
+		T->nnz = m.nnz();
+		A = cholmod_l_triplet_to_sparse(T, 0, &common);
+		cholmod_l_free_triplet(&T, &common);
+	}
 	void InitSlv(){
 		b = cholmod_l_zeros(A->nrow, 1, A->xtype, &common);
 		QR = SuiteSparseQR_C_factorize(SPQR_ORDERING_DEFAULT, SPQR_DEFAULT_TOL, A, &common);
@@ -212,7 +440,13 @@ struct SPQR{
 
 }
 
-SuiteSparseQRSolver::SuiteSparseQRSolver(const Mat& m, Options opt): MatSolve(m){
+SuiteSparseQRSolver::SuiteSparseQRSolver(const Mat& m, Options opt){
+	auto slv1 = new QRImpl::SPQR();
+	slv1->InitMat(m);
+	slv1->InitSlv();
+	slv = slv1;
+}
+SuiteSparseQRSolver::SuiteSparseQRSolver(const CsrMat& m, Options opt){
 	auto slv1 = new QRImpl::SPQR();
 	slv1->InitMat(m);
 	slv1->InitSlv();
@@ -228,3 +462,261 @@ void SuiteSparseQRSolver::Solve(const vector<double>& rhs, vector<double>& x){
 }
 
 
+
+// ======================= Umfpack LU Solver
+//umfpack uses compressed column format. Csr arrays of a matrix are
+//treated as csc arrays of the transposed one hence transposed system is solved.
+namespace{
+struct UmfSymbolic{
+	void* symbolic;
+	UmfSymbolic(const CsrMat& m): symbolic(0){
+		int n = m.rows();
+		int status = umfpack_di_symbolic(n, n, m.start.data(), m.cols.data(), m.vals.data(),
+				&symbolic, 0, 0);
+		if (status != UMFPACK_OK)
+			throw std::runtime_error("Umfpack symbolic factorization failed");
+	}
+	~UmfSymbolic(){ if (symbolic != 0) umfpack_di_free_symbolic(&symbolic); }
+};
+}
+
+UmfpackSolver::UmfpackSolver(const CsrMat& m, Options opt): m(&m), numeric(0){
+	auto backend = SymbolicCache::Backend::Umfpack;
+	if (m.symbolic) symbolic = m.symbolic->get(backend, m.rows(), m.nnz());
+	if (!symbolic){
+		symbolic.reset(new UmfSymbolic(m));
+		if (m.symbolic) m.symbolic->set(backend, m.rows(), m.nnz(), symbolic);
+	}
+	if (!Refactor(m)) throw std::runtime_error("Umfpack numeric factorization failed");
+}
+
+UmfpackSolver::~UmfpackSolver(){
+	if (numeric != 0) umfpack_di_free_numeric(&numeric);
+}
+
+bool UmfpackSolver::Refactor(const CsrMat& m){
+	if (numeric != 0) umfpack_di_free_numeric(&numeric);
+	this->m = &m;
+	int status = umfpack_di_numeric(m.start.data(), m.cols.data(), m.vals.data(),
+			static_cast<UmfSymbolic*>(symbolic.get())->symbolic, &numeric, 0, 0);
+	if (status != UMFPACK_OK){
+		if (numeric != 0) umfpack_di_free_numeric(&numeric);
+		numeric = 0;
+		return false;
+	}
+	return true;
+}
+
+void UmfpackSolver::Solve(const vector<double>& rhs, vector<double>& x){
+	x.resize(m->rows());
+	int status = umfpack_di_solve(UMFPACK_At, m->start.data(), m->cols.data(), m->vals.data(),
+			x.data(), rhs.data(), numeric, 0, 0);
+	if (status != UMFPACK_OK) throw std::runtime_error("Umfpack matrix solution failed");
+}
+
+// ======================= Cholmod Cholesky Solver
+namespace CholImpl{
+
+//factorization with lower reciprocal condition number estimate is treated as failed
+const double MIN_RCOND = 1e-13;
+
+//matrix is symmetric, so its csr arrays are
+//csc arrays of the same matrix. Wrap them without copying.
+cholmod_sparse wrap(const CsrMat& m){
+	cholmod_sparse A;
+	A.nrow = A.ncol = m.rows();
+	A.nzmax = m.nnz();
+	A.p = const_cast<int*>(m.start.data());
+	A.i = const_cast<int*>(m.cols.data());
+	A.nz = 0;
+	A.x = const_cast<double*>(m.vals.data());
+	A.z = 0;
+	A.stype = 1;
+	A.itype = CHOLMOD_INT;
+	A.xtype = CHOLMOD_REAL;
+	A.dtype = CHOLMOD_DOUBLE;
+	A.sorted = 1;
+	A.packed = 1;
+	return A;
+}
+
+//symbolic factor: ordering and supernodal structure
+struct Symbolic{
+	Symbolic(const CsrMat& m): L(0){
+		cholmod_start(&common);
+		common.supernodal = CHOLMOD_SUPERNODAL;
+		cholmod_sparse A = wrap(m);
+		L = cholmod_analyze(&A, &common);
+		if (L == 0){
+			cholmod_finish(&common);
+			throw std::runtime_error("Cholmod analysis failed");
+		}
+	}
+	~Symbolic(){
+		cholmod_free_factor(&L, &common);
+		cholmod_finish(&common);
+	}
+	cholmod_common common;
+	cholmod_factor *L;
+};
+
+struct Chol{
+	Chol(): L(0){ cholmod_start(&common); }
+	~Chol(){
+		if (L!=0) {cholmod_free_factor(&L, &common); L=0;}
+		cholmod_finish(&common);
+	}
+	void Init(const CsrMat& m, const Symbolic& sym){
+		L = cholmod_copy_factor(sym.L, &common);
+		if (L == 0) throw std::runtime_error("Cholmod analysis failed");
+		if (!Refactor(m)) throw std::runtime_error("Cholmod factorization failed");
+	}
+	bool Refactor(const CsrMat& m){
+		cholmod_sparse A = wrap(m);
+		cholmod_factorize(&A, L, &common);
+		//semidefinite matrices could be factorized with roundoff level pivots
+		return common.status == CHOLMOD_OK && cholmod_rcond(L, &common) > MIN_RCOND;
+	}
+	int Solve(const double* rhs, double* v){
+		cholmod_dense b;
+		b.nrow = b.nzmax = b.d = L->n;
+		b.ncol = 1;
+		b.x = const_cast<double*>(rhs);
+		b.z = 0;
+		b.xtype = CHOLMOD_REAL;
+		b.dtype = CHOLMOD_DOUBLE;
+
+		cholmod_dense* x = cholmod_solve(CHOLMOD_A, L, &b, &common);
+		if (x == 0) return 0;
+		std::copy((double*)x->x, (double*)x->x + L->n, v);
+		cholmod_free_dense(&x, &common);
+		return 1;
+	}
+
+	cholmod_common common;
+	cholmod_factor *L;
+};
+
+}
+
+CholmodSolver::CholmodSolver(const CsrMat& m, Options opt){
+	shared_ptr<void> sym;
+	auto backend = SymbolicCache::Backend::Cholmod;
+	if (m.symbolic) sym = m.symbolic->get(backend, m.rows(), m.nnz());
+	if (!sym){
+		sym.reset(new CholImpl::Symbolic(m));
+		if (m.symbolic) m.symbolic->set(backend, m.rows(), m.nnz(), sym);
+	}
+	std::unique_ptr<CholImpl::Chol> slv1(new CholImpl::Chol());
+	slv1->Init(m, *static_cast<CholImpl::Symbolic*>(sym.get()));
+	slv = slv1.release();
+}
+CholmodSolver::~CholmodSolver(){
+	delete static_cast<CholImpl::Chol*>(slv);
+}
+bool CholmodSolver::Refactor(const CsrMat& m){
+	return static_cast<CholImpl::Chol*>(slv)->Refactor(m);
+}
+void CholmodSolver::Solve(const vector<double>& rhs, vector<double>& x){
+	x.resize(rhs.size());
+	int ans = static_cast<CholImpl::Chol*>(slv)->Solve(&rhs[0], &x[0]);
+	if (ans != 1) throw std::runtime_error("Cholmod matrix solution failed");
+}
+
+// ======================= Preconditioned CG Solver
+PcgSolver::PcgSolver(const CsrMat& m, Options opt): m(&m){
+	MaxIt = opt.iter_maxit;
+	tol = opt.iter_tol;
+	prec = opt.iter_precond;
+	dinv = m.diag();
+	for (auto& d: dinv) d = 1.0/d;
+	if (prec == Precond::IC0) build_ic0();
+}
+
+void PcgSolver::build_ic0(){
+	//lower triangle of m including diagonal
+	int n = m->rows();
+	lmat.start.resize(n+1);
+	lmat.start[0] = 0;
+	for (int i=0; i<n; ++i){
+		for (int k=m->start[i]; k<m->start[i+1] && m->cols[k]<=i; ++k){
+			lmat.cols.push_back(m->cols[k]);
+			lmat.vals.push_back(m->vals[k]);
+		}
+		lmat.start[i+1] = lmat.cols.size();
+	}
+	//incomplete factorization within the pattern of m.
+	//Last entry in each row is a diagonal one.
+	for (int i=0; i<n; ++i){
+		int ib = lmat.start[i], ie = lmat.start[i+1] - 1;
+		if (ie < ib || lmat.cols[ie] != i){ prec = Precond::Jacobi; return; }
+		for (int k=ib; k<=ie; ++k){
+			int j = lmat.cols[k];
+			//dot product of i-th and j-th rows restricted by columns < j
+			double s = lmat.vals[k];
+			int p1 = ib, p2 = lmat.start[j];
+			while (p1 < k && lmat.cols[p2] < j){
+				if (lmat.cols[p1] == lmat.cols[p2]) s -= lmat.vals[p1++]*lmat.vals[p2++];
+				else if (lmat.cols[p1] < lmat.cols[p2]) ++p1;
+				else ++p2;
+			}
+			if (j < i) lmat.vals[k] = s/lmat.vals[lmat.start[j+1]-1];
+			else if (s > 0) lmat.vals[k] = sqrt(s);
+			//breakdown
+			else { prec = Precond::Jacobi; return; }
+		}
+	}
+}
+
+void PcgSolver::precondition(const vector<double>& r, vector<double>& z) const{
+	int n = r.size();
+	if (prec == Precond::Jacobi){
+		for (int i=0; i<n; ++i) z[i] = r[i]*dinv[i];
+		return;
+	}
+	// L*y = r
+	for (int i=0; i<n; ++i){
+		double s = r[i];
+		int ie = lmat.start[i+1] - 1;
+		for (int k=lmat.start[i]; k<ie; ++k) s -= lmat.vals[k]*z[lmat.cols[k]];
+		z[i] = s/lmat.vals[ie];
+	}
+	// L^T*z = y
+	for (int i=n-1; i>=0; --i){
+		int ie = lmat.start[i+1] - 1;
+		z[i] /= lmat.vals[ie];
+		for (int k=lmat.start[i]; k<ie; ++k) z[lmat.cols[k]] -= lmat.vals[k]*z[i];
+	}
+}
+
+void PcgSolver::Solve(const vector<double>& rhs, vector<double>& x){
+	int n = m->rows();
+	if ((int)x.size() != n) x.assign(n, 0.0);
+	vector<double> r(n), z(n), p(n), q(n);
+	m->MultVec(x, r);
+	for (int i=0; i<n; ++i) r[i] = rhs[i] - r[i];
+	double bnorm = 1;
+	for (auto v: rhs) bnorm = std::max(bnorm, fabs(v));
+
+	precondition(r, z);
+	p = z;
+	double rz = std::inner_product(r.begin(), r.end(), z.begin(), 0.0);
+	for (int it=0; it<MaxIt; ++it){
+		double rnorm = 0;
+		for (auto v: r) rnorm = std::max(rnorm, fabs(v));
+		if (rnorm <= tol*bnorm) return;
+
+		m->MultVec(p, q);
+		double alpha = rz/std::inner_product(p.begin(), p.end(), q.begin(), 0.0);
+		for (int i=0; i<n; ++i){
+			x[i] += alpha*p[i];
+			r[i] -= alpha*q[i];
+		}
+		precondition(r, z);
+		double rz1 = std::inner_product(r.begin(), r.end(), z.begin(), 0.0);
+		double beta = rz1/rz;
+		rz = rz1;
+		for (int i=0; i<n; ++i) p[i] = z[i] + beta*p[i];
+	}
+	throw std::runtime_error("PCG solver failed to converge");
+}
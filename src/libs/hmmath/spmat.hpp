@@ -1,10 +1,13 @@
 #ifndef HYBMESH_HMFEM_FEMMAT_HPP
 #define HYBMESH_HMFEM_FEMMAT_HPP
 #include "hmproject.h"
+#include <mutex>
 
 namespace HMMath{
 
-//Sparce Matrix
+//Sparce Matrix with dynamic pattern.
+//Used for small systems with irregular assembling.
+//Large fem systems should be built as CsrMat.
 struct Mat{
 	vector<std::map<int, double>> data;
 
@@ -29,48 +32,131 @@ struct Mat{
 };
 std::ostream& operator<<(std::ostream& os, const Mat&);
 
+//Symbolic analysis data of direct solvers for a sparse matrix pattern.
+//It is shared between copies of a matrix which could be solved concurrently,
+//so entries are accessed under a lock.
+//Each entry remembers the pattern size it was built for and is
+//ignored if the matrix pattern size has changed since then.
+class SymbolicCache{
+public:
+	enum class Backend {Cholmod, Umfpack};
+	//returns nullptr if there is no valid entry
+	shared_ptr<void> get(Backend b, int rows, int nnz) const;
+	void set(Backend b, int rows, int nnz, shared_ptr<void> data);
+private:
+	struct Entry{
+		Entry(): rows(-1), nnz(-1){}
+		shared_ptr<void> data;
+		int rows, nnz;
+	};
+	mutable std::mutex mtx;
+	Entry cholmod, umfpack;
+	Entry& entry(Backend b){ return b == Backend::Cholmod ? cholmod : umfpack; }
+	const Entry& entry(Backend b) const { return b == Backend::Cholmod ? cholmod : umfpack; }
+};
+
+//Sparse matrix in compressed row storage with fixed pattern.
+//Columns within each row are sorted.
+//Built in two phases: symbolic (Pattern) and numeric (add/set within pattern).
+//Arrays are passed to SuiteSparse solvers without copying.
+struct CsrMat{
+	vector<int> start;    //size = rows()+1
+	vector<int> cols;     //size = nnz()
+	vector<double> vals;  //size = nnz()
+	//filled by solvers and shared between copies of the matrix.
+	//Should be reset if start or cols arrays are changed:
+	//only the pattern size is checked before reuse.
+	shared_ptr<SymbolicCache> symbolic;
+
+	//symbolic phase: builds zero filled matrix
+	//which contains all (i, j) pairs where i, j belong to the same element.
+	//nodes of i-th element are elem_nodes[elem_start[i]], ..., elem_nodes[elem_start[i+1]-1]
+	static CsrMat Pattern(int n, const vector<int>& elem_start, const vector<int>& elem_nodes);
+	//conversion from dynamic matrix
+	static CsrMat FromMat(const Mat& m);
+
+	//get/set methods
+	int rows() const { return start.size() > 0 ? start.size()-1 : 0; }
+	int nnz() const { return cols.size(); }
+	int row_size(int irow) const { return start[irow+1] - start[irow]; }
+	//index of (i, j) entry in cols/vals arrays or -1 if it is not in pattern
+	int find(int i, int j) const;
+	double get(int i, int j) const;
+	//set/add throw if (i, j) is not within pattern
+	void set(int i, int j, double val);
+	void add(int i, int j, double val);
+	//adds dense n x n matrix a given in row-major order
+	//to (pind[i], pind[j]) entries. Throws if any of them is not within pattern.
+	void add_dense(int n, const int* pind, const double* a);
+	//fills row with zeros keeping its pattern
+	void clear_row(int i);
+	void fill_zero() { std::fill(vals.begin(), vals.end(), 0.0); }
+	vector<double> diag() const;
+	bool is_symmetric(double eps=geps) const;
+
+	//Methods
+	double RowMultVec(const vector<double>& u, int irow) const;
+	//res = this*u. Rows are processed in parallel.
+	void MultVec(const vector<double>& u, vector<double>& res) const;
+};
 
 //dense matrix of little dimension
 struct LocMat{
 	virtual void ToMat(const vector<int>& pind, Mat& target) const = 0;
+	virtual void ToMat(const vector<int>& pind, CsrMat& target) const = 0;
 };
 
 struct LocMat3Sym: public LocMat, public std::array<double, 6>{
 	void ToMat(const vector<int>& pind, Mat& target) const;
+	void ToMat(const vector<int>& pind, CsrMat& target) const;
 };
 
 struct LocMat3: public LocMat, public std::array<double, 9>{
 	void ToMat(const vector<int>& pind, Mat& target) const;
+	void ToMat(const vector<int>& pind, CsrMat& target) const;
 };
 
 struct LocMat4Sym: public LocMat, public std::array<double, 10>{
 	void ToMat(const vector<int>& pind, Mat& target) const;
+	void ToMat(const vector<int>& pind, CsrMat& target) const;
 };
 
 // ==================== Solving procedures
 class MatSolve{
-protected:
-	const Mat* m;
 public:
-	MatSolve(const Mat& mat): m(&mat){}
 	virtual ~MatSolve(){}
+	enum class Precond {Jacobi, IC0};
 	struct Options{
 		Options():
 			direct_solver_max_nnz(1000000),
 			iter_tol(geps),
-			iter_maxit(10000)
+			iter_maxit(10000),
+			iter_precond(Precond::IC0)
 		{}
 		int direct_solver_max_nnz;
 		double iter_tol;
 		int iter_maxit;
+		//preconditioner for iterative solvers of symmetric systems
+		Precond iter_precond;
 	};
 	virtual void Solve(const vector<double>& rhs, vector<double>& x) = 0;
+	//numeric refactorization of a matrix with the pattern
+	//used for solver construction. Returns false if it is not possible:
+	//solver should be rebuilt by Factory in that case.
+	virtual bool Refactor(const CsrMat& m){ return false; }
 
 	static shared_ptr<MatSolve>
 	Factory(const Mat& m, Options=Options());
+	//Symmetric matrices with positive diagonal are solved by
+	//Cholesky (direct) or preconditioned conjugate gradients (iterative) methods,
+	//all others by LU. Singular matrices are solved by QR.
+	//m should not be destroyed before returned solver
+	static shared_ptr<MatSolve>
+	Factory(const CsrMat& m, Options=Options());
 };
 
 class SeidelSolver: public MatSolve{
+	const Mat* m;
 	int MaxIt;
 	double tol;
 public:
@@ -82,10 +168,55 @@ class SuiteSparseQRSolver: public MatSolve{
 	void* slv;
 public:
 	SuiteSparseQRSolver(const Mat& m, Options opt);
+	SuiteSparseQRSolver(const CsrMat& m, Options opt);
 	~SuiteSparseQRSolver();
 	void Solve(const vector<double>& rhs, vector<double>& x) override;
 };
 
+//LU factorization of general square matrix.
+//Uses CsrMat arrays directly, so m should live as long as the solver.
+//Symbolic analysis is taken from m.symbolic if present.
+class UmfpackSolver: public MatSolve{
+	const CsrMat* m;
+	shared_ptr<void> symbolic;
+	void* numeric;
+public:
+	UmfpackSolver(const CsrMat& m, Options opt);
+	~UmfpackSolver();
+	void Solve(const vector<double>& rhs, vector<double>& x) override;
+	bool Refactor(const CsrMat& m) override;
+};
+
+//Supernodal Cholesky factorization of symmetric positive definite matrix.
+//Only upper triangle of m is used. Throws if m is not positive definite.
+//Symbolic analysis is taken from m.symbolic if present.
+class CholmodSolver: public MatSolve{
+	void* slv;
+public:
+	CholmodSolver(const CsrMat& m, Options opt);
+	~CholmodSolver();
+	void Solve(const vector<double>& rhs, vector<double>& x) override;
+	bool Refactor(const CsrMat& m) override;
+};
+
+//Preconditioned conjugate gradients for symmetric positive definite matrix.
+//x passed to Solve is used as an initial guess if it has proper size.
+class PcgSolver: public MatSolve{
+	const CsrMat* m;
+	int MaxIt;
+	double tol;
+	//preconditioner: diagonal for Jacobi,
+	//lower triangle of incomplete cholesky factor for IC0
+	Precond prec;
+	vector<double> dinv;
+	CsrMat lmat;
+	void build_ic0();
+	void precondition(const vector<double>& r, vector<double>& z) const;
+public:
+	PcgSolver(const CsrMat& m, Options opt);
+	void Solve(const vector<double>& rhs, vector<double>& x) override;
+};
+
 
 
 }
@@ -1,5 +1,7 @@
 #include "piecewise.hpp"
+#include "spmat.hpp"
 #include "hmtesting.hpp"
+#include "hmparallel.hpp"
 using HMTesting::add_check;
 
 void test01(){
@@ -38,8 +40,263 @@ void test01(){
 		ISEQ(f2.Integral(-1, 1), 0), "linear piecewise 2");
 }
 
+void test02(){
+	std::cout<<"02. Sparse matrix assembly"<<std::endl;
+	//three triangles (0, 1, 2), (0, 2, 3), (2, 3, 4)
+	vector<int> es = {0, 3, 6, 9};
+	vector<int> en = {0, 1, 2, 0, 2, 3, 2, 3, 4};
+	HMMath::CsrMat cm = HMMath::CsrMat::Pattern(5, es, en);
+	add_check(cm.rows() == 5 && cm.nnz() == 19 &&
+		cm.start == vector<int>({0, 4, 7, 12, 16, 19}) &&
+		cm.cols == vector<int>({0, 1, 2, 3, 0, 1, 2, 0, 1, 2, 3, 4, 0, 2, 3, 4, 2, 3, 4}) &&
+		cm.find(1, 3) == -1 && cm.find(3, 4) >= 0, "symbolic phase");
+
+	HMMath::Mat m;
+	HMMath::LocMat3Sym a1, a2;
+	HMMath::LocMat3 a3;
+	for (int i=0; i<6; ++i){ a1[i] = 1.0 + i; a2[i] = 0.5*i - 1; }
+	for (int i=0; i<9; ++i){ a3[i] = 0.1*i*i; }
+	a1.ToMat({0, 1, 2}, m); a1.ToMat({0, 1, 2}, cm);
+	a2.ToMat({0, 2, 3}, m); a2.ToMat({0, 2, 3}, cm);
+	a3.ToMat({2, 3, 4}, m); a3.ToMat({2, 3, 4}, cm);
+	bool ok = true;
+	for (int i=0; i<5; ++i)
+	for (int j=0; j<5; ++j){
+		if (fabs(m.get(i, j) - cm.get(i, j)) > 1e-14) ok = false;
+	}
+	add_check(ok, "numeric phase");
+}
+
+void test03(){
+	std::cout<<"03. Sparse matrix solution"<<std::endl;
+	//1d laplace on 10 nodes with Dirichlet conditions
+	int n = 10;
+	vector<int> es, en;
+	for (int i=0; i<n-1; ++i){
+		es.push_back(en.size());
+		en.push_back(i); en.push_back(i+1);
+	}
+	es.push_back(en.size());
+	HMMath::CsrMat cm = HMMath::CsrMat::Pattern(n, es, en);
+	for (int i=0; i<n-1; ++i){
+		cm.add(i, i, 1); cm.add(i+1, i+1, 1);
+		cm.add(i, i+1, -1); cm.add(i+1, i, -1);
+	}
+	add_check(cm.is_symmetric(), "symmetry");
+	cm.clear_row(0); cm.set(0, 0, 1);
+	cm.clear_row(n-1); cm.set(n-1, n-1, 1);
+	vector<double> rhs(n, 0), x(n, 0), r(n, 0);
+	rhs[0] = 1; rhs[n-1] = 2;
+	auto slv = HMMath::MatSolve::Factory(cm);
+	slv->Solve(rhs, x);
+	cm.MultVec(x, r);
+	bool ok = true;
+	for (int i=0; i<n; ++i){
+		if (fabs(r[i] - rhs[i]) > 1e-12) ok = false;
+		if (fabs(x[i] - (1.0 + double(i)/(n-1))) > 1e-12) ok = false;
+	}
+	add_check(ok, "direct solver");
+}
+
+void test04(){
+	std::cout<<"04. Symmetric sparse solvers"<<std::endl;
+	//5-point laplace on n x n regular grid with unit boundary values
+	//and source term in the center
+	int n = 20;
+	auto gi = [n](int i, int j){ return j*n + i; };
+	auto isbnd = [n](int k){ return k%n == 0 || k/n == 0 || k%n == n-1 || k/n == n-1; };
+	vector<int> es, en;
+	for (int j=0; j<n; ++j)
+	for (int i=0; i<n; ++i){
+		es.push_back(en.size());
+		en.push_back(gi(i, j));
+		if (i>0) en.push_back(gi(i-1, j));
+		if (i<n-1) en.push_back(gi(i+1, j));
+		if (j>0) en.push_back(gi(i, j-1));
+		if (j<n-1) en.push_back(gi(i, j+1));
+	}
+	es.push_back(en.size());
+	HMMath::CsrMat cm = HMMath::CsrMat::Pattern(n*n, es, en);
+	vector<double> rhs(n*n, 0);
+	for (int j=0; j<n; ++j)
+	for (int i=0; i<n; ++i){
+		int k = gi(i, j);
+		if (isbnd(k)){
+			cm.set(k, k, 1);
+			rhs[k] = 1;
+		} else {
+			cm.set(k, k, 4);
+			rhs[k] = (i == n/2 && j == n/2) ? 1 : 0;
+			for (int k2: {gi(i-1, j), gi(i+1, j), gi(i, j-1), gi(i, j+1)}){
+				//eliminate boundary values to keep matrix symmetric
+				if (isbnd(k2)) rhs[k] += 1;
+				else cm.set(k, k2, -1);
+			}
+		}
+	}
+	add_check(cm.is_symmetric(), "symmetric matrix");
+
+	vector<double> x1, x2, x3, r(n*n);
+	auto resid = [&](const vector<double>& x){
+		cm.MultVec(x, r);
+		double ret = 0;
+		for (int i=0; i<n*n; ++i) ret = std::max(ret, fabs(r[i] - rhs[i]));
+		return ret;
+	};
+	HMMath::MatSolve::Factory(cm)->Solve(rhs, x1);
+	add_check(resid(x1) < 1e-10, "cholesky solver");
+
+	HMMath::MatSolve::Options opt;
+	opt.direct_solver_max_nnz = 0;
+	opt.iter_tol = 1e-12;
+	HMMath::MatSolve::Factory(cm, opt)->Solve(rhs, x2);
+	opt.iter_precond = HMMath::MatSolve::Precond::Jacobi;
+	HMMath::MatSolve::Factory(cm, opt)->Solve(rhs, x3);
+	double d2 = 0, d3 = 0;
+	for (int i=0; i<n*n; ++i){
+		d2 = std::max(d2, fabs(x1[i] - x2[i]));
+		d3 = std::max(d3, fabs(x1[i] - x3[i]));
+	}
+	add_check(d2 < 1e-10 && d3 < 1e-10, "preconditioned cg solver");
+}
+
+void test05(){
+	std::cout<<"05. Sparse factorization reuse"<<std::endl;
+	//1d laplace with Dirichlet conditions and varying coefficients
+	int n = 30;
+	vector<int> es, en;
+	for (int i=0; i<n-1; ++i){
+		es.push_back(en.size());
+		en.push_back(i); en.push_back(i+1);
+	}
+	es.push_back(en.size());
+	HMMath::CsrMat cm = HMMath::CsrMat::Pattern(n, es, en);
+	auto fill = [&](double k){
+		cm.fill_zero();
+		for (int i=1; i<n-2; ++i){
+			double c = 1 + k*i;
+			cm.add(i, i, c); cm.add(i+1, i+1, c);
+			cm.add(i, i+1, -c); cm.add(i+1, i, -c);
+		}
+		cm.add(1, 1, 1); cm.add(n-2, n-2, 1);
+		cm.set(0, 0, 1); cm.set(n-1, n-1, 1);
+	};
+	vector<double> rhs(n, 1), x1, x2;
+	rhs[0] = rhs[n-1] = 0;
+
+	fill(0.1);
+	HMMath::CsrMat cm2 = cm;
+	auto slv = HMMath::MatSolve::Factory(cm);
+	auto chol = HMMath::SymbolicCache::Backend::Cholmod;
+	add_check(cm.symbolic->get(chol, n, cm.nnz()) != nullptr &&
+			cm2.symbolic->get(chol, n, cm.nnz()) == cm.symbolic->get(chol, n, cm.nnz()),
+			"symbolic analysis sharing");
+
+	fill(0.5);
+	add_check(slv->Refactor(cm), "numeric refactorization");
+	slv->Solve(rhs, x1);
+	HMMath::CsrMat cm3 = cm;
+	cm3.symbolic.reset();
+	HMMath::MatSolve::Factory(cm3)->Solve(rhs, x2);
+	double d = 0;
+	for (int i=0; i<n; ++i) d = std::max(d, fabs(x1[i] - x2[i]));
+	add_check(d < 1e-12, "refactorized solution");
+
+	//concurrent solves of matrix copies sharing a fresh cache
+	cm.symbolic = std::make_shared<HMMath::SymbolicCache>();
+	vector<vector<double>> xs(4);
+	HMParallel::SetNumThreads(4);
+	HMParallel::ForChunks(4, [&](int ib, int ie, int){
+		for (int i=ib; i<ie; ++i){
+			HMMath::CsrMat c = cm;
+			HMMath::MatSolve::Factory(c)->Solve(rhs, xs[i]);
+		}
+	}, 1);
+	HMParallel::SetNumThreads(1);
+	bool same = true;
+	for (auto& x: xs) same = same && x == xs[0];
+	add_check(same && cm.symbolic->get(chol, n, cm.nnz()) != nullptr, "concurrent shared symbolic");
+
+	//cache built for another pattern size is not reused
+	add_check(cm.symbolic->get(chol, n, cm.nnz()-1) == nullptr &&
+			cm.symbolic->get(chol, n+1, cm.nnz()) == nullptr, "stale symbolic analysis");
+}
+
+void test06(){
+	std::cout<<"06. Parallel chunks"<<std::endl;
+	HMParallel::SetNumThreads(4);
+	int n = 100000;
+	add_check(HMParallel::NumChunks(n, 1000) == 4 && HMParallel::NumChunks(10, 1000) == 1,
+			"number of chunks");
+	vector<int> hits(n, 0);
+	HMParallel::ForChunks(n, [&](int ib, int ie, int){
+		for (int i=ib; i<ie; ++i) ++hits[i];
+	});
+	add_check(std::all_of(hits.begin(), hits.end(), [](int h){ return h == 1; }),
+			"chunks cover range");
+	bool thrown = false;
+	try{
+		HMParallel::ForChunks(n, [&](int, int, int ichunk){
+			if (ichunk == 2) throw std::runtime_error("chunk failed");
+		});
+	} catch (std::runtime_error&){
+		thrown = true;
+	}
+	add_check(thrown, "exception from worker thread");
+
+	//tridiagonal matrix-vector product
+	vector<int> es, en;
+	for (int i=0; i<n-1; ++i){
+		es.push_back(en.size());
+		en.push_back(i); en.push_back(i+1);
+	}
+	es.push_back(en.size());
+	HMMath::CsrMat cm = HMMath::CsrMat::Pattern(n, es, en);
+	for (int i=0; i<n-1; ++i){
+		cm.add(i, i, 2); cm.add(i+1, i+1, 1.0/(i+1));
+		cm.add(i, i+1, -1); cm.add(i+1, i, -0.5);
+	}
+	vector<double> x(n), y1(n), y2(n);
+	for (int i=0; i<n; ++i) x[i] = sin(i);
+	cm.MultVec(x, y1);
+	HMParallel::SetNumThreads(1);
+	cm.MultVec(x, y2);
+	add_check(y1 == y2, "parallel matrix-vector product");
+}
+
+void test07(){
+	std::cout<<"07. Singular sparse system"<<std::endl;
+	//1d laplace with Neumann conditions only
+	int n = 30;
+	vector<int> es, en;
+	for (int i=0; i<n-1; ++i){
+		es.push_back(en.size());
+		en.push_back(i); en.push_back(i+1);
+	}
+	es.push_back(en.size());
+	HMMath::CsrMat cm = HMMath::CsrMat::Pattern(n, es, en);
+	for (int i=0; i<n-1; ++i){
+		cm.add(i, i, 1); cm.add(i+1, i+1, 1);
+		cm.add(i, i+1, -1); cm.add(i+1, i, -1);
+	}
+	//compatible right hand side
+	vector<double> rhs(n, 1), x, r(n);
+	rhs[0] = rhs[n-1] = -(n-2)/2.0;
+	HMMath::MatSolve::Factory(cm)->Solve(rhs, x);
+	cm.MultVec(x, r);
+	double d = 0;
+	for (int i=0; i<n; ++i) d = std::max(d, fabs(r[i] - rhs[i]));
+	add_check(d < 1e-8, "pure neumann system");
+}
+
 int main(){
 	test01();
+	test02();
+	test03();
+	test04();
+	test05();
+	test06();
+	test07();
 
 	HMTesting::check_final_report();
 	std::cout<<"DONE"<<std::endl;
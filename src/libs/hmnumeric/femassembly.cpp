@@ -1,16 +1,23 @@
 #include "femassembly.hpp"
+#include "hmparallel.hpp"
 
 using namespace HMFem;
 
 namespace{
 
 // =========================== 3 node cells
-shared_ptr<HMMath::LocMat> LaplaceLocalMatrix3(const HM2D::VertexData& points){
-	assert(points.size() == 3);
-	shared_ptr<HMMath::LocMat3Sym> ret(new HMMath::LocMat3Sym());
-	const double &x1 = points[0]->x, &x2 = points[1]->x, &x3 = points[2]->x;
-	const double &y1 = points[0]->y, &y2 = points[1]->y, &y3 = points[2]->y;
+//Local matrices of triangle cells are computed in batches.
+//Structure of arrays layout lets compiler vectorize kernel loops.
+struct TriBatch{
+	static const int N = 64;
+	int n = 0;
+	int cells[N];
+	double x1[N], x2[N], x3[N], y1[N], y2[N], y3[N];
+	//local matrices in row-major order
+	double a[9][N];
+};
 
+void LaplaceBatch3(TriBatch& b){
 	// x(k, e) = k*(x2-x1) + e*(x3-x1) + x1
 	// y(k, e) = k*(y2-y1) + e*(y3-y1) + y1
 	//
@@ -22,270 +29,285 @@ shared_ptr<HMMath::LocMat> LaplaceLocalMatrix3(const HM2D::VertexData& points){
 	//
 	// |dfdx| = InvJ * |dfdk|
 	// |dfdy|          |dfde|
-
-	double j11 = x2 - x1, j21 = x3 - x1;
-	double j12 = y2 - y1, j22 = y3 - y1;
-	double modjx2 = 2*(j22*j11 - j21*j12);
-	double j1222 = j12 - j22, j1121 = j11 - j21;
-
-	(*ret)[0] = ( sqr(j1222) + sqr(j1121))/modjx2;
-	(*ret)[1] = ( j22*j1222  + j21*j1121 )/modjx2;
-	(*ret)[2] = (-j11*j1121  - j12*j1222 )/modjx2;
-	(*ret)[3] = ( sqr(j22)   + sqr(j21)  )/modjx2;
-	(*ret)[4] = (-j12*j22    - j21*j11   )/modjx2;
-	(*ret)[5] = ( sqr(j11)   + sqr(j12)  )/modjx2;
-
-	return ret;
+	for (int k=0; k<b.n; ++k){
+		double j11 = b.x2[k] - b.x1[k], j21 = b.x3[k] - b.x1[k];
+		double j12 = b.y2[k] - b.y1[k], j22 = b.y3[k] - b.y1[k];
+		double modjx2 = 2*(j22*j11 - j21*j12);
+		double j1222 = j12 - j22, j1121 = j11 - j21;
+
+		b.a[0][k] = ( j1222*j1222 + j1121*j1121)/modjx2;
+		b.a[1][k] = b.a[3][k] = ( j22*j1222  + j21*j1121 )/modjx2;
+		b.a[2][k] = b.a[6][k] = (-j11*j1121  - j12*j1222 )/modjx2;
+		b.a[4][k] = ( j22*j22    + j21*j21   )/modjx2;
+		b.a[5][k] = b.a[7][k] = (-j12*j22    - j21*j11   )/modjx2;
+		b.a[8][k] = ( j11*j11    + j12*j12   )/modjx2;
+	}
 }
 
-shared_ptr<HMMath::LocMat> DDxLocalMatrix3(const HM2D::VertexData& points){
-	assert(points.size() == 3);
-	shared_ptr<HMMath::LocMat3> ret(new HMMath::LocMat3());
-	const double &y1 = points[0]->y, &y2 = points[1]->y, &y3 = points[2]->y;
-	double j12 = y2 - y1, j22 = y3 - y1;
-
-	(*ret)[0] = (*ret)[3] = (*ret)[6] = (-j22+j12)/6.0;
-	(*ret)[1] = (*ret)[4] = (*ret)[7] = j22/6.0;
-	(*ret)[2] = (*ret)[5] = (*ret)[8] = -j12/6.0;
-
-	return ret;
+void DDxBatch3(TriBatch& b){
+	for (int k=0; k<b.n; ++k){
+		double j12 = b.y2[k] - b.y1[k], j22 = b.y3[k] - b.y1[k];
+		b.a[0][k] = b.a[3][k] = b.a[6][k] = (-j22+j12)/6.0;
+		b.a[1][k] = b.a[4][k] = b.a[7][k] = j22/6.0;
+		b.a[2][k] = b.a[5][k] = b.a[8][k] = -j12/6.0;
+	}
 }
 
-shared_ptr<HMMath::LocMat> DDyLocalMatrix3(const HM2D::VertexData& points){
-	assert(points.size() == 3);
-	shared_ptr<HMMath::LocMat3> ret(new HMMath::LocMat3());
-	const double &x1 = points[0]->x, &x2 = points[1]->x, &x3 = points[2]->x;
-
-	double j11 = x2 - x1, j21 = x3 - x1;
-
-	(*ret)[0] = (*ret)[3] = (*ret)[6] = (j21-j11)/6.0;
-	(*ret)[1] = (*ret)[4] = (*ret)[7] = -j21/6.0;
-	(*ret)[2] = (*ret)[5] = (*ret)[8] = j11/6.0;
-
-	return ret;
+void DDyBatch3(TriBatch& b){
+	for (int k=0; k<b.n; ++k){
+		double j11 = b.x2[k] - b.x1[k], j21 = b.x3[k] - b.x1[k];
+		b.a[0][k] = b.a[3][k] = b.a[6][k] = (j21-j11)/6.0;
+		b.a[1][k] = b.a[4][k] = b.a[7][k] = -j21/6.0;
+		b.a[2][k] = b.a[5][k] = b.a[8][k] = j11/6.0;
+	}
 }
 
-shared_ptr<HMMath::LocMat> FullMassLocalMatrix3(const HM2D::VertexData& points){
-	assert(points.size() == 3);
-	shared_ptr<HMMath::LocMat3Sym> ret(new HMMath::LocMat3Sym());
-	const double &x1 = points[0]->x, &x2 = points[1]->x, &x3 = points[2]->x;
-	const double &y1 = points[0]->y, &y2 = points[1]->y, &y3 = points[2]->y;
-	double j11 = x2 - x1, j21 = x3 - x1;
-	double j12 = y2 - y1, j22 = y3 - y1;
-	double v1 = (j22*j11 - j21*j12)/12.0;
-	double v2 = v1/2.0;
-
-	(*ret)[0] = v1;
-	(*ret)[1] = v2;
-	(*ret)[2] = v2;
-	(*ret)[3] = v1;
-	(*ret)[4] = v2;
-	(*ret)[5] = v1;
-
-	return ret;
+void FullMassBatch3(TriBatch& b){
+	for (int k=0; k<b.n; ++k){
+		double j11 = b.x2[k] - b.x1[k], j21 = b.x3[k] - b.x1[k];
+		double j12 = b.y2[k] - b.y1[k], j22 = b.y3[k] - b.y1[k];
+		double v1 = (j22*j11 - j21*j12)/12.0;
+		double v2 = v1/2.0;
+		b.a[0][k] = b.a[4][k] = b.a[8][k] = v1;
+		b.a[1][k] = b.a[2][k] = b.a[3][k] = v2;
+		b.a[5][k] = b.a[6][k] = b.a[7][k] = v2;
+	}
 }
 
 // ============================ 4 node cells
-//integration in [-1, 1]x[-1, 1] square
-struct _Integration{
-	virtual double operator()(
-		std::function<double(double, double)> fun) = 0;
+struct QuadBatch{
+	static const int N = 64;
+	int n = 0;
+	int cells[N];
+	double x[4][N], y[4][N];
+	//local matrices in row-major order
+	double a[16][N];
 };
-//4nodes square integration
-struct Integration4: public _Integration{
-
-	const double x[4]={ 0.577350269189626e0,
-			-0.577350269189626e0,
-			-0.577350269189626e0,
-			 0.577350269189626e0
-	};
-	const double y[4]={ 0.577350269189626e0,
-			 0.577350269189626e0,
-			-0.577350269189626e0,
-			-0.577350269189626e0
-	};
-	const double w[4]={ 1,1,1,1};
 
-	double operator()(std::function<double(double, double)> fun){
-		_THROW_NOT_IMP_;
-	}
+//9 nodes gauss integration in [-1, 1]x[-1, 1] square
+const double gauss9_k[9] = {
+	 0.774596669241483e0, -0.774596669241483e0,
+	 0.774596669241483e0, -0.774596669241483e0,
+	 0.774596669241483e0, -0.774596669241483e0,
+	 0.0e0, 0.0e0, 0.0e0
 };
-
-//9nodes square integration
-struct Integration9: public _Integration{
-	const double x[9] = { 0.774596669241483e0,
-			-0.774596669241483e0,
-			 0.774596669241483e0,
-			-0.774596669241483e0,
-			 0.774596669241483e0,
-			-0.774596669241483e0,
-			 0.0e0,
-			 0.0e0,
-			 0.0e0
-	};
-	const double y[9] = { 
-			 0.774596669241483e0,
-			 0.774596669241483e0,
-			-0.774596669241483e0,
-			-0.774596669241483e0,
-			 0.0e0,
-			 0.0e0,
-			 0.774596669241483e0,
-			-0.774596669241483e0,
-			 0.0e0
-	};
-	const double w[9] = {
-			0.308641975308642e0,
-			0.308641975308642e0,
-			0.308641975308642e0,
-			0.308641975308642e0,
-			0.493827160493827e0,
-			0.493827160493827e0,
-			0.493827160493827e0,
-			0.493827160493827e0,
-			0.790123456790123e0
-	};
-	double operator()(std::function<double(double, double)> fun){
-		return w[0] * fun(x[0], y[0]) +
-		       w[1] * fun(x[1], y[1]) +
-		       w[2] * fun(x[2], y[2]) +
-		       w[3] * fun(x[3], y[3]) +
-		       w[4] * fun(x[4], y[4]) +
-		       w[5] * fun(x[5], y[5]) +
-		       w[6] * fun(x[6], y[6]) +
-		       w[7] * fun(x[7], y[7]) +
-		       w[8] * fun(x[8], y[8]);
-	}
+const double gauss9_e[9] = {
+	 0.774596669241483e0,  0.774596669241483e0,
+	-0.774596669241483e0, -0.774596669241483e0,
+	 0.0e0, 0.0e0,
+	 0.774596669241483e0, -0.774596669241483e0,
+	 0.0e0
+};
+const double gauss9_w[9] = {
+	0.308641975308642e0, 0.308641975308642e0,
+	0.308641975308642e0, 0.308641975308642e0,
+	0.493827160493827e0, 0.493827160493827e0,
+	0.493827160493827e0, 0.493827160493827e0,
+	0.790123456790123e0
 };
 
-//using 9-node integration
-std::unique_ptr<_Integration> NumIntegration(new Integration9());
-
-//stiff matrix 
-double stiff4(const HM2D::VertexData& pts, int i, int j, double k, double e){
-	//basic function derivatives
-	static const std::function<double(double, double)> ddk[4] ={
-		[](double x, double y){ return -(1-y)/4; },
-		[](double x, double y){ return  (1-y)/4; },
-		[](double x, double y){ return  (1+y)/4; },
-		[](double x, double y){ return -(1+y)/4;}
-	};
-	static const std::function<double(double, double)> dde[4] ={
-		[](double x, double y){ return -(1-x)/4; },
-		[](double x, double y){ return -(1+x)/4; },
-		[](double x, double y){ return  (1+x)/4; },
-		[](double x, double y){ return  (1-x)/4; }
-	};
-
-	const double &x0 = pts[0]->x, &x1 = pts[1]->x, &x2 = pts[2]->x, &x3 = pts[3]->x;
-	const double &y0 = pts[0]->y, &y1 = pts[1]->y, &y2 = pts[2]->y, &y3 = pts[3]->y;
-	double j11 = ((1-e)*(x1-x0)+(1+e)*(x2-x3))/4.0;
-	double j21 = ((1-k)*(x3-x0)+(1+k)*(x2-x1))/4.0;
-	double j12 = ((1-e)*(y1-y0)+(1+e)*(y2-y3))/4.0;
-	double j22 = ((1-k)*(y3-y0)+(1+k)*(y2-y1))/4.0;
-	double modj = j11*j22-j12*j21;
-
-	double didk = ddk[i](k, e); 
-	double djdk = ddk[j](k, e); 
-	double dide = dde[i](k, e); 
-	double djde = dde[j](k, e); 
-
-	double d1dx= j22*didk - j21*dide;
-	double d1dy=-j12*didk + j11*dide;
-	double d2dx= j22*djdk - j21*djde;
-	double d2dy=-j12*djdk + j11*djde;
-
-	return (d1dx*d2dx+d1dy*d2dy)/modj;
+void LaplaceBatch4(QuadBatch& b){
+	for (int i=0; i<16; ++i) std::fill(b.a[i], b.a[i] + b.n, 0.0);
+	for (int g=0; g<9; ++g){
+		double k = gauss9_k[g], e = gauss9_e[g], w = gauss9_w[g];
+		//basic function derivatives
+		double ddk[4] = {-(1-e)/4, (1-e)/4, (1+e)/4, -(1+e)/4};
+		double dde[4] = {-(1-k)/4, -(1+k)/4, (1+k)/4, (1-k)/4};
+		for (int m=0; m<b.n; ++m){
+			double j11 = ((1-e)*(b.x[1][m]-b.x[0][m])+(1+e)*(b.x[2][m]-b.x[3][m]))/4.0;
+			double j21 = ((1-k)*(b.x[3][m]-b.x[0][m])+(1+k)*(b.x[2][m]-b.x[1][m]))/4.0;
+			double j12 = ((1-e)*(b.y[1][m]-b.y[0][m])+(1+e)*(b.y[2][m]-b.y[3][m]))/4.0;
+			double j22 = ((1-k)*(b.y[3][m]-b.y[0][m])+(1+k)*(b.y[2][m]-b.y[1][m]))/4.0;
+			double modj = j11*j22-j12*j21;
+			double dx[4], dy[4];
+			for (int i=0; i<4; ++i){
+				dx[i] = j22*ddk[i] - j21*dde[i];
+				dy[i] =-j12*ddk[i] + j11*dde[i];
+			}
+			for (int i=0; i<4; ++i)
+			for (int j=i; j<4; ++j){
+				b.a[4*i+j][m] += w*(dx[i]*dx[j]+dy[i]*dy[j])/modj;
+			}
+		}
+	}
+	for (int i=1; i<4; ++i)
+	for (int j=0; j<i; ++j){
+		std::copy(b.a[4*j+i], b.a[4*j+i] + b.n, b.a[4*i+j]);
+	}
 }
 
-shared_ptr<HMMath::LocMat> LaplaceLocalMatrix4(const HM2D::VertexData& points){
-	using namespace std::placeholders;
-	assert(points.size() == 4);
-	shared_ptr<HMMath::LocMat4Sym> ret(new HMMath::LocMat4Sym());
-	auto& I = *NumIntegration;
-	(*ret)[0] = I(std::bind(stiff4, points, 0, 0, _1, _2));
-	(*ret)[1] = I(std::bind(stiff4, points, 0, 1, _1, _2));
-	(*ret)[2] = I(std::bind(stiff4, points, 0, 2, _1, _2));
-	(*ret)[3] = I(std::bind(stiff4, points, 0, 3, _1, _2));
-	(*ret)[4] = I(std::bind(stiff4, points, 1, 1, _1, _2));
-	(*ret)[5] = I(std::bind(stiff4, points, 1, 2, _1, _2));
-	(*ret)[6] = I(std::bind(stiff4, points, 1, 3, _1, _2));
-	(*ret)[7] = I(std::bind(stiff4, points, 2, 2, _1, _2));
-	(*ret)[8] = I(std::bind(stiff4, points, 2, 3, _1, _2));
-	(*ret)[9] = I(std::bind(stiff4, points, 3, 3, _1, _2));
-	return ret;
+// ============================== Global assembling
+enum class Kernel {Laplace, FullMass, DDx, DDy};
+
+void (*batch3(Kernel k))(TriBatch&){
+	switch (k){
+		case Kernel::Laplace: return LaplaceBatch3;
+		case Kernel::FullMass: return FullMassBatch3;
+		case Kernel::DDx: return DDxBatch3;
+		case Kernel::DDy: return DDyBatch3;
+	}
+	return 0;
 }
 
-shared_ptr<HMMath::LocMat> DDxLocalMatrix4(const HM2D::VertexData& points){
-	_THROW_NOT_IMP_;
-}
-shared_ptr<HMMath::LocMat> DDyLocalMatrix4(const HM2D::VertexData& points){
-	_THROW_NOT_IMP_;
-}
-shared_ptr<HMMath::LocMat> FullMassLocalMatrix4(const HM2D::VertexData& points){
-	_THROW_NOT_IMP_;
+//quadrangle cells are implemented only for laplace kernel
+void (*batch4(Kernel k))(QuadBatch&){
+	switch (k){
+		case Kernel::Laplace: return LaplaceBatch4;
+		default: return 0;
+	}
 }
 
-shared_ptr<HMMath::LocMat> LaplaceLocalMatrix(const HM2D::VertexData& points){
-	if (points.size() == 3) return LaplaceLocalMatrix3(points);
-	else return LaplaceLocalMatrix4(points);
 }
-shared_ptr<HMMath::LocMat> FullMassLocalMatrix(const HM2D::VertexData& points){
-	if (points.size() == 3) return FullMassLocalMatrix3(points);
-	else return FullMassLocalMatrix4(points);
-}
-shared_ptr<HMMath::LocMat> DDxLocalMatrix(const HM2D::VertexData& points){
-	if (points.size() == 3) return DDxLocalMatrix3(points);
-	else return DDxLocalMatrix4(points);
-}
-shared_ptr<HMMath::LocMat> DDyLocalMatrix(const HM2D::VertexData& points){
-	if (points.size() == 3) return DDyLocalMatrix3(points);
-	else return DDyLocalMatrix4(points);
+
+void HMFem::Impl::CellVertices(const HM2D::GridData& grid, vector<int>& cv_start, vector<int>& cv){
+	aa::enumerate_ids_pvec(grid.vvert);
+	int nc = grid.vcells.size();
+	cv_start.resize(nc+1);
+	cv_start[0] = 0;
+	for (int i=0; i<nc; ++i) cv_start[i+1] = cv_start[i] + grid.vcells[i]->edges.size();
+	cv.resize(cv_start.back());
+	HMParallel::ForChunks(nc, [&](int ib, int ie, int){
+		for (int i=ib; i<ie; ++i){
+			HM2D::VertexData pp = HM2D::Contour::OrderedPoints1(grid.vcells[i]->edges);
+			for (int k=0; k<pp.size(); ++k) cv[cv_start[i]+k] = pp[k]->id;
+		}
+	}, 5000);
 }
 
+vector<int> HMFem::Impl::ColorCells(int nvert, const vector<int>& cv_start, const vector<int>& cv,
+		vector<int>& color_start){
+	int nc = cv_start.size() - 1;
+	//vertex -> cells
+	vector<int> vc_start(nvert+1, 0), vc(cv.size());
+	for (auto v: cv) ++vc_start[v+1];
+	for (int i=0; i<nvert; ++i) vc_start[i+1] += vc_start[i];
+	vector<int> pos(vc_start.begin(), vc_start.end()-1);
+	for (int ic=0; ic<nc; ++ic)
+	for (int k=cv_start[ic]; k<cv_start[ic+1]; ++k) vc[pos[cv[k]]++] = ic;
+
+	vector<int> color(nc, -1), forbidden, ncolor;
+	for (int ic=0; ic<nc; ++ic){
+		for (int k=cv_start[ic]; k<cv_start[ic+1]; ++k)
+		for (int m=vc_start[cv[k]]; m<vc_start[cv[k]+1]; ++m){
+			int c = color[vc[m]];
+			if (c >= 0) forbidden[c] = ic;
+		}
+		int c = 0;
+		while (c < forbidden.size() && forbidden[c] == ic) ++c;
+		if (c == forbidden.size()){
+			forbidden.push_back(-1);
+			ncolor.push_back(0);
+		}
+		color[ic] = c;
+		++ncolor[c];
+	}
 
+	color_start.resize(ncolor.size()+1);
+	color_start[0] = 0;
+	for (int c=0; c<ncolor.size(); ++c) color_start[c+1] = color_start[c] + ncolor[c];
+	vector<int> ret(nc);
+	pos.assign(color_start.begin(), color_start.end()-1);
+	for (int ic=0; ic<nc; ++ic) ret[pos[color[ic]]++] = ic;
+	return ret;
 }
 
-// ============================== Global assembling
 namespace{
 
-shared_ptr<HMMath::Mat> GlobAssembly(const HM2D::GridData& grid, 
-		decltype(LaplaceLocalMatrix)& fun){
-	aa::enumerate_ids_pvec(grid.vvert);
-	shared_ptr<HMMath::Mat> ret(new HMMath::Mat());
-	for (int i=0; i<grid.vcells.size(); ++i){
-		HM2D::VertexData pp = HM2D::Contour::OrderedPoints1(grid.vcells[i]->edges);
-		shared_ptr<HMMath::LocMat> A = fun(pp);
-		vector<int> pind(pp.size());
-		std::transform(pp.begin(), pp.end(), pind.begin(), 
-				[](const shared_ptr<HM2D::Vertex>& p){ return p->id; });
-		A->ToMat(pind, *ret);
+//adds local matrices of cells[0], ..., cells[ncells-1] to target
+void assemble_cells(const HM2D::GridData& grid, Kernel kern,
+		const vector<int>& cv_start, const vector<int>& cv,
+		const int* cells, int ncells, HMMath::CsrMat& target){
+	auto fun3 = batch3(kern);
+	auto fun4 = batch4(kern);
+	TriBatch b;
+	QuadBatch q;
+	auto flush3 = [&](){
+		fun3(b);
+		double a[9];
+		int pind[3];
+		for (int k=0; k<b.n; ++k){
+			for (int i=0; i<9; ++i) a[i] = b.a[i][k];
+			const int* c = &cv[cv_start[b.cells[k]]];
+			pind[0] = c[0]; pind[1] = c[1]; pind[2] = c[2];
+			target.add_dense(3, pind, a);
+		}
+		b.n = 0;
+	};
+	auto flush4 = [&](){
+		fun4(q);
+		double a[16];
+		for (int k=0; k<q.n; ++k){
+			for (int i=0; i<16; ++i) a[i] = q.a[i][k];
+			target.add_dense(4, &cv[cv_start[q.cells[k]]], a);
+		}
+		q.n = 0;
+	};
+	for (int i=0; i<ncells; ++i){
+		int ic = cells[i];
+		const int* c = &cv[cv_start[ic]];
+		if (cv_start[ic+1] - cv_start[ic] == 3){
+			b.cells[b.n] = ic;
+			b.x1[b.n] = grid.vvert[c[0]]->x; b.y1[b.n] = grid.vvert[c[0]]->y;
+			b.x2[b.n] = grid.vvert[c[1]]->x; b.y2[b.n] = grid.vvert[c[1]]->y;
+			b.x3[b.n] = grid.vvert[c[2]]->x; b.y3[b.n] = grid.vvert[c[2]]->y;
+			if (++b.n == TriBatch::N) flush3();
+		} else if (cv_start[ic+1] - cv_start[ic] == 4 && fun4 != 0){
+			q.cells[q.n] = ic;
+			for (int k=0; k<4; ++k){
+				q.x[k][q.n] = grid.vvert[c[k]]->x;
+				q.y[k][q.n] = grid.vvert[c[k]]->y;
+			}
+			if (++q.n == QuadBatch::N) flush4();
+		} else {
+			_THROW_NOT_IMP_;
+		}
+	}
+	if (b.n > 0) flush3();
+	if (q.n > 0) flush4();
+}
+
+shared_ptr<HMMath::CsrMat> GlobAssembly(const HM2D::GridData& grid, Kernel kern){
+	vector<int> cv_start, cv;
+	Impl::CellVertices(grid, cv_start, cv);
+	//symbolic phase
+	shared_ptr<HMMath::CsrMat> ret(new HMMath::CsrMat(
+		HMMath::CsrMat::Pattern(grid.vvert.size(), cv_start, cv)));
+	//numeric phase.
+	//cells of one color modify different matrix rows.
+	//Colored order is used regardless of threads number
+	//so that summation order and hence the result do not depend on it.
+	vector<int> color_start;
+	vector<int> cells = Impl::ColorCells(grid.vvert.size(), cv_start, cv, color_start);
+	for (int c=0; c<color_start.size()-1; ++c){
+		const int* cc = cells.data() + color_start[c];
+		HMParallel::ForChunks(color_start[c+1] - color_start[c], [&](int ib, int ie, int){
+			assemble_cells(grid, kern, cv_start, cv, cc + ib, ie - ib, *ret);
+		}, 2000);
 	}
 	return ret;
 }
 
 }
-shared_ptr<HMMath::Mat> Assemble::PureLaplace(const HM2D::GridData& grid){
-	return GlobAssembly(grid, LaplaceLocalMatrix);
+shared_ptr<HMMath::CsrMat> Assemble::PureLaplace(const HM2D::GridData& grid){
+	return GlobAssembly(grid, Kernel::Laplace);
 }
 
-shared_ptr<HMMath::Mat> Assemble::FullMass(const HM2D::GridData& grid){
-	return GlobAssembly(grid, FullMassLocalMatrix);
+shared_ptr<HMMath::CsrMat> Assemble::FullMass(const HM2D::GridData& grid){
+	return GlobAssembly(grid, Kernel::FullMass);
 }
 
-shared_ptr<HMMath::Mat> Assemble::DDx(const HM2D::GridData& grid){
-	return GlobAssembly(grid, DDxLocalMatrix);
+shared_ptr<HMMath::CsrMat> Assemble::DDx(const HM2D::GridData& grid){
+	return GlobAssembly(grid, Kernel::DDx);
 }
 
-shared_ptr<HMMath::Mat> Assemble::DDy(const HM2D::GridData& grid){
-	return GlobAssembly(grid, DDyLocalMatrix);
+shared_ptr<HMMath::CsrMat> Assemble::DDy(const HM2D::GridData& grid){
+	return GlobAssembly(grid, Kernel::DDy);
 }
 
 vector<double> Assemble::LumpMass(const HM2D::GridData& grid){
-	shared_ptr<HMMath::Mat> m = FullMass(grid);
+	shared_ptr<HMMath::CsrMat> m = FullMass(grid);
 	vector<double> tmp(m->rows(), 1.0);
 	vector<double> ret(m->rows(), 0.0);
 	m->MultVec(tmp, ret);
 	return ret;
 }
-
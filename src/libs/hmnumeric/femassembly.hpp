@@ -9,24 +9,37 @@ namespace HMFem{
 namespace Assemble{
 
 //== grad(p_i) . grad(p_j)
-shared_ptr<HMMath::Mat> PureLaplace(const HM2D::GridData& grid);
+shared_ptr<HMMath::CsrMat> PureLaplace(const HM2D::GridData& grid);
 
 //== p_i * p_j
-shared_ptr<HMMath::Mat> FullMass(const HM2D::GridData& grid);
+shared_ptr<HMMath::CsrMat> FullMass(const HM2D::GridData& grid);
 
 //== p_i
 vector<double> LumpMass(const HM2D::GridData& grid);
 
 //== dp_j /dx * p_i 
-shared_ptr<HMMath::Mat> DDx(const HM2D::GridData& grid);
+shared_ptr<HMMath::CsrMat> DDx(const HM2D::GridData& grid);
 
 //== dp_j /dy * p_i 
-shared_ptr<HMMath::Mat> DDy(const HM2D::GridData& grid);
+shared_ptr<HMMath::CsrMat> DDy(const HM2D::GridData& grid);
 
 
 
 }//Assemble
 
+namespace Impl{
+
+//cell vertices in CSR format. Enumerates grid vertices.
+void CellVertices(const HM2D::GridData& grid, vector<int>& cv_start, vector<int>& cv);
+
+//Greedy coloring of cells: cells of the same color have no common vertices,
+//hence they could be assembled concurrently.
+//Returns cells sorted by colors, color_start[i] is the first cell of i-th color.
+vector<int> ColorCells(int nvert, const vector<int>& cv_start, const vector<int>& cv,
+		vector<int>& color_start);
+
+}//Impl
+
 
 
 
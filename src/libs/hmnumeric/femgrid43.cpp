@@ -7,6 +7,7 @@
 #include "trigrid.hpp"
 #include "finder2d.hpp"
 #include "buildcont.hpp"
+#include "hmparallel.hpp"
 
 using namespace HMFem;
 
@@ -62,16 +63,15 @@ void Grid43::AddSegments(HM2D::GridData& grid, const vector<vector<Point>>& pts)
 
 Grid43::Approximator::Approximator(const HM2D::GridData* g, int n): grid(g){
 	auto bbox = HM2D::BBox(g->vcells);
-	double L = bbox.maxlen()/n;
-	cfinder.reset(new BoundingBoxFinder(bbox, L));
+	outer_dist = bbox.maxlen()/n;
 	int nc = g->vcells.size();
 	icellvert.resize(nc);
 	cellvert.resize(nc);
 	is3.resize(nc, true);
+	vector<BoundingBox> cbb(nc);
 	for (int ic=0; ic<nc; ++ic){
 		auto op = HM2D::Contour::OrderedPoints1(g->vcells[ic]->edges);
-		auto bb = HM2D::BBox(op);
-		cfinder->addentry(bb);
+		cbb[ic] = HM2D::BBox(op);
 		if (op.size() < 3 || op.size() > 4) throw std::runtime_error(
 			"invalid grid was passed to approximator");
 		cellvert[ic][0] = op[0].get();
@@ -82,6 +82,7 @@ Grid43::Approximator::Approximator(const HM2D::GridData* g, int n): grid(g){
 			is3[ic] = false;
 		}
 	}
+	cfinder.reset(new BoundingBoxTree(cbb));
 	aa::enumerate_ids_pvec(g->vvert);
 	for (int ic=0; ic<nc; ++ic){
 		icellvert[ic][0] = cellvert[ic][0]->id;
@@ -89,6 +90,25 @@ Grid43::Approximator::Approximator(const HM2D::GridData* g, int n): grid(g){
 		icellvert[ic][2] = cellvert[ic][2]->id;
 		if (!is3[ic]) icellvert[ic][3] = cellvert[ic][3]->id;
 	}
+	all3 = std::all_of(is3.begin(), is3.end(), [](bool b){ return b; });
+	//cell neighbours
+	aa::enumerate_ids_pvec(g->vcells);
+	cellnb.resize(nc, {-1, -1, -1, -1});
+	for (int ic=0; ic<nc; ++ic){
+		int n = is3[ic] ? 3 : 4;
+		for (auto& e: g->vcells[ic]->edges){
+			auto nb = (e->left.lock() == g->vcells[ic]) ? e->right.lock() : e->left.lock();
+			if (!nb) continue;
+			for (int i=0; i<n; ++i){
+				auto v1 = cellvert[ic][i], v2 = cellvert[ic][(i+1)%n];
+				if ((v1 == e->pfirst() && v2 == e->plast()) ||
+				    (v2 == e->pfirst() && v1 == e->plast())){
+					cellnb[ic][i] = nb->id;
+					break;
+				}
+			}
+		}
+	}
 };
 Point Grid43::Approximator::LocalCoordinates(int c, Point p) const{
 	if (is3[c]) return LocalCoordinates3(c, p);
@@ -160,32 +180,49 @@ void Grid43::Approximator::FillJ4(std::array<double, 5>& J, const Point& p, int
 	_THROW_NOT_IMP_;
 }
 
-int Grid43::Approximator::FindPositive(const Point& p, Point& ksieta) const{
-	auto candidates = cfinder->suspects(p);
+vector<int> Grid43::Approximator::Candidates(const Point& p) const{
+	//neighbouring cells are included as it was done by the raster finder:
+	//boundary coordinates and outer approximation searches rely on them.
+	return cfinder->suspects(BoundingBox(p, outer_dist));
+}
+
+bool Grid43::Approximator::Contains(int c, const Point& p, Point& ke) const{
 	std::array<double, 5> J; //modj, j11, j12, j21, j22
+	if (is3[c]){FillJ3(J, c);}
+	else { _THROW_NOT_IMP_;}
+	if (fabs(J[0]) < geps*geps){
+		double ksi;
+		if (isOnSection(p, *cellvert[c][0], *cellvert[c][1], ksi)){
+			ke = Point(ksi, 0);
+		} else if (isOnSection(p, *cellvert[c][1], *cellvert[c][2], ksi)){
+			ke = Point(1-ksi, ksi);
+		} else if (isOnSection(p, *cellvert[c][0], *cellvert[c][2], ksi)){
+			ke = Point(0, ksi);
+		} else assert(false);
+	} else {
+		auto cp = cellvert[c][0];
+		ke.x = ( J[4]*(p.x - cp->x) - J[3]*(p.y - cp->y))/J[0];
+		ke.y = (-J[2]*(p.x - cp->x) + J[1]*(p.y - cp->y))/J[0];
+	}
+	return J[0] > -geps*geps && ke.x>-geps && ke.x<1+geps && ke.y>-geps && ke.y<1-ke.x+geps;
+}
+
+int Grid43::Approximator::FindPositive(const Point& p, Point& ksieta) const{
+	//cells which boxes contain p are checked first.
+	int ret = -1;
+	cfinder->visit(p, [&](int c){
+		if (!Contains(c, p, ksieta)) return true;
+		ret = c;
+		return false;
+	});
+	if (ret >= 0) return ret;
+	//widened search only if no positive cell contains p
+	auto candidates = Candidates(p);
 	std::vector<Point> bad_ksieta(candidates.size());
 	for (int i=0; i<candidates.size(); ++i){
-		auto& c = candidates[i];
-		auto& ke = bad_ksieta[i];
-		if (is3[c]){FillJ3(J, c);}
-		else { _THROW_NOT_IMP_;}
-		if (fabs(J[0]) < geps*geps){
-			double ksi;
-			if (isOnSection(p, *cellvert[c][0], *cellvert[c][1], ksi)){
-				ke = Point(ksi, 0);
-			} else if (isOnSection(p, *cellvert[c][1], *cellvert[c][2], ksi)){
-				ke = Point(1-ksi, ksi);
-			} else if (isOnSection(p, *cellvert[c][0], *cellvert[c][2], ksi)){
-				ke = Point(0, ksi);
-			} else assert(false);
-		} else {
-			auto cp = cellvert[c][0];
-			ke.x = ( J[4]*(p.x - cp->x) - J[3]*(p.y - cp->y))/J[0];
-			ke.y = (-J[2]*(p.x - cp->x) + J[1]*(p.y - cp->y))/J[0];
-		}
-		if (J[0] > -geps*geps && ke.x>-geps && ke.x<1+geps && ke.y>-geps && ke.y<1-ke.x+geps){
-			ksieta = ke;
-			return c;
+		if (Contains(candidates[i], p, bad_ksieta[i])){
+			ksieta = bad_ksieta[i];
+			return candidates[i];
 		}
 	}
 	//find best outer approximation
@@ -210,6 +247,105 @@ int Grid43::Approximator::FindPositive(const Point& p, Point& ksieta) const{
 	} else throw Grid43::Approximator::EOutOfArea();
 }
 
+int Grid43::Approximator::Walk(int c, const Point& p, Point& ksieta) const{
+	int maxsteps = 10 + 4*sqrt(cellnb.size());
+	std::array<double, 5> J;
+	for (int step=0; step<maxsteps; ++step){
+		FillJ3(J, c);
+		if (J[0] < geps*geps) return -1;
+		auto cp = cellvert[c][0];
+		double ksi = ( J[4]*(p.x - cp->x) - J[3]*(p.y - cp->y))/J[0];
+		double eta = (-J[2]*(p.x - cp->x) + J[1]*(p.y - cp->y))/J[0];
+		if (ksi>-geps && ksi<1+geps && eta>-geps && eta<1-ksi+geps){
+			ksieta.set(ksi, eta);
+			return c;
+		}
+		//cross the edge opposite to the most negative barycentric coordinate
+		double l[3] = {1-ksi-eta, ksi, eta};
+		int k = std::min_element(l, l+3) - l;
+		c = cellnb[c][(k+1)%3];
+		if (c < 0) return -1;
+	}
+	return -1;
+}
+
+namespace{
+//index of (x, y) point of [0, 2^16)x[0, 2^16) lattice along Hilbert curve
+uint64_t hilbert_index(uint32_t x, uint32_t y){
+	const uint32_t n = 1<<16;
+	uint64_t d = 0;
+	for (uint32_t s=n/2; s>0; s/=2){
+		uint32_t rx = (x & s) > 0;
+		uint32_t ry = (y & s) > 0;
+		d += (uint64_t)s * s * ((3*rx) ^ ry);
+		if (ry == 0){
+			if (rx == 1){ x = n-1-x; y = n-1-y; }
+			std::swap(x, y);
+		}
+	}
+	return d;
+}
+}
+
+Grid43::Approximator::Locations Grid43::Approximator::Locate(const vector<Point>& pts) const{
+	int np = pts.size();
+	Locations ret;
+	ret.cell.resize(np, -1);
+	ret.ksi.resize(np, 0);
+	ret.eta.resize(np, 0);
+	if (np == 0) return ret;
+
+	//order along Hilbert curve
+	BoundingBox bb = BoundingBox::Build(pts.begin(), pts.end());
+	double L = std::max(bb.maxlen(), geps);
+	vector<std::pair<uint64_t, int>> order(np);
+	HMParallel::ForChunks(np, [&](int ib, int ie, int){
+		for (int i=ib; i<ie; ++i){
+			uint32_t x = (pts[i].x - bb.xmin)/L*65535;
+			uint32_t y = (pts[i].y - bb.ymin)/L*65535;
+			order[i] = std::make_pair(hilbert_index(x, y), i);
+		}
+	});
+	std::sort(order.begin(), order.end());
+
+	//jump and walk
+	HMParallel::ForChunks(np, [&](int ib, int ie, int){
+		int c = -1;
+		Point ke;
+		for (int k=ib; k<ie; ++k){
+			int i = order[k].second;
+			int fnd = (all3 && c >= 0) ? Walk(c, pts[i], ke) : -1;
+			if (fnd < 0) try{
+				fnd = FindPositive(pts[i], ke);
+			} catch (EOutOfArea&){
+				continue;
+			}
+			c = fnd;
+			ret.cell[i] = fnd;
+			ret.ksi[i] = ke.x;
+			ret.eta[i] = ke.y;
+		}
+	}, 500);
+	return ret;
+}
+
+vector<vector<double>> Grid43::Approximator::Vals(const Locations& loc,
+		const vector<const vector<double>*>& funs) const{
+	int np = loc.cell.size();
+	vector<vector<double>> ret(funs.size(), vector<double>(np));
+	HMParallel::ForChunks(np, [&](int ib, int ie, int){
+		for (int i=ib; i<ie; ++i){
+			int c = loc.cell[i];
+			if (c < 0) throw EOutOfArea();
+			Point ke(loc.ksi[i], loc.eta[i]);
+			for (int k=0; k<funs.size(); ++k){
+				ret[k][i] = Interpolate(c, ke, *funs[k]);
+			}
+		}
+	});
+	return ret;
+}
+
 double Grid43::Approximator::Val(Point p, const vector<double>& fun) const{
 	Point ksieta;
 	int c = FindPositive(p, ksieta);
@@ -226,7 +362,7 @@ vector<double> Grid43::Approximator::Vals(Point p, const vector<const vector<dou
 }
 
 std::tuple<int, int, double> Grid43::Approximator::BndCoordinates(Point p) const{
-	vector<int> susp = cfinder->suspects(p);
+	vector<int> susp = Candidates(p);
 	int e1=-1, e2;
 	double mindist = 1e32;
 	double ksi;
@@ -10,12 +10,17 @@ namespace Grid43{
 
 class Approximator{
 	const HM2D::GridData* grid;
-	shared_ptr<BoundingBoxFinder> cfinder;
+	shared_ptr<BoundingBoxTree> cfinder;
+	//if point lies outside all cells, candidates are searched within this distance
+	double outer_dist;
 	vector<std::array<HM2D::Vertex*, 4>> cellvert;
 	vector<std::array<int, 4>> icellvert;
 	vector<bool> is3;
-	//try to find point amoung cells with positive ordering.
-	//if fails->searches amoung others
+	//neighbouring cell across (cellvert[i], cellvert[i+1]) edge or -1
+	vector<std::array<int, 4>> cellnb;
+	bool all3;
+	//try to find point amoung positive cells which boxes contain it.
+	//if fails->searches amoung all cells within outer_dist
 	//if fails->throws EOutOfArea
 	int FindPositive(const Point& p, Point& ksieta) const;
 	void FillJ3(std::array<double, 5>& J, int ic) const;
@@ -29,12 +34,33 @@ class Approximator{
 	double Interpolate4(int ic, Point ksieta, const vector<double>& fun) const;
 	
 	std::tuple<int, int, double> BndCoordinates(Point p) const;
+	//cells which bounding boxes lie within outer_dist from p
+	vector<int> Candidates(const Point& p) const;
+	//computes local coordinates of p in cell c.
+	//Returns true if c is positive and contains p.
+	bool Contains(int c, const Point& p, Point& ksieta) const;
+	//walks from triangle c towards p through positive triangles.
+	//Returns -1 if walk leaves the grid or meets non-positive cell.
+	int Walk(int c, const Point& p, Point& ksieta) const;
 public:
 	struct EOutOfArea: public std::runtime_error{
 		EOutOfArea(): std::runtime_error("out of area"){}
 	};
 	Approximator(const HM2D::GridData* g, int n=40);
 
+	//batch point location results as structure of arrays
+	struct Locations{
+		vector<int> cell;   //-1 for points out of area
+		vector<double> ksi, eta;
+	};
+	//Points are ordered along Hilbert curve and each one is searched by
+	//walking from the previous hit cell. Failed walks fall back to
+	//bounding box search. Ordered points are processed by parallel chunks.
+	Locations Locate(const vector<Point>& pts) const;
+	//ret[i][j] is funs[i] value at j-th located point.
+	//Throws EOutOfArea if any point was not located.
+	vector<vector<double>> Vals(const Locations& loc, const vector<const vector<double>*>& funs) const;
+
 	//function value calculator.
 	//If p is not within grid throws OutOfArea
 	double Val(Point p, const vector<double>& fun) const;
@@ -27,7 +27,7 @@ LaplaceProblem::LaplaceProblem(const HM2D::GridData& g):
 		solution_mat(),
 		rhs(grid->vvert.size(), 0.0){}
 
-LaplaceProblem::LaplaceProblem(const HM2D::GridData& g, shared_ptr<HMMath::Mat> lap):
+LaplaceProblem::LaplaceProblem(const HM2D::GridData& g, shared_ptr<HMMath::CsrMat> lap):
 		grid(&g), laplas_mat(lap),
 		solution_mat(),
 		rhs(grid->vvert.size(), 0.0){}
@@ -61,9 +61,8 @@ void LaplaceProblem::SetNeumann(const HM2D::VertexData& pts, TNeuFunc f){
 	_THROW_NOT_IMP_;
 }
 
-void LaplaceProblem::RebuildSolutionMatrix(){
+void LaplaceProblem::AssembleRhs(){
 	std::fill(rhs.begin(), rhs.end(), 0.0);
-	solution_mat = *laplas_mat;
 
 	//Neumann
 	for (auto& nc: neumann_data){
@@ -74,16 +73,53 @@ void LaplaceProblem::RebuildSolutionMatrix(){
 	}
 
 	//Dirichlet. Strictly after Neumann
+	vector<char> isdir(rhs.size(), 0);
+	for (auto& dc: dirichlet_data) isdir[dc.index] = 1;
 	for (auto& dc: dirichlet_data){
-		//put 1 to diagonal and value to rhs
+		//put value to rhs
 		double val = (*dc.fun)(grid->vvert[dc.index].get());
+		rhs[dc.index] = val;
+		//move known values of unknown rows to rhs
+		const HMMath::CsrMat& lm = *laplas_mat;
+		for (int k=lm.start[dc.index]; k<lm.start[dc.index+1]; ++k){
+			int j = lm.cols[k];
+			if (!isdir[j]) rhs[j] -= lm.get(j, dc.index)*val;
+		}
+	}
+}
+
+void LaplaceProblem::RebuildSolutionMatrix(){
+	//matrix depends only on the set of Dirichlet points.
+	//If it was not changed current factorization is used.
+	vector<int> dirpts;
+	dirpts.reserve(dirichlet_data.size());
+	for (auto& dc: dirichlet_data) dirpts.push_back(dc.index);
+	if (solver && dirpts == solver_dirpts){
+		AssembleRhs();
+		return;
+	}
+
+	//pattern and symbolic analysis are shared with laplas_mat
+	if (solver) solution_mat.vals = laplas_mat->vals;
+	else solution_mat = *laplas_mat;
+
+	//Dirichlet: put 1 to diagonal and zeros to the rest of row and column
+	//so that matrix stays symmetric
+	for (auto& dc: dirichlet_data){
 		solution_mat.clear_row(dc.index);
 		solution_mat.set(dc.index, dc.index, 1.0);
-		rhs[dc.index] = val;
+		for (int k=solution_mat.start[dc.index]; k<solution_mat.start[dc.index+1]; ++k){
+			int j = solution_mat.cols[k];
+			if (j != dc.index) solution_mat.set(j, dc.index, 0.0);
+		}
 	}
+	AssembleRhs();
 
-	//solver initialization
-	solver = HMMath::MatSolve::Factory(solution_mat);
+	//solver initialization: numeric refactorization if possible
+	if (!solver || !solver->Refactor(solution_mat)){
+		solver = HMMath::MatSolve::Factory(solution_mat);
+	}
+	solver_dirpts = std::move(dirpts);
 }
 
 //solve Ax=0
@@ -98,25 +134,7 @@ void LaplaceProblem::QuickSolve(vector<double>& ans){
 }
 
 void LaplaceProblem::QuickSolve_BC(vector<double>& ans){
-	std::fill(rhs.begin(), rhs.end(), 0.0);
-
-	//Neumann
-	for (auto& nc: neumann_data){
-		//val = (df/dn)*L/2;
-		double val = ((*nc.fun)(grid->vvert[nc.index1].get(), grid->vvert[nc.index2].get())) * nc.dist / 2;
-		rhs[nc.index1] += val;
-		rhs[nc.index2] += val;
-	}
-
-	//Dirichlet. Strictly after Neumann
-	for (auto& dc: dirichlet_data){
-		//put 1 to diagonal and value to rhs
-		double val = (*dc.fun)(grid->vvert[dc.index].get());
-		solution_mat.clear_row(dc.index);
-		solution_mat.set(dc.index, dc.index, 1.0);
-		rhs[dc.index] = val;
-	}
-
+	AssembleRhs();
 	solver->Solve(rhs, ans);
 }
 
@@ -38,10 +38,12 @@ class LaplaceProblem{
 	//Grids
 	const HM2D::GridData* grid;
 	//Matricies
-	shared_ptr<HMMath::Mat> laplas_mat;
+	shared_ptr<HMMath::CsrMat> laplas_mat;
 
-	HMMath::Mat solution_mat;
+	HMMath::CsrMat solution_mat;
 	shared_ptr<HMMath::MatSolve> solver;
+	//Dirichlet points used for solver construction
+	vector<int> solver_dirpts;
 	vector<double> rhs;
 	//boundary condition data
 	std::list<TNeuFunc> _neufunc;
@@ -50,6 +52,9 @@ class LaplaceProblem{
 	std::set<TDirData, TDirCmp> dirichlet_data;
 
 	void RebuildSolutionMatrix();
+	//fills rhs with boundary conditions.
+	//Dirichlet values are eliminated from non-Dirichlet rows.
+	void AssembleRhs();
 
 	mutable std::set<HM2D::Vertex> _bp;
 	const HM2D::Vertex* get_boundary_point(const Point& p) const;
@@ -59,7 +64,7 @@ public:
 	//build laplas operator
 	LaplaceProblem(const HM2D::GridData& g);
 	//using prebuilt laplas matrix
-	LaplaceProblem(const HM2D::GridData& g, shared_ptr<HMMath::Mat> lap);
+	LaplaceProblem(const HM2D::GridData& g, shared_ptr<HMMath::CsrMat> lap);
 
 	//boundary conditions: using vector of grid points
 	void ClearBC();
@@ -1,10 +1,17 @@
 #include "laplace_bem2d.hpp"
 #include "densemat.hpp"
 #include "treverter2d.hpp"
+#include "hmatrix.hpp"
+#include "hmparallel.hpp"
 
 using namespace HMBem;
 
-LaplaceCE2D::LaplaceCE2D(const HM2D::Contour::Tree& area){
+namespace{
+//matrix size starting from which AUTO method uses hierarchical matrices
+const double HMATRIX_MIN_SIZE = 4e6;
+}
+
+LaplaceCE2D::LaplaceCE2D(const HM2D::Contour::Tree& area, Method method): method(method){
 	no_bmap = true;
 	N = 0;
 	for (auto& nd: area.nodes){
@@ -45,7 +52,32 @@ LaplaceCE2D::LaplaceCE2D(const HM2D::Contour::Tree& area){
 	}
 };
 
+bool LaplaceCE2D::use_hmatrix(int nrows) const{
+	switch (method){
+		case Method::DENSE: return false;
+		case Method::HMATRIX: return true;
+		default: return (double)nrows*N >= HMATRIX_MIN_SIZE;
+	}
+}
+
+vector<double> LaplaceCE2D::segment_boxes() const{
+	vector<double> ret(4*N);
+	for (int i=0; i<N; ++i){
+		double xe = xs[i] - ny[i]*len[i], ye = ys[i] + nx[i]*len[i];
+		ret[4*i] = std::min(xs[i], xe);
+		ret[4*i+1] = std::min(ys[i], ye);
+		ret[4*i+2] = std::max(xs[i], xe);
+		ret[4*i+3] = std::max(ys[i], ye);
+	}
+	return ret;
+}
+
 void LaplaceCE2D::Solve(){
+	if (use_hmatrix(N)) solve_hmatrix();
+	else solve_dense();
+}
+
+void LaplaceCE2D::solve_dense(){
 	HMMath::DenseMat mat(N);
 	std::vector<double> rhs(N, 0);
 	vector<double>::iterator matiter = mat.dt.begin();
@@ -72,6 +104,57 @@ void LaplaceCE2D::Solve(){
 	}
 }
 
+void LaplaceCE2D::solve_hmatrix(){
+	//System matrix is -G*Pd + H*Pn, right hand side is -H*Pd*u + G*Pn*dudn,
+	//where G, H are single and double layer potentials at segment centers,
+	//Pd, Pn are projections on dirichlet and neumann segments.
+	vector<double> segbox = segment_boxes();
+	vector<double> colloc(4*N);
+	for (int i=0; i<N; ++i){
+		colloc[4*i] = colloc[4*i+2] = xm[i];
+		colloc[4*i+1] = colloc[4*i+3] = ym[i];
+	}
+	HMMath::HMatrix G(colloc, segbox, [&](int i, int j){
+		return Ffun(j, xm[i], ym[i]).first;
+	});
+	HMMath::HMatrix H(colloc, segbox, [&](int i, int j){
+		double ret = Ffun(j, xm[i], ym[i]).second;
+		return (i == j) ? ret - 0.5 : ret;
+	});
+
+	vector<double> ud(N, 0), un(N, 0), t1, t2;
+	for (int i=0; i<N; ++i){
+		if (isdir[i]) ud[i] = dirvals[i];
+		else un[i] = neuvals[i];
+	}
+	vector<double> rhs(N);
+	H.MultVec(ud, t1);
+	G.MultVec(un, t2);
+	for (int i=0; i<N; ++i) rhs[i] = t2[i] - t1[i];
+
+	vector<double> diag(N);
+	for (int i=0; i<N; ++i){
+		auto F = Ffun(i, xm[i], ym[i]);
+		diag[i] = isdir[i] ? -F.first : F.second - 0.5;
+	}
+	auto mult = [&](const vector<double>& z, vector<double>& res){
+		for (int i=0; i<N; ++i){
+			ud[i] = isdir[i] ? z[i] : 0;
+			un[i] = isdir[i] ? 0 : z[i];
+		}
+		G.MultVec(ud, t1);
+		H.MultVec(un, t2);
+		for (int i=0; i<N; ++i) res[i] = t2[i] - t1[i];
+	};
+	vector<double> z(N, 0);
+	HMMath::Gmres(mult, diag, rhs, z);
+
+	for (int i=0; i<N; ++i){
+		if (isdir[i]) neuvals[i] = z[i];
+		else dirvals[i] = z[i];
+	}
+}
+
 int LaplaceCE2D::where_is(double x, double y) const{
 	_THROW_NOT_IMP_;
 }
@@ -92,6 +175,29 @@ double LaplaceCE2D::internal_value_at(double x, double y) const{
 	return ret;
 }
 
+vector<double> LaplaceCE2D::internal_value_at(const vector<Point>& pts) const{
+	int n = pts.size();
+	vector<double> ret(n, 0);
+	if (!use_hmatrix(n)){
+		HMParallel::ForChunks(n, [&](int ib, int ie, int){
+			for (int i=ib; i<ie; ++i) ret[i] = internal_value_at(pts[i].x, pts[i].y);
+		}, 64);
+	} else {
+		//far field of all boundary segments is summed up by a compressed matrix
+		vector<double> ptbox(4*n);
+		for (int i=0; i<n; ++i){
+			ptbox[4*i] = ptbox[4*i+2] = pts[i].x;
+			ptbox[4*i+1] = ptbox[4*i+3] = pts[i].y;
+		}
+		HMMath::HMatrix P(ptbox, segment_boxes(), [&](int i, int j){
+			auto v = Ffun(j, pts[i].x, pts[i].y);
+			return dirvals[j]*v.second - neuvals[j]*v.first;
+		});
+		P.MultVec(vector<double>(N, 1.0), ret);
+	}
+	return ret;
+}
+
 double LaplaceCE2D::boundary_value_at(double x, double y) const{
 	if (no_bmap){
 		for (int i=0; i<N; ++i) vfinder.add(xs[i], ys[i], i);
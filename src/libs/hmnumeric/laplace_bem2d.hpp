@@ -8,6 +8,14 @@ namespace HMBem{
 
 //2D solution using constant elements
 class LaplaceCE2D{
+public:
+	//DENSE: direct solution of a full matrix system, O(N^3).
+	//HMATRIX: GMRES solution with hierarchically compressed matrices, O(N log N) per iteration.
+	//AUTO: HMATRIX for large boundaries. Should be requested explicitly,
+	//default is DENSE.
+	enum class Method {AUTO, DENSE, HMATRIX};
+private:
+	Method method;
 	vector<double> dirvals, neuvals;
 	vector<int> iprev;
 	vector<bool> isdir;
@@ -20,8 +28,13 @@ class LaplaceCE2D{
 	std::pair<double, double> Ffun(int k, double x, double y) const;
 	double B(int k, double x, double y) const;
 	double E(int k, double x, double y) const;
+	bool use_hmatrix(int nrows) const;
+	//bounding boxes of boundary segments as HMMath::HMatrix geometry
+	vector<double> segment_boxes() const;
+	void solve_dense();
+	void solve_hmatrix();
 public:
-	LaplaceCE2D(const HM2D::Contour::Tree& area);
+	LaplaceCE2D(const HM2D::Contour::Tree& area, Method method=Method::DENSE);
 	void Solve();
 	//set boundary values
 	//default is df/dn=0
@@ -30,6 +43,8 @@ public:
 	std::pair<double, double> boundary_data(int i) const { return std::make_pair(dirvals[i], neuvals[i]); }
 	double value_at(double x, double y) const;
 	double internal_value_at(double x, double y) const;
+	//batch evaluation at a set of internal points
+	vector<double> internal_value_at(const vector<Point>& pts) const;
 	double boundary_value_at(double x, double y) const;
 };
 
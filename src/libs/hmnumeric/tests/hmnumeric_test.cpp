@@ -15,6 +15,8 @@
 #include "hmtimer.hpp"
 #include "treverter2d.hpp"
 #include "densemat.hpp"
+#include "femgrid43.hpp"
+#include "hmparallel.hpp"
 using HMTesting::add_check;
 
 double maxskew(const HM2D::GridData& g){
@@ -247,11 +249,182 @@ void test04(){
 };
 
 
+void test05(){
+	std::cout<<"05. Bem with hierarchical matrices"<<std::endl;
+	auto c1 = HM2D::Contour::Constructor::Rectangle(Point(0,0), Point(2, 1));
+	auto c2 = HM2D::Contour::Constructor::Circle(16, 0.2, Point(1.3, 0.6));
+	HM2D::Contour::R::ReallyDirect::Permanent(c1);
+	HM2D::Contour::R::ReallyRevert::Permanent(c2);
+	c1 = HM2D::Contour::Algos::Partition(0.005, c1, HM2D::Contour::Algos::PartitionTp::KEEP_SHAPE);
+	c2 = HM2D::Contour::Algos::Partition(0.005, c2, HM2D::Contour::Algos::PartitionTp::KEEP_SHAPE);
+	HM2D::Contour::Tree t1;
+	t1.add_contour(c1);
+	t1.add_contour(c2);
+
+	//dirichlet at left/right sides and circle, neumann at top/bottom
+	HMBem::LaplaceCE2D dense(t1, HMBem::LaplaceCE2D::Method::DENSE);
+	HMBem::LaplaceCE2D hmat(t1, HMBem::LaplaceCE2D::Method::HMATRIX);
+	auto ae = t1.alledges();
+	for (size_t i=0; i<ae.size(); ++i){
+		Point c = ae[i]->center();
+		if (fabs(c.x) < 1e-8 || fabs(c.x-2) < 1e-8 || i >= c1.size()){
+			double v = (i >= c1.size()) ? 2 : c.x/2.0;
+			dense.dirichlet_value(i, v);
+			hmat.dirichlet_value(i, v);
+		} else {
+			dense.neumann_value(i, 0.1);
+			hmat.neumann_value(i, 0.1);
+		}
+	}
+	dense.Solve();
+	hmat.Solve();
+	double diff = 0, maxv = 0;
+	for (size_t i=0; i<ae.size(); ++i){
+		auto d1 = dense.boundary_data(i), d2 = hmat.boundary_data(i);
+		diff = std::max(diff, fabs(d1.first - d2.first));
+		diff = std::max(diff, fabs(d1.second - d2.second));
+		maxv = std::max(maxv, std::max(fabs(d1.first), fabs(d1.second)));
+	}
+	add_check(diff < 1e-4*maxv, "compressed boundary solution");
+
+	vector<Point> pts;
+	for (int i=0; i<40; ++i)
+	for (int j=0; j<20; ++j){
+		Point p(0.025 + 0.05*i, 0.025 + 0.05*j);
+		if (Point::dist(p, Point(1.3, 0.6)) > 0.25) pts.push_back(p);
+	}
+	vector<double> v1 = dense.internal_value_at(pts);
+	vector<double> v2 = hmat.internal_value_at(pts);
+	double diff1 = 0, diff2 = 0;
+	for (size_t i=0; i<pts.size(); ++i){
+		diff1 = std::max(diff1, fabs(v1[i] - dense.internal_value_at(pts[i].x, pts[i].y)));
+		diff2 = std::max(diff2, fabs(v2[i] - v1[i]));
+	}
+	add_check(diff1 < 1e-12 && diff2 < 1e-4, "batch internal values");
+}
+
+void test06(){
+	std::cout<<"06. Batch point location in fem grid"<<std::endl;
+	auto c1 = HM2D::Contour::Constructor::Circle(64, 1, Point(0, 0));
+	auto tree = HM2D::Mesher::PrepareSource(c1, 0.05);
+	auto g = HM2D::Mesher::UnstructuredTriangle(tree);
+	HMFem::Grid43::Approximator approx(&g);
+	//linear functions are interpolated exactly
+	vector<double> u(g.vvert.size()), v(g.vvert.size());
+	for (int i=0; i<g.vvert.size(); ++i){
+		u[i] = g.vvert[i]->x + 2*g.vvert[i]->y;
+		v[i] = 3 - g.vvert[i]->y;
+	}
+	vector<Point> pts;
+	for (int i=0; i<50; ++i)
+	for (int j=0; j<50; ++j){
+		Point p(-0.95 + 1.9*i/49., -0.95 + 1.9*j/49.);
+		if (vecLen(p) < 0.95) pts.push_back(p);
+	}
+	//out of area point
+	pts.push_back(Point(2, 2));
+
+	auto loc1 = approx.Locate(pts);
+	HMParallel::SetNumThreads(4);
+	auto loc4 = approx.Locate(pts);
+	HMParallel::SetNumThreads(1);
+	bool good = loc1.cell.back() == -1 && loc4.cell.back() == -1;
+	pts.pop_back();
+	loc1.cell.pop_back(); loc1.ksi.pop_back(); loc1.eta.pop_back();
+	auto s = approx.Vals(loc1, {&u, &v});
+	for (int i=0; i<pts.size(); ++i){
+		good = good && loc1.cell[i] >= 0 && loc4.cell[i] >= 0;
+		good = good && fabs(s[0][i] - (pts[i].x + 2*pts[i].y)) < 1e-10;
+		good = good && fabs(s[1][i] - (3 - pts[i].y)) < 1e-10;
+		good = good && fabs(s[0][i] - approx.Val(pts[i], u)) < 1e-10;
+	}
+	add_check(good, "walking locator");
+
+	loc1.cell[0] = -1;
+	try{
+		approx.Vals(loc1, {&u, &v});
+		add_check(false, "out of area");
+	} catch (HMFem::Grid43::Approximator::EOutOfArea& e){
+		add_check(true, "out of area");
+	}
+}
+
+void test07(){
+	std::cout<<"07. Multithreaded fem assembly"<<std::endl;
+	//grids are large enough to give several assembly chunks for each color.
+	//quadrangle grid with every third cell splitted into triangles
+	auto g = HM2D::Grid::Constructor::RectGrid(Point(0, 0), Point(3, 2), 300, 200);
+	for (auto& v: g.vvert){
+		v->set(v->x + 0.1*sin(3*v->y), v->y + 0.05*v->x*v->x);
+	}
+	int nc0 = g.vcells.size();
+	for (int i=0; i<nc0; i+=3) HM2D::Grid::Algos::SplitCell(g, i, 0, 2);
+	//triangle grid: quadrangle cells are supported only by laplace kernel
+	auto g3 = HM2D::Grid::Constructor::RectGrid(Point(0, 0), Point(3, 2), 300, 200);
+	HM2D::Grid::Algos::CutCellDims(g3, 3);
+
+	//cells of one color have no common vertices
+	auto check_colors = [](const HM2D::GridData& grid)->bool{
+		vector<int> cv_start, cv, color_start;
+		HMFem::Impl::CellVertices(grid, cv_start, cv);
+		auto cells = HMFem::Impl::ColorCells(grid.vvert.size(), cv_start, cv, color_start);
+		if (cells.size() != grid.vcells.size()) return false;
+		vector<int> used(grid.vvert.size(), -1);
+		for (int c=0; c<color_start.size()-1; ++c)
+		for (int i=color_start[c]; i<color_start[c+1]; ++i)
+		for (int k=cv_start[cells[i]]; k<cv_start[cells[i]+1]; ++k){
+			if (used[cv[k]] == c) return false;
+			used[cv[k]] = c;
+		}
+		return color_start.size() > 2;
+	};
+	add_check(check_colors(g) && check_colors(g3), "cells coloring");
+
+	typedef shared_ptr<HMMath::CsrMat> (*TAssembler)(const HM2D::GridData&);
+	auto same = [](const HM2D::GridData& grid, TAssembler fun)->bool{
+		HMParallel::SetNumThreads(1);
+		auto m1 = fun(grid);
+		HMParallel::SetNumThreads(4);
+		auto m4 = fun(grid);
+		HMParallel::SetNumThreads(1);
+		return m1->vals == m4->vals;
+	};
+	add_check(same(g, HMFem::Assemble::PureLaplace), "mixed grid laplace");
+	add_check(same(g3, HMFem::Assemble::PureLaplace), "triangle grid laplace");
+	add_check(same(g3, HMFem::Assemble::FullMass), "triangle grid full mass");
+	add_check(same(g3, HMFem::Assemble::DDx), "triangle grid ddx");
+	add_check(same(g3, HMFem::Assemble::DDy), "triangle grid ddy");
+	HMParallel::SetNumThreads(1);
+	auto l1 = HMFem::Assemble::LumpMass(g3);
+	HMParallel::SetNumThreads(4);
+	auto l4 = HMFem::Assemble::LumpMass(g3);
+	HMParallel::SetNumThreads(1);
+	add_check(l1 == l4, "triangle grid lump mass");
+
+	//bilinear unit square stiffness matrix
+	auto q = HM2D::Grid::Constructor::RectGrid(Point(0, 0), Point(1, 1), 1, 1);
+	auto mq = HMFem::Assemble::PureLaplace(q);
+	bool good = true;
+	//diagonal, adjacent, opposite vertices
+	double ans[3] = {2./3., -1./6., -1./3.};
+	for (int i=0; i<4; ++i)
+	for (int j=0; j<4; ++j){
+		auto& vi = *q.vvert[i];
+		auto& vj = *q.vvert[j];
+		int d = (vi.x != vj.x) + (vi.y != vj.y);
+		good = good && fabs(mq->get(i, j) - ans[d]) < 1e-12;
+	}
+	add_check(good, "quadrangle laplace local matrix");
+}
+
 int main(){
 	test01();
 	test02();
 	test03();
 	test04();
+	test05();
+	test06();
+	test07();
 
 
 	HMTesting::check_final_report();
@@ -109,6 +109,29 @@ void remove_entries(std::vector<A>& v, const std::set<int>& supi){
 	v=v1;
 }
 
+//====================== closed edges chain -> vertices
+//e[0..len) are indices of sequentially connected edges,
+//edge_vert is an edge->vertex table with two entries per edge.
+//Pushes len ordered chain vertices to ret.
+template<class EdgeIter>
+void chain_vertices(EdgeIter e, int len, const std::vector<int>& edge_vert, std::vector<int>& ret){
+	if (len == 0) return;
+	//first vertex
+	{
+		int p1 = edge_vert[2*e[0]], p2 = edge_vert[2*e[0]+1];
+		if (len > 1){
+			int p3 = edge_vert[2*e[1]], p4 = edge_vert[2*e[1]+1];
+			if (p1 == p3 || p1 == p4) std::swap(p1, p2);
+		}
+		ret.push_back(p1); ret.push_back(p2);
+	}
+	//other vertices
+	for (int k=1; k<len-1; ++k){
+		int p1 = edge_vert[2*e[k]], p2 = edge_vert[2*e[k]+1];
+		ret.push_back( (p1 == ret.back()) ? p2 : p1 );
+	}
+}
+
 //====================== Container<Data>  ->  Container<Data*>
 template<template<class...> class Container, class Data,
 	class PData=typename Container<Data>::iterator::pointer>  //(const Data*) for sets
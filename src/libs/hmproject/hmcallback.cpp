@@ -5,6 +5,7 @@
 #include "hmtimer.hpp"
 #include "hmproject.h"
 #include "hmdebug.hpp"
+#include "hmparallel.hpp"
 
 using namespace HMCallback;
 
@@ -88,6 +89,8 @@ void Caller2::setfun(Fun2 func){
 }
 
 void Caller2::new_sub_process(std::string subproc_name, double subproc_duration){
+	HMTrace::End(trace_sub);
+	if (!subproc_name.empty()) trace_sub = HMTrace::Begin(subproc_name, "subprocess");
 	name2 = subproc_name;
 	dur2 = subproc_duration;
 	prog2 = 0;
@@ -188,6 +191,7 @@ void Caller2::subprocess_step_after(double progress){
 
 void Caller2::fin() noexcept{
 	before1(false); before2(false);
+	HMTrace::End(trace_sub);
 	prog1 = dur1;
 	name2 = "Done";
 	prog2 = 1;
@@ -276,6 +280,82 @@ LoopCaller2 Caller2::looper(double parent_duration, double nloops, std::string c
 	return LoopCaller2(name1, caption, nloops, sf);
 }
 
+shared_ptr<ParallelCaller2> Caller2::parallel_subrange(double parent_duration, int ntasks,
+		std::string caption, int nworkers){
+	before1(true);
+	double parent_start = prog1;
+	prog1 += parent_duration;
+	if (nworkers < 0) nworkers = HMParallel::NumThreads();
+	return std::make_shared<ParallelCaller2>(name1, caption,
+			parent_start/dur1, parent_duration/dur1, ntasks, call, 50,
+			nworkers > 1 && ntasks > 1);
+}
+
+ParallelCaller2::ParallelCaller2(std::string name, std::string caption,
+		double parent_start, double parent_duration,
+		int ntasks, Fun2& call, int interval_ms, bool threaded):
+	name(name), caption(caption), start(parent_start), dur(parent_duration),
+	ntasks(ntasks), done(new std::atomic<double>[ntasks]), call(call), stopping(false),
+	last(-1){
+	for (int i=0; i<ntasks; ++i) done[i] = 0;
+	if (threaded) reporter = std::thread(&ParallelCaller2::report_loop, this, interval_ms);
+}
+
+ParallelCaller2::~ParallelCaller2(){
+	stop();
+}
+
+void ParallelCaller2::stop(){
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		stopping = true;
+	}
+	cv.notify_all();
+	if (reporter.joinable()) reporter.join();
+}
+
+void ParallelCaller2::report(){
+	double w = 0;
+	int ndone = 0;
+	for (int i=0; i<ntasks; ++i){
+		double d = done[i];
+		w += d;
+		if (d >= 1.0) ++ndone;
+	}
+	w /= ntasks;
+	if (w == last) return;
+	last = w;
+	std::string s2 = caption + ": " + std::to_string(ndone) + "/" + std::to_string(ntasks);
+	int res;
+	try{
+		res = call(name.c_str(), s2.c_str(), start + dur*w, w);
+	} catch (...){
+		res = CANCEL;
+	}
+	if (res == CANCEL) token.cancel();
+}
+
+void ParallelCaller2::report_loop(int interval_ms){
+	std::unique_lock<std::mutex> lock(mtx);
+	while (!stopping){
+		cv.wait_for(lock, std::chrono::milliseconds(interval_ms));
+		if (stopping || token.cancelled()) break;
+		lock.unlock();
+		report();
+		lock.lock();
+	}
+}
+
+shared_ptr<Caller2> ParallelCaller2::task(int itask, std::string task_name, double task_duration){
+	bool sync = !reporter.joinable();
+	auto sf = [this, itask, sync](const char* s1, const char* s2, double p1, double p2)->int{
+		if (p1 >= 0) done[itask] = std::min(p1, 1.0);
+		if (sync && !stopping && !token.cancelled()) report();
+		return token.cancelled() ? CANCEL : OK;
+	};
+	return shared_ptr<Caller2>(new Caller2(task_name, task_duration, sf));
+}
+
 LoopCaller2::LoopCaller2(std::string proc_name, std::string loop_caption, double nloops, Fun2 call):
 	Caller2(proc_name, nloops, call), caption(loop_caption), iter(0){}
 
@@ -1,11 +1,17 @@
 #ifndef HYBMESH_CALLBACK_HPP
 #define HYBMESH_CALLBACK_HPP
 #include <functional>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
 #include "hmproject.h"
+#include "hmtrace.hpp"
 
 namespace HMCallback{
 struct Caller2;
 struct LoopCaller2;
+class ParallelCaller2;
 
 const int OK = 0;
 const int CANCEL = 1;
@@ -60,6 +66,11 @@ struct Caller2{
 	std::shared_ptr<Caller2> bottom_line_subrange(double parent_bottom_duration, double child_duration);
 
 	LoopCaller2 looper(double parent_duration, double nloops, std::string caption);
+	//aggregate for ntasks running concurrently within parent_duration.
+	//nworkers is the number of threads which actually run the tasks,
+	//negative value means HMParallel::NumThreads().
+	std::shared_ptr<ParallelCaller2> parallel_subrange(double parent_duration, int ntasks,
+			std::string caption="Tasks", int nworkers=-1);
 
 	//output 100%
 	void fin() noexcept;
@@ -74,6 +85,9 @@ protected:
 	//construct data
 	Fun2 call; 
 
+	//tracing event of current subprocess
+	HMTrace::Mark trace_sub;
+
 	void flush();
 	void new_sub_process(std::string subproc_name, double subproc_duration);
 	void before1(bool);
@@ -88,6 +102,58 @@ private:
 	int iter;
 };
 
+//Cancellation flag shared by concurrent workers.
+//Checking it costs a single atomic load.
+class CancelToken{
+	std::atomic<bool> flag;
+public:
+	CancelToken(): flag(false){}
+	void cancel(){ flag = true; }
+	bool cancelled() const { return flag; }
+	//throws Cancelled(proc) if cancellation was requested
+	void check(std::string proc) const { if (flag) throw Cancelled(proc); }
+};
+
+//Thread safe progress aggregation for concurrently running tasks.
+//Each task reports through its own Caller2 obtained by task(itask, ...)
+//which only stores task progress into an atomic counter.
+//Parent function is called from a separate reporter thread at most once
+//per interval with averaged progress of all tasks as the top line.
+//If tasks are run by a single worker no reporter thread is started:
+//parent function is called synchronously by task callers.
+//If the parent returns CANCEL the token is set: all tasks receive CANCEL
+//on their next flush so each of them throws Cancelled.
+//Parallel loops without Caller2 should poll check_cancelled().
+//stop() (or destructor) should be called before the parent caller is used again.
+class ParallelCaller2{
+	std::string name, caption;
+	double start, dur;
+	int ntasks;
+	std::unique_ptr<std::atomic<double>[]> done;
+	CancelToken token;
+	Fun2& call;
+
+	//reporter
+	std::mutex mtx;
+	std::condition_variable cv;
+	bool stopping;
+	std::thread reporter;
+	void report_loop(int interval_ms);
+	//calls parent with current averaged progress if it has changed since the last call
+	double last;
+	void report();
+public:
+	ParallelCaller2(std::string name, std::string caption,
+			double parent_start, double parent_duration,
+			int ntasks, Fun2& call, int interval_ms=50, bool threaded=true);
+	~ParallelCaller2();
+	std::shared_ptr<Caller2> task(int itask, std::string task_name, double task_duration);
+
+	bool cancelled() const { return token.cancelled(); }
+	void check_cancelled() const { token.check(name); }
+	//stops reporter thread and synchronous reports
+	void stop();
+};
 
 template<int N>
 struct TDuration{ static constexpr int value = N; };
@@ -150,9 +216,10 @@ class FunctionWithCallback{
 	template<class... Args>
 	struct Beholder{
 		TExecutor* e;
+		HMTrace::Scope trace;
 		static constexpr const char* nm = TExecutor::procname();
 		static constexpr double dr = HMCB_DURATION(TExecutor, Args...);
-		Beholder(TExecutor* _e):e(_e){ e->init(nm, dr); }
+		Beholder(TExecutor* _e):e(_e), trace(nm){ e->init(nm, dr); }
 		~Beholder() { e->fin(); }
 	};
 
@@ -174,7 +241,10 @@ class FunctionWithCallback{
 	struct Beholder1{
 		TExecutor* e;
 		Caller2* cb;
-		Beholder1(Caller2& _cb, TExecutor* _e):e(_e), cb(&_cb){ e->swap_callback(_cb); }
+		HMTrace::Scope trace;
+		Beholder1(Caller2& _cb, TExecutor* _e):e(_e), cb(&_cb), trace(TExecutor::procname()){
+			e->swap_callback(_cb);
+		}
 		~Beholder1() { e->swap_callback(*cb); }
 	};
 	template<class... Args>
@@ -0,0 +1,48 @@
+#include "hmgmsh.hpp"
+#include "Gmsh.h"
+#ifndef WIN32
+#include <pthread.h>
+#include <new>
+#endif
+
+using namespace HMGmsh;
+
+namespace{
+std::recursive_mutex& gmsh_mutex(){
+	static std::recursive_mutex m;
+	return m;
+}
+
+#ifndef WIN32
+//fork() copies gmsh state as is. Forking thread waits until gmsh jobs of other
+//threads are finished so the child never gets a half modified state.
+//Mutex in the child is owned by the thread id of the parent, hence it is reinitialized.
+void fork_prepare(){ gmsh_mutex().lock(); }
+void fork_parent(){ gmsh_mutex().unlock(); }
+void fork_child(){ new (&gmsh_mutex()) std::recursive_mutex(); }
+
+struct ForkHandlers{
+	ForkHandlers(){ pthread_atfork(fork_prepare, fork_parent, fork_child); }
+} fork_handlers;
+#endif
+}
+
+Context::Context(): lock(gmsh_mutex()){}
+
+Context::~Context(){
+	for (auto it = saved.rbegin(); it != saved.rend(); ++it){
+		GmshSetOption(it->category, it->name, it->value);
+	}
+}
+
+void Context::set_option(const std::string& category, const std::string& name, double value){
+	double old;
+	GmshGetOption(category, name, old);
+	saved.push_back(SavedOption {category, name, old});
+	GmshSetOption(category, name, value);
+}
+
+void Context::set_bounding_box(double xmin, double xmax, double ymin, double ymax,
+		double zmin, double zmax){
+	GmshSetBoundingBox(xmin, xmax, ymin, ymax, zmin, zmax);
+}
@@ -0,0 +1,33 @@
+#ifndef HMPROJECT_GMSH_HPP
+#define HMPROJECT_GMSH_HPP
+
+#include <string>
+#include <vector>
+#include <mutex>
+
+namespace HMGmsh{
+
+//gmsh keeps options, bounding box, messages and current model
+//in process-global objects. Context is a scoped access to that state:
+//it serializes gmsh jobs of concurrent threads (nested contexts in one
+//thread are allowed), applies per job options and restores option values
+//which were active before the job on destruction.
+//All gmsh calls including GModel construction and destruction
+//should be done within a context.
+//To run gmsh jobs concurrently use worker processes (HMParallel::ForProcesses).
+//fork() is blocked while any other thread is inside a context.
+class Context{
+public:
+	Context();
+	~Context();
+	void set_option(const std::string& category, const std::string& name, double value);
+	void set_bounding_box(double xmin, double xmax, double ymin, double ymax,
+			double zmin, double zmax);
+private:
+	std::unique_lock<std::recursive_mutex> lock;
+	struct SavedOption{ std::string category, name; double value; };
+	std::vector<SavedOption> saved;
+};
+
+}
+#endif
@@ -0,0 +1,165 @@
+#include "hmparallel.hpp"
+#include <thread>
+#include <vector>
+#include <exception>
+#include <algorithm>
+#include <stdexcept>
+#ifndef WIN32
+#include <unistd.h>
+#include <errno.h>
+#include <sys/wait.h>
+#endif
+
+namespace{
+int _num_threads = 1;
+
+#ifndef WIN32
+//returns false on write error
+bool write_all(int fd, const char* data, size_t n){
+	while (n > 0){
+		ssize_t k = write(fd, data, n);
+		if (k < 0 && errno == EINTR) continue;
+		if (k <= 0) return false;
+		data += k; n -= k;
+	}
+	return true;
+}
+
+//reads until eof, throws on read error
+std::string read_all(int fd){
+	std::string ret;
+	char buf[65536];
+	while (1){
+		ssize_t k = read(fd, buf, sizeof(buf));
+		if (k < 0 && errno == EINTR) continue;
+		if (k < 0) throw std::runtime_error("failed to read worker process output");
+		if (k == 0) break;
+		ret.append(buf, k);
+	}
+	return ret;
+}
+
+//returns false if process was not finished with zero exit code
+bool wait_process(pid_t pid){
+	int wstatus;
+	while (waitpid(pid, &wstatus, 0) < 0){
+		if (errno != EINTR) return false;
+	}
+	return WIFEXITED(wstatus) && WEXITSTATUS(wstatus) == 0;
+}
+
+//worker output: status byte (0 - success, 1 - error message) followed by data
+void run_worker(int fd, int i, const std::function<std::string(int)>& fun){
+	char status = 0;
+	std::string out;
+	try{
+		out = fun(i);
+	} catch (std::exception& e){
+		status = 1;
+		out = e.what();
+	} catch (...){
+		status = 1;
+		out = "unknown error";
+	}
+	bool ok = write_all(fd, &status, 1) && write_all(fd, out.data(), out.size());
+	close(fd);
+	//skip static destructors of the parent copy
+	_exit(ok ? 0 : 1);
+}
+#endif
+}
+
+void HMParallel::SetNumThreads(int n){
+	if (n <= 0) n = std::thread::hardware_concurrency();
+	_num_threads = std::max(1, n);
+}
+
+int HMParallel::NumThreads(){
+	return _num_threads;
+}
+
+int HMParallel::NumChunks(int n, int min_chunk){
+	int nc = (min_chunk > 0) ? n/min_chunk : n;
+	return std::max(1, std::min(nc, _num_threads));
+}
+
+int HMParallel::ForChunks(int n, const std::function<void(int, int, int)>& fun, int min_chunk){
+	int nc = NumChunks(n, min_chunk);
+	if (nc == 1){
+		fun(0, n, 0);
+		return 1;
+	}
+	std::vector<std::exception_ptr> errs(nc);
+	auto run = [&](int ic){
+		try{
+			fun((long long)n*ic/nc, (long long)n*(ic+1)/nc, ic);
+		} catch (...){
+			errs[ic] = std::current_exception();
+		}
+	};
+	std::vector<std::thread> threads;
+	threads.reserve(nc-1);
+	for (int ic=1; ic<nc; ++ic) threads.emplace_back(run, ic);
+	run(0);
+	for (auto& t: threads) t.join();
+	for (auto& e: errs) if (e) std::rethrow_exception(e);
+	return nc;
+}
+
+std::vector<std::string> HMParallel::ForProcesses(int n, const std::function<std::string(int)>& fun){
+	std::vector<std::string> ret(n);
+#ifndef WIN32
+	int np = std::min(n, _num_threads);
+#else
+	int np = 1;
+#endif
+	if (np <= 1){
+		for (int i=0; i<n; ++i) ret[i] = fun(i);
+		return ret;
+	}
+#ifndef WIN32
+	for (int ib=0; ib<n; ib+=np){
+		int ie = std::min(n, ib+np);
+		std::vector<int> fds;
+		std::vector<pid_t> pids;
+		std::string err;
+		for (int i=ib; i<ie; ++i){
+			int fd[2];
+			if (pipe(fd) != 0){ err = "failed to create a pipe"; break; }
+			pid_t pid = fork();
+			if (pid < 0){
+				close(fd[0]); close(fd[1]);
+				err = "failed to fork a worker process";
+				break;
+			}
+			if (pid == 0){
+				close(fd[0]);
+				run_worker(fd[1], i, fun);
+			}
+			close(fd[1]);
+			fds.push_back(fd[0]);
+			pids.push_back(pid);
+		}
+		for (int k=0; k<(int)fds.size(); ++k){
+			std::string out;
+			try{
+				out = read_all(fds[k]);
+			} catch (std::exception& e){
+				if (err.empty()) err = e.what();
+			}
+			close(fds[k]);
+			bool exited = wait_process(pids[k]);
+			if (!err.empty()) continue;
+			if (!exited || out.size() == 0){
+				err = "worker process " + std::to_string(ib+k) + " terminated abnormally";
+			} else if (out[0] != 0){
+				err = out.substr(1);
+			} else {
+				ret[ib+k] = out.substr(1);
+			}
+		}
+		if (!err.empty()) throw std::runtime_error(err);
+	}
+#endif
+	return ret;
+}
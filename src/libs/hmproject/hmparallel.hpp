@@ -0,0 +1,37 @@
+#ifndef HMPROJECT_PARALLEL_HPP
+#define HMPROJECT_PARALLEL_HPP
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace HMParallel{
+
+//Number of threads used by parallel algorithms.
+//n <= 0 sets number of hardware threads. Default is 1.
+void SetNumThreads(int n);
+int NumThreads();
+
+//number of chunks ForChunks splits [0, n) range into
+int NumChunks(int n, int min_chunk=1000);
+
+//Splits [0, n) into NumChunks(n, min_chunk) contiguous chunks
+//and calls fun(ibegin, iend, ichunk) for each chunk in a separate thread.
+//First chunk is processed by the calling thread.
+//Exception thrown by any of the chunks is rethrown after all threads are joined.
+//Returns number of chunks.
+int ForChunks(int n, const std::function<void(int, int, int)>& fun, int min_chunk=1000);
+
+//Calls fun(i) for i in [0, n) in forked worker processes, at most NumThreads() at once,
+//and returns byte strings produced by fun in index order.
+//Used for jobs which rely on non-reentrant libraries (gmsh):
+//each worker operates on its own copy of the process state.
+//fun should not write to parent memory: only its returned value is passed back.
+//Exception thrown by any worker is rethrown as std::runtime_error after the
+//workers of the current batch are finished.
+//If NumThreads() == 1 or processes are not supported (windows)
+//jobs are run sequentially by the calling process.
+std::vector<std::string> ForProcesses(int n, const std::function<std::string(int)>& fun);
+
+}
+#endif
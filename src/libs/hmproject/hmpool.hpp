@@ -0,0 +1,144 @@
+#ifndef HMPROJECT_POOL_HPP
+#define HMPROJECT_POOL_HPP
+
+#include "hmproject.h"
+#include <atomic>
+#include <new>
+
+namespace HMPool{
+
+//Bump allocator which takes memory from the system by blocks.
+//Block sizes grow geometrically from 4Kb up to max_block,
+//so small grids don't waste memory and large ones need only a few system calls.
+//Each block counts its live chunks and is returned to the system
+//by the last deallocate of its chunks or by arena destruction if it is empty.
+//So objects which outlive the arena keep only their own blocks.
+//Allocation is not thread safe: arena should be filled by a single thread.
+//Chunks can be deallocated by any thread.
+class Arena{
+	struct Block{
+		//live chunks count biased by BIAS while block is filled by arena
+		std::atomic<size_t> live;
+	};
+	static const size_t BIAS = size_t(1) << (8*sizeof(size_t)-2);
+	//each chunk is preceded by a pointer to its block
+	static const size_t HEAD = sizeof(Block*);
+
+	Block* cur;
+	size_t nalloc;  //chunks given from cur
+	size_t max_block;
+	size_t block_size;
+	size_t pos;
+	size_t total;
+	size_t nblk;
+
+	static size_t align_up(size_t a, size_t align){ return (a + align - 1) & ~(align - 1); }
+	//malloc result is aligned for any fundamental type
+	Block* new_block(size_t sz){
+		void* b = malloc(sz);
+		if (b == 0) throw std::bad_alloc();
+		++nblk;
+		Block* ret = static_cast<Block*>(b);
+		new (&ret->live) std::atomic<size_t>(BIAS);
+		return ret;
+	}
+	static void release(Block* b, size_t n){
+		if (b->live.fetch_sub(n, std::memory_order_acq_rel) == n) free(b);
+	}
+	//arena stops filling the block: removes bias
+	static void retire(Block* b, size_t nalloc){ release(b, BIAS - nalloc); }
+	static char* place(Block* b, size_t off){
+		char* ret = reinterpret_cast<char*>(b) + off;
+		*reinterpret_cast<Block**>(ret - HEAD) = b;
+		return ret;
+	}
+public:
+	explicit Arena(size_t max_block=1<<20)
+		: cur(0), nalloc(0), max_block(std::max(max_block, size_t(4096))),
+		  block_size(0), pos(0), total(0), nblk(0){}
+	Arena(const Arena&) = delete;
+	Arena& operator=(const Arena&) = delete;
+	~Arena(){ if (cur != 0) retire(cur, nalloc); }
+
+	void* allocate(size_t n, size_t align){
+		total += n;
+		align = std::max(align, alignof(Block*));
+		size_t start = align_up(sizeof(Block) + HEAD, align);
+		//oversized requests get their own block
+		if (n > max_block/4){
+			Block* b = new_block(start + n);
+			char* ret = place(b, start);
+			retire(b, 1);
+			return ret;
+		}
+		size_t off = align_up(pos + HEAD, align);
+		if (cur == 0 || off + n > block_size){
+			block_size = (block_size == 0) ? 4096 : std::min(2*block_size, max_block);
+			while (block_size < start + n) block_size *= 2;
+			Block* b = new_block(block_size);
+			if (cur != 0) retire(cur, nalloc);
+			cur = b;
+			nalloc = 0;
+			off = start;
+		}
+		++nalloc;
+		pos = off + n;
+		return place(cur, off);
+	}
+	//returns chunk given by any arena
+	static void deallocate(void* p){
+		release(*(reinterpret_cast<Block**>(p) - 1), 1);
+	}
+
+	//number of system allocations made by arena
+	size_t nblocks() const { return nblk; }
+	//number of bytes given to clients
+	size_t used() const { return total; }
+};
+
+//std compatible allocator placing objects into an arena.
+//Arena is needed only for allocation, deallocated memory
+//is returned to its block, so allocator copies kept by shared_ptr
+//control blocks do not prolong arena lifetime.
+template<class T>
+struct Allocator{
+	typedef T value_type;
+	Arena* arena;
+
+	explicit Allocator(Arena* a): arena(a){}
+	template<class U>
+	Allocator(const Allocator<U>& other): arena(other.arena){}
+
+	T* allocate(size_t n){
+		return static_cast<T*>(arena->allocate(n*sizeof(T), alignof(T)));
+	}
+	void deallocate(T* p, size_t){ Arena::deallocate(p); }
+
+	template<class U>
+	bool operator==(const Allocator<U>& other) const { return arena == other.arena; }
+	template<class U>
+	bool operator!=(const Allocator<U>& other) const { return arena != other.arena; }
+};
+
+//Factory of shared objects placed in a common arena.
+//Object and its shared_ptr control block are placed in a single arena chunk.
+//Objects could outlive the pool: memory block is released when
+//the pool and all objects placed in that block are destroyed.
+//Usage:
+//  HMPool::Pool pool;
+//  shared_ptr<Vertex> v = pool.make<Vertex>(0, 1);
+class Pool{
+	Arena _arena;
+public:
+	explicit Pool(size_t max_block=1<<20): _arena(max_block){}
+
+	template<class T, class... Args>
+	shared_ptr<T> make(Args&&... args){
+		return std::allocate_shared<T>(Allocator<T>(&_arena), std::forward<Args>(args)...);
+	}
+
+	const Arena& arena() const { return _arena; }
+};
+
+}
+#endif
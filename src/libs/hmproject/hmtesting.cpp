@@ -2,6 +2,7 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <cstring>
 
 namespace{
 int FAILED_CHECKS = 0;
@@ -149,3 +150,48 @@ void HMTesting::add_filesize_check(size_t sz, std::string fn, std::string info){
 		std::cout<<"\t\tinput file size   = "<<sz<<std::endl;
 	}
 }
+
+std::map<std::string, std::vector<double>> HMTesting::msh_sections(std::string fn){
+	std::ifstream t(fn, std::ios::binary);
+	std::string s((std::istreambuf_iterator<char>(t)), std::istreambuf_iterator<char>());
+	std::map<std::string, std::vector<double>> ret;
+	size_t pos = s.find('(');
+	while (pos != std::string::npos){
+		int index = atoi(s.c_str() + pos + 1);
+		int sec = index % 1000;
+		size_t hstart = s.find('(', pos+1), hend = s.find(')', pos+1);
+		bool hasdata = (sec == 10 || sec == 12 || sec == 13 || sec == 18) &&
+			hstart < hend && hend+1 < s.size() && s[hend+1] == '(';
+		if (!hasdata){
+			pos = s.find('\n', pos);
+			if (pos != std::string::npos) pos = s.find('(', pos);
+			continue;
+		}
+		std::string key = std::to_string(sec) + " (" + s.substr(hstart+1, hend-hstart-1) + ")";
+		std::vector<double>& dt = ret[key];
+		size_t dstart = hend + 2, dend;
+		if (index > 1000){
+			dend = s.find(")\nEnd of Binary Section", dstart);
+			if (dend == std::string::npos) break;
+			if (index / 1000 == 3){
+				dt.resize((dend - dstart)/sizeof(double));
+				if (dt.size() > 0) memcpy(&dt[0], &s[dstart], dt.size()*sizeof(double));
+			} else {
+				std::vector<int> idata((dend - dstart)/sizeof(int));
+				if (idata.size() > 0) memcpy(&idata[0], &s[dstart], idata.size()*sizeof(int));
+				dt.assign(idata.begin(), idata.end());
+			}
+		} else {
+			dend = s.find("))", dstart);
+			if (dend == std::string::npos) break;
+			std::istringstream is(s.substr(dstart, dend - dstart));
+			std::string tok;
+			while (is>>tok){
+				dt.push_back((sec == 10) ? std::stod(tok) : std::stoi(tok, 0, 16));
+			}
+		}
+		pos = s.find('\n', dend);
+		if (pos != std::string::npos) pos = s.find('(', pos);
+	}
+	return ret;
+}
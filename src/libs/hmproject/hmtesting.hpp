@@ -25,6 +25,10 @@ namespace HMTesting{
 	//file size
 	size_t calculate_file_size(std::string fn);
 
+	//Fluent msh (ascii or binary) data sections: "index (header)" -> numbers.
+	//Binary section indices are reduced to ascii ones: 3010 -> 10, 2013 -> 13, etc.
+	std::map<std::string, std::vector<double>> msh_sections(std::string fn);
+
 	//returns number of failed checks;
 	int failed_num();
 
@@ -0,0 +1,149 @@
+#include "hmtrace.hpp"
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#ifndef WIN32
+#include <sys/resource.h>
+#endif
+
+using namespace HMTrace;
+
+namespace{
+
+struct Event{
+	std::string name;
+	const char* category;
+	int tid;
+	double start, dur;
+	long long allocs;
+	long peak_rss_growth;
+};
+
+std::atomic<bool> _enabled(false);
+std::mutex _mtx;
+std::vector<Event> _events;
+std::atomic<int> _nthreads(0);
+const auto _epoch = std::chrono::steady_clock::now();
+
+//per thread data
+thread_local int _tid = -1;
+thread_local long long _allocs = 0;
+
+int thread_index(){
+	if (_tid < 0) _tid = _nthreads++;
+	return _tid;
+}
+
+double now(){
+	return std::chrono::duration<double, std::micro>(
+			std::chrono::steady_clock::now() - _epoch).count();
+}
+
+//process lifetime peak resident set size in kilobytes
+long peak_rss(){
+#ifndef WIN32
+	struct rusage ru;
+	if (getrusage(RUSAGE_SELF, &ru) == 0) return ru.ru_maxrss;
+#endif
+	return 0;
+}
+
+std::string escape(const std::string& s){
+	std::string ret;
+	for (char c: s){
+		if (c == '"' || c == '\\') ret += '\\';
+		if (c == '\n') { ret += "\\n"; continue; }
+		ret += c;
+	}
+	return ret;
+}
+
+}
+
+#ifdef HYBMESH_TRACE_ALLOCATIONS
+//counting replacement of global allocation functions
+#include <cstdlib>
+#include <new>
+void* operator new(std::size_t sz){
+	++_allocs;
+	if (void* p = std::malloc(sz == 0 ? 1 : sz)) return p;
+	throw std::bad_alloc();
+}
+void* operator new[](std::size_t sz){
+	++_allocs;
+	if (void* p = std::malloc(sz == 0 ? 1 : sz)) return p;
+	throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept{ std::free(p); }
+void operator delete[](void* p) noexcept{ std::free(p); }
+void operator delete(void* p, std::size_t) noexcept{ std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept{ std::free(p); }
+#endif
+
+void HMTrace::Enable(bool on){ _enabled = on; }
+bool HMTrace::IsEnabled(){ return _enabled; }
+
+void HMTrace::Clear(){
+	std::lock_guard<std::mutex> lock(_mtx);
+	_events.clear();
+}
+
+int HMTrace::NumEvents(){
+	std::lock_guard<std::mutex> lock(_mtx);
+	return _events.size();
+}
+
+Mark HMTrace::Begin(const std::string& name, const char* category){
+	Mark ret;
+	if (!_enabled) return ret;
+	ret.active = true;
+	ret.name = name;
+	ret.category = category;
+	ret.allocs = _allocs;
+	ret.peak_rss = peak_rss();
+	ret.start = now();
+	return ret;
+}
+
+void HMTrace::End(Mark& m){
+	if (!m.active) return;
+	m.active = false;
+	Event e;
+	e.dur = now() - m.start;
+	e.name = std::move(m.name);
+	e.category = m.category;
+	e.tid = thread_index();
+	e.start = m.start;
+	e.allocs = _allocs - m.allocs;
+	e.peak_rss_growth = peak_rss() - m.peak_rss;
+
+	std::lock_guard<std::mutex> lock(_mtx);
+	_events.push_back(std::move(e));
+}
+
+void HMTrace::ExportChrome(std::string fn){
+	std::ofstream fs(fn);
+	if (!fs) throw std::runtime_error("failed to open " + fn);
+	std::lock_guard<std::mutex> lock(_mtx);
+	fs<<"{\"traceEvents\":["<<std::endl;
+	for (size_t i=0; i<_events.size(); ++i){
+		auto& e = _events[i];
+		std::ostringstream os;
+		os.precision(15);
+		os<<"{\"name\":\""<<escape(e.name)<<"\",\"cat\":\""<<e.category<<"\","
+		  <<"\"ph\":\"X\",\"pid\":0,\"tid\":"<<e.tid<<","
+		  <<"\"ts\":"<<e.start<<",\"dur\":"<<e.dur<<","
+		  <<"\"args\":{"
+#ifdef HYBMESH_TRACE_ALLOCATIONS
+		  <<"\"allocations\":"<<e.allocs<<","
+#endif
+		  <<"\"peak_rss_growth_kb\":"<<e.peak_rss_growth<<"}}";
+		if (i != _events.size()-1) os<<",";
+		fs<<os.str()<<std::endl;
+	}
+	fs<<"],\"displayTimeUnit\":\"ms\"}"<<std::endl;
+}
@@ -0,0 +1,55 @@
+#ifndef HMPROJECT_TRACE_HPP
+#define HMPROJECT_TRACE_HPP
+
+#include <string>
+
+//Hierarchical procedures tracing.
+//When enabled every HMCallback::FunctionWithCallback invocation and
+//every HMCallback::Caller2 subprocess is recorded as an event with
+//wall time, thread index, number of heap allocations and growth of the
+//process peak resident memory during the event. Peak memory is process wide,
+//so for concurrent events growth could be caused by other threads.
+//Nesting is restored from time intervals within each thread.
+//Allocations are counted only if library was built with TRACE_ALLOCATIONS option.
+//Disabled tracing costs a single atomic flag check per procedure.
+namespace HMTrace{
+
+void Enable(bool on);
+bool IsEnabled();
+//removes all recorded events
+void Clear();
+//number of recorded events
+int NumEvents();
+
+//Chrome trace event format json (chrome://tracing, ui.perfetto.dev)
+void ExportChrome(std::string fn);
+
+//opened event
+struct Mark{
+	Mark(): active(false){}
+	bool active;
+	std::string name;
+	const char* category;
+	double start;      //microseconds from trace epoch
+	long long allocs;  //thread allocations counter at start
+	long peak_rss;     //process peak resident memory at start in kilobytes
+};
+
+//returns inactive mark if tracing is disabled
+Mark Begin(const std::string& name, const char* category);
+//records event and deactivates mark
+void End(Mark& m);
+
+//Begin/End for a scope
+struct Scope{
+	Scope(const char* name, const char* category="procedure"){
+		if (IsEnabled()) m = Begin(name, category);
+	}
+	~Scope(){ End(m); }
+private:
+	Mark m;
+};
+
+}
+
+#endif
@@ -0,0 +1,251 @@
+#include "hmvtuwriter.hpp"
+#include "hmparallel.hpp"
+#include <fstream>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#ifdef HYBMESH_USE_ZLIB
+#include <zlib.h>
+#endif
+
+using namespace HMVtu;
+
+namespace{
+
+//size of compressed blocks
+const size_t CBLOCK = 1<<18;
+
+//array of appended section
+struct TArray{
+	TArray(std::string name, std::string tp, int ncomp, const void* dt, size_t nb):
+		name(name), tp(tp), ncomp(ncomp), data(static_cast<const char*>(dt)), nbytes(nb){}
+	template<class A>
+	TArray(std::string name, std::string tp, int ncomp, const vector<A>& v):
+		TArray(name, tp, ncomp, v.data(), v.size()*sizeof(A)){}
+
+	std::string name, tp;
+	int ncomp;
+	const char* data;
+	size_t nbytes;
+	//vtkZLibDataCompressor header followed by compressed blocks
+	vector<char> cdata;
+	bool compressed = false;
+
+	//size in appended section
+	size_t asize() const { return compressed ? cdata.size() : sizeof(uint64_t) + nbytes; }
+
+	void compress(bool parallel);
+	void write(std::ofstream& fs) const;
+	std::string xml(size_t offset) const;
+};
+
+void TArray::compress(bool parallel){
+#ifdef HYBMESH_USE_ZLIB
+	int nblocks = (nbytes + CBLOCK - 1)/CBLOCK;
+	vector<vector<char>> blocks(nblocks);
+	auto cfun = [&](int ib, int ie, int){
+		for (int i=ib; i<ie; ++i){
+			size_t st = i*CBLOCK;
+			size_t len = std::min(CBLOCK, nbytes - st);
+			uLongf clen = compressBound(len);
+			blocks[i].resize(clen);
+			//fast compression level: output speed is the purpose of binary format
+			int err = compress2(reinterpret_cast<Bytef*>(&blocks[i][0]), &clen,
+				reinterpret_cast<const Bytef*>(data + st), len, 1);
+			if (err != Z_OK) throw std::runtime_error("zlib compression failed");
+			blocks[i].resize(clen);
+		}
+	};
+	if (parallel) HMParallel::ForChunks(nblocks, cfun, 1);
+	else cfun(0, nblocks, 0);
+
+	//header: number of blocks, block size, last block size, compressed sizes
+	vector<uint64_t> head(3 + nblocks);
+	head[0] = nblocks;
+	head[1] = CBLOCK;
+	head[2] = (nbytes % CBLOCK == 0 && nbytes > 0) ? CBLOCK : nbytes % CBLOCK;
+	size_t tot = head.size()*sizeof(uint64_t);
+	for (int i=0; i<nblocks; ++i){
+		head[3+i] = blocks[i].size();
+		tot += blocks[i].size();
+	}
+	cdata.resize(tot);
+	char* it = &cdata[0];
+	memcpy(it, head.data(), head.size()*sizeof(uint64_t));
+	it += head.size()*sizeof(uint64_t);
+	for (auto& b: blocks){
+		if (b.size() > 0) memcpy(it, b.data(), b.size());
+		it += b.size();
+	}
+	compressed = true;
+#endif
+}
+
+void TArray::write(std::ofstream& fs) const{
+	if (compressed){
+		fs.write(cdata.data(), cdata.size());
+	} else {
+		uint64_t n = nbytes;
+		fs.write(reinterpret_cast<const char*>(&n), sizeof(uint64_t));
+		if (nbytes > 0) fs.write(data, nbytes);
+	}
+}
+
+std::string TArray::xml(size_t offset) const{
+	std::string ret = "<DataArray type=\"" + tp + "\" Name=\"" + name + "\"";
+	if (ncomp > 1) ret += " NumberOfComponents=\"" + std::to_string(ncomp) + "\"";
+	ret += " format=\"appended\" offset=\"" + std::to_string(offset) + "\"/>\n";
+	return ret;
+}
+
+std::string vtkfile_tag(std::string tp, bool compressed){
+	const uint16_t one = 1;
+	bool little = *reinterpret_cast<const char*>(&one) == 1;
+	std::string ret = "<VTKFile type=\"" + tp + "\" version=\"1.0\" byte_order=\"";
+	ret += little ? "LittleEndian" : "BigEndian";
+	ret += "\" header_type=\"UInt64\"";
+	if (compressed) ret += " compressor=\"vtkZLibDataCompressor\"";
+	ret += ">\n";
+	return ret;
+}
+
+void write_vtu(const UGrid& g, std::string fn, bool compress, bool parallel){
+	vector<TArray> arr;
+	arr.emplace_back("Points", "Float64", 3, g.points);
+	arr.emplace_back("connectivity", "Int32", 1, g.connectivity);
+	arr.emplace_back("offsets", "Int32", 1, g.offsets);
+	arr.emplace_back("types", "UInt8", 1, g.types);
+	if (g.faceoffsets.size() > 0){
+		arr.emplace_back("faces", "Int32", 1, g.faces);
+		arr.emplace_back("faceoffsets", "Int32", 1, g.faceoffsets);
+	}
+	if (compress && HasCompression()){
+		for (auto& a: arr) a.compress(parallel);
+	} else compress = false;
+
+	vector<size_t> aoffset(arr.size(), 0);
+	for (size_t i=1; i<arr.size(); ++i) aoffset[i] = aoffset[i-1] + arr[i-1].asize();
+
+	std::ofstream fs(fn, std::ios::binary);
+	if (!fs) throw std::runtime_error("failed to open " + fn + " for writing");
+	std::string head = "<?xml version=\"1.0\"?>\n";
+	head += vtkfile_tag("UnstructuredGrid", compress);
+	head += "<UnstructuredGrid>\n";
+	head += "<Piece NumberOfPoints=\"" + std::to_string(g.n_points()) +
+		"\" NumberOfCells=\"" + std::to_string(g.n_cells()) + "\">\n";
+	head += "<Points>\n" + arr[0].xml(aoffset[0]) + "</Points>\n";
+	head += "<Cells>\n";
+	for (size_t i=1; i<arr.size(); ++i) head += arr[i].xml(aoffset[i]);
+	head += "</Cells>\n";
+	head += "</Piece>\n";
+	head += "</UnstructuredGrid>\n";
+	head += "<AppendedData encoding=\"raw\">\n_";
+	fs.write(head.data(), head.size());
+	for (auto& a: arr) a.write(fs);
+	std::string tail = "\n</AppendedData>\n</VTKFile>\n";
+	fs.write(tail.data(), tail.size());
+	if (!fs) throw std::runtime_error("failed to write " + fn);
+}
+
+//cells [cb, ce) of g with renumbered vertices
+UGrid subgrid(const UGrid& g, int cb, int ce, vector<int>& loc){
+	UGrid ret;
+	int c0 = (cb == 0) ? 0 : g.offsets[cb-1];
+	int c1 = (ce == 0) ? 0 : g.offsets[ce-1];
+	//vertices in order of appearance
+	loc.assign(g.n_points(), -1);
+	int np = 0;
+	ret.connectivity.resize(c1 - c0);
+	for (int k=c0; k<c1; ++k){
+		int p = g.connectivity[k];
+		if (loc[p] < 0){
+			loc[p] = np++;
+			ret.points.insert(ret.points.end(), &g.points[3*p], &g.points[3*p] + 3);
+		}
+		ret.connectivity[k-c0] = loc[p];
+	}
+	ret.offsets.resize(ce - cb);
+	for (int i=cb; i<ce; ++i) ret.offsets[i-cb] = g.offsets[i] - c0;
+	ret.types.assign(g.types.begin() + cb, g.types.begin() + ce);
+
+	//polyhedral faces
+	if (g.faceoffsets.size() == 0) return ret;
+	int f0 = 0;
+	for (int i=cb-1; i>=0; --i) if (g.faceoffsets[i] >= 0){
+		f0 = g.faceoffsets[i];
+		break;
+	}
+	ret.faceoffsets.assign(ce - cb, -1);
+	bool haspoly = false;
+	for (int i=cb; i<ce; ++i) if (g.faceoffsets[i] >= 0){
+		haspoly = true;
+		auto it = g.faces.begin() + f0;
+		int nf = *it++;
+		ret.faces.push_back(nf);
+		for (int j=0; j<nf; ++j){
+			int nv = *it++;
+			ret.faces.push_back(nv);
+			for (int k=0; k<nv; ++k) ret.faces.push_back(loc[*it++]);
+		}
+		f0 = g.faceoffsets[i];
+		ret.faceoffsets[i-cb] = ret.faces.size();
+	}
+	if (!haspoly) ret.faceoffsets.clear();
+	return ret;
+}
+
+void write_pvtu(const UGrid& g, std::string fn, int npieces, bool compress){
+	//pieces filenames
+	std::string stem = fn, dir, base;
+	for (std::string ext: {".pvtu", ".vtu"}){
+		if (stem.size() > ext.size() &&
+				stem.compare(stem.size() - ext.size(), ext.size(), ext) == 0){
+			stem.resize(stem.size() - ext.size());
+			break;
+		}
+	}
+	size_t sep = stem.find_last_of("/\\");
+	base = (sep == std::string::npos) ? stem : stem.substr(sep+1);
+	dir = (sep == std::string::npos) ? "" : stem.substr(0, sep+1);
+	vector<std::string> names(npieces);
+	for (int i=0; i<npieces; ++i) names[i] = base + "_" + std::to_string(i) + ".vtu";
+
+	//pieces are processed concurrently, each by a single thread
+	HMParallel::ForChunks(npieces, [&](int ib, int ie, int){
+		vector<int> loc;
+		for (int i=ib; i<ie; ++i){
+			int cb = (long long)g.n_cells()*i/npieces;
+			int ce = (long long)g.n_cells()*(i+1)/npieces;
+			UGrid sub = subgrid(g, cb, ce, loc);
+			write_vtu(sub, dir + names[i], compress, false);
+		}
+	}, 1);
+
+	std::ofstream fs(fn);
+	if (!fs) throw std::runtime_error("failed to open " + fn + " for writing");
+	fs<<"<?xml version=\"1.0\"?>\n";
+	fs<<vtkfile_tag("PUnstructuredGrid", compress && HasCompression());
+	fs<<"<PUnstructuredGrid GhostLevel=\"0\">\n";
+	fs<<"<PPoints>\n";
+	fs<<"<PDataArray type=\"Float64\" NumberOfComponents=\"3\"/>\n";
+	fs<<"</PPoints>\n";
+	for (auto& n: names) fs<<"<Piece Source=\""<<n<<"\"/>\n";
+	fs<<"</PUnstructuredGrid>\n";
+	fs<<"</VTKFile>\n";
+}
+
+}
+
+bool HMVtu::HasCompression(){
+#ifdef HYBMESH_USE_ZLIB
+	return true;
+#else
+	return false;
+#endif
+}
+
+void HMVtu::Write(const UGrid& g, std::string fn, const Options& opt){
+	int npieces = std::min(opt.npieces, g.n_cells());
+	if (npieces > 1) write_pvtu(g, fn, npieces, opt.compress);
+	else write_vtu(g, fn, opt.compress, true);
+}
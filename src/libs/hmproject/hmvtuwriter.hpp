@@ -0,0 +1,43 @@
+#ifndef HMPROJECT_VTUWRITER_HPP
+#define HMPROJECT_VTUWRITER_HPP
+#include "hmproject.h"
+
+namespace HMVtu{
+
+//unstructured grid in vtk xml (*.vtu) layout.
+//Vertices of i-th cell are connectivity[offsets[i-1]], ..., connectivity[offsets[i]-1].
+//For polyhedral cells (type 42) faces stream {nf, nv0, v0..., nv1, v1..., ...}
+//ends at faces[faceoffsets[i]-1]. faceoffsets[i] = -1 for other cell types.
+//faces and faceoffsets are left empty if there are no polyhedral cells.
+struct UGrid{
+	vector<double> points;       //x0, y0, z0, x1, ...
+	vector<int> connectivity;
+	vector<int> offsets;
+	vector<unsigned char> types;
+	vector<int> faces;
+	vector<int> faceoffsets;
+
+	int n_points() const { return points.size()/3; }
+	int n_cells() const { return types.size(); }
+};
+
+struct Options{
+	Options(){}
+	//zlib compression of appended data. Ignored if HasCompression() is false.
+	bool compress = false;
+	//if > 1 cells are split into npieces contiguous ranges.
+	//Each range is written to a separate *.vtu file in parallel,
+	//output file is a *.pvtu collection of them.
+	int npieces = 1;
+};
+
+//whether the library was built with zlib
+bool HasCompression();
+
+//Writes grid to fn using binary appended format.
+//If opt.npieces > 1 fn is a *.pvtu file, pieces are saved
+//as fn-without-extension_0.vtu, fn-without-extension_1.vtu, ...
+void Write(const UGrid& g, std::string fn, const Options& opt=Options());
+
+}
+#endif
@@ -1,10 +1,20 @@
 #include "hmxmlreader.hpp"
+#include "hmparallel.hpp"
 #include <libxml/xmlmemory.h>
 #include <libxml/parser.h>
 #include <libxml/xpath.h>
 #include <sstream>
 #include <fstream>
 #include <string.h>
+#include <climits>
+#ifndef WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#else
+#include <windows.h>
+#endif
 
 using namespace HMXML;
 
@@ -240,6 +250,74 @@ Reader Reader::provide_child(std::string tag){
 	return fnd;
 }
 
+// ======================== MappedFile
+struct HMXML::MappedFile{
+	MappedFile(const std::string& fn);
+	~MappedFile();
+	const char* data() const { return size() > 0 ? _data : nullptr; }
+	size_t size() const { return _size; }
+private:
+	const char* _data = nullptr;
+	size_t _size = 0;
+	//file contents if mapping failed
+	std::vector<char> _copy;
+#ifndef WIN32
+	void* _map = MAP_FAILED;
+#else
+	HANDLE _hfile = INVALID_HANDLE_VALUE, _hmap = NULL;
+#endif
+	void read_copy(const std::string& fn);
+};
+
+HMXML::MappedFile::MappedFile(const std::string& fn){
+#ifndef WIN32
+	int fd = open(fn.c_str(), O_RDONLY);
+	if (fd < 0) throw std::runtime_error("file "+fn+" was not found");
+	struct stat st;
+	if (fstat(fd, &st) == 0 && st.st_size > 0){
+		_size = st.st_size;
+		_map = mmap(NULL, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (_map != MAP_FAILED){
+			madvise(_map, _size, MADV_SEQUENTIAL);
+			_data = (const char*)_map;
+		}
+	}
+	close(fd);
+#else
+	_hfile = CreateFileA(fn.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (_hfile == INVALID_HANDLE_VALUE) throw std::runtime_error("file "+fn+" was not found");
+	LARGE_INTEGER fsize;
+	if (GetFileSizeEx(_hfile, &fsize) && fsize.QuadPart > 0){
+		_size = fsize.QuadPart;
+		_hmap = CreateFileMappingA(_hfile, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (_hmap != NULL) _data = (const char*)MapViewOfFile(_hmap, FILE_MAP_READ, 0, 0, 0);
+	}
+#endif
+	if (_data == nullptr) read_copy(fn);
+}
+
+void HMXML::MappedFile::read_copy(const std::string& fn){
+	std::ifstream fs(fn, std::ios::binary);
+	if (!fs.is_open()) throw std::runtime_error("file "+fn+" was not found");
+	auto buf = fs.rdbuf();
+	_size = buf->pubseekoff(0, fs.end, fs.in);
+	buf->pubseekpos(0, fs.in);
+	_copy.resize(_size);
+	if (_size > 0) buf->sgetn(&_copy[0], _size);
+	_data = _copy.data();
+}
+
+HMXML::MappedFile::~MappedFile(){
+#ifndef WIN32
+	if (_map != MAP_FAILED) munmap(_map, _size);
+#else
+	if (_data != nullptr && _copy.size() == 0) UnmapViewOfFile(_data);
+	if (_hmap != NULL) CloseHandle(_hmap);
+	if (_hfile != INVALID_HANDLE_VALUE) CloseHandle(_hfile);
+#endif
+}
+
 // ======================== AReader
 namespace{
 template<class A>
@@ -293,7 +371,7 @@ template<> std::string get_type_id<double>(){return "double";}
 template<> std::string get_type_id<float>(){return "float";}
 
 template<class A>
-void add_field(HMXML::Reader& reader, const std::vector<A>& data, bool binary, vector<char>& buffer){
+void add_field(HMXML::Reader& reader, const std::vector<A>& data, bool binary, vector<char>& buffer, size_t start0){
 	if (data.size() == 0) return;
 	reader.new_attribute("type", get_type_id<A>());
 	if (!binary){
@@ -302,13 +380,13 @@ void add_field(HMXML::Reader& reader, const std::vector<A>& data, bool binary, v
 	} else {
 		reader.new_attribute("format", "binary");
 		size_t sz= data.size()*sizeof(A);
-		reader.new_child("START").set_content(std::to_string(buffer.size()));
+		reader.new_child("START").set_content(std::to_string(start0 + buffer.size()));
 		buffer.resize(buffer.size()+sz);
 		std::copy((char*)(&data[0]), (char*)(&data[0])+sz, buffer.end()-sz);
 	}
 }
 template<class A>
-void add_vfield(HMXML::Reader& reader, const vector<vector<A>>& data, bool binary, vector<char>& buffer){
+void add_vfield(HMXML::Reader& reader, const vector<vector<A>>& data, bool binary, vector<char>& buffer, size_t start0){
 	if (data.size() == 0) return;
 	reader.new_attribute("type", get_type_id<A>());
 	int vecsz=data[0].size();
@@ -327,7 +405,7 @@ void add_vfield(HMXML::Reader& reader, const vector<vector<A>>& data, bool binar
 		reader.new_attribute("format", "binary");
 		size_t sz= totalsz*sizeof(A);
 		if (vecsz == -1) sz += data.size()*sizeof(unsigned int);
-		reader.new_child("START").set_content(std::to_string(buffer.size()));
+		reader.new_child("START").set_content(std::to_string(start0 + buffer.size()));
 		buffer.resize(buffer.size()+sz);
 		auto bufiter = buffer.end()-sz;
 		if (vecsz != -1){
@@ -351,29 +429,45 @@ void add_vfield(HMXML::Reader& reader, const vector<vector<A>>& data, bool binar
 }//namespace
 
 void ReaderA::set_num_content(const std::vector<char>& data, Reader& subnode, bool binary){
-	add_field(subnode, data, binary, buffer);
+	if (binary) detach();
+	add_field(subnode, data, binary, buffer, spill_size);
+	if (binary) flush_buffer();
 }
 void ReaderA::set_num_content(const std::vector<int>& data, Reader& subnode, bool binary){
-	add_field(subnode, data, binary, buffer);
+	if (binary) detach();
+	add_field(subnode, data, binary, buffer, spill_size);
+	if (binary) flush_buffer();
 }
 void ReaderA::set_num_content(const std::vector<float>& data, Reader& subnode, bool binary){
-	add_field(subnode, data, binary, buffer);
+	if (binary) detach();
+	add_field(subnode, data, binary, buffer, spill_size);
+	if (binary) flush_buffer();
 }
 void ReaderA::set_num_content(const std::vector<double>& data, Reader& subnode, bool binary){
-	add_field(subnode, data, binary, buffer);
+	if (binary) detach();
+	add_field(subnode, data, binary, buffer, spill_size);
+	if (binary) flush_buffer();
 }
 
 void ReaderA::set_num_content(const std::vector<std::vector<char>>& data, Reader& subnode, bool binary){
-	add_vfield(subnode, data, binary, buffer);
+	if (binary) detach();
+	add_vfield(subnode, data, binary, buffer, spill_size);
+	if (binary) flush_buffer();
 }
 void ReaderA::set_num_content(const std::vector<std::vector<int>>& data, Reader& subnode, bool binary){
-	add_vfield(subnode, data, binary, buffer);
+	if (binary) detach();
+	add_vfield(subnode, data, binary, buffer, spill_size);
+	if (binary) flush_buffer();
 }
 void ReaderA::set_num_content(const std::vector<std::vector<float>>& data, Reader& subnode, bool binary){
-	add_vfield(subnode, data, binary, buffer);
+	if (binary) detach();
+	add_vfield(subnode, data, binary, buffer, spill_size);
+	if (binary) flush_buffer();
 }
 void ReaderA::set_num_content(const std::vector<std::vector<double>>& data, Reader& subnode, bool binary){
-	add_vfield(subnode, data, binary, buffer);
+	if (binary) detach();
+	add_vfield(subnode, data, binary, buffer, spill_size);
+	if (binary) flush_buffer();
 }
 
 ReaderA::ReaderA(Reader& r):Reader(r){
@@ -390,45 +484,107 @@ ReaderA* ReaderA::pcreate(std::string tag){
 }
 
 void ReaderA::write(std::string filename){
+	//output file could be the mapped one
+	detach();
 	std::ofstream ofile(filename, std::ios::out | std::ios::binary);
 	std::string xmlstring = tostring();
 	while (xmlstring.size()!=0 && xmlstring.back()!='>') xmlstring.pop_back();
 	assert(xmlstring.size() > 0);
 	ofile<<xmlstring;
+	//binary data from temporary file is copied by blocks
+	if (spill_size > 0){
+		fflush(spill.get());
+		rewind(spill.get());
+		vector<char> block(std::min(spill_size, (size_t)1<<22));
+		size_t left = spill_size;
+		while (left > 0){
+			size_t n = fread(&block[0], 1, std::min(left, block.size()), spill.get());
+			if (n == 0) throw std::runtime_error("failed to read temporary binary data");
+			ofile.write(&block[0], n);
+			left -= n;
+		}
+	}
 	if (buffer.size()>0){
 		ofile.write(&buffer[0], buffer.size());
 	}
 }
 
+void ReaderA::flush_buffer(){
+	if (buffer.size() <= max_buffer_size) return;
+	if (!spill){
+		FILE* f = tmpfile();
+		//keep data in memory if temporary file is not available
+		if (f == NULL) return;
+		spill.reset(f, fclose);
+	}
+	fseek(spill.get(), 0, SEEK_END);
+	if (fwrite(&buffer[0], 1, buffer.size(), spill.get()) != buffer.size())
+		throw std::runtime_error("failed to write temporary binary data");
+	spill_size += buffer.size();
+	vector<char>().swap(buffer);
+}
+
+void ReaderA::unspill(){
+	if (spill_size == 0) return;
+	vector<char> data(spill_size + buffer.size());
+	fflush(spill.get());
+	rewind(spill.get());
+	if (fread(&data[0], 1, spill_size, spill.get()) != spill_size)
+		throw std::runtime_error("failed to read temporary binary data");
+	std::copy(buffer.begin(), buffer.end(), data.begin() + spill_size);
+	std::swap(data, buffer);
+	spill.reset();
+	spill_size = 0;
+}
+
 ReaderA::ReaderA(std::string fn, std::string ending_tag){
-	std::ifstream fs(fn);
-	if (!fs.is_open()) throw std::runtime_error("file "+fn+" was not found");
-	auto buf = fs.rdbuf();
-	size_t sz = buf->pubseekoff(0, fs.end, fs.in);
-	buf->pubseekpos(0, fs.in);
-	vector<char> bufc(sz);
-	buf->sgetn(&bufc[0], sz);
-	auto fnd = strstr(&bufc[0], ending_tag.c_str());
-	if (fnd == NULL) throw std::runtime_error("ending tag "+ending_tag+" was not found");
+	mapped.reset(new MappedFile(fn));
+	const char* data = mapped->data();
+	size_t sz = mapped->size();
+	const char* fnd = std::search(data, data+sz, ending_tag.begin(), ending_tag.end());
+	if (sz == 0 || fnd == data+sz) throw std::runtime_error("ending tag "+ending_tag+" was not found");
 	fnd += ending_tag.size();
 
-	size_t fndpos = (fnd-&bufc[0]);
-	size_t endpos = bufc.size();
-
-	_doc = xmlParseMemory(&bufc[0], fndpos);
-	if (_doc == NULL) std::runtime_error("Error reading xml");
+	size_t fndpos = (fnd-data);
+	_doc = xmlParseMemory(data, fndpos);
+	if (_doc == NULL) throw std::runtime_error("Error reading xml");
 	_nd=xmlDocGetRootElement((xmlDoc*)_doc);
 	isroot=true;
 
-	size_t bufsize = bufc.size()-fndpos;
-	buffer.resize(bufsize);
-	std::copy(bufc.begin()+fndpos, bufc.end(), buffer.begin());
+	mapped_start = fnd;
+	mapped_size = sz-fndpos;
+	if (mapped_size == 1 && fnd[0]=='\n') mapped_size = 0;
+	if (mapped_size == 2 && fnd[0]=='\n' && fnd[1]=='\r') mapped_size = 0;
+	if (mapped_size == 0) detach();
+}
+
+void ReaderA::detach(){
+	if (!mapped) return;
+	buffer.insert(buffer.begin(), mapped_start, mapped_start+mapped_size);
+	mapped.reset();
+	mapped_start = nullptr;
+	mapped_size = 0;
+}
+
+const char* ReaderA::binary_data(){
+	if (mapped) return mapped_start;
+	unspill();
+	return buffer.size() > 0 ? &buffer[0] : nullptr;
+}
+size_t ReaderA::binary_size() const{
+	if (mapped) return mapped_size;
+	else return spill_size + buffer.size();
+}
 
-	if (buffer.size() == 1 && buffer[0]=='\n') buffer.clear();
-	if (buffer.size() == 2 && buffer[0]=='\n' && buffer[1]=='\r') buffer.clear();
+ReaderA::TBinView ReaderA::binary_view(Reader& subnode){
+	unsigned long pos;
+	subnode.value_ulong("START", pos, true);
+	if (pos > binary_size()) throw std::runtime_error("file binary buffer overflow");
+	const char* data = binary_data();
+	return TBinView{data+pos, binary_size()-pos};
 }
 
-ReaderA::TNumContent::TNumContent(Reader& subnode, int num, const vector<char>& buffer){
+ReaderA::TNumContent::TNumContent(Reader& subnode, int num, ReaderA& doc){
 	if (num==0) return;
 
 	//read attributes
@@ -443,138 +599,225 @@ ReaderA::TNumContent::TNumContent(Reader& subnode, int num, const vector<char>&
 
 	//read data
 	if (format_str == "ascii"){
-		std::string content;
-		subnode.value_string(".", content, true);
-		fill_data_ascii(content, dim, type_str, num);
+		//node text is parsed in place if it is stored in a single text node
+		xmlNode* txt = ((xmlNode*)subnode._nd)->children;
+		while (txt != NULL && txt->type != XML_TEXT_NODE) txt = txt->next;
+		if (txt != NULL && (txt->next == NULL || txt->next->type != XML_TEXT_NODE)){
+			const char* content = (const char*)txt->content;
+			fill_data_ascii(content, strlen(content), dim, type_str, doc.min_parse_chunk);
+		} else {
+			std::string content;
+			subnode.value_string(".", content, true);
+			fill_data_ascii(content.c_str(), content.size(), dim, type_str, doc.min_parse_chunk);
+		}
 	} else if (format_str == "binary"){
-		unsigned long pos;
-		subnode.value_ulong("START", pos, true);
-		fill_data_bin(&buffer[0]+pos, buffer.size()-pos, dim, type_str, num);
+		fill_data_bin(doc.binary_view(subnode), dim, type_str, num);
 	} else throw std::runtime_error("unknown xml field format "+format_str);
 }
 
 ReaderA::TNumContent ReaderA::read_num_content(Reader& subnode, int num){
-	return ReaderA::TNumContent(subnode, num, buffer);
+	return ReaderA::TNumContent(subnode, num, *this);
 }
 
 namespace{
-template<class A> void toA(const std::string& s, A& val){}; 
-template<> void toA<float>(const std::string& s, float& val){val=(float)atof(s.c_str());}
-template<> void toA<double>(const std::string& s, double& val){val=atof(s.c_str());}
-template<> void toA<int>(const std::string& s, int& val){val=atoi(s.c_str());}
-template<> void toA<char>(const std::string& s, char& val){val=(char)atoi(s.c_str());}
+//whitespace separated numbers are parsed in place without string allocations.
+//Each token is converted as atoi/atof would do it: trailing garbage is ignored.
+inline bool is_space(char c){
+	return c==' ' || c=='\n' || c=='\r' || c=='\t' || c=='\v';
+}
+inline const char* skip_spaces(const char* s, const char* end){
+	while (s != end && is_space(*s)) ++s;
+	return s;
+}
+inline const char* skip_token(const char* s, const char* end){
+	while (s != end && !is_space(*s)) ++s;
+	return s;
+}
+inline const char* parse_int(const char* s, const char* end, int& val){
+	bool neg = false;
+	if (s != end && (*s == '-' || *s == '+')) neg = (*s++ == '-');
+	int r = 0;
+	while (s != end && *s >= '0' && *s <= '9') r = 10*r + (*s++ - '0');
+	val = neg ? -r : r;
+	return skip_token(s, end);
+}
+template<class A> const char* parse_num(const char* s, const char* end, A& val);
+template<> const char* parse_num(const char* s, const char* end, int& val){
+	return parse_int(s, end, val);
+}
+template<> const char* parse_num(const char* s, const char* end, char& val){
+	int v;
+	s = parse_int(s, end, v);
+	val = (char)v;
+	return s;
+}
+template<> const char* parse_num(const char* s, const char* end, double& val){
+	//node text is null terminated so strtod never reads beyond the token
+	char* e;
+	val = strtod(s, &e);
+	return skip_token(e, end);
+}
+template<> const char* parse_num(const char* s, const char* end, float& val){
+	double v;
+	s = parse_num(s, end, v);
+	val = (float)v;
+	return s;
+}
+
+//Splits text into chunks at whitespace positions.
+//first[i] is the index of the first number in i-th chunk, first.back() is the total count.
+//Chunks are parsed in parallel if text is longer than min_chunk.
+vector<const char*> text_chunks(const char* s, size_t len, size_t min_chunk, vector<size_t>& first){
+	int nchunks = HMParallel::NumChunks((int)std::min(len, (size_t)INT_MAX),
+			(int)std::max((size_t)1, std::min(min_chunk, (size_t)INT_MAX)));
+	vector<const char*> bnd(nchunks+1);
+	bnd[0] = s;
+	bnd[nchunks] = s+len;
+	for (int i=1; i<nchunks; ++i){
+		bnd[i] = std::max(bnd[i-1], skip_token(s + i*(len/nchunks), s+len));
+	}
+	first.assign(nchunks+1, 0);
+	HMParallel::ForChunks(nchunks, [&](int ib, int ie, int){
+		for (int k=ib; k<ie; ++k){
+			const char* it = skip_spaces(bnd[k], bnd[k+1]);
+			while (it != bnd[k+1]){
+				++first[k+1];
+				it = skip_spaces(skip_token(it, bnd[k+1]), bnd[k+1]);
+			}
+		}
+	}, 1);
+	for (int i=0; i<nchunks; ++i) first[i+1] += first[i];
+	return bnd;
+}
+
+//calls put(index, value) for each number
+template<class A, class TPut>
+void parse_chunks(const vector<const char*>& bnd, const vector<size_t>& first, TPut&& put){
+	HMParallel::ForChunks(bnd.size()-1, [&](int ib, int ie, int){
+		for (int k=ib; k<ie; ++k){
+			size_t index = first[k];
+			const char* it = skip_spaces(bnd[k], bnd[k+1]);
+			A val;
+			while (it != bnd[k+1]){
+				it = skip_spaces(parse_num(it, bnd[k+1], val), bnd[k+1]);
+				put(index++, val);
+			}
+		}
+	}, 1);
+}
 
 template<class A>
-void fill_vector(vector<A>& ret, vector<std::string>::const_iterator start, vector<std::string>::const_iterator end){
-	ret.resize(end-start);
-	auto rit = ret.begin();
-	for (auto it=start; it!=end; ++it) toA(*it, *rit++);
+void fill_vector_ascii(const char* s, size_t len, size_t min_chunk, vector<A>& ret){
+	vector<size_t> first;
+	auto bnd = text_chunks(s, len, min_chunk, first);
+	ret.resize(first.back());
+	parse_chunks<A>(bnd, first, [&ret](size_t i, A val){ ret[i] = val; });
 }
+
 template<class A>
-void fill_vector_bin(const char* start, size_t size, vector<A>& vec, int vecn){
-	vec.resize(vecn);
-	size_t asize = sizeof(A)*vecn;
-	if (asize > size) throw std::runtime_error("file binary buffer overflow");
-	memcpy((void*)(&vec[0]), start, asize);
+void fill_dimvector_ascii(const char* s, size_t len, size_t min_chunk, vector<vector<A>>& ret, int dim){
+	vector<size_t> first;
+	auto bnd = text_chunks(s, len, min_chunk, first);
+	size_t n = first.back()/dim;
+	ret.resize(n, vector<A>(dim));
+	parse_chunks<A>(bnd, first, [&ret, dim, n](size_t i, A val){
+		if (i/dim < n) ret[i/dim][i%dim] = val;
+	});
 }
 
+//first number in each subvector gives its dimension
 template<class A>
-void split_vector(vector<A>& input, vector<vector<A>>& output, int dim){
-	output = vector<vector<A>>(input.size()/dim, vector<A>(dim));
-	auto it=input.begin();
-	for (int i=0; i<output.size(); ++i){
-		for (int j=0; j<dim; ++j){
-			output[i][j]=*it++;
+void fill_vvector_ascii(const char* s, size_t len, vector<vector<A>>& ret){
+	const char* end = s+len;
+	const char* it = skip_spaces(s, end);
+	while (it != end){
+		int dim;
+		it = skip_spaces(parse_int(it, end, dim), end);
+		//each number takes at least one character
+		if (dim > end - it) throw std::runtime_error("corrupted variable vector data");
+		ret.emplace_back(std::max(dim, 0));
+		for (auto& v: ret.back()){
+			if (it == end) throw std::runtime_error("corrupted variable vector data");
+			it = skip_spaces(parse_num(it, end, v), end);
 		}
 	}
-	input.clear();
 }
+
 template<class A>
-void fill_vvector(const vector<std::string>& s, vector<vector<A>>& ret){
-	auto it=s.begin();
-	while (it!=s.end()){
-		int dim = atoi((*it++).c_str());
-		if (it-s.begin()+dim>s.size())
-			throw std::runtime_error("corrupted variable vector data");
-		ret.emplace_back();
-		fill_vector<A>(ret.back(), it, it+dim);
-		it+=dim;
-	}
+void fill_vector_bin(const ReaderA::TBinView& data, vector<A>& vec, int vecn){
+	vec.resize(vecn);
+	if (vecn > 0) data.read(0, vecn, &vec[0]);
 }
 template<class A>
-void fill_vvector_bin(const char* start, size_t size, vector<vector<A>>& ret, int vecn){
+void fill_dimvector_bin(const ReaderA::TBinView& data, vector<vector<A>>& ret, int vecn, int dim){
+	if ((size_t)vecn*dim*sizeof(A) > data.size) throw std::runtime_error("file binary buffer overflow");
+	ret.resize(vecn, vector<A>(dim));
+	size_t pos = 0;
+	for (auto& it: ret) pos = data.read(pos, dim, &it[0]);
+}
+
+template<class A>
+void fill_vvector_bin(const ReaderA::TBinView& data, vector<vector<A>>& ret, int vecn){
 	ret.resize(vecn);
-	const char* iter=start;
-	long leftsize=size;
-	auto decrease_leftsize = [&leftsize](size_t num){
-		leftsize-=num;
-		if (leftsize<0) throw std::runtime_error("file binary buffer overflow");
-	};
+	size_t pos = 0;
 	for (int i=0; i<vecn; ++i){
-		//dim
 		unsigned int dim;
-		decrease_leftsize(sizeof(unsigned int));
-		memcpy(&dim, iter, sizeof(unsigned int));
-		iter+=sizeof(unsigned int);
-		//data
-		fill_vector_bin(iter, leftsize, ret[i], dim);
-		decrease_leftsize(dim*sizeof(A));
-		iter+=dim*sizeof(A);
+		pos = data.read(pos, 1, &dim);
+		if (dim > (data.size - pos)/sizeof(A)) throw std::runtime_error("file binary buffer overflow");
+		ret[i].resize(dim);
+		if (dim > 0) pos = data.read(pos, dim, &ret[i][0]);
 	}
 }
 
 }
-void ReaderA::TNumContent::fill_data_ascii(const std::string& data, int dim, std::string typestr, int num){
+void ReaderA::TNumContent::fill_data_ascii(const char* data, size_t len, int dim, std::string typestr,
+		size_t min_chunk){
 	int tp = code(typestr);
 	if (dim == 1){
-		std::vector<std::string> ss = split(data, "\n\r\v\t ");
 		switch (tp){
-			case RINT: fill_vector(intvec, ss.begin(), ss.end()); break;
-			case RCHR: fill_vector(chrvec, ss.begin(), ss.end()); break;
-			case RDBL: fill_vector(dblvec, ss.begin(), ss.end()); break;
-			case RFLT: fill_vector(fltvec, ss.begin(), ss.end()); break;
+			case RINT: fill_vector_ascii(data, len, min_chunk, intvec); break;
+			case RCHR: fill_vector_ascii(data, len, min_chunk, chrvec); break;
+			case RDBL: fill_vector_ascii(data, len, min_chunk, dblvec); break;
+			case RFLT: fill_vector_ascii(data, len, min_chunk, fltvec); break;
 		};
 	} else if (dim!=-1){
-		fill_data_ascii(data, 1, typestr, num*dim);
 		switch (tp){
-			case RINT: split_vector(intvec, intvecvec, dim); break;
-			case RCHR: split_vector(chrvec, chrvecvec, dim); break;
-			case RDBL: split_vector(dblvec, dblvecvec, dim); break;
-			case RFLT: split_vector(fltvec, fltvecvec, dim); break;
+			case RINT: fill_dimvector_ascii(data, len, min_chunk, intvecvec, dim); break;
+			case RCHR: fill_dimvector_ascii(data, len, min_chunk, chrvecvec, dim); break;
+			case RDBL: fill_dimvector_ascii(data, len, min_chunk, dblvecvec, dim); break;
+			case RFLT: fill_dimvector_ascii(data, len, min_chunk, fltvecvec, dim); break;
 		}
 	} else{
-		std::vector<std::string> ss = split(data, "\n\r\v\t ");
 		switch (tp){
-			case RINT: fill_vvector(ss, intvecvec); break;
-			case RCHR: fill_vvector(ss, chrvecvec); break;
-			case RDBL: fill_vvector(ss, dblvecvec); break;
-			case RFLT: fill_vvector(ss, fltvecvec); break;
+			case RINT: fill_vvector_ascii(data, len, intvecvec); break;
+			case RCHR: fill_vvector_ascii(data, len, chrvecvec); break;
+			case RDBL: fill_vvector_ascii(data, len, dblvecvec); break;
+			case RFLT: fill_vvector_ascii(data, len, fltvecvec); break;
 		}
 	}
 }
-void ReaderA::TNumContent::fill_data_bin(const char* start, size_t size, int dim, std::string typestr, int num){
+void ReaderA::TNumContent::fill_data_bin(const TBinView& data, int dim, std::string typestr, int num){
 	int tp = code(typestr);
 	if (dim == 1){
 		switch (tp){
-			case RINT: fill_vector_bin(start, size, intvec, num); break;
-			case RFLT: fill_vector_bin(start, size, fltvec, num); break;
-			case RDBL: fill_vector_bin(start, size, dblvec, num); break;
-			case RCHR: fill_vector_bin(start, size, chrvec, num); break;
+			case RINT: fill_vector_bin(data, intvec, num); break;
+			case RFLT: fill_vector_bin(data, fltvec, num); break;
+			case RDBL: fill_vector_bin(data, dblvec, num); break;
+			case RCHR: fill_vector_bin(data, chrvec, num); break;
 		}
 	} else if (dim!=-1){
-		fill_data_bin(start, size, 1, typestr, num*dim);
 		switch (tp){
-			case RINT: split_vector(intvec, intvecvec, dim); break;
-			case RCHR: split_vector(chrvec, chrvecvec, dim); break;
-			case RDBL: split_vector(dblvec, dblvecvec, dim); break;
-			case RFLT: split_vector(fltvec, fltvecvec, dim); break;
+			case RINT: fill_dimvector_bin(data, intvecvec, num, dim); break;
+			case RCHR: fill_dimvector_bin(data, chrvecvec, num, dim); break;
+			case RDBL: fill_dimvector_bin(data, dblvecvec, num, dim); break;
+			case RFLT: fill_dimvector_bin(data, fltvecvec, num, dim); break;
 		}
 	} else {
 		switch (tp){
-			case RINT: fill_vvector_bin(start, size, intvecvec, num); break;
-			case RCHR: fill_vvector_bin(start, size, chrvecvec, num); break;
-			case RDBL: fill_vvector_bin(start, size, dblvecvec, num); break;
-			case RFLT: fill_vvector_bin(start, size, fltvecvec, num); break;
+			case RINT: fill_vvector_bin(data, intvecvec, num); break;
+			case RCHR: fill_vvector_bin(data, chrvecvec, num); break;
+			case RDBL: fill_vvector_bin(data, dblvecvec, num); break;
+			case RFLT: fill_vvector_bin(data, fltvecvec, num); break;
 		}
 	}
 	if (N()!=num) throw std::runtime_error("invalid ascii numerical field size given");
@@ -1,6 +1,8 @@
 #ifndef HYBMESH_XML_READER_HPP
 #define HYBMESH_XML_READER_HPP
 #include "hmproject.h"
+#include <string.h>
+#include <stdio.h>
 
 namespace HMXML{
 
@@ -53,12 +55,23 @@ struct Reader{
 	void *_doc, *_nd;
 };
 
+//read-only file contents. Uses memory mapping if possible.
+struct MappedFile;
+
 //reader with additional binary buffer, which will be written to end of output file
 //this class should represent only the root node of xml document
 struct ReaderA: public Reader{
+	//binary data appended by set_num_content procedures.
+	//When it grows above max_buffer_size it is moved to a temporary file
+	//which is copied to the output by write().
 	std::vector<char> buffer;
+	size_t max_buffer_size = 16*1024*1024;
+	//ascii numeric fields longer than this are parsed by parallel chunks
+	size_t min_parse_chunk = 1024*1024;
 	ReaderA():Reader(){isroot=true;}
 	ReaderA(Reader& r);
+	//file is memory mapped: xml part is parsed directly from mapped memory,
+	//binary part is not copied and is accessed through binary views.
 	ReaderA(std::string filename, std::string ending_tag);
 
 	static ReaderA create(std::string tag);
@@ -77,7 +90,43 @@ struct ReaderA: public Reader{
 	struct TNumContent;
 	TNumContent read_num_content(Reader& subnode, int num);
 
+	//view of binary data starting from subnode START position.
+	//Valid until this document is modified or destroyed.
+	struct TBinView;
+	TBinView binary_view(Reader& subnode);
+	//whole binary part of the document
+	const char* binary_data();
+	size_t binary_size() const;
+
 	void write(std::string filename) override;
+private:
+	shared_ptr<MappedFile> mapped;
+	const char* mapped_start = nullptr;
+	size_t mapped_size = 0;
+	//copies mapped binary data to buffer and releases the mapping
+	void detach();
+
+	shared_ptr<FILE> spill;
+	size_t spill_size = 0;
+	//moves buffer to the temporary file if it is too large
+	void flush_buffer();
+	//reads data from the temporary file back to the buffer
+	void unspill();
+};
+
+//Binary data is stored without alignment, so values are read by memcpy.
+struct ReaderA::TBinView{
+	const char* start;
+	size_t size;   //in bytes
+
+	//reads n values of type A starting at byte offset pos into dst; returns offset after read data
+	template<class A>
+	size_t read(size_t pos, size_t n, A* dst) const{
+		size_t asize = n*sizeof(A);
+		if (pos > size || asize > size - pos) throw std::runtime_error("file binary buffer overflow");
+		if (asize > 0) memcpy((void*)dst, start+pos, asize);
+		return pos + asize;
+	}
 };
 
 struct ReaderA::TNumContent{
@@ -85,7 +134,7 @@ struct ReaderA::TNumContent{
 	static const int RINT=2;
 	static const int RFLT=3;
 	static const int RDBL=4;
-	TNumContent(Reader& subnode, int num, const vector<char>& buffer);
+	TNumContent(Reader& subnode, int num, ReaderA& doc);
 
 	//only one of those fields are filled after read_num_content execution
 	std::vector<char> chrvec;
@@ -118,8 +167,8 @@ struct ReaderA::TNumContent{
 	std::vector<vector<To>> convert_vdata();  //To is vector<...> class
 
 private:
-	void fill_data_ascii(const std::string& data, int dim, std::string typestr, int num);
-	void fill_data_bin(const char* start, size_t size, int dim, std::string type_str, int num);
+	void fill_data_ascii(const char* data, size_t len, int dim, std::string typestr, size_t min_chunk);
+	void fill_data_bin(const TBinView& data, int dim, std::string type_str, int num);
 	template<class A> void force_vv();
 	template<class A> void force_v();
 	template<class A> vector<A>& _vec();
@@ -2,6 +2,7 @@
 #include "clipper_core.hpp"
 #include "gpc_core.hpp"
 #include "assemble2d.hpp"
+#include "hmparallel.hpp"
 
 namespace ci = HM2D::Contour::Clip;
 using namespace ci;
@@ -266,8 +267,22 @@ TRet ci::Union(const vector<ECont>& cont){
 	if (cont.size() == 0) return TRet();
 	vector<Impl::GpcTree> p1; p1.reserve(cont.size());
 	for (auto& c: cont) p1.push_back(Impl::GpcTree(c));
-	for (int i=1; i<cont.size(); ++i){
-		p1[0] = Impl::GpcTree::Union(p1[0], p1[i]);
+	//neighbouring polygons are united pairwise level by level,
+	//so operands of each union are of comparable size.
+	//Unions of a level are independent and are run in parallel.
+	while (p1.size() > 1){
+		int n2 = p1.size()/2;
+		vector<vector<Impl::GpcTree>> chres(HMParallel::NumChunks(n2, 1));
+		HMParallel::ForChunks(n2, [&](int ib, int ie, int ichunk){
+			for (int i=ib; i<ie; ++i){
+				chres[ichunk].push_back(Impl::GpcTree::Union(p1[2*i], p1[2*i+1]));
+			}
+		}, 1);
+		vector<Impl::GpcTree> p2; p2.reserve(n2+1);
+		for (auto& ch: chres)
+		for (auto& it: ch) p2.push_back(std::move(it));
+		if (p1.size() % 2 == 1) p2.push_back(std::move(p1.back()));
+		std::swap(p1, p2);
 	}
 	return assign_btypes(
 		cont,
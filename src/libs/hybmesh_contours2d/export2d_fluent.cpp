@@ -4,6 +4,8 @@
 #include <unordered_map>
 #include "modcont.hpp"
 #include "assemble2d.hpp"
+#include "hmparallel.hpp"
+#include "nodes_compare.h"
 
 using namespace HM2D;
 namespace hme=HM2D::Export;
@@ -105,6 +107,82 @@ char msh_cell_type(const Cell& c){
 	throw std::runtime_error("invalid cell type for Fluent export");
 }
 
+//(index (head)(binary data)End of Binary Section index)
+template<class A>
+void binary_section(std::ofstream& fs, int index, const std::string& head, const vector<A>& data){
+	fs<<"("<<index<<" ("<<head<<")(";
+	fs.write(reinterpret_cast<const char*>(data.data()), data.size()*sizeof(A));
+	fs<<")\nEnd of Binary Section   "<<index<<")\n";
+}
+
+//binary sections contents are filled by parallel chunks
+void write_binary(std::string fn, const GridData& g, const vector<char>& ctypes, char cell_common_type,
+		vector<FaceData>& face_data, const vector<int>& periodic_relations,
+		const hme::PeriodicData& pd){
+	std::ofstream fs(fn, std::ios::binary);
+	//header
+	fs<<"(0 \"HybMesh to Fluent File\")\n(2 2)\n";
+
+	//Vertices: Zone 1
+	fs<<"(10 (0 1 "<<to_hex(g.vvert.size())<<" 0 2))\n";
+	{
+		vector<double> vdata(2*g.vvert.size());
+		HMParallel::ForChunks(g.vvert.size(), [&](int ib, int ie, int){
+			for (int i=ib; i<ie; ++i){
+				vdata[2*i] = g.vvert[i]->x;
+				vdata[2*i+1] = g.vvert[i]->y;
+			}
+		});
+		binary_section(fs, 3010, "1 1 " + to_hex(g.vvert.size()) + " 1 2", vdata);
+	}
+
+	//Cells: Zone2
+	fs<<"(12 (0 1 "<<to_hex(g.vcells.size())<<" 0))\n";
+	if (cell_common_type != '0'){
+		fs<<"(12 (2 1 "<<to_hex(g.vcells.size())<<" 1 "<<cell_common_type<<"))\n";
+	} else {
+		vector<int> cdata(ctypes.size());
+		for (size_t i=0; i<ctypes.size(); ++i) cdata[i] = ctypes[i] - '0';
+		binary_section(fs, 2012, "2 1 " + to_hex(g.vcells.size()) + " 1 0", cdata);
+	}
+
+	//Faces: Zones 3+it
+	fs<<"(13 (0 1 "<<to_hex(g.vedges.size())<<" 0))\n";
+	for (auto& fd: face_data){
+		if (fd.n == 0) continue;
+		vector<int> fdata(4*fd.n);
+		HMParallel::ForChunks(fd.n, [&](int ib, int ie, int){
+			for (int i=ib; i<ie; ++i){
+				auto& ed = *g.vedges[fd.istart + i];
+				fdata[4*i] = ed.first()->id + 1;
+				fdata[4*i+1] = ed.last()->id + 1;
+				fdata[4*i+2] = ed.has_left_cell() ? ed.left.lock()->id + 1 : 0;
+				fdata[4*i+3] = ed.has_right_cell() ? ed.right.lock()->id + 1 : 0;
+			}
+		});
+		binary_section(fs, 2013, to_hex(fd.zone_index) + " " + to_hex(fd.istart+1) + " " +
+				to_hex(fd.iend) + " " + to_hex(fd.zone_type) + " 2", fdata);
+	}
+	//Periodic features
+	int it = 0;
+	for (int k=0; k<pd.size(); ++k){
+		auto z1 = FaceData::zone_by_bindex(face_data, pd.b1[k]);
+		auto z2 = FaceData::zone_by_bindex(face_data, pd.b2[k]);
+		int sz = z1->n;
+		vector<int> pdata(periodic_relations.begin() + 2*it, periodic_relations.begin() + 2*(it+sz));
+		for (auto& v: pdata) v += 1;
+		binary_section(fs, 2018, to_hex(it+1) + " " + to_hex(it+sz) + " " +
+				to_hex(z1->zone_index) + " " + to_hex(z2->zone_index), pdata);
+		it+=sz;
+	}
+
+	//Boundary features
+	fs<<"(45 (2 fluid fluid 1)())\n";
+	for (auto& fd: face_data){
+		fs<<"(45 ("<<fd.zone_index<<" "<<fd.zone_name<<" "<<fd.boundary_name<<" 1)())\n";
+	}
+}
+
 }
 
 std::vector<int> hme::PeriodicData::assemble(GridData& g) const {
@@ -181,21 +259,30 @@ std::vector<int> hme::PeriodicData::assemble(GridData& g) const {
 		if (ar[0].size() > 1 && ar[0][0]->last() != ar[0][1]->first()) HM2D::Contour::Algos::Reverse(ar[0]);
 		assembled_b_contours.push_back(std::move(ar[0]));
 	}
-	//map for adressing
+	//map for adressing. Grid edges are found by their end points
+	//which are placed into a spatial hash as 2*i, 2*i+1 for i-th edge.
+	vector<double> bnd_crd(4*bnd_edges.size());
+	for (int i=0; i<bnd_edges.size(); ++i){
+		bnd_crd[4*i] = bnd_edges[i]->first()->x;
+		bnd_crd[4*i+1] = bnd_edges[i]->first()->y;
+		bnd_crd[4*i+2] = bnd_edges[i]->last()->x;
+		bnd_crd[4*i+3] = bnd_edges[i]->last()->y;
+	}
+	PointHashGrid<2> bnd_hash(std::move(bnd_crd));
 	std::unordered_map<HM2D::Edge*, int> e_cont_to_grid;
 	for (auto& it1: assembled_b_contours)
 	for (auto& it2: it1){
-		//int p1 = static_cast<GridPoint*>(it2->pstart)->get_ind();
-		//int p2 = static_cast<GridPoint*>(it2->pend)->get_ind();
 		auto v1 = it2->first().get();
 		auto v2 = it2->last().get();
-		int gi;
-		for (gi=0; gi<bnd_edges.size(); ++gi){
-			auto e = bnd_edges[gi];
-			if (*e->first() != *v1 && *e->first() != *v2) continue;
-			if (*e->last() != *v1 && *e->last() != *v2) continue;
-			break;
-		}
+		double p1[2] = {v1->x, v1->y};
+		//lowest index of edge which connects v1 and v2
+		int gi = bnd_edges.size();
+		bnd_hash.visit(p1, [&](int k){
+			auto e = bnd_edges[k/2];
+			auto vopp = (k % 2 == 0) ? e->last() : e->first();
+			if (*vopp == *v1 || *vopp == *v2) gi = std::min(gi, k/2);
+			return true;
+		});
 		assert(gi<bnd_edges.size());
 		e_cont_to_grid.emplace(it2.get(), bnd_edges_indicies[gi]);
 	}
@@ -223,7 +310,7 @@ std::vector<int> hme::PeriodicData::assemble(GridData& g) const {
 	return ret;
 }
 
-void hme::GridMSH(const GridData& gg, std::string fn, hme::BNamesFun bnames, PeriodicData pd){
+void hme::GridMSH(const GridData& gg, std::string fn, hme::BNamesFun bnames, PeriodicData pd, bool binary){
 	//Zones:
 	//1    - verticies default
 	//2    - fluid for cells
@@ -245,6 +332,11 @@ void hme::GridMSH(const GridData& gg, std::string fn, hme::BNamesFun bnames, Per
 	//edges will be reverted if necessary
 	vector<int> periodic_relations = pd.assemble(g);
 
+	if (binary){
+		aa::enumerate_ids_pvec(g.vcells);
+		aa::enumerate_ids_pvec(g.vvert);
+		return write_binary(fn, g, ctypes, cell_common_type, face_data, periodic_relations, pd);
+	}
 	std::ofstream fs(fn);
 	fs.precision(16);
 	//header
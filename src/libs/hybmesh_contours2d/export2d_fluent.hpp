@@ -24,7 +24,9 @@ void GridMSH(const GridData& g, std::string fn, BNamesFun bnames);
 
 void GridMSH(const GridData& g, std::string fn, PeriodicData pd);
 
-void GridMSH(const GridData& g, std::string fn, BNamesFun bnames, PeriodicData pd);
+//binary=true writes node, cell, face and periodic sections in Fluent binary format
+//(3010, 2012, 2013, 2018 sections)
+void GridMSH(const GridData& g, std::string fn, BNamesFun bnames, PeriodicData pd, bool binary=false);
 
 }}
 
@@ -151,24 +151,6 @@ Export::GridWriter::GridWriter(const GridData& g,
 	g.enumerate_all();
 	__tp = tp;
 	
-	//supplementary data
-	vector<double> pcoords(2*grid->vvert.size());
-	for (int i=0; i<grid->vvert.size(); ++i){
-		pcoords[2*i]   = grid->vvert[i]->x;
-		pcoords[2*i+1] = grid->vvert[i]->y;
-	}
-	vector<int> edgeconnect(grid->vedges.size()*2), edgecellconnect(grid->vedges.size()*2);
-	for (int i=0; i<grid->vedges.size(); ++i){
-		auto e = grid->vedges[i];
-		edgeconnect[2*i] = e->first()->id;
-		edgeconnect[2*i+1] = e->last()->id;
-		int cl = -1, cr = -1;
-		if (e->has_left_cell()) cl = e->left.lock()->id;
-		if (e->has_right_cell()) cr = e->right.lock()->id;
-		edgecellconnect[2*i] = cl;
-		edgecellconnect[2*i+1] = cr;
-	}
-
 	//create xml structure
 	gwriter = subnode->new_child("GRID2D");
 	gwriter.new_attribute("name", gridname);
@@ -178,18 +160,41 @@ Export::GridWriter::GridWriter(const GridData& g,
 	gwriter.new_child("N_EDGES").set_content(std::to_string(grid->vedges.size()));
 	gwriter.new_child("N_CELLS").set_content(std::to_string(grid->vcells.size()));
 
+	//supplementary data arrays are built right before writing
+	//so that only one of them is kept in memory at a time.
 	//vertices
 	vwriter = gwriter.new_child("VERTICES");
-	auto coordswriter = vwriter.new_child("COORDS");
-	writer->set_num_content(pcoords, coordswriter, __tp!="ascii");
+	{
+		vector<double> pcoords(2*grid->vvert.size());
+		for (int i=0; i<grid->vvert.size(); ++i){
+			pcoords[2*i]   = grid->vvert[i]->x;
+			pcoords[2*i+1] = grid->vvert[i]->y;
+		}
+		auto coordswriter = vwriter.new_child("COORDS");
+		writer->set_num_content(pcoords, coordswriter, __tp!="ascii");
+	}
 
 	//edges
 	ewriter = gwriter.new_child("EDGES");
-	auto vconnectwriter = ewriter.new_child("VERT_CONNECT");
-	writer->set_num_content(edgeconnect, vconnectwriter, __tp=="bin");
-
-	auto cconnectwriter = ewriter.new_child("CELL_CONNECT");
-	writer->set_num_content(edgecellconnect, cconnectwriter, __tp=="bin");
+	{
+		vector<int> edgeconnect(grid->vedges.size()*2);
+		for (int i=0; i<grid->vedges.size(); ++i){
+			edgeconnect[2*i] = grid->vedges[i]->first()->id;
+			edgeconnect[2*i+1] = grid->vedges[i]->last()->id;
+		}
+		auto vconnectwriter = ewriter.new_child("VERT_CONNECT");
+		writer->set_num_content(edgeconnect, vconnectwriter, __tp=="bin");
+	}
+	{
+		vector<int> edgecellconnect(grid->vedges.size()*2);
+		for (int i=0; i<grid->vedges.size(); ++i){
+			auto& e = grid->vedges[i];
+			edgecellconnect[2*i] = e->has_left_cell() ? e->left.lock()->id : -1;
+			edgecellconnect[2*i+1] = e->has_right_cell() ? e->right.lock()->id : -1;
+		}
+		auto cconnectwriter = ewriter.new_child("CELL_CONNECT");
+		writer->set_num_content(edgecellconnect, cconnectwriter, __tp=="bin");
+	}
 
 	//cells
 	cwriter = gwriter.new_child("CELLS");
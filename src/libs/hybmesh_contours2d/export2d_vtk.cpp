@@ -2,6 +2,7 @@
 #include <fstream>
 #include "contour.hpp"
 #include "contour_tree.hpp"
+#include "hmparallel.hpp"
 
 using namespace HM2D;
 
@@ -79,35 +80,68 @@ void Export::VerticesVTK(const VertexData& data, std::string fn){
 }
 
 void Export::GridVTK(const GridData& g, std::string fn){
+	GridVTK(Flatten(g), fn);
+}
+
+void Export::GridVTK(const FlatGrid& g, std::string fn){
 	std::ofstream fs(fn);
 	fs<<"# vtk DataFile Version 3.0"<<std::endl;
 	fs<<"HybMesh Grid 2D"<<std::endl;
 	fs<<"ASCII"<<std::endl;
 	//Points
 	fs<<"DATASET UNSTRUCTURED_GRID"<<std::endl;
-	fs<<"POINTS "<<g.vvert.size()<< " float"<<std::endl;
-	for (int i=0;i<g.vvert.size();++i){
-		auto p = g.vvert[i];
-		fs<<(float)p->x<<" "<<(float)p->y<<" 0"<<std::endl;
+	fs<<"POINTS "<<g.n_vert()<< " float"<<std::endl;
+	for (int i=0; i<g.n_vert(); ++i){
+		fs<<(float)g.vert[2*i]<<" "<<(float)g.vert[2*i+1]<<" 0"<<std::endl;
 	}
 	//Cells
-	int totc = g.vcells.size();
-	for (auto c: g.vcells) totc+=c->edges.size();
-	fs<<"CELLS  "<<g.vcells.size()<<"   "<<totc<<std::endl;
-	aa::enumerate_ids_pvec(g.vvert);
-	for (int i=0;i<g.vcells.size();++i){
-		auto c = g.vcells[i];
-		fs<<c->edges.size()<<"  ";
-		auto op = HM2D::Contour::OrderedPoints(c->edges);
-		op.resize(op.size()-1);
-		for (auto p: op){ fs<<p->id<<" "; }
+	int totc = g.n_cells() + g.cell_edge.size();
+	fs<<"CELLS  "<<g.n_cells()<<"   "<<totc<<std::endl;
+	vector<int> op;
+	for (int i=0; i<g.n_cells(); ++i){
+		op.clear();
+		g.cell_vert(i, op);
+		fs<<op.size()<<"  ";
+		for (auto p: op){ fs<<p<<" "; }
 		fs<<std::endl;
 	}
-	fs<<"CELL_TYPES  "<<g.vcells.size()<<std::endl;
-	for (int i=0;i<g.vcells.size();++i) fs<<7<<std::endl;
+	fs<<"CELL_TYPES  "<<g.n_cells()<<std::endl;
+	for (int i=0; i<g.n_cells(); ++i) fs<<7<<std::endl;
 	fs.close();
 }
 
+void Export::GridVTU(const GridData& g, std::string fn, const HMVtu::Options& opt){
+	GridVTU(Flatten(g), fn, opt);
+}
+
+void Export::GridVTU(const FlatGrid& g, std::string fn, const HMVtu::Options& opt){
+	HMVtu::UGrid ug;
+	ug.points.resize(3*g.n_vert());
+	HMParallel::ForChunks(g.n_vert(), [&](int ib, int ie, int){
+		for (int i=ib; i<ie; ++i){
+			ug.points[3*i] = g.vert[2*i];
+			ug.points[3*i+1] = g.vert[2*i+1];
+			ug.points[3*i+2] = 0;
+		}
+	});
+	//number of cell vertices equals number of cell edges,
+	//so each cell range is written directly to its final position
+	ug.connectivity.resize(g.cell_edge.size());
+	if (g.n_cells() > 0){
+		ug.offsets.assign(g.cell_edge_start.begin()+1, g.cell_edge_start.end());
+	}
+	ug.types.assign(g.n_cells(), 7);
+	HMParallel::ForChunks(g.n_cells(), [&](int ib, int ie, int){
+		vector<int> op;
+		for (int i=ib; i<ie; ++i){
+			op.clear();
+			g.cell_vert(i, op);
+			std::copy(op.begin(), op.end(), ug.connectivity.begin() + g.cell_edge_start[i]);
+		}
+	});
+	HMVtu::Write(ug, fn, opt);
+}
+
 void Export::GridCDataVTK(const GridData& g, const vector<double>& dt, std::string fn){
 	assert(dt.size() == g.vcells.size());
 	GridVTK(g, fn);
@@ -2,6 +2,8 @@
 #define HYBMESH_VTK_EXPORT2D
 
 #include "primitives2d.hpp"
+#include "flatgrid2d.hpp"
+#include "hmvtuwriter.hpp"
 
 namespace HM2D{ namespace Export{
 
@@ -11,6 +13,10 @@ void VerticesVTK(const VertexData& data, std::string fn);
 
 
 void GridVTK(const GridData& g, std::string fn);
+void GridVTK(const FlatGrid& g, std::string fn);
+//binary vtk xml format (*.vtu or *.pvtu if opt.npieces > 1)
+void GridVTU(const GridData& g, std::string fn, const HMVtu::Options& opt=HMVtu::Options());
+void GridVTU(const FlatGrid& g, std::string fn, const HMVtu::Options& opt=HMVtu::Options());
 void GridCDataVTK(const GridData& g, const vector<double>& dt, std::string fn);
 void GridVDataVTK(const GridData& g, const vector<double>& dt, std::string fn);
 
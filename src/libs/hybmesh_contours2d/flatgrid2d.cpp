@@ -0,0 +1,148 @@
+#include "flatgrid2d.hpp"
+#include "hmpool.hpp"
+
+using namespace HM2D;
+
+// ===================== FlatGrid
+void FlatGrid::cell_vert(int icell, vector<int>& ret) const{
+	aa::chain_vertices(cell_edges_begin(icell), cell_size(icell), edge_vert, ret);
+}
+
+void FlatGrid::clear(){
+	vert.clear();
+	edge_vert.clear();
+	edge_cell.clear();
+	btypes.clear();
+	cell_edge_start.clear();
+	cell_edge.clear();
+}
+
+size_t FlatGrid::memory_usage() const{
+	return vert.size()*sizeof(double) +
+		(edge_vert.size() + edge_cell.size() + btypes.size() +
+		 cell_edge_start.size() + cell_edge.size())*sizeof(int);
+}
+
+// ===================== conversion
+FlatGrid HM2D::Flatten(const GridData& g){
+	FlatGrid ret;
+	g.enumerate_all();
+
+	ret.vert.resize(2*g.vvert.size());
+	auto vit = ret.vert.begin();
+	for (auto& v: g.vvert){
+		*vit++ = v->x;
+		*vit++ = v->y;
+	}
+
+	ret.edge_vert.resize(2*g.vedges.size());
+	ret.edge_cell.resize(2*g.vedges.size());
+	ret.btypes.resize(g.vedges.size());
+	for (size_t i=0; i<g.vedges.size(); ++i){
+		const Edge& e = *g.vedges[i];
+		ret.edge_vert[2*i] = e.vertices[0]->id;
+		ret.edge_vert[2*i+1] = e.vertices[1]->id;
+		ret.edge_cell[2*i] = e.has_left_cell() ? e.left.lock()->id : -1;
+		ret.edge_cell[2*i+1] = e.has_right_cell() ? e.right.lock()->id : -1;
+		ret.btypes[i] = e.boundary_type;
+	}
+
+	ret.cell_edge_start.resize(g.vcells.size()+1);
+	ret.cell_edge_start[0] = 0;
+	for (size_t i=0; i<g.vcells.size(); ++i){
+		ret.cell_edge_start[i+1] = ret.cell_edge_start[i] + g.vcells[i]->edges.size();
+	}
+	ret.cell_edge.resize(ret.cell_edge_start.back());
+	auto cit = ret.cell_edge.begin();
+	for (auto& c: g.vcells)
+	for (auto& e: c->edges){
+		*cit++ = e->id;
+	}
+
+	return ret;
+}
+
+GridData HM2D::Unflatten(const FlatGrid& fg){
+	GridData ret;
+	HMPool::Pool pool;
+	ret.vvert.resize(fg.n_vert());
+	ret.vedges.resize(fg.n_edges());
+	ret.vcells.resize(fg.n_cells());
+
+	for (int i=0; i<fg.n_vert(); ++i){
+		ret.vvert[i] = pool.make<Vertex>(fg.vert[2*i], fg.vert[2*i+1]);
+	}
+	for (int i=0; i<fg.n_cells(); ++i){
+		ret.vcells[i] = pool.make<Cell>();
+		ret.vcells[i]->edges.reserve(fg.cell_size(i));
+	}
+	for (int i=0; i<fg.n_edges(); ++i){
+		ret.vedges[i] = pool.make<Edge>(ret.vvert[fg.edge_vert[2*i]], ret.vvert[fg.edge_vert[2*i+1]]);
+		Edge* e = ret.vedges[i].get();
+		int cl = fg.edge_cell[2*i], cr = fg.edge_cell[2*i+1];
+		if (cl >= 0) e->left = ret.vcells[cl];
+		if (cr >= 0) e->right = ret.vcells[cr];
+		if (fg.btypes.size() > 0) e->boundary_type = fg.btypes[i];
+	}
+	for (int i=0; i<fg.n_cells(); ++i){
+		auto& ce = ret.vcells[i]->edges;
+		for (const int* it=fg.cell_edges_begin(i); it!=fg.cell_edges_end(i); ++it){
+			ce.push_back(ret.vedges[*it]);
+		}
+	}
+
+	return ret;
+}
+
+// ===================== algorithms
+void Flat::CellVert(const FlatGrid& fg, vector<int>& cell_vert_start, vector<int>& cell_vert){
+	cell_vert_start.resize(fg.n_cells()+1);
+	cell_vert.clear();
+	cell_vert.reserve(fg.cell_edge.size());
+	cell_vert_start[0] = 0;
+	for (int i=0; i<fg.n_cells(); ++i){
+		fg.cell_vert(i, cell_vert);
+		cell_vert_start[i+1] = cell_vert.size();
+	}
+}
+
+vector<double> Flat::CellCenters(const FlatGrid& fg){
+	vector<double> ret(2*fg.n_cells());
+	vector<int> cv;
+	for (int i=0; i<fg.n_cells(); ++i){
+		cv.clear();
+		fg.cell_vert(i, cv);
+		double x=0, y=0;
+		for (auto iv: cv){
+			x += fg.vert[2*iv];
+			y += fg.vert[2*iv+1];
+		}
+		ret[2*i] = x/cv.size();
+		ret[2*i+1] = y/cv.size();
+	}
+	return ret;
+}
+
+vector<double> Flat::CellAreas(const FlatGrid& fg){
+	vector<double> ret(fg.n_cells());
+	vector<int> cv;
+	for (int i=0; i<fg.n_cells(); ++i){
+		cv.clear();
+		fg.cell_vert(i, cv);
+		double a = 0;
+		for (size_t k=0; k<cv.size(); ++k){
+			int k1 = cv[k], k2 = cv[(k+1) % cv.size()];
+			a += fg.vert[2*k1]*fg.vert[2*k2+1] - fg.vert[2*k2]*fg.vert[2*k1+1];
+		}
+		ret[i] = a/2.0;
+	}
+	return ret;
+}
+
+vector<int> Flat::BoundaryEdges(const FlatGrid& fg){
+	vector<int> ret;
+	for (int i=0; i<fg.n_edges(); ++i){
+		if (fg.is_boundary_edge(i)) ret.push_back(i);
+	}
+	return ret;
+}
@@ -0,0 +1,61 @@
+#ifndef HYBMESH_FLATGRID2D_HPP
+#define HYBMESH_FLATGRID2D_HPP
+
+#include "primitives2d.hpp"
+
+namespace HM2D{
+
+//Compact index based grid storage.
+//All tables are contiguous arrays; cell->edge connectivity
+//is stored in CSR format: edges of i-th cell are
+//cell_edge[cell_edge_start[i]], ..., cell_edge[cell_edge_start[i+1]-1].
+//Edges of each cell are stored in the same order as in HM2D::Cell::edges.
+struct FlatGrid{
+	vector<double> vert;            //x0, y0, x1, y1, ...
+	vector<int> edge_vert;          //edge0_start, edge0_end, edge1_start, edge1_end, ...
+	vector<int> edge_cell;          //edge0_left, edge0_right, ...; -1 if no cell
+	vector<int> btypes;             //boundary type for each edge
+	vector<int> cell_edge_start;    //size = n_cells()+1
+	vector<int> cell_edge;          //size = cell_edge_start.back()
+
+	int n_vert() const { return vert.size()/2; }
+	int n_edges() const { return edge_vert.size()/2; }
+	int n_cells() const { return cell_edge_start.size() > 0 ? cell_edge_start.size()-1 : 0; }
+
+	// ====== features
+	Point vertex(int ivert) const { return Point(vert[2*ivert], vert[2*ivert+1]); }
+	int cell_size(int icell) const { return cell_edge_start[icell+1] - cell_edge_start[icell]; }
+	const int* cell_edges_begin(int icell) const { return &cell_edge[0] + cell_edge_start[icell]; }
+	const int* cell_edges_end(int icell) const { return &cell_edge[0] + cell_edge_start[icell+1]; }
+	bool is_boundary_edge(int iedge) const { return edge_cell[2*iedge] < 0 || edge_cell[2*iedge+1] < 0; }
+	//ordered cell vertices. First vertex is common to last and first edge.
+	//Result is written to ret starting from its current end.
+	void cell_vert(int icell, vector<int>& ret) const;
+
+	// ====== methods
+	void clear();
+	//number of bytes used by connectivity tables
+	size_t memory_usage() const;
+};
+
+//builds compact representation in a single pass over primitives.
+//Ids of g primitives are changed.
+FlatGrid Flatten(const GridData& g);
+//builds shared pointers based grid from compact representation
+GridData Unflatten(const FlatGrid& fg);
+
+namespace Flat{
+
+//cell vertices of all cells in CSR format
+void CellVert(const FlatGrid& fg, vector<int>& cell_vert_start, vector<int>& cell_vert);
+//cell centers as x0, y0, x1, y1, ...
+vector<double> CellCenters(const FlatGrid& fg);
+//cell areas
+vector<double> CellAreas(const FlatGrid& fg);
+//boundary edges indices
+vector<int> BoundaryEdges(const FlatGrid& fg);
+
+}
+
+}
+#endif
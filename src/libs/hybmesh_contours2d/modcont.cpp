@@ -210,9 +210,10 @@ EdgeData eal::NoCrosses(const EdgeData& ecol){
 	EdgeData ret;
 	DeepCopy(ecol, ret);
 	//Find crosses
-	BoundingBox area = BBox(ret, geps);
-	BoundingBoxFinder finder(area, area.maxlen()/20);
-	for (auto e: ret) finder.addentry(BoundingBox(*e->first(), *e->last()));
+	vector<BoundingBox> ebb;
+	ebb.reserve(ret.size());
+	for (auto e: ret) ebb.push_back(BoundingBox(*e->first(), *e->last()));
+	BoundingBoxTree finder(ebb);
 	_TEdgeCrossAnalyser ec(ret.size());
 	for (int i=0; i<ecol.size(); ++i){
 		auto s = finder.suspects(BoundingBox(*ret[i]->first(), *ret[i]->last()));
@@ -1,4 +1,5 @@
 #include <type_traits>
+#include <fstream>
 #include "hmtesting.hpp"
 #include "primitives2d.hpp"
 #include "buildcont.hpp"
@@ -11,6 +12,10 @@
 #include "export2d_vtk.hpp"
 #include "finder2d.hpp"
 #include "clipper_core.hpp"
+#include "flatgrid2d.hpp"
+#include "hmpool.hpp"
+#include "nodes_compare.h"
+#include "bgeom3d.h"
 
 using HMTesting::add_check;
 
@@ -684,6 +689,207 @@ void test16(){
 	}
 }
 
+void test17(){
+	std::cout<<"17. Flat grid storage"<<std::endl;
+	//two unit squares: [0, 1]x[0, 1], [1, 2]x[0, 1]
+	FlatGrid fg;
+	fg.vert = {0,0, 1,0, 2,0, 0,1, 1,1, 2,1};
+	fg.edge_vert = {0,1, 1,2, 1,4, 2,5, 4,3, 5,4, 3,0};
+	fg.edge_cell = {0,-1, 1,-1, 0,1, 1,-1, 0,-1, 1,-1, 0,-1};
+	fg.btypes = {1, 1, 0, 2, 3, 3, 4};
+	fg.cell_edge_start = {0, 4, 8};
+	fg.cell_edge = {0, 2, 4, 6, 1, 3, 5, 2};
+
+	GridData g = Unflatten(fg);
+	add_check(g.vvert.size() == 6 && g.vedges.size() == 7 && g.vcells.size() == 2 &&
+		g.vedges[2]->left.lock() == g.vcells[0] &&
+		g.vedges[2]->right.lock() == g.vcells[1] &&
+		g.vedges[3]->boundary_type == 2, "flat to shared pointers grid");
+
+	FlatGrid fg2 = Flatten(g);
+	add_check(fg2.vert == fg.vert && fg2.edge_vert == fg.edge_vert &&
+		fg2.edge_cell == fg.edge_cell && fg2.btypes == fg.btypes &&
+		fg2.cell_edge_start == fg.cell_edge_start &&
+		fg2.cell_edge == fg.cell_edge, "shared pointers to flat grid");
+
+	vector<int> cvs, cv;
+	Flat::CellVert(fg2, cvs, cv);
+	auto area = Flat::CellAreas(fg2);
+	auto cnt = Flat::CellCenters(fg2);
+	add_check(cvs == vector<int>({0, 4, 8}) &&
+		cv == vector<int>({0, 1, 4, 3, 1, 2, 5, 4}) &&
+		ISEQ(area[0], 1) && ISEQ(area[1], 1) &&
+		ISEQ(cnt[0], 0.5) && ISEQ(cnt[1], 0.5) &&
+		ISEQ(cnt[2], 1.5) && ISEQ(cnt[3], 0.5) &&
+		Flat::BoundaryEdges(fg2).size() == 6, "flat grid connectivity");
+}
+
+void test18(){
+	std::cout<<"18. Arena allocated primitives"<<std::endl;
+	shared_ptr<Vertex> keep;
+	size_t nblocks;
+	{
+		HMPool::Pool pool;
+		VertexData vd;
+		for (int i=0; i<10000; ++i) vd.push_back(pool.make<Vertex>(i, 2*i));
+		nblocks = pool.arena().nblocks();
+		keep = vd[5000];
+	}
+	//arena block outlives the pool while any of its objects is alive
+	add_check(nblocks > 0 && nblocks < 20 && keep->x == 5000 && keep->y == 10000,
+			"pool allocation");
+
+	FlatGrid fg;
+	fg.vert = {0,0, 1,0, 1,1, 0,1};
+	fg.edge_vert = {0,1, 1,2, 2,3, 3,0};
+	fg.edge_cell = {0,-1, 0,-1, 0,-1, 0,-1};
+	fg.cell_edge_start = {0, 4};
+	fg.cell_edge = {0, 1, 2, 3};
+	shared_ptr<Cell> c;
+	{
+		GridData g = Unflatten(fg);
+		c = g.vcells[0];
+	}
+	add_check(c->edges.size() == 4 && c->edges[2]->vertices[1]->y == 1 &&
+			c->edges[0]->left.lock() == c, "primitives lifetime");
+}
+
+void test19(){
+	std::cout<<"19. Bounding box tree"<<std::endl;
+	//graded boxes: small ones near origin, large far from it
+	vector<BoundingBox> bbs;
+	for (int i=0; i<3000; ++i){
+		double r = 1e-3*exp(0.004*i), a = 0.37*i;
+		Point c(r*cos(a), r*sin(a));
+		bbs.push_back(BoundingBox(c, r/10.0));
+	}
+	BoundingBoxTree bulk(bbs), incr;
+	for (auto& b: bbs) incr.addentry(b);
+
+	auto brute = [&](std::function<bool(const BoundingBox&)> cond){
+		vector<int> ret;
+		for (int i=0; i<bbs.size(); ++i) if (cond(bbs[i])) ret.push_back(i);
+		return ret;
+	};
+	bool good_box = true, good_point = true, good_segment = true;
+	for (int k=0; k<200; ++k){
+		double r = 1e-3*exp(0.06*k), a = 1.1*k;
+		Point p(r*cos(a), r*sin(a)), p2(-r*sin(a)/2, r*cos(a)/3);
+		BoundingBox qb(p, r/5.0);
+		auto ans1 = brute([&](const BoundingBox& b){ return b.has_common_points(qb); });
+		good_box = good_box && bulk.suspects(qb) == ans1 && incr.suspects(qb) == ans1;
+
+		auto ans2 = brute([&](const BoundingBox& b){ return b.whereis(p) != OUTSIDE; });
+		good_point = good_point && bulk.suspects(p) == ans2 && incr.suspects(p) == ans2;
+
+		auto ans3 = brute([&](const BoundingBox& b){
+			if (b.whereis(p) != OUTSIDE || b.whereis(p2) != OUTSIDE) return true;
+			auto fp = b.four_points();
+			double ksieta[2];
+			for (int i=0; i<4; ++i)
+				if (SectCross(p, p2, fp[i], fp[(i+1)%4], ksieta)) return true;
+			return false;
+		});
+		good_segment = good_segment && bulk.suspects(p, p2) == ans3 && incr.suspects(p, p2) == ans3;
+	}
+	add_check(good_box, "box queries");
+	add_check(good_point, "point queries");
+	add_check(good_segment, "segment queries");
+
+	int cnt = 0;
+	bulk.visit(BoundingBox(-1, -1, 1, 1), [&cnt](int){ return ++cnt < 10; });
+	add_check(cnt == 10, "interrupted visitor");
+}
+
+void test20(){
+	std::cout<<"20. Coincident points search"<<std::endl;
+	//vertical grid lines: each internal node is repeated in two neighboring lines.
+	//Second copies are shifted by a value less than geps
+	//and coordinates are placed close to hash cell boundaries.
+	int nx = 30, ny = 50;
+	vector<Point> pts;
+	for (int i=0; i<nx; ++i)
+	for (int j=0; j<ny; ++j){
+		pts.push_back(Point(i*4e-8, 1.0 + j*4e-8));
+		if (i>0) pts.push_back(Point(i*4e-8 - 0.3e-8, 1.0 + j*4e-8 + 0.6e-8));
+	}
+	auto set2 = point2_set_coords(pts);
+	auto pairs = set2.verbose_unique();
+	bool good_pairs = pairs.size() == (nx-1)*ny;
+	for (auto& p: pairs){
+		//base point has lower y coordinate
+		if (pts[p.second].y > pts[p.first].y || pts[p.first] != pts[p.second]) good_pairs = false;
+	}
+	add_check(good_pairs, "2d unique pairs");
+	add_check(set2.find(4e-8 + 0.5e-8, 1.0) == 50 &&
+	          set2.find(4e-8, 1.0 + 1.2e-8) == -1, "2d search after removal");
+
+	vector<Point3> pts3;
+	for (int i=0; i<20; ++i)
+	for (int j=0; j<20; ++j)
+	for (int k=0; k<20; ++k){
+		Point3 p(i*4e-8, j*4e-8, k*4e-8);
+		pts3.push_back(p);
+		if ((i+j+k) % 3 == 0) pts3.push_back(Point3(p.x+0.9e-8, p.y-0.9e-8, p.z));
+	}
+	auto set3 = point3_set_coords(pts3);
+	auto pairs3 = set3.verbose_unique();
+	bool good3 = true;
+	for (auto& p: pairs3){
+		if (p.second != p.first + 1) good3 = false;
+	}
+	add_check(good3 && pairs3.size() == pts3.size() - 8000, "3d unique pairs");
+	add_check(set3.find(0, 0, 4e-8) == 2 && set3.find(0, 0, 2e-8) == -1, "3d search");
+}
+
+void test21(){
+	std::cout<<"21. Binary vtk grid export"<<std::endl;
+	FlatGrid fg;
+	fg.vert = {0,0, 1,0, 2,0, 0,1, 1,1, 2,1};
+	fg.edge_vert = {0,1, 1,2, 1,4, 3,4, 4,5, 0,3, 2,5};
+	fg.edge_cell = {0,-1, 1,-1, 0,1, -1,0, -1,1, -1,0, 1,-1};
+	fg.btypes = {0, 0, 0, 0, 0, 0, 0};
+	fg.cell_edge_start = {0, 4, 8};
+	fg.cell_edge = {0, 2, 3, 5, 1, 6, 4, 2};
+
+	Export::GridVTU(fg, "g1.vtu");
+	std::ifstream f("g1.vtu", std::ios::binary);
+	std::string s((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+	//raw appended arrays: uint64 size followed by data
+	vector<std::string> arr;
+	size_t pos = s.find("<AppendedData encoding=\"raw\">\n_");
+	pos = (pos == std::string::npos) ? s.size() : s.find('_', pos) + 1;
+	while (pos + sizeof(uint64_t) < s.size()){
+		uint64_t n;
+		memcpy(&n, &s[pos], sizeof(uint64_t));
+		pos += sizeof(uint64_t);
+		if (pos + n > s.size()) break;
+		arr.push_back(s.substr(pos, n));
+		pos += n;
+	}
+	bool good = arr.size() == 4 && arr[0].size() == 18*sizeof(double) &&
+		arr[1].size() == 8*sizeof(int) && arr[2].size() == 2*sizeof(int) &&
+		arr[3] == std::string(2, char(7));
+	if (good){
+		vector<double> pts(18);
+		vector<int> conn(8), offsets(2);
+		memcpy(&pts[0], arr[0].data(), arr[0].size());
+		memcpy(&conn[0], arr[1].data(), arr[1].size());
+		memcpy(&offsets[0], arr[2].data(), arr[2].size());
+		good = pts[12] == 1 && pts[13] == 1 && pts[14] == 0 &&
+			conn == vector<int>({0, 1, 4, 3, 1, 2, 5, 4}) &&
+			offsets == vector<int>({4, 8});
+	}
+	add_check(good, "vtu arrays");
+
+	HMVtu::Options opt;
+	opt.npieces = 2;
+	Export::GridVTU(fg, "g1.pvtu", opt);
+	std::ifstream f1("g1_1.vtu");
+	std::string s1((std::istreambuf_iterator<char>(f1)), std::istreambuf_iterator<char>());
+	add_check(s1.find("NumberOfPoints=\"4\" NumberOfCells=\"1\"") != std::string::npos,
+		"pvtu pieces");
+}
 
 int main(){
 	std::cout<<"hybmesh_contours2d testing"<<std::endl;
@@ -703,6 +909,11 @@ int main(){
 	test14();
 	test15();
 	test16();
+	test17();
+	test18();
+	test19();
+	test20();
+	test21();
 
 
 	HMTesting::check_final_report();
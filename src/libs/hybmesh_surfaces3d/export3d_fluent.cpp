@@ -6,6 +6,7 @@
 #include "debug3d.hpp"
 #include "serialize3d.hpp"
 #include "assemble3d.hpp"
+#include "hmparallel.hpp"
 
 using namespace HM3D;
 namespace hme = HM3D::Export;
@@ -20,18 +21,17 @@ std::string to_hex(int a){
 	return os.str();
 }
 
-char msh_face_type(HM3D::Face& f){
-	int ne = f.edges.size();
+char msh_face_type(int ne){
 	if (ne == 3) return '3';
 	if (ne == 4) return '4';
 	return '5';
 }
+char msh_face_type(HM3D::Face& f){
+	return msh_face_type(f.edges.size());
+}
 
-char msh_cell_type(HM3D::Cell& c){
-	auto nfev = c.n_fev();
-	int nf = std::get<0>(nfev);
-	int ne = std::get<1>(nfev);
-	int nv = std::get<2>(nfev);
+//by number of faces, edges and vertices
+char msh_cell_type(int nf, int ne, int nv){
 	//tetrahedral
 	if (nf == 4 && ne == 6 && nv == 4)
 		return '2';
@@ -47,6 +47,10 @@ char msh_cell_type(HM3D::Cell& c){
 	//mixed
 	return '7';
 }
+char msh_cell_type(HM3D::Cell& c){
+	auto nfev = c.n_fev();
+	return msh_cell_type(std::get<0>(nfev), std::get<1>(nfev), std::get<2>(nfev));
+}
 
 std::map<int, ShpVector<Face>> faces_by_btype(const GridData& g){
 	std::map<int, ShpVector<Face>> ret;
@@ -60,33 +64,37 @@ std::map<int, ShpVector<Face>> faces_by_btype(const GridData& g){
 	return ret;
 }
 std::vector<std::pair<int, int>> left_right_cells(const ShpVector<Face>& data, const ShpVector<HM3D::Cell>& cells){
-	std::vector<std::pair<int, int>> ret; ret.reserve(data.size());
+	std::vector<std::pair<int, int>> ret(data.size());
 	auto _indexer = aa::ptr_container_indexer(cells);
 	_indexer.convert();
-	for (auto& f: data){
-		int p1 = (f->has_right_cell()) ?  _indexer.index(f->right.lock()) : -1;
-		int p2 = (f->has_left_cell())  ?  _indexer.index(f->left.lock())  : -1;
-		ret.push_back(std::make_pair(p1, p2));
-	}
+	HMParallel::ForChunks(data.size(), [&](int ib, int ie, int){
+		for (int i=ib; i<ie; ++i){
+			auto& f = data[i];
+			int p1 = (f->has_right_cell()) ?  _indexer.index(f->right.lock()) : -1;
+			int p2 = (f->has_left_cell())  ?  _indexer.index(f->left.lock())  : -1;
+			ret[i] = std::make_pair(p1, p2);
+		}
+	});
 
 	return ret;
 }
 
 std::vector<std::vector<int>> int_face_vertices(const ShpVector<Face>& data, const ShpVector<Vertex>& vert){
-	std::vector<std::vector<int>> ret; ret.reserve(data.size());
+	std::vector<std::vector<int>> ret(data.size());
 	auto _indexer = aa::ptr_container_indexer(vert);
 	_indexer.convert();
-	for (auto& f: data){
-		auto sv = f->sorted_vertices();
-		ret.push_back(vector<int>());
-		ret.back().reserve(sv.size());
-		for (auto p: sv){
-			ret.back().push_back(_indexer.index(p));
+	HMParallel::ForChunks(data.size(), [&](int ib, int ie, int){
+		for (int i=ib; i<ie; ++i){
+			auto sv = data[i]->sorted_vertices();
+			ret[i].reserve(sv.size());
+			for (auto p: sv){
+				ret[i].push_back(_indexer.index(p));
+			}
 		}
-	}
+	});
 	return ret;
 }
-char get_common_type(vector<char>::iterator istart, vector<char>::iterator iend){
+char get_common_type(vector<char>::const_iterator istart, vector<char>::const_iterator iend){
 	for (auto it=istart; it!=iend; ++it) if (*it != *istart) return '0';
 	return *istart;
 }
@@ -97,14 +105,21 @@ typedef std::map<
 PeriodicMap assemble_periodic(const std::map<int, ShpVector<Face>>& fzones, const std::map<Face*, Face*>& pfaces){
 	std::map<std::pair<int, int>,
 		std::vector<std::pair<int, int>>> ret;
-	auto perface_index = [&](Face* f){
+	//index of boundary face in the output faces array
+	std::unordered_map<Face*, int> bface_index;
+	if (pfaces.size() > 0){
 		int ret = 0;
-		auto fnd1 = fzones.find(f->boundary_type);
-		for (auto it=fzones.begin(); it!= fnd1; ++it){
-			ret += it->second.size();
+		for (auto& it: fzones){
+			if (it.first != std::numeric_limits<int>::min()){
+				for (size_t i=0; i<it.second.size(); ++i){
+					bface_index.emplace(it.second[i].get(), ret + i);
+				}
+			}
+			ret += it.second.size();
 		}
-		auto fnd3 = aa::shp_find(fnd1->second.begin(), fnd1->second.end(), f);
-		return ret + fnd3 - (fnd1->second.begin());
+	}
+	auto perface_index = [&](Face* f){
+		return bface_index.at(f);
 	};
 	std::map<int, int> btype_zone;
 	int zt = 4;
@@ -127,7 +142,7 @@ PeriodicMap assemble_periodic(const std::map<int, ShpVector<Face>>& fzones, cons
 }
 
 void zones_names(const PeriodicMap& periodic,
-		const std::map<int, ShpVector<Face>>& fzones,
+		const std::map<int, int>& fzones,
 		std::map<int, std::string>& btypes,
 		std::map<int, std::string>& bnames){
 
@@ -156,60 +171,132 @@ void zones_names(const PeriodicMap& periodic,
 	}
 }
 
-//save to fluent main function
-void gridmsh(HMCallback::Caller2& callback, const GridData& g, std::string fn,
-		hme::BFun btype_name,
-		std::map<Face*, Face*> pfaces=std::map<Face*, Face*>()){
-	if (g.vcells.size() == 0) throw std::runtime_error("Exporting blank grid");
+//(index (head)(binary data)End of Binary Section index)
+template<class A>
+void binary_section(std::ofstream& fs, int index, const std::string& head, const vector<A>& data){
+	fs<<"("<<index<<" ("<<head<<")(";
+	fs.write(reinterpret_cast<const char*>(data.data()), data.size()*sizeof(A));
+	fs<<")\nEnd of Binary Section   "<<index<<")\n";
+}
+
+//integer representation of msh file contents
+struct MshData{
+	vector<double> vert;                         //x0, y0, z0, x1, y1, z1, ...
+	std::map<int, int> zone_size;                //boundary type -> number of faces. Interior zone goes first.
+	vector<vector<int>> face_vertices;           //face->vertices for faces in zones order
+	vector<std::pair<int, int>> face_adjacents;  //right, left cell for faces in zones order
+	vector<char> ctypes;                         //cell types
+	vector<char> ftypes;                         //face types for faces in zones order
+	PeriodicMap periodic;                        //<periodic zonetype, shadow zonetype> -> [periodic face, shadow face]
+};
+
+void writemsh(HMCallback::Caller2& callback, const MshData& d, std::string fn,
+		hme::BFun btype_name, bool binary){
 	//Zones:
 	//1    - verticies default
 	//2    - fluid for cells
 	//3    - default interior
 	//4..N - bc's faces
+	int nvert = d.vert.size()/3;
+	int ncells = d.ctypes.size();
+	int nfaces = d.ftypes.size();
+	auto& facezones = d.zone_size;
+	auto& face_vertices = d.face_vertices;
+	auto& face_adjacents = d.face_adjacents;
+	auto& periodic_data = d.periodic;
 
-	// ===== Needed data
-	callback.silent_step_after(60, "Assembling connectivity", 70);
-	//* vertices table
-	callback.subprocess_step_after(10);
-	auto vert = g.vvert;
-	//* faces by boundary_type grouped by zones
-	callback.subprocess_step_after(10);
-	std::map<int, ShpVector<Face>> facezones = faces_by_btype(g);
-	//* faces as they would be in resulting file
-	callback.subprocess_step_after(10);
-	ShpVector<Face> allfaces;
-	for (auto& it: facezones) allfaces.insert(allfaces.end(), it.second.begin(), it.second.end());
-	//* left/right cell indicies for each face in integer representation
-	callback.subprocess_step_after(10);
-	std::vector<std::pair<int, int>> face_adjacents = left_right_cells(allfaces, g.vcells); 
-	//* face->vertices connectivity in integer representation
-	callback.subprocess_step_after(10);
-	std::vector<std::vector<int>> face_vertices = int_face_vertices(allfaces, vert);
-	//* cells, faces types for each entry;
-	callback.subprocess_step_after(10);
-	std::vector<char> ctypes;   //cell types array
-	std::vector<char> ftypes;   //face types for each zone
-	for (auto& c: g.vcells) ctypes.push_back(msh_cell_type(*c));
-	for (auto& f: allfaces)     ftypes.push_back(msh_face_type(*f));
         //* common cell types or '0' if they differ, common face type for each zone
-	char cell_common_type = get_common_type(ctypes.begin(), ctypes.end());
+	char cell_common_type = get_common_type(d.ctypes.begin(), d.ctypes.end());
 	std::vector<char> facezones_common_type;
-	auto ftypes_it = ftypes.begin();
+	auto ftypes_it = d.ftypes.begin();
 	for (auto& v: facezones){
-		auto itnext = ftypes_it + v.second.size();
+		auto itnext = ftypes_it + v.second;
 		facezones_common_type.push_back(get_common_type(ftypes_it, itnext));
 		ftypes_it = itnext;
 	}
-	//* <periodic zonetype, shadow zonetype> -> vector of periodic face, shadow face>
-	callback.subprocess_step_after(10);
-	PeriodicMap periodic_data = assemble_periodic(facezones, pfaces);
 	//* name and type of each zone by zone id: 2-interior, 3-wall, 8-periodic-shadow, 12-periodic
 	std::map<int, std::string> facezones_btype, facezones_bname;
 	zones_names(periodic_data, facezones, facezones_btype, facezones_bname);
-	callback.subprocess_fin();
 	
 	//=========== Write to file
 	callback.silent_step_after(40, "Writing File", 30);
+	if (binary){
+		//binary sections contents are filled by parallel chunks
+		std::ofstream fs(fn, std::ios::binary);
+		fs<<"(0 \"HybMesh to Fluent File\")\n(2 3)\n";
+
+		//Vertices: Zone 1
+		callback.subprocess_step_after(10);
+		fs<<"(10 (0 1 "<<to_hex(nvert)<<" 0 3))\n";
+		binary_section(fs, 3010, "1 1 " + to_hex(nvert) + " 1 3", d.vert);
+
+		//Cells: Zone 2
+		callback.subprocess_step_after(10);
+		fs<<"(12 (0 1 "<<to_hex(ncells)<<" 0))\n";
+		if (cell_common_type != '0'){
+			fs<<"(12 (2 1 "<<to_hex(ncells)<<" 1 "<<cell_common_type<<"))\n";
+		} else {
+			vector<int> cdata(ncells);
+			for (int i=0; i<ncells; ++i) cdata[i] = d.ctypes[i] - '0';
+			binary_section(fs, 2012, "2 1 " + to_hex(ncells) + " 1 0", cdata);
+		}
+
+		//Faces: Zones 3+it
+		callback.subprocess_step_after(10);
+		fs<<"(13 (0 1 "<<to_hex(nfaces)<<" 0))\n";
+		int zonetype = 3;
+		int iface = 0;
+		int it = 0;
+		for (auto& fz: facezones){
+			int nf = fz.second;
+			if (nf == 0) { ++it; ++zonetype; continue;}
+			bool wsize = facezones_common_type[it] == '0' || facezones_common_type[it] == '5';
+			//face entry: [number of vertices], vertices, right cell, left cell
+			vector<int> fstart(nf+1, 0);
+			for (int i=0; i<nf; ++i){
+				fstart[i+1] = fstart[i] + face_vertices[iface+i].size() + (wsize ? 3 : 2);
+			}
+			vector<int> fdata(fstart.back());
+			HMParallel::ForChunks(nf, [&](int ib, int ie, int){
+				for (int i=ib; i<ie; ++i){
+					int* d = &fdata[fstart[i]];
+					auto& fv = face_vertices[iface+i];
+					if (wsize) *d++ = fv.size();
+					for (auto v: fv) *d++ = v+1;
+					*d++ = face_adjacents[iface+i].first+1;
+					*d++ = face_adjacents[iface+i].second+1;
+				}
+			});
+			binary_section(fs, 2013, to_hex(zonetype) + " " + to_hex(iface+1) + " " +
+					to_hex(iface+nf) + " " + facezones_btype[zonetype] + " " +
+					facezones_common_type[it], fdata);
+			iface += nf;
+			++it; ++zonetype;
+		}
+		//Periodic
+		it = 0;
+		for (auto& pd: periodic_data){
+			int sz = pd.second.size();
+			vector<int> pdata(2*sz);
+			for (int i=0; i<sz; ++i){
+				pdata[2*i] = pd.second[i].first+1;
+				pdata[2*i+1] = pd.second[i].second+1;
+			}
+			binary_section(fs, 2018, to_hex(it+1) + " " + to_hex(it+sz) + " " +
+					to_hex(pd.first.first) + " " + to_hex(pd.first.second), pdata);
+			it += sz;
+		}
+
+		//Boundary features
+		fs<<"(45 (2 fluid fluid 1)())\n";
+		fs<<"(45 (3 interior default-interior 1)())\n";
+		zonetype = 4;
+		for (auto it = std::next(facezones.begin()); it!=facezones.end(); ++it){
+			fs<<"(45 ("<<zonetype<<" "<<facezones_bname[zonetype]<<" "<<btype_name(it->first)<<" 1)())\n";
+			++zonetype;
+		}
+		return;
+	}
 	std::ofstream fs(fn);
 	fs.precision(16);
 	//header
@@ -217,37 +304,37 @@ void gridmsh(HMCallback::Caller2& callback, const GridData& g, std::string fn,
 
 	//Vertices: Zone 1
 	callback.subprocess_step_after(10);
-	fs<<"(10 (0 1 "<<to_hex(vert.size())<<" 0 3))\n";
-	fs<<"(10 (1 1 "<<to_hex(vert.size())<<" 1 3)(\n";
-	for (auto p: vert){
-		fs<<p->x<<" "<<p->y<<" "<<p->z<<"\n";
+	fs<<"(10 (0 1 "<<to_hex(nvert)<<" 0 3))\n";
+	fs<<"(10 (1 1 "<<to_hex(nvert)<<" 1 3)(\n";
+	for (int i=0; i<nvert; ++i){
+		fs<<d.vert[3*i]<<" "<<d.vert[3*i+1]<<" "<<d.vert[3*i+2]<<"\n";
 	}
 	fs<<"))\n";
 
 	//Cells: Zone 2
 	callback.subprocess_step_after(10);
-	fs<<"(12 (0 1 "<<to_hex(g.vcells.size())<<" 0))\n";
-	fs<<"(12 (2 1 "<<to_hex(g.vcells.size())<<" 1 "<<cell_common_type<<")";
+	fs<<"(12 (0 1 "<<to_hex(ncells)<<" 0))\n";
+	fs<<"(12 (2 1 "<<to_hex(ncells)<<" 1 "<<cell_common_type<<")";
 	if (cell_common_type != '0') fs<<")\n";
 	else {
 		fs<<"(\n";
-		for (auto s: ctypes) fs<<s<<" ";
+		for (auto s: d.ctypes) fs<<s<<" ";
 		fs<<"\n))\n";
 	}
 
 	//Faces: Zones 3+it
 	callback.subprocess_step_after(10);
-	fs<<"(13 (0 1 "<<to_hex(allfaces.size())<<" 0))\n";
+	fs<<"(13 (0 1 "<<to_hex(nfaces)<<" 0))\n";
 	int zonetype = 3;
 	int iface = 0;
 	int it = 0;
 	for (auto& fz: facezones){
-		if (fz.second.size() == 0) { ++it; ++zonetype; continue;}
+		if (fz.second == 0) { ++it; ++zonetype; continue;}
 		std::string first_index = to_hex(iface+1);
-		std::string last_index = to_hex(iface+fz.second.size());
+		std::string last_index = to_hex(iface+fz.second);
 		fs<<"(13 ("<<to_hex(zonetype)<<" "<<first_index<<" "<<last_index<<" ";
 		fs<<facezones_btype[zonetype]<<" "<<facezones_common_type[it]<<")(\n";
-		for (auto f: fz.second){
+		for (int k=0; k<fz.second; ++k){
 			if (facezones_common_type[it] == '0' ||
 			    facezones_common_type[it] == '5')
 				fs<<to_hex(face_vertices[iface].size())<<" ";
@@ -260,7 +347,7 @@ void gridmsh(HMCallback::Caller2& callback, const GridData& g, std::string fn,
 		++it; ++zonetype;
 	}
 	//Periodic
-	if (pfaces.size() > 0){
+	if (periodic_data.size() > 0){
 		int it = 0;
 		for (auto& pd: periodic_data){
 			int sz = pd.second.size();
@@ -284,6 +371,119 @@ void gridmsh(HMCallback::Caller2& callback, const GridData& g, std::string fn,
 	}
 }
 
+//save to fluent main function
+void gridmsh(HMCallback::Caller2& callback, const GridData& g, std::string fn,
+		hme::BFun btype_name, bool binary,
+		std::map<Face*, Face*> pfaces=std::map<Face*, Face*>()){
+	if (g.vcells.size() == 0) throw std::runtime_error("Exporting blank grid");
+	MshData d;
+
+	// ===== Needed data
+	callback.silent_step_after(60, "Assembling connectivity", 70);
+	//* vertices table
+	callback.subprocess_step_after(10);
+	d.vert.resize(3*g.vvert.size());
+	HMParallel::ForChunks(g.vvert.size(), [&](int ib, int ie, int){
+		for (int i=ib; i<ie; ++i){
+			d.vert[3*i] = g.vvert[i]->x;
+			d.vert[3*i+1] = g.vvert[i]->y;
+			d.vert[3*i+2] = g.vvert[i]->z;
+		}
+	});
+	//* faces by boundary_type grouped by zones
+	callback.subprocess_step_after(10);
+	std::map<int, ShpVector<Face>> facezones = faces_by_btype(g);
+	for (auto& it: facezones) d.zone_size[it.first] = it.second.size();
+	//* faces as they would be in resulting file
+	callback.subprocess_step_after(10);
+	ShpVector<Face> allfaces;
+	for (auto& it: facezones) allfaces.insert(allfaces.end(), it.second.begin(), it.second.end());
+	//* left/right cell indicies for each face in integer representation
+	callback.subprocess_step_after(10);
+	d.face_adjacents = left_right_cells(allfaces, g.vcells); 
+	//* face->vertices connectivity in integer representation
+	callback.subprocess_step_after(10);
+	d.face_vertices = int_face_vertices(allfaces, g.vvert);
+	//* cells, faces types for each entry;
+	callback.subprocess_step_after(10);
+	for (auto& c: g.vcells) d.ctypes.push_back(msh_cell_type(*c));
+	for (auto& f: allfaces) d.ftypes.push_back(msh_face_type(*f));
+	//* <periodic zonetype, shadow zonetype> -> vector of periodic face, shadow face>
+	callback.subprocess_step_after(10);
+	d.periodic = assemble_periodic(facezones, pfaces);
+	callback.subprocess_fin();
+
+	writemsh(callback, d, fn, btype_name, binary);
+}
+
+//same for compact grid without periodic conditions
+void flatmsh(HMCallback::Caller2& callback, const FlatGrid& g, std::string fn,
+		hme::BFun btype_name, bool binary){
+	if (g.n_cells() == 0) throw std::runtime_error("Exporting blank grid");
+	MshData d;
+
+	// ===== Needed data
+	callback.silent_step_after(60, "Assembling connectivity", 70);
+	//* vertices table
+	callback.subprocess_step_after(10);
+	d.vert = g.vert;
+	//* faces by boundary_type grouped by zones
+	callback.subprocess_step_after(10);
+	std::map<int, vector<int>> facezones;
+	facezones.emplace(std::numeric_limits<int>::min(), vector<int>());
+	for (int i=0; i<g.n_faces(); ++i){
+		int tp = g.is_boundary_face(i) ? g.btypes[i] : std::numeric_limits<int>::min();
+		facezones[tp].push_back(i);
+	}
+	for (auto& it: facezones) d.zone_size[it.first] = it.second.size();
+	//* faces as they would be in resulting file
+	callback.subprocess_step_after(10);
+	vector<int> allfaces;
+	allfaces.reserve(g.n_faces());
+	for (auto& it: facezones) allfaces.insert(allfaces.end(), it.second.begin(), it.second.end());
+	//* left/right cell indicies for each face in integer representation
+	callback.subprocess_step_after(10);
+	d.face_adjacents.resize(allfaces.size());
+	for (size_t i=0; i<allfaces.size(); ++i){
+		int f = allfaces[i];
+		d.face_adjacents[i] = std::make_pair(g.face_cell[2*f+1], g.face_cell[2*f]);
+	}
+	//* face->vertices connectivity in integer representation
+	callback.subprocess_step_after(10);
+	d.face_vertices.resize(allfaces.size());
+	HMParallel::ForChunks(allfaces.size(), [&](int ib, int ie, int){
+		for (int i=ib; i<ie; ++i){
+			d.face_vertices[i].reserve(g.face_size(allfaces[i]));
+			g.face_vert(allfaces[i], d.face_vertices[i]);
+		}
+	});
+	//* cells, faces types for each entry;
+	callback.subprocess_step_after(10);
+	d.ctypes.resize(g.n_cells());
+	HMParallel::ForChunks(g.n_cells(), [&](int ib, int ie, int){
+		vector<int> ce, cv;
+		for (int i=ib; i<ie; ++i){
+			ce.clear(); cv.clear();
+			for (const int* f=g.cell_faces_begin(i); f!=g.cell_faces_end(i); ++f){
+				ce.insert(ce.end(), g.face_edges_begin(*f), g.face_edges_end(*f));
+			}
+			std::sort(ce.begin(), ce.end());
+			ce.erase(std::unique(ce.begin(), ce.end()), ce.end());
+			for (auto e: ce){
+				cv.push_back(g.edge_vert[2*e]);
+				cv.push_back(g.edge_vert[2*e+1]);
+			}
+			std::sort(cv.begin(), cv.end());
+			cv.erase(std::unique(cv.begin(), cv.end()), cv.end());
+			d.ctypes[i] = msh_cell_type(g.cell_size(i), ce.size(), cv.size());
+		}
+	});
+	for (auto f: allfaces) d.ftypes.push_back(msh_face_type(g.face_size(f)));
+	callback.subprocess_fin();
+
+	writemsh(callback, d, fn, btype_name, binary);
+}
+
 }
 
 void hme::PeriodicDataEntry::assemble(GridData& g, std::map<Face*, Face*>& outmap){
@@ -339,11 +539,16 @@ HM3D::GridData hme::PeriodicData::assemble(const GridData& g,
 }
 
 void hme::TGridMSH::_run(const Ser::Grid& g, std::string fn,
-		BFun btype_name, PeriodicData periodic){
+		BFun btype_name, PeriodicData periodic, bool binary){
 	callback->step_after(30, "Periodic merging");
 	std::map<Face*, Face*> periodic_cells;
 	GridData gp = periodic.assemble(g.grid, periodic_cells);
-	return gridmsh(*callback, gp, fn, btype_name, periodic_cells);
+	return gridmsh(*callback, gp, fn, btype_name, binary, periodic_cells);
+}
+
+void hme::TGridMSH::_run(const Ser::Grid& g, std::string fn,
+		BFun btype_name, PeriodicData periodic){
+	return _run(g, fn, btype_name, periodic, false);
 }
 
 void hme::TGridMSH::_run(const HM3D::Ser::Grid& g, std::string fn,
@@ -352,9 +557,34 @@ void hme::TGridMSH::_run(const HM3D::Ser::Grid& g, std::string fn,
 }
 
 void hme::TGridMSH::_run(const HM3D::Ser::Grid& g, std::string fn, BFun btype_name){
-	return gridmsh(*callback, g.grid, fn, btype_name);
+	return gridmsh(*callback, g.grid, fn, btype_name, false);
 }
 
 void hme::TGridMSH::_run(const HM3D::Ser::Grid& g, std::string fn){
 	return _run(g, fn, def_bfun);
 }
+
+void hme::TGridMSH::_run(const FlatGrid& g, std::string fn,
+		BFun btype_name, PeriodicData periodic, bool binary){
+	//periodic surfaces matching requires primitives connectivity
+	if (periodic.size() > 0) return _run(Ser::Grid(Unflatten(g)), fn, btype_name, periodic, binary);
+	callback->step_after(30, "Periodic merging");
+	return flatmsh(*callback, g, fn, btype_name, binary);
+}
+
+void hme::TGridMSH::_run(const FlatGrid& g, std::string fn,
+		BFun btype_name, PeriodicData periodic){
+	return _run(g, fn, btype_name, periodic, false);
+}
+
+void hme::TGridMSH::_run(const FlatGrid& g, std::string fn, PeriodicData periodic){
+	return _run(g, fn, def_bfun, periodic);
+}
+
+void hme::TGridMSH::_run(const FlatGrid& g, std::string fn, BFun btype_name){
+	return flatmsh(*callback, g, fn, btype_name, false);
+}
+
+void hme::TGridMSH::_run(const FlatGrid& g, std::string fn){
+	return _run(g, fn, def_bfun);
+}
@@ -3,6 +3,7 @@
 #include "hmproject.h"
 #include "hmcallback.hpp"
 #include "serialize3d.hpp"
+#include "flatgrid3d.hpp"
 #include "treverter3d.hpp"
 
 namespace HM3D{namespace Export{
@@ -73,6 +74,11 @@ struct TGridMSH: public HMCallback::ExecutorBase{
 			const Ser::Grid&, std::string, BFun, PeriodicData);
 	void _run(const Ser::Grid&, std::string, BFun, PeriodicData);
 
+	//binary = true writes node, cell, face and periodic sections in Fluent binary format
+	HMCB_SET_DURATION(HMCB_DURATION(TGridMSH, Ser::Grid, std::string) + 30, 
+			const Ser::Grid&, std::string, BFun, PeriodicData, bool);
+	void _run(const Ser::Grid&, std::string, BFun, PeriodicData, bool binary);
+
 	// ===== GridData versions
 	void _run(const GridData& a, std::string b){ return _run(Ser::Grid(a), b); }
 	void _run(const GridData& a, std::string b, BFun c) { return _run(Ser::Grid(a), b, c); }
@@ -86,6 +92,26 @@ struct TGridMSH: public HMCallback::ExecutorBase{
 			GridData, std::string, BFun, PeriodicData);
 	void _run(const GridData& a, std::string b, BFun c, PeriodicData d){ return _run(Ser::Grid(a), b, c, d); }
 
+	HMCB_SET_DURATION(HMCB_DURATION(TGridMSH, Ser::Grid, std::string) + 30, 
+			GridData, std::string, BFun, PeriodicData, bool);
+	void _run(const GridData& a, std::string b, BFun c, PeriodicData d, bool e){ return _run(Ser::Grid(a), b, c, d, e); }
+
+	// ===== FlatGrid versions. Grids with periodic conditions are unflattened.
+	void _run(const FlatGrid&, std::string);
+	void _run(const FlatGrid&, std::string, BFun);
+
+	HMCB_SET_DURATION(HMCB_DURATION(TGridMSH, Ser::Grid, std::string) + 30, 
+			FlatGrid, std::string, PeriodicData);
+	void _run(const FlatGrid&, std::string, PeriodicData);
+
+	HMCB_SET_DURATION(HMCB_DURATION(TGridMSH, Ser::Grid, std::string) + 30, 
+			FlatGrid, std::string, BFun, PeriodicData);
+	void _run(const FlatGrid&, std::string, BFun, PeriodicData);
+
+	HMCB_SET_DURATION(HMCB_DURATION(TGridMSH, Ser::Grid, std::string) + 30, 
+			FlatGrid, std::string, BFun, PeriodicData, bool);
+	void _run(const FlatGrid&, std::string, BFun, PeriodicData, bool binary);
+
 };
 
 //instance of TGridMSH for function-like operator() calls
@@ -12,30 +12,16 @@ namespace hme = HM3D::Export;
 
 HMCallback::FunctionWithCallback<hme::TGridGMSH> hme::GridGMSH;
 
-void hme::TGridGMSH::_run(const Ser::Grid& ser, std::string fn, BFun bfun){
-	const GridData& grid = ser.grid;
-	callback->step_after(25, "Faces assembling");
-	auto fv = ser.face_vertex();
-	//face data
-	std::map<int, FaceData> srfs = Surface::Assembler::GridSurfaceBType(grid);
-	std::map<int, vector<vector<int>>> psrfs;
+namespace{
+//psrfs: boundary type -> boundary faces vertices with cells on their left side
+void write_gmsh(HMCallback::Caller2& callback, const vector<double>& vert,
+		const vector<hme::vtkcell_expression>& cp,
+		const std::map<int, vector<vector<int>>>& psrfs,
+		std::string fn, hme::BFun bfun){
+	int nvert = vert.size()/3;
+	int ncells = cp.size();
 	int totfaces = 0;
-	aa::enumerate_ids_pvec(grid.vfaces);
-	for (auto& s: srfs){
-		auto er = psrfs.emplace(s.first, vector<vector<int>>(s.second.size()));
-		auto& vv = er.first->second;
-		totfaces+=s.second.size();
-		//enumerate nodes so that all cells be on their left side
-		for (int i=0; i<s.second.size(); ++i){
-			auto fc = s.second[i];
-			int iface = fc->id;
-			vv[i] = fv[iface];
-			if (!fc->has_left_cell()) std::reverse(vv[i].begin()+1, vv[i].end());
-		}
-	}
-	callback->step_after(30, "Cells assembling");
-	//cell data
-	auto cp = hme::vtkcell_expression::cell_assembler(ser, fv);
+	for (auto& s: psrfs) totfaces += s.second.size();
 	int ientity = psrfs.rbegin()->first+1;
 	auto cell_line = [&cp, &ientity](int num)->std::string{
 		auto& c = cp[num];
@@ -74,27 +60,26 @@ void hme::TGridGMSH::_run(const Ser::Grid& ser, std::string fn, BFun bfun){
 	of<<"3 "<<ientity<<" \"interior\""<<std::endl;
 	of<<"$EndPhysicalNames"<<std::endl;
 	//nodes
-	callback->step_after(25, "Nodes writing");
+	callback.step_after(25, "Nodes writing");
 	of<<"$Nodes"<<std::endl;
 	{
-		of<<ser.n_vert()<<std::endl;
-		auto& vert = ser.vert();
-		for (int i=0; i<ser.n_vert(); ++i){
+		of<<nvert<<std::endl;
+		for (int i=0; i<nvert; ++i){
 			of<<i+1<<" "<<vert[3*i]<<" "<<vert[3*i+1]<<" "<<vert[3*i+2]<<std::endl;
 		}
 	}
 	of<<"$EndNodes"<<std::endl;
 	of<<"$Elements"<<std::endl;
-	of<<ser.n_cells()+totfaces<<std::endl;
+	of<<ncells+totfaces<<std::endl;
 	//cells
 	{
-		callback->step_after(10, "Interior cells");
+		callback.step_after(10, "Interior cells");
 		//3d cells
-		for (int i=0; i<ser.n_cells(); ++i){
+		for (int i=0; i<ncells; ++i){
 			of<<cell_line(i)<<std::endl;
 		}
-		int icell=ser.n_cells();
-		callback->step_after(10, "Boundary cells");
+		int icell=ncells;
+		callback.step_after(10, "Boundary cells");
 		//boundary
 		for (auto& s: psrfs){
 			int entity = s.first;
@@ -108,7 +93,55 @@ void hme::TGridGMSH::_run(const Ser::Grid& ser, std::string fn, BFun bfun){
 	}
 	of<<"$EndElements"<<std::endl;
 }
+}
+
+void hme::TGridGMSH::_run(const Ser::Grid& ser, std::string fn, BFun bfun){
+	const GridData& grid = ser.grid;
+	callback->step_after(25, "Faces assembling");
+	auto fv = ser.face_vertex();
+	//face data
+	std::map<int, FaceData> srfs = Surface::Assembler::GridSurfaceBType(grid);
+	std::map<int, vector<vector<int>>> psrfs;
+	aa::enumerate_ids_pvec(grid.vfaces);
+	for (auto& s: srfs){
+		auto er = psrfs.emplace(s.first, vector<vector<int>>(s.second.size()));
+		auto& vv = er.first->second;
+		//enumerate nodes so that all cells be on their left side
+		for (int i=0; i<s.second.size(); ++i){
+			auto fc = s.second[i];
+			int iface = fc->id;
+			vv[i] = fv[iface];
+			if (!fc->has_left_cell()) std::reverse(vv[i].begin()+1, vv[i].end());
+		}
+	}
+	callback->step_after(30, "Cells assembling");
+	//cell data
+	auto cp = hme::vtkcell_expression::cell_assembler(ser, fv);
+	write_gmsh(*callback, ser.vert(), cp, psrfs, fn, bfun);
+}
+
+void hme::TGridGMSH::_run(const FlatGrid& g, std::string fn, BFun bfun){
+	callback->step_after(25, "Faces assembling");
+	vector<int> fvstart, fv;
+	Flat::FaceVert(g, fvstart, fv);
+	//face data
+	std::map<int, vector<vector<int>>> psrfs;
+	for (int i=0; i<g.n_faces(); ++i) if (g.is_boundary_face(i)){
+		psrfs[g.btypes[i]].emplace_back(fv.begin() + fvstart[i], fv.begin() + fvstart[i+1]);
+		//enumerate nodes so that all cells be on their left side
+		auto& vv = psrfs[g.btypes[i]].back();
+		if (g.face_cell[2*i] < 0) std::reverse(vv.begin()+1, vv.end());
+	}
+	callback->step_after(30, "Cells assembling");
+	//cell data
+	auto cp = hme::vtkcell_expression::cell_assembler(g, fvstart, fv);
+	write_gmsh(*callback, g.vert, cp, psrfs, fn, bfun);
+}
 
 void hme::TGridGMSH::_run(const Ser::Grid& ser, std::string fn){
 	return _run(ser, fn, def_bfun);
 }
+
+void hme::TGridGMSH::_run(const FlatGrid& g, std::string fn){
+	return _run(g, fn, def_bfun);
+}
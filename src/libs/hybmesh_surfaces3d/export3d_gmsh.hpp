@@ -5,6 +5,7 @@
 #include "hmcallback.hpp"
 #include "primitives3d.hpp"
 #include "serialize3d.hpp"
+#include "flatgrid3d.hpp"
 #include "export3d_fluent.hpp"
 
 namespace HM3D{namespace Export{
@@ -21,6 +22,9 @@ struct TGridGMSH: public HMCallback::ExecutorBase{
 	void _run(const GridData& a, std::string b){ return _run(Ser::Grid(a), b); }
 	void _run(const GridData& a, std::string b, BFun c) { return _run(Ser::Grid(a), b, c); }
 
+	void _run(const FlatGrid& g, std::string fn);
+	void _run(const FlatGrid& g, std::string fn, BFun func);
+
 };
 extern HMCallback::FunctionWithCallback<TGridGMSH> GridGMSH;
 
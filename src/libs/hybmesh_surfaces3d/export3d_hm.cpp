@@ -17,62 +17,118 @@ Export::GridWriter::GridWriter(const GridData& g,
 	fill(*_storage, writer, subnode, gridname, tp);
 }
 
-void Export::GridWriter::fill(const Ser::Grid& g,
+Export::GridWriter::GridWriter(const FlatGrid& g,
 		HMXML::ReaderA* writer,
 		HMXML::Reader* subnode,
 		std::string gridname, std::string tp){
-	__tp = tp;
-	grid=&g;
-	pwriter=writer;
+	fill(g, writer, subnode, gridname, tp);
+}
 
+void Export::GridWriter::fill_header(int nvert, int nedges, int nfaces, int ncells,
+		HMXML::Reader* subnode, std::string gridname){
 	//create xml structure
 	gwriter = subnode->new_child("GRID3D");
 	gwriter.new_attribute("name", gridname);
 
 	//inforamtion
-	gwriter.new_child("N_VERTICES").set_content(std::to_string(grid->n_vert()));
-	gwriter.new_child("N_FACES").set_content(std::to_string(grid->n_faces()));
-	gwriter.new_child("N_EDGES").set_content(std::to_string(grid->n_edges()));
-	gwriter.new_child("N_CELLS").set_content(std::to_string(grid->n_cells()));
+	gwriter.new_child("N_VERTICES").set_content(std::to_string(nvert));
+	gwriter.new_child("N_FACES").set_content(std::to_string(nfaces));
+	gwriter.new_child("N_EDGES").set_content(std::to_string(nedges));
+	gwriter.new_child("N_CELLS").set_content(std::to_string(ncells));
 
-	//vertices
 	vwriter = gwriter.new_child("VERTICES");
+	ewriter = gwriter.new_child("EDGES");
+	fwriter = gwriter.new_child("FACES");
+	cwriter = gwriter.new_child("CELLS");
+}
+
+void Export::GridWriter::fill_btypes(const vector<int>& bt){
+	int minv = *std::min_element(bt.begin(), bt.end());
+	int maxv = *std::max_element(bt.begin(), bt.end());
+	if (minv == maxv && minv == 0) return;
+	if (minv >-128 && maxv < 128){
+		std::vector<char> btchar(bt.begin(), bt.end());
+		AddFaceData("__boundary_types__", btchar, is_binary<char>());
+	} else {
+		AddFaceData("__boundary_types__", bt, is_binary<int>());
+	}
+}
+
+void Export::GridWriter::fill(const Ser::Grid& g,
+		HMXML::ReaderA* writer,
+		HMXML::Reader* subnode,
+		std::string gridname, std::string tp){
+	__tp = tp;
+	grid=&g;
+	pwriter=writer;
+	fill_header(grid->n_vert(), grid->n_edges(), grid->n_faces(), grid->n_cells(),
+			subnode, gridname);
+
+	//vertices
 	auto coordswriter = vwriter.new_child("COORDS");
 	writer->set_num_content(grid->vert(), coordswriter, is_binary<double>());
 
 	//edges
-	ewriter = gwriter.new_child("EDGES");
 	auto vconnectwriter = ewriter.new_child("VERT_CONNECT");
 	writer->set_num_content(grid->edge_vert(), vconnectwriter, is_binary<int>());
 
 	//faces
-	fwriter = gwriter.new_child("FACES");
 	auto econnectwriter = fwriter.new_child("EDGE_CONNECT");
 	writer->set_num_content(grid->face_edge(), econnectwriter, is_binary<int>());
 
 	auto cconnectwriter = fwriter.new_child("CELL_CONNECT");
 	writer->set_num_content(grid->face_cell(), cconnectwriter, is_binary<int>());
 
-	//cells
-	cwriter = gwriter.new_child("CELLS");
-	
 	//boundary types
 	std::vector<int> bt(g.n_faces()); 
 	for (size_t i=0; i<bt.size(); ++i) bt[i] = g.grid.vfaces[i]->boundary_type;
-	int minv = *std::min_element(bt.begin(), bt.end());
-	int maxv = *std::max_element(bt.begin(), bt.end());
-	if (minv == maxv && minv == 0) return;
-	if (minv >-128 && maxv < 128){
-		std::vector<char> btchar(bt.begin(), bt.end());
-		AddFaceData("__boundary_types__", btchar, is_binary<char>());
-	} else {
-		AddFaceData("__boundary_types__", bt, is_binary<int>());
+	fill_btypes(bt);
+}
+
+void Export::GridWriter::fill(const FlatGrid& g,
+		HMXML::ReaderA* writer,
+		HMXML::Reader* subnode,
+		std::string gridname, std::string tp){
+	__tp = tp;
+	fgrid=&g;
+	pwriter=writer;
+	fill_header(g.n_vert(), g.n_edges(), g.n_faces(), g.n_cells(), subnode, gridname);
+
+	//vertices
+	auto coordswriter = vwriter.new_child("COORDS");
+	writer->set_num_content(g.vert, coordswriter, is_binary<double>());
+
+	//edges
+	auto vconnectwriter = ewriter.new_child("VERT_CONNECT");
+	writer->set_num_content(g.edge_vert, vconnectwriter, is_binary<int>());
+
+	//faces
+	auto econnectwriter = fwriter.new_child("EDGE_CONNECT");
+	{
+		std::vector<std::vector<int>> face_edge(g.n_faces());
+		for (int i=0; i<g.n_faces(); ++i){
+			face_edge[i].assign(g.face_edges_begin(i), g.face_edges_end(i));
+		}
+		writer->set_num_content(face_edge, econnectwriter, is_binary<int>());
 	}
+
+	auto cconnectwriter = fwriter.new_child("CELL_CONNECT");
+	writer->set_num_content(g.face_cell, cconnectwriter, is_binary<int>());
+
+	//boundary types
+	if (g.btypes.size() > 0) fill_btypes(g.btypes);
 }
 
 void Export::GridWriter::AddFaceVertexConnectivity(){
+	std::vector<std::vector<int>> face_vertex(fgrid ? fgrid->n_faces() : grid->n_faces());
+	if (fgrid){
+		for (size_t i=0; i<face_vertex.size(); ++i){
+			fgrid->face_vert(i, face_vertex[i]);
+		}
+		AddFaceData("__face_vertices__", face_vertex, is_binary<int>());
+		return;
+	}
 	aa::enumerate_ids_pvec(grid->grid.vvert);
-	std::vector<std::vector<int>> face_vertex(grid->n_faces());
 	for (size_t i=0; i<face_vertex.size(); ++i){
 		auto fv = grid->grid.vfaces[i]->sorted_vertices();
 		face_vertex[i].resize(fv.size());
@@ -83,8 +139,15 @@ void Export::GridWriter::AddFaceVertexConnectivity(){
 	AddFaceData("__face_vertices__", face_vertex, is_binary<int>());
 }
 void Export::GridWriter::AddCellFaceConnectivity(){
+	std::vector<std::vector<int>> cell_face(fgrid ? fgrid->n_cells() : grid->n_cells());
+	if (fgrid){
+		for (size_t i=0; i<cell_face.size(); ++i){
+			cell_face[i].assign(fgrid->cell_faces_begin(i), fgrid->cell_faces_end(i));
+		}
+		AddCellData("__cell_faces__", cell_face, is_binary<int>());
+		return;
+	}
 	aa::enumerate_ids_pvec(grid->grid.vfaces);
-	std::vector<std::vector<int>> cell_face(grid->n_cells());
 	for (size_t i=0; i<cell_face.size(); ++i){
 		auto& cf = grid->grid.vcells[i]->faces;
 		cell_face[i].resize(cf.size());
@@ -95,9 +158,23 @@ void Export::GridWriter::AddCellFaceConnectivity(){
 	AddCellData("__cell_faces__", cell_face, is_binary<int>());
 }
 void Export::GridWriter::AddCellVertexConnectivity(){
-	aa::enumerate_ids_pvec(grid->grid.vvert);
-	std::vector<std::vector<int>> cell_vertex(grid->n_cells());
+	std::vector<std::vector<int>> cell_vertex(fgrid ? fgrid->n_cells() : grid->n_cells());
 	std::vector<int> tmp;
+	if (fgrid){
+		for (size_t i=0; i<cell_vertex.size(); ++i){
+			tmp.resize(0);
+			for (const int* f=fgrid->cell_faces_begin(i); f!=fgrid->cell_faces_end(i); ++f)
+			for (const int* e=fgrid->face_edges_begin(*f); e!=fgrid->face_edges_end(*f); ++e){
+				tmp.push_back(fgrid->edge_vert[2*(*e)]);
+				tmp.push_back(fgrid->edge_vert[2*(*e)+1]);
+			}
+			auto itback = std::unique(tmp.begin(), tmp.end());
+			cell_vertex[i].assign(tmp.begin(), itback);
+		}
+		AddCellData("__cell_vertices__", cell_vertex, is_binary<int>());
+		return;
+	}
+	aa::enumerate_ids_pvec(grid->grid.vvert);
 	size_t i=0;
 	for (auto& c: grid->grid.vcells){
 		tmp.resize(0);
@@ -113,8 +190,15 @@ void Export::GridWriter::AddCellVertexConnectivity(){
 }
 
 void Export::GridWriter::AddLinFemConnectivity(){
-	vector<vector<int>> af = (*grid).face_vertex();
-	auto vtkex = vtkcell_expression::cell_assembler(*grid, af, true);
+	vector<vtkcell_expression> vtkex;
+	if (fgrid){
+		vector<int> fvstart, fv;
+		Flat::FaceVert(*fgrid, fvstart, fv);
+		vtkex = vtkcell_expression::cell_assembler(*fgrid, fvstart, fv, true);
+	} else {
+		vector<vector<int>> af = (*grid).face_vertex();
+		vtkex = vtkcell_expression::cell_assembler(*grid, af, true);
+	}
 	vector<vector<int>> linfem(vtkex.size());
 	for (size_t i=0; i<linfem.size(); ++i){
 		switch (vtkex[i].celltype){
@@ -1,6 +1,7 @@
 #ifndef HMG_EXPORT_GRID3D_HPP
 #define HMG_EXPORT_GRID3D_HPP
 #include "serialize3d.hpp"
+#include "flatgrid3d.hpp"
 #include "hmxmlreader.hpp"
 
 namespace HM3D{ namespace Export{
@@ -14,6 +15,11 @@ struct GridWriter{
 		HMXML::ReaderA* writer,
 		HMXML::Reader* subnode,
 		std::string gridname, std::string tp);
+	//g is not copied and should live as long as the writer
+	GridWriter(const FlatGrid& g,
+		HMXML::ReaderA* writer,
+		HMXML::Reader* subnode,
+		std::string gridname, std::string tp);
 
 	template<class A>
 	void AddVertexData(std::string fieldname, const A& data, bool binary);
@@ -36,6 +42,13 @@ private:
 		HMXML::ReaderA* writer,
 		HMXML::Reader* subnode,
 		std::string gridname, std::string tp);
+	void fill(const FlatGrid& g,
+		HMXML::ReaderA* writer,
+		HMXML::Reader* subnode,
+		std::string gridname, std::string tp);
+	void fill_header(int nvert, int nedges, int nfaces, int ncells,
+		HMXML::Reader* subnode, std::string gridname);
+	void fill_btypes(const vector<int>& bt);
 
 	virtual void data_changed(){}
 	template<class A>
@@ -43,7 +56,9 @@ private:
 			bool binary, HMXML::ReaderA& writer);
 
 	HMXML::ReaderA* pwriter;
-	const Ser::Grid* grid;
+	//only one of grid, fgrid is not null
+	const Ser::Grid* grid = 0;
+	const FlatGrid* fgrid = 0;
 	HMXML::Reader gwriter, vwriter, ewriter, fwriter, cwriter;
 	std::string __tp;
 };
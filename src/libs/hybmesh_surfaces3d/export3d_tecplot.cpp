@@ -1,4 +1,5 @@
 #include <fstream>
+#include <unordered_map>
 #include "export3d_tecplot.hpp"
 #include "surface.hpp"
 #include "debug3d.hpp"
@@ -54,6 +55,35 @@ struct SurfSerial{
 		}
 		_findexer.restore();
 	}
+	//srf - indices of fg faces
+	SurfSerial(const HM3D::FlatGrid& fg, const vector<int>& srf){
+		n_faces = srf.size();
+		//edge->nodes. Edges are ordered as in AllEdges
+		std::unordered_map<int, int> eindex;
+		for (auto f: srf)
+		for (const int* e=fg.face_edges_begin(f); e!=fg.face_edges_end(f); ++e){
+			if (eindex.emplace(*e, eindex.size()).second){
+				edges.push_back(fg.edge_vert[2*(*e)]);
+				edges.push_back(fg.edge_vert[2*(*e)+1]);
+			}
+		}
+		n_edges = eindex.size();
+		//edge->faces
+		edge_adj.resize(n_edges*2, -1);
+		for (int i=0; i<n_faces; ++i){
+			int f = srf[i];
+			bool has_right = fg.face_cell[2*f+1] >= 0;
+			const int* eprev = fg.face_edges_end(f) - 1;
+			for (const int* e=fg.face_edges_begin(f); e!=fg.face_edges_end(f); ++e){
+				int p = fg.edge_vert[2*(*e)];
+				bool isleft = (p == fg.edge_vert[2*(*eprev)] || p == fg.edge_vert[2*(*eprev)+1]);
+				if (!has_right) isleft = !isleft;
+				int ie = eindex[*e];
+				edge_adj[isleft ? 2*ie : 2*ie+1] = i;
+				eprev = e;
+			}
+		}
+	}
 	int n_edges, n_faces;
 	vector<int> edges; //start_node_index, end_node_index for each face
 	vector<int> edge_adj;//left face, right face for each edge
@@ -93,6 +123,73 @@ void write_row_n(std::ostream& str, Func&& fun, const vector<V>& vals){
 	if (resj>0) str<<fun(*it)<<std::endl; it+=Step;
 }
 
+//face_nodes, face_nodes_start - face->vertices connectivity in CSR format
+void write_tecplot(HMCallback::Caller2& callback, std::string fn,
+		const vector<double>& vert, int n_cells,
+		const vector<int>& face_nodes_start, const vector<int>& face_nodes,
+		const vector<int>& left_cells, const vector<int>& right_cells,
+		const std::map<int, SurfSerial>& surfaces, hme::BFun bnames){
+	int n_vert = vert.size()/3;
+	int n_faces = face_nodes_start.size() - 1;
+	vector<int> face_dims(n_faces);
+	for (int i=0; i<n_faces; ++i) face_dims[i] = face_nodes_start[i+1] - face_nodes_start[i];
+
+	// ====== write to file:
+	callback.silent_step_after(30, "Write to file", 10);
+	std::ofstream of(fn);
+	of.precision(10);
+	//====== main header
+	of<<"TITLE=\"Tecplot Export\""<<std::endl;
+	of<<"VARIABLES=\"X\" \"Y\" \"Z\""<<std::endl;
+	of<<"ZONE T=\"Grid\""<<std::endl;
+	of<<"Nodes="<<n_vert<<std::endl;
+	of<<"Faces="<<n_faces<<std::endl;
+	of<<"Elements="<<n_cells<<std::endl;
+	of<<"ZONETYPE=FEPOLYHEDRON"<<std::endl;
+	of<<"DATAPACKING=BLOCK"<<std::endl;
+	of<<"TotalNumFaceNodes="<<face_nodes.size()<<std::endl;
+	of<<"NumConnectedBoundaryFaces=0, TotalNumBoundaryConnections=0"<<std::endl;
+	//points
+	callback.subprocess_step_after(3);
+	write_row_n<3, 0, 20>(of, [](double v){ return v; }, vert);
+	write_row_n<3, 1, 20>(of, [](double v){ return v; }, vert);
+	write_row_n<3, 2, 20>(of, [](double v){ return v; }, vert);
+	//face dims
+	callback.subprocess_step_after(1);
+	write_row_n<1, 0, 20>(of, [](const int& v){ return v; }, face_dims);
+	//face->nodes
+	callback.subprocess_step_after(3);
+	for (int i=0; i<n_faces; ++i){
+		for (int j=face_nodes_start[i]; j<face_nodes_start[i+1]; ++j) of<<face_nodes[j]+1<<" ";
+		of<<std::endl;
+	}
+	//face left/right cells
+	callback.subprocess_step_after(1);
+	write_row_n<1, 0, 20>(of, [](const int& v){ return v + 1; }, left_cells);
+	write_row_n<1, 0, 20>(of, [](const int& v){ return v + 1; }, right_cells);
+
+	//====== boundary surfaces
+	callback.subprocess_step_after(3);
+	for (auto& s: surfaces){
+		std::string name = bnames(s.first); 
+		of<<"ZONE T=\""<<name<<"\""<<std::endl;
+		of<<"D=(1 2 3)"<<std::endl;
+		of<<"Faces="<<s.second.n_edges<<std::endl;
+		of<<"Elements="<<s.second.n_faces<<std::endl;
+		of<<"ZONETYPE=FEPOLYGON"<<std::endl;
+		of<<"DATAPACKING=BLOCK"<<std::endl;
+		of<<"NumConnectedBoundaryFaces=0, TotalNumBoundaryConnections=0"<<std::endl;
+		//edges
+		write_row_n<1, 0, 20>(of, [](const int& v){ return v+1; }, s.second.edges);
+		//adjacents left
+		write_row_n<2, 0, 20>(of, [](const int& v){ return v+1; }, s.second.edge_adj);
+		//adjacents right
+		write_row_n<2, 1, 20>(of, [](const int& v){ return v+1; }, s.second.edge_adj);
+	}
+	
+	of.close();
+}
+
 };
 
 void hme::TGridTecplot::_run(const GridData& g, std::string fn, BFun bnd_names){
@@ -102,10 +199,11 @@ void hme::TGridTecplot::_run(const GridData& g, std::string fn, BFun bnd_names){
 void hme::TGridTecplot::_run(const Ser::Grid& ser, std::string fn, BFun bnames){
 	callback->step_after(30, "Assembling connectivity");
 	//face->nodes connectivity
-	vector<vector<int>> face_nodes = ser.face_vertex();
-	//total face connectivity
-	int totalfn = 0;
-	for (int i=0; i<face_nodes.size(); ++i) totalfn+=face_nodes[i].size();
+	vector<int> fnstart(1, 0), face_nodes;
+	for (auto& fv: ser.face_vertex()){
+		face_nodes.insert(face_nodes.end(), fv.begin(), fv.end());
+		fnstart.push_back(face_nodes.size());
+	}
 	//face adjacents
 	vector<int> left_cells, right_cells;
 	{
@@ -141,61 +239,36 @@ void hme::TGridTecplot::_run(const Ser::Grid& ser, std::string fn, BFun bnames){
 		_indexer.restore();
 	}
 
-	// ====== write to file:
-	callback->silent_step_after(30, "Write to file", 10);
-	std::ofstream of(fn);
-	of.precision(10);
-	//====== main header
-	of<<"TITLE=\"Tecplot Export\""<<std::endl;
-	of<<"VARIABLES=\"X\" \"Y\" \"Z\""<<std::endl;
-	of<<"ZONE T=\"Grid\""<<std::endl;
-	of<<"Nodes="<<ser.n_vert()<<std::endl;
-	of<<"Faces="<<ser.n_faces()<<std::endl;
-	of<<"Elements="<<ser.n_cells()<<std::endl;
-	of<<"ZONETYPE=FEPOLYHEDRON"<<std::endl;
-	of<<"DATAPACKING=BLOCK"<<std::endl;
-	of<<"TotalNumFaceNodes="<<totalfn<<std::endl;
-	of<<"NumConnectedBoundaryFaces=0, TotalNumBoundaryConnections=0"<<std::endl;
-	//points
-	callback->subprocess_step_after(3);
-	write_row_n<3, 0, 20>(of, [](double v){ return v; }, ser.vert());
-	write_row_n<3, 1, 20>(of, [](double v){ return v; }, ser.vert());
-	write_row_n<3, 2, 20>(of, [](double v){ return v; }, ser.vert());
-	//face dims
-	callback->subprocess_step_after(1);
-	//for (int i=0; i<face_nodes.size(); ++i) of<<face_nodes[i].size()<<std::endl;
-	write_row_n<1, 0, 20>(of, [](const vector<int>& v){ return v.size(); }, face_nodes);
-	//face->nodes
-	callback->subprocess_step_after(3);
-	for (int i=0; i<face_nodes.size(); ++i){
-		for (int j=0; j<face_nodes[i].size(); ++j) of<<face_nodes[i][j]+1<<" ";
-		of<<std::endl;
-	}
-	//face left/right cells
-	callback->subprocess_step_after(1);
-	write_row_n<1, 0, 20>(of, [](const int& v){ return v + 1; }, left_cells);
-	write_row_n<1, 0, 20>(of, [](const int& v){ return v + 1; }, right_cells);
+	write_tecplot(*callback, fn, ser.vert(), ser.n_cells(), fnstart, face_nodes,
+			left_cells, right_cells, surfaces, bnames);
+}
 
-	//====== boundary surfaces
-	callback->subprocess_step_after(3);
-	for (auto& s: surfaces){
-		std::string name = bnames(s.first); 
-		of<<"ZONE T=\""<<name<<"\""<<std::endl;
-		of<<"D=(1 2 3)"<<std::endl;
-		of<<"Faces="<<s.second.n_edges<<std::endl;
-		of<<"Elements="<<s.second.n_faces<<std::endl;
-		of<<"ZONETYPE=FEPOLYGON"<<std::endl;
-		of<<"DATAPACKING=BLOCK"<<std::endl;
-		of<<"NumConnectedBoundaryFaces=0, TotalNumBoundaryConnections=0"<<std::endl;
-		//edges
-		write_row_n<1, 0, 20>(of, [](const int& v){ return v+1; }, s.second.edges);
-		//adjacents left
-		write_row_n<2, 0, 20>(of, [](const int& v){ return v+1; }, s.second.edge_adj);
-		//adjacents right
-		write_row_n<2, 1, 20>(of, [](const int& v){ return v+1; }, s.second.edge_adj);
+void hme::TGridTecplot::_run(const FlatGrid& g, std::string fn, BFun bnames){
+	callback->step_after(30, "Assembling connectivity");
+	//face->nodes connectivity
+	vector<int> fnstart, face_nodes;
+	Flat::FaceVert(g, fnstart, face_nodes);
+	//face adjacents
+	vector<int> left_cells(g.n_faces()), right_cells(g.n_faces());
+	for (int i=0; i<g.n_faces(); ++i){
+		left_cells[i] = g.face_cell[2*i];
+		right_cells[i] = g.face_cell[2*i+1];
 	}
-	
-	of.close();
+	//assembling surfaces
+	std::map<int, vector<int>> surfaces_geom;
+	for (int i=0; i<g.n_faces(); ++i) if (g.is_boundary_face(i)){
+		surfaces_geom[g.btypes[i]].push_back(i);
+	}
+	//serializing surfaces
+	callback->silent_step_after(20, "Serialize surfaces", surfaces_geom.size());
+	std::map<int, SurfSerial> surfaces;
+	for (auto& m: surfaces_geom){
+		callback->subprocess_step_after(1);
+		surfaces.emplace(m.first, SurfSerial(g, m.second));
+	}
+
+	write_tecplot(*callback, fn, g.vert, g.n_cells(), fnstart, face_nodes,
+			left_cells, right_cells, surfaces, bnames);
 }
 
 
@@ -2,6 +2,7 @@
 #define TECPLOT_EXPORT_GRID3D_HPP
 #include "export3d_fluent.hpp"
 #include "serialize3d.hpp"
+#include "flatgrid3d.hpp"
 #include "hmcallback.hpp"
 namespace HM3D{ namespace Export{
 
@@ -11,6 +12,7 @@ struct TGridTecplot: public HMCallback::ExecutorBase{
 
 	void _run(const Ser::Grid& g, std::string fn, BFun bnd_names=def_bfun);
 	void _run(const GridData& g, std::string fn, BFun bnd_names=def_bfun);
+	void _run(const FlatGrid& g, std::string fn, BFun bnd_names=def_bfun);
 
 };
 
@@ -3,11 +3,13 @@
 #include "addalgo.hpp"
 #include "export3d_vtk.hpp"
 #include "serialize3d.hpp"
+#include "hmparallel.hpp"
 
 using namespace HM3D;
 namespace hme = HM3D::Export;
 
 HMCallback::FunctionWithCallback<hme::TGridVTK> hme::GridVTK;
+HMCallback::FunctionWithCallback<hme::TGridVTU> hme::GridVTU;
 HMCallback::FunctionWithCallback<hme::TBoundaryVTK> hme::BoundaryVTK;
 HMCallback::FunctionWithCallback<hme::TAllVTK> hme::AllVTK;
 HMCallback::FunctionWithCallback<hme::TSurfaceVTK> hme::SurfaceVTK;
@@ -221,6 +223,44 @@ vector<hme::vtkcell_expression> hme::vtkcell_expression::cell_assembler(const Se
 }
 
 
+namespace{
+//faces vertices of icell with left cell orientation
+void flat_cell_points(const FlatGrid& fg, const vector<int>& face_vert_start,
+		const vector<int>& face_vert, int icell, vector<vector<int>>& cell_points){
+	cell_points.resize(fg.cell_size(icell));
+	auto cpit = cell_points.begin();
+	for (const int* it=fg.cell_faces_begin(icell); it!=fg.cell_faces_end(icell); ++it){
+		int iface = *it;
+		auto& vertv = *cpit++;
+		vertv.assign(face_vert.begin() + face_vert_start[iface],
+		             face_vert.begin() + face_vert_start[iface+1]);
+		//reverse to guarantee left cell
+		if (fg.face_cell[2*iface] != icell){
+			std::reverse(vertv.begin(), vertv.end());
+		}
+	}
+}
+}
+
+vector<hme::vtkcell_expression> hme::vtkcell_expression::cell_assembler(const FlatGrid& fg,
+		const vector<int>& face_vert_start, const vector<int>& face_vert, bool ignore_errors){
+	vector<vtkcell_expression> ret; ret.reserve(fg.n_cells());
+	vector<vector<int>> cell_points;
+
+	for (int icell=0; icell<fg.n_cells(); ++icell){
+		flat_cell_points(fg, face_vert_start, face_vert, icell, cell_points);
+		//match vtk data format. throws if impossible
+		try{
+			ret.push_back(vtkcell_expression::build(cell_points));
+		} catch (std::runtime_error& e){
+			if (!ignore_errors) throw;
+			else ret.push_back(vtkcell_expression());
+		}
+	}
+	return ret;
+}
+
+
 void hme::TGridVTK::_run(const Ser::Grid& ser, std::string fn){
 	callback->step_after(20, "Assembling faces");
 	vector<vector<int>> aface = ser.face_vertex();
@@ -256,8 +296,113 @@ void hme::TGridVTK::_run(const Ser::Grid& ser, std::string fn){
 	fs.close();
 }
 
-void hme::TGridVTK::_run(const GridData& ser, std::string fn){
-	return _run(Ser::Grid(ser), fn);
+void hme::TGridVTK::_run(const GridData& g, std::string fn){
+	return _run(Flatten(g), fn);
+}
+
+void hme::TGridVTK::_run(const FlatGrid& g, std::string fn){
+	callback->step_after(20, "Assembling faces");
+	vector<int> fvstart, fv;
+	Flat::FaceVert(g, fvstart, fv);
+
+	callback->step_after(20, "Assembling cells");
+	vector<vtkcell_expression> vtkcell = vtkcell_expression::cell_assembler(g, fvstart, fv);
+	int nffull = std::accumulate(vtkcell.begin(), vtkcell.end(), 0,
+			[](int s, const vtkcell_expression& v){ return s + v.wsize(); });
+
+	callback->silent_step_after(40, "Writing to file", 2, 0);
+	//header
+	std::ofstream fs(fn);
+	fs<<"# vtk DataFile Version 3.0"<<std::endl;
+	fs<<"3D Grid"<<std::endl;
+	fs<<"ASCII"<<std::endl;
+
+	//Points
+	callback->subprocess_step_after(1);
+	fs<<"DATASET UNSTRUCTURED_GRID"<<std::endl;
+	fs<<"POINTS "<<g.n_vert()<< " float"<<std::endl;
+	for (int i=0; i<3*g.n_vert(); i+=3)
+		fs<<g.vert[i]<<" "<<g.vert[i+1]<<" "<<g.vert[i+2]<<std::endl;
+
+	//Cells
+	callback->subprocess_step_after(1);
+	fs<<"CELLS  "<<vtkcell.size()<<"   "<<nffull<<std::endl;
+	for (auto& f: vtkcell) fs<<f.to_string()<<std::endl;
+	fs<<"CELL_TYPES  "<<vtkcell.size()<<std::endl;
+	for (auto& f: vtkcell) fs<<f.stype()<<std::endl;
+
+	fs.close();
+}
+
+void hme::TGridVTU::_run(const GridData& g, std::string fn, const HMVtu::Options& opt){
+	return _run(Flatten(g), fn, opt);
+}
+
+void hme::TGridVTU::_run(const FlatGrid& g, std::string fn, const HMVtu::Options& opt){
+	callback->step_after(15, "Assembling faces");
+	vector<int> fvstart, fv;
+	Flat::FaceVert(g, fvstart, fv);
+
+	callback->step_after(35, "Assembling cells");
+	HMVtu::UGrid ug;
+	ug.points = g.vert;
+	int nc = g.n_cells();
+	ug.offsets.resize(nc);
+	ug.types.resize(nc);
+	ug.faceoffsets.resize(nc);
+	//each chunk fills its own connectivity and faces streams.
+	//offsets are local to chunk streams at this stage
+	int nchunks = HMParallel::NumChunks(nc);
+	vector<vector<int>> conn(nchunks), faces(nchunks);
+	HMParallel::ForChunks(nc, [&](int ib, int ie, int ic){
+		vector<vector<int>> cell_points;
+		auto& cn = conn[ic];
+		auto& fc = faces[ic];
+		cn.reserve((long long)g.cell_face.size()*(ie-ib)/std::max(1, nc));
+		for (int icell=ib; icell<ie; ++icell){
+			flat_cell_points(g, fvstart, fv, icell, cell_points);
+			vtkcell_expression e = vtkcell_expression::build(cell_points);
+			ug.types[icell] = e.celltype;
+			if (e.celltype == 42){
+				//pts contain vtu faces stream, connectivity lists unique vertices
+				fc.insert(fc.end(), e.pts.begin(), e.pts.end());
+				ug.faceoffsets[icell] = fc.size();
+				size_t cstart = cn.size();
+				for (auto& face: cell_points)
+				for (auto p: face){
+					if (std::find(cn.begin() + cstart, cn.end(), p) == cn.end()){
+						cn.push_back(p);
+					}
+				}
+			} else {
+				cn.insert(cn.end(), e.pts.begin(), e.pts.end());
+				ug.faceoffsets[icell] = -1;
+			}
+			ug.offsets[icell] = cn.size();
+		}
+	});
+	//chunks concatenation
+	vector<int> cstart(nchunks+1, 0), fstart(nchunks+1, 0);
+	for (int i=0; i<nchunks; ++i){
+		cstart[i+1] = cstart[i] + conn[i].size();
+		fstart[i+1] = fstart[i] + faces[i].size();
+	}
+	ug.connectivity.resize(cstart.back());
+	ug.faces.resize(fstart.back());
+	HMParallel::ForChunks(nc, [&](int ib, int ie, int ic){
+		std::copy(conn[ic].begin(), conn[ic].end(), ug.connectivity.begin() + cstart[ic]);
+		std::copy(faces[ic].begin(), faces[ic].end(), ug.faces.begin() + fstart[ic]);
+		vector<int>().swap(conn[ic]);
+		vector<int>().swap(faces[ic]);
+		for (int i=ib; i<ie; ++i){
+			ug.offsets[i] += cstart[ic];
+			if (ug.faceoffsets[i] >= 0) ug.faceoffsets[i] += fstart[ic];
+		}
+	});
+	if (ug.faces.size() == 0) ug.faceoffsets.clear();
+
+	callback->step_after(30, "Writing to file");
+	HMVtu::Write(ug, fn, opt);
 }
 
 namespace {
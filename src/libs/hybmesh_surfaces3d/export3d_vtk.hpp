@@ -5,6 +5,8 @@
 #include "hmcallback.hpp"
 #include "primitives3d.hpp"
 #include "serialize3d.hpp"
+#include "flatgrid3d.hpp"
+#include "hmvtuwriter.hpp"
 
 namespace HM3D{namespace Export{
 
@@ -16,10 +18,25 @@ struct TGridVTK: public HMCallback::ExecutorBase{
 
 	void _run(const Ser::Grid& g, std::string fn);
 	void _run(const GridData& g, std::string fn);
+	void _run(const FlatGrid& g, std::string fn);
 
 };
 extern HMCallback::FunctionWithCallback<TGridVTK> GridVTK;
 
+//binary vtk xml format (*.vtu or *.pvtu if opt.npieces > 1).
+//Cells are assembled in parallel by contiguous cell ranges.
+//signature void GridVTU(const FlatGrid& g, std::string fn, const HMVtu::Options& opt);
+struct TGridVTU: public HMCallback::ExecutorBase{
+	HMCB_SET_PROCNAME("Exporting 3d grid to *.vtu");
+	HMCB_SET_DEFAULT_DURATION(80);
+
+	void _run(const GridData& g, std::string fn, const HMVtu::Options& opt);
+	void _run(const FlatGrid& g, std::string fn, const HMVtu::Options& opt);
+	void _run(const GridData& g, std::string fn){ return _run(g, fn, HMVtu::Options()); }
+	void _run(const FlatGrid& g, std::string fn){ return _run(g, fn, HMVtu::Options()); }
+};
+extern HMCallback::FunctionWithCallback<TGridVTU> GridVTU;
+
 
 //signature void BoundaryVTK(const HMGrid3D::Grid& g, std::string* fn);
 struct TBoundaryVTK: public HMCallback::ExecutorBase{
@@ -84,6 +101,11 @@ public:
 	//aface is face_vertex connectivity table
 	static vector<vtkcell_expression> cell_assembler(const Ser::Grid& ser,
 			const vector<vector<int>>& aface, bool ignore_errors=false);
+	//same for compact grid. face_vert_start, face_vert is a
+	//face_vertex connectivity table in CSR format
+	static vector<vtkcell_expression> cell_assembler(const FlatGrid& fg,
+			const vector<int>& face_vert_start, const vector<int>& face_vert,
+			bool ignore_errors=false);
 	virtual std::string to_string() const;
 
 	int wsize() const;  //number of points + 1
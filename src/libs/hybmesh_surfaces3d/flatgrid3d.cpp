@@ -0,0 +1,156 @@
+#include "flatgrid3d.hpp"
+#include "hmpool.hpp"
+
+using namespace HM3D;
+
+// ===================== FlatGrid
+void FlatGrid::face_vert(int iface, vector<int>& ret) const{
+	aa::chain_vertices(face_edges_begin(iface), face_size(iface), edge_vert, ret);
+}
+
+void FlatGrid::clear(){
+	vert.clear();
+	edge_vert.clear();
+	face_edge_start.clear();
+	face_edge.clear();
+	face_cell.clear();
+	btypes.clear();
+	cell_face_start.clear();
+	cell_face.clear();
+}
+
+size_t FlatGrid::memory_usage() const{
+	return vert.size()*sizeof(double) +
+		(edge_vert.size() + face_edge_start.size() + face_edge.size() +
+		 face_cell.size() + btypes.size() +
+		 cell_face_start.size() + cell_face.size())*sizeof(int);
+}
+
+void FlatGrid::assemble_cell_face(int ncells){
+	if (ncells < 0){
+		ncells = 0;
+		for (auto c: face_cell) if (c >= ncells) ncells = c+1;
+	}
+	cell_face_start.assign(ncells+1, 0);
+	for (auto c: face_cell) if (c >= 0) ++cell_face_start[c+1];
+	for (int i=0; i<ncells; ++i) cell_face_start[i+1] += cell_face_start[i];
+	cell_face.resize(cell_face_start.back());
+	vector<int> pos(cell_face_start.begin(), cell_face_start.end()-1);
+	for (int i=0; i<n_faces(); ++i){
+		int cl = face_cell[2*i], cr = face_cell[2*i+1];
+		if (cl >= 0) cell_face[pos[cl]++] = i;
+		if (cr >= 0) cell_face[pos[cr]++] = i;
+	}
+}
+
+// ===================== conversion
+FlatGrid HM3D::Flatten(const GridData& g){
+	FlatGrid ret;
+	g.enumerate_all();
+
+	ret.vert.resize(3*g.vvert.size());
+	auto vit = ret.vert.begin();
+	for (auto& v: g.vvert){
+		*vit++ = v->x;
+		*vit++ = v->y;
+		*vit++ = v->z;
+	}
+
+	ret.edge_vert.resize(2*g.vedges.size());
+	auto eit = ret.edge_vert.begin();
+	for (auto& e: g.vedges){
+		*eit++ = e->vertices[0]->id;
+		*eit++ = e->vertices[1]->id;
+	}
+
+	ret.face_edge_start.resize(g.vfaces.size()+1);
+	ret.face_edge_start[0] = 0;
+	for (size_t i=0; i<g.vfaces.size(); ++i){
+		ret.face_edge_start[i+1] = ret.face_edge_start[i] + g.vfaces[i]->edges.size();
+	}
+	ret.face_edge.resize(ret.face_edge_start.back());
+	ret.face_cell.resize(2*g.vfaces.size());
+	ret.btypes.resize(g.vfaces.size());
+	auto feit = ret.face_edge.begin();
+	for (size_t i=0; i<g.vfaces.size(); ++i){
+		const Face& f = *g.vfaces[i];
+		for (auto& e: f.edges) *feit++ = e->id;
+		ret.face_cell[2*i] = f.has_left_cell() ? f.left.lock()->id : -1;
+		ret.face_cell[2*i+1] = f.has_right_cell() ? f.right.lock()->id : -1;
+		ret.btypes[i] = f.boundary_type;
+	}
+
+	ret.cell_face_start.resize(g.vcells.size()+1);
+	ret.cell_face_start[0] = 0;
+	for (size_t i=0; i<g.vcells.size(); ++i){
+		ret.cell_face_start[i+1] = ret.cell_face_start[i] + g.vcells[i]->faces.size();
+	}
+	ret.cell_face.resize(ret.cell_face_start.back());
+	auto cit = ret.cell_face.begin();
+	for (auto& c: g.vcells)
+	for (auto& f: c->faces){
+		*cit++ = f->id;
+	}
+
+	return ret;
+}
+
+GridData HM3D::Unflatten(const FlatGrid& fg){
+	GridData ret;
+	HMPool::Pool pool;
+	ret.vvert.resize(fg.n_vert());
+	ret.vedges.resize(fg.n_edges());
+	ret.vfaces.resize(fg.n_faces());
+	ret.vcells.resize(fg.n_cells());
+
+	for (int i=0; i<fg.n_vert(); ++i){
+		ret.vvert[i] = pool.make<Vertex>(fg.vert[3*i], fg.vert[3*i+1], fg.vert[3*i+2]);
+	}
+	for (int i=0; i<fg.n_edges(); ++i){
+		ret.vedges[i] = pool.make<Edge>(ret.vvert[fg.edge_vert[2*i]], ret.vvert[fg.edge_vert[2*i+1]]);
+	}
+	for (int i=0; i<fg.n_cells(); ++i){
+		ret.vcells[i] = pool.make<Cell>();
+	}
+	for (int i=0; i<fg.n_faces(); ++i){
+		ret.vfaces[i] = pool.make<Face>();
+		Face* f = ret.vfaces[i].get();
+		f->edges.reserve(fg.face_size(i));
+		for (const int* it=fg.face_edges_begin(i); it!=fg.face_edges_end(i); ++it){
+			f->edges.push_back(ret.vedges[*it]);
+		}
+		int cl = fg.face_cell[2*i], cr = fg.face_cell[2*i+1];
+		if (cl >= 0) f->left = ret.vcells[cl];
+		if (cr >= 0) f->right = ret.vcells[cr];
+		if (fg.btypes.size() > 0) f->boundary_type = fg.btypes[i];
+	}
+	for (int i=0; i<fg.n_cells(); ++i){
+		auto& cf = ret.vcells[i]->faces;
+		cf.reserve(fg.cell_size(i));
+		for (const int* it=fg.cell_faces_begin(i); it!=fg.cell_faces_end(i); ++it){
+			cf.push_back(ret.vfaces[*it]);
+		}
+	}
+
+	return ret;
+}
+
+// ===================== algorithms
+void Flat::FaceVert(const FlatGrid& fg, vector<int>& face_vert_start, vector<int>& face_vert){
+	face_vert_start.resize(fg.n_faces()+1);
+	face_vert.clear();
+	face_vert.reserve(fg.face_edge.size());
+	face_vert_start[0] = 0;
+	for (int i=0; i<fg.n_faces(); ++i){
+		fg.face_vert(i, face_vert);
+		face_vert_start[i+1] = face_vert.size();
+	}
+}
+
+vector<int> Flat::BoundaryFaces(const FlatGrid& fg){
+	vector<int> ret;
+	for (int i=0; i<fg.n_faces(); ++i){
+		if (fg.is_boundary_face(i)) ret.push_back(i);
+	}
+	return ret;
+}
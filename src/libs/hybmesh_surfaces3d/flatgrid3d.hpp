@@ -0,0 +1,65 @@
+#ifndef HYBMESH_FLATGRID3D_HPP
+#define HYBMESH_FLATGRID3D_HPP
+
+#include "primitives3d.hpp"
+
+namespace HM3D{
+
+//Compact index based grid storage.
+//Face->edge and cell->face connectivities are stored in CSR format:
+//edges of i-th face are face_edge[face_edge_start[i]], ..., face_edge[face_edge_start[i+1]-1].
+//Face edges are sorted as in HM3D::Face::edges, cell faces as in HM3D::Cell::faces.
+struct FlatGrid{
+	vector<double> vert;           //x0, y0, z0, x1, y1, z1, ...
+	vector<int> edge_vert;         //edge0_start, edge0_end, edge1_start, edge1_end, ...
+	vector<int> face_edge_start;   //size = n_faces()+1
+	vector<int> face_edge;         //size = face_edge_start.back()
+	vector<int> face_cell;         //face0_left, face0_right, ...; -1 if no cell
+	vector<int> btypes;            //boundary type for each face
+	vector<int> cell_face_start;   //size = n_cells()+1
+	vector<int> cell_face;         //size = cell_face_start.back()
+
+	int n_vert() const { return vert.size()/3; }
+	int n_edges() const { return edge_vert.size()/2; }
+	int n_faces() const { return face_edge_start.size() > 0 ? face_edge_start.size()-1 : 0; }
+	int n_cells() const { return cell_face_start.size() > 0 ? cell_face_start.size()-1 : 0; }
+
+	// ====== features
+	Point3 vertex(int ivert) const { return Point3(vert[3*ivert], vert[3*ivert+1], vert[3*ivert+2]); }
+	int face_size(int iface) const { return face_edge_start[iface+1] - face_edge_start[iface]; }
+	int cell_size(int icell) const { return cell_face_start[icell+1] - cell_face_start[icell]; }
+	const int* face_edges_begin(int iface) const { return &face_edge[0] + face_edge_start[iface]; }
+	const int* face_edges_end(int iface) const { return &face_edge[0] + face_edge_start[iface+1]; }
+	const int* cell_faces_begin(int icell) const { return &cell_face[0] + cell_face_start[icell]; }
+	const int* cell_faces_end(int icell) const { return &cell_face[0] + cell_face_start[icell+1]; }
+	bool is_boundary_face(int iface) const { return face_cell[2*iface] < 0 || face_cell[2*iface+1] < 0; }
+	//ordered face vertices. First vertex is common to last and first edge.
+	//Result is written to ret starting from its current end.
+	void face_vert(int iface, vector<int>& ret) const;
+
+	// ====== methods
+	void clear();
+	//number of bytes used by connectivity tables
+	size_t memory_usage() const;
+	//fills cell_face_start, cell_face from face_cell table.
+	//Faces of each cell are sorted by face index.
+	void assemble_cell_face(int ncells=-1);
+};
+
+//builds compact representation in a single pass over primitives.
+//Ids of g primitives are changed.
+FlatGrid Flatten(const GridData& g);
+//builds shared pointers based grid from compact representation
+GridData Unflatten(const FlatGrid& fg);
+
+namespace Flat{
+
+//face vertices of all faces in CSR format
+void FaceVert(const FlatGrid& fg, vector<int>& face_vert_start, vector<int>& face_vert);
+//boundary faces indices
+vector<int> BoundaryFaces(const FlatGrid& fg);
+
+}
+
+}
+#endif
@@ -5,49 +5,55 @@ using namespace HMXML;
 HMCallback::FunctionWithCallback<Import::TReadHMG> Import::ReadHMG;
 
 std::unique_ptr<Import::GridReader> Import::TReadHMG::_run(HMXML::ReaderA* reader, HMXML::Reader* subnode){
-	callback->silent_step_after(50, "Reading data", 4);
 	std::unique_ptr<Import::GridReader> ret(new GridReader(reader, subnode));
+	ret->fill_result(*callback);
+	return ret;
+}
+
+void Import::GridReader::fill_result(HMCallback::Caller2& callback){
+	callback.silent_step_after(50, "Reading data", 4);
 	//read dimensions
-	ret->pgreader->value_int("N_VERTICES", ret->Nv, true);
-	ret->pgreader->value_int("N_EDGES", ret->Ne, true);
-	ret->pgreader->value_int("N_CELLS", ret->Nc, true);
-	ret->pgreader->value_int("N_FACES", ret->Nf, true);
+	pgreader->value_int("N_VERTICES", Nv, true);
+	pgreader->value_int("N_EDGES", Ne, true);
+	pgreader->value_int("N_CELLS", Nc, true);
+	pgreader->value_int("N_FACES", Nf, true);
 
+	//binary fields are read directly from the mapped file into final tables
+	//which are then moved to the serialized grid without copying.
 	//read vertices
-	callback->subprocess_step_after(1);
-	Reader tmp = ret->pgreader->find_by_path("VERTICES/COORDS", true);
-	vector<double> vert = ret->preader->read_num_content(tmp, 3*ret->Nv).vec<double>();
+	callback.subprocess_step_after(1);
+	Reader tmp = pgreader->find_by_path("VERTICES/COORDS", true);
+	vector<double> vert = std::move(preader->read_num_content(tmp, 3*Nv).vec<double>());
 
 	//read edges->vertices
-	callback->subprocess_step_after(1);
-	tmp = ret->pgreader->find_by_path("EDGES/VERT_CONNECT", true);
-	vector<int> edgevert = ret->preader->read_num_content(tmp, 2*ret->Ne).vec<int>();
+	callback.subprocess_step_after(1);
+	tmp = pgreader->find_by_path("EDGES/VERT_CONNECT", true);
+	vector<int> edgevert = std::move(preader->read_num_content(tmp, 2*Ne).vec<int>());
 
 	//read faces->edges
-	callback->subprocess_step_after(1);
-	tmp = ret->pgreader->find_by_path("FACES/EDGE_CONNECT", true);
-	vector<vector<int>> faceedge = ret->preader->read_num_content(tmp, ret->Nf).vecvec<int>();
+	callback.subprocess_step_after(1);
+	tmp = pgreader->find_by_path("FACES/EDGE_CONNECT", true);
+	vector<vector<int>> faceedge = std::move(preader->read_num_content(tmp, Nf).vecvec<int>());
 
 	//read faces->cells
-	callback->subprocess_step_after(1);
-	tmp = ret->pgreader->find_by_path("FACES/CELL_CONNECT", true);
-	vector<int> facecell = ret->preader->read_num_content(tmp, ret->Nf*2).vec<int>();
-	callback->subprocess_fin();
+	callback.subprocess_step_after(1);
+	tmp = pgreader->find_by_path("FACES/CELL_CONNECT", true);
+	vector<int> facecell = std::move(preader->read_num_content(tmp, Nf*2).vec<int>());
+	callback.subprocess_fin();
 
 	//constructing serialized grid
-	ret->result.reset(new Ser::Grid());
+	result.reset(new Ser::Grid());
 	//boundary conditions
-	vector<int> btypes(ret->Nf, 0);
+	vector<int> btypes(Nf, 0);
 	try{
-		btypes = ret->read_faces_field<int>("__boundary_types__");
+		btypes = read_faces_field<int>("__boundary_types__");
 	} catch (const XmlElementNotFound&){
 	}
 
 	//unserial
-	callback->step_after(50, "Assembling grid");
-	ret->result->fill_from_serial(vert, edgevert, faceedge, facecell, btypes);
-	
-	return ret;
+	callback.step_after(50, "Assembling grid");
+	result->fill_from_serial(std::move(vert), std::move(edgevert),
+			std::move(faceedge), std::move(facecell), std::move(btypes));
 }
 
 Import::GridReader::TFieldInfo::TFieldInfo(HMXML::Reader& field){
@@ -68,42 +74,46 @@ Import::GridReader::TFieldInfo::TFieldInfo(HMXML::Reader& field){
 HMCallback::FunctionWithCallback<Import::TReadHMC> Import::ReadHMC;
 
 std::unique_ptr<Import::SurfaceReader> Import::TReadHMC::_run(HMXML::ReaderA* reader, HMXML::Reader* subnode){
-	callback->silent_step_after(50, "Reading data", 4);
 	std::unique_ptr<Import::SurfaceReader> ret(new SurfaceReader(reader, subnode));
+	ret->fill_result(*callback);
+	return ret;
+}
+
+void Import::SurfaceReader::fill_result(HMCallback::Caller2& callback){
+	callback.silent_step_after(50, "Reading data", 4);
 	//read dimensions
-	ret->psreader->value_int("N_VERTICES", ret->Nv, true);
-	ret->psreader->value_int("N_EDGES", ret->Ne, true);
-	ret->psreader->value_int("N_FACES", ret->Nf, true);
+	psreader->value_int("N_VERTICES", Nv, true);
+	psreader->value_int("N_EDGES", Ne, true);
+	psreader->value_int("N_FACES", Nf, true);
 
 	//read vertices
-	callback->subprocess_step_after(1);
-	Reader tmp = ret->psreader->find_by_path("VERTICES/COORDS", true);
-	vector<double> vert = ret->preader->read_num_content(tmp, 3*ret->Nv).vec<double>();
+	callback.subprocess_step_after(1);
+	Reader tmp = psreader->find_by_path("VERTICES/COORDS", true);
+	vector<double> vert = std::move(preader->read_num_content(tmp, 3*Nv).vec<double>());
 
 	//read edges->vertices
-	callback->subprocess_step_after(1);
-	tmp = ret->psreader->find_by_path("EDGES/VERT_CONNECT", true);
-	vector<int> edgevert = ret->preader->read_num_content(tmp, 2*ret->Ne).vec<int>();
+	callback.subprocess_step_after(1);
+	tmp = psreader->find_by_path("EDGES/VERT_CONNECT", true);
+	vector<int> edgevert = std::move(preader->read_num_content(tmp, 2*Ne).vec<int>());
 
 	//read faces->edges
-	callback->subprocess_step_after(1);
-	tmp = ret->psreader->find_by_path("FACES/EDGE_CONNECT", true);
-	vector<vector<int>> faceedge = ret->preader->read_num_content(tmp, ret->Nf).vecvec<int>();
+	callback.subprocess_step_after(1);
+	tmp = psreader->find_by_path("FACES/EDGE_CONNECT", true);
+	vector<vector<int>> faceedge = std::move(preader->read_num_content(tmp, Nf).vecvec<int>());
 
 	//boundary conditions
-	callback->subprocess_step_after(1);
-	vector<int> btypes(ret->Nf, 0);
+	callback.subprocess_step_after(1);
+	vector<int> btypes(Nf, 0);
 	try{
-		btypes = ret->read_faces_field<int>("__boundary_types__");
+		btypes = read_faces_field<int>("__boundary_types__");
 	} catch (const XmlElementNotFound&){
 	}
 
 	//constructing serialized grid
-	ret->result.reset(new Ser::Surface());
-	callback->step_after(50, "Assembling surface");
-	ret->result->fill_from_serial(vert, edgevert, faceedge, btypes);
-
-	return ret;
+	result.reset(new Ser::Surface());
+	callback.step_after(50, "Assembling surface");
+	result->fill_from_serial(std::move(vert), std::move(edgevert),
+			std::move(faceedge), std::move(btypes));
 }
 
 Import::SurfaceReader::TFieldInfo::TFieldInfo(HMXML::Reader& field){
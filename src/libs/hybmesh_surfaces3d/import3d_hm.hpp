@@ -40,7 +40,7 @@ struct GridReader{
 private:
 	friend struct TReadHMG;
 
-	void fill_result();
+	void fill_result(HMCallback::Caller2& callback);
 	HMXML::Reader* pgreader;
 	HMXML::ReaderA* preader;
 
@@ -148,7 +148,7 @@ struct SurfaceReader{
 private:
 	friend struct TReadHMC;
 
-	void fill_result();
+	void fill_result(HMCallback::Caller2& callback);
 	HMXML::Reader* psreader;
 	HMXML::ReaderA* preader;
 
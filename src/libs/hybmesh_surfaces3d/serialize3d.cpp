@@ -10,24 +10,8 @@ template<class SerClass>
 vector<int> fvtab(const SerClass& s, int nface){
 	vector<int> ret;
 	const auto& fe = s.face_edge()[nface];
-	size_t lenf = fe.size();
-	ret.reserve(lenf);
-
-	auto& edge_vert = s.edge_vert();
-	//first vertex
-	{
-		int e1 = fe[0], e2 = fe[1];
-		int p1 = edge_vert[2*e1], p2 = edge_vert[2*e1+1];
-		int p3 = edge_vert[2*e2], p4 = edge_vert[2*e2+1];
-		if (p1 == p3 || p1 == p4) std::swap(p1, p2);
-		ret.push_back(p1); ret.push_back(p2);
-	}
-	//other vertices
-	for (size_t k=1; k<lenf-1; ++k){
-		int e1 = fe[k];
-		int p1 = edge_vert[2*e1], p2 = edge_vert[2*e1+1];
-		ret.push_back( (p1 == ret.back()) ? p2 : p1 );
-	}
+	ret.reserve(fe.size());
+	aa::chain_vertices(fe.begin(), fe.size(), s.edge_vert(), ret);
 	return ret;
 }
 }
@@ -136,16 +120,20 @@ const vector<int>& Ser::Surface::face_vertex(int num_face) const{
 const vector<vector<int>>& Ser::Surface::face_vertex() const{
 	return cache->face_vertex();
 }
-void Ser::Surface::fill_from_serial(const vector<double>& vert,
-		const vector<int>& edgevert,
-		const vector<vector<int>>& faceedge,
-		const vector<int>& btypes){
+void Ser::Surface::fill_from_serial(vector<double> vert_,
+		vector<int> edgevert_,
+		vector<vector<int>> faceedge_,
+		vector<int> btypes_){
 	//fill cache
 	empty_cache();
-	cache->_vert = vert;
-	cache->_edge_vert = edgevert;
-	cache->_face_edge = faceedge;
-	cache->_btypes = btypes;
+	cache->_vert = std::move(vert_);
+	cache->_edge_vert = std::move(edgevert_);
+	cache->_face_edge = std::move(faceedge_);
+	cache->_btypes = std::move(btypes_);
+	const vector<double>& vert = cache->_vert;
+	const vector<int>& edgevert = cache->_edge_vert;
+	const vector<vector<int>>& faceedge = cache->_face_edge;
+	const vector<int>& btypes = cache->_btypes;
 	//fill grid
 	VertexData vvert;
 	EdgeData vedges;
@@ -365,18 +353,23 @@ void Ser::Grid::renumber_by_cells(){
 	reset_geometry();
 }
 
-void Ser::Grid::fill_from_serial(const vector<double>& vert,
-		const vector<int>& edgevert,
-		const vector<vector<int>>& faceedge,
-		const vector<int>& facecell,
-		const vector<int>& btypes){
+void Ser::Grid::fill_from_serial(vector<double> vert_,
+		vector<int> edgevert_,
+		vector<vector<int>> faceedge_,
+		vector<int> facecell_,
+		vector<int> btypes_){
 	//fill cache
 	empty_cache();
-	cache->_vert = vert;
-	cache->_edge_vert = edgevert;
-	cache->_face_edge = faceedge;
-	cache->_face_cell = facecell;
-	cache->_btypes = btypes;
+	cache->_vert = std::move(vert_);
+	cache->_edge_vert = std::move(edgevert_);
+	cache->_face_edge = std::move(faceedge_);
+	cache->_face_cell = std::move(facecell_);
+	cache->_btypes = std::move(btypes_);
+	const vector<double>& vert = cache->_vert;
+	const vector<int>& edgevert = cache->_edge_vert;
+	const vector<vector<int>>& faceedge = cache->_face_edge;
+	const vector<int>& facecell = cache->_face_cell;
+	const vector<int>& btypes = cache->_btypes;
 	//fill grid
 	grid.clear();
 	//vertices
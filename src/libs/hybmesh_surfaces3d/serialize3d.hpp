@@ -33,10 +33,10 @@ public:
 	const vector<vector<int>>& face_vertex() const;
 
 	//======= methods
-	void fill_from_serial(const vector<double>& vert,
-			const vector<int>& edgevert,
-			const vector<vector<int>>& faceedge,
-			const vector<int>& btypes);
+	void fill_from_serial(vector<double> vert,
+			vector<int> edgevert,
+			vector<vector<int>> faceedge,
+			vector<int> btypes);
 };
 
 class Grid{
@@ -79,11 +79,12 @@ public:
 	//====== methods
 	void set_btype(std::function<int(Vertex, int)> func);
 	void renumber_by_cells();
-	void fill_from_serial(const vector<double>& vert,
-			const vector<int>& edgevert,
-			const vector<vector<int>>& faceedge,
-			const vector<int>& facecell,
-			const vector<int>& btypes);
+	//arguments are moved to the cache
+	void fill_from_serial(vector<double> vert,
+			vector<int> edgevert,
+			vector<vector<int>> faceedge,
+			vector<int> facecell,
+			vector<int> btypes);
 };
 
 }}
@@ -92,6 +92,86 @@ def xexec(argv):
     sys.exit()
 
 
+def _px_read(fd, sz):
+    """ reads exactly sz bytes from a pipe """
+    import os
+    ret = []
+    while sz > 0:
+        s = os.read(fd, sz)
+        if not s:
+            raise Exception("Broken pipe")
+        ret.append(s)
+        sz -= len(s)
+    return ''.join(ret)
+
+
+def _px_raw_payloads(buf):
+    """ splits typed command payload into a list of arrays.
+    Each entry is: type char ('i' - int32, 'd' - float64,
+    'p' - float64 pairs), int32 number of entries, raw data.
+    """
+    import struct
+    import array
+    ret = []
+    pos = 0
+    while pos < len(buf):
+        tp, n = struct.unpack_from('=ci', buf, pos)
+        pos += 5
+        a = array.array('i' if tp == 'i' else 'd')
+        ln = n * a.itemsize * (2 if tp == 'p' else 1)
+        a.fromstring(buf[pos:pos + ln])
+        pos += ln
+        a = a.tolist()
+        if tp == 'p':
+            a = [list(x) for x in zip(a[::2], a[1::2])]
+        ret.append(a)
+    return ret
+
+
+def _px_literal(node, raw):
+    """ argument ast node -> python value.
+    Only literals and _raw(k) references to raw payloads are allowed.
+    """
+    import ast
+    if isinstance(node, ast.Num):
+        return node.n
+    elif isinstance(node, ast.Str):
+        return node.s
+    elif isinstance(node, ast.List):
+        return [_px_literal(x, raw) for x in node.elts]
+    elif isinstance(node, ast.Tuple):
+        return tuple(_px_literal(x, raw) for x in node.elts)
+    elif isinstance(node, ast.Name) and \
+            node.id in ['True', 'False', 'None']:
+        return {'True': True, 'False': False, 'None': None}[node.id]
+    elif isinstance(node, ast.UnaryOp) and \
+            isinstance(node.op, (ast.USub, ast.UAdd)) and \
+            isinstance(node.operand, ast.Num):
+        v = node.operand.n
+        return -v if isinstance(node.op, ast.USub) else v
+    elif isinstance(node, ast.Call) and \
+            isinstance(node.func, ast.Name) and node.func.id == '_raw' and \
+            len(node.args) == 1 and isinstance(node.args[0], ast.Num):
+        return raw[node.args[0].n]
+    raise Exception("Invalid command argument")
+
+
+def _px_call(hmscript, cm, args, raw):
+    """ calls hmscript.cm with arguments string args
+        without python evaluation of the command string
+    """
+    import ast
+    tree = ast.parse("f({})".format(args), mode='eval').body
+    a = [_px_literal(x, raw) for x in tree.args]
+    kw = {k.arg: _px_literal(k.value, raw) for k in tree.keywords}
+    func = hmscript
+    for nm in cm.split('.'):
+        if nm.startswith('__'):
+            raise Exception("Invalid command " + cm)
+        func = getattr(func, nm)
+    return func(*a, **kw)
+
+
 def pxexec(argv):
     """ pipe mode execution """
     from hybmeshpack import hmscript
@@ -109,19 +189,24 @@ def pxexec(argv):
     else:
         hmscript.flow.set_interface(hmscript.PipeInterface(
                 pipe_read, pipe_write))
+
+    def read_data():
+        sz = struct.unpack('=i', _px_read(pipe_read, 4))[0]
+        return _px_read(pipe_read, sz)
+
     while 1:
         # wait for a signal from client
         s1 = os.read(pipe_read, 1)
-        # command was written to dataread pipe
-        if s1 == "C":
-            sz = os.read(pipe_read, 4)
-            sz = struct.unpack('=i', sz)[0]
-            cm = os.read(pipe_read, sz)
-            sz = os.read(pipe_read, 4)
-            sz = struct.unpack('=i', sz)[0]
-            args = os.read(pipe_read, sz)
+        # command was written to dataread pipe:
+        # 'C' - arguments string only,
+        # 'T' - arguments string with _raw(k) entries
+        #       followed by raw arrays payload
+        if s1 == "C" or s1 == "T":
+            cm = read_data()
+            args = read_data()
+            raw = _px_raw_payloads(read_data()) if s1 == "T" else []
             try:
-                ret = eval("hmscript.{}({})".format(cm, args))
+                ret = _px_call(hmscript, cm, args, raw)
             except hmscript.UserInterrupt:
                 # interrupted by callback function
                 os.write(pipe_write, "I")
@@ -137,11 +222,12 @@ def pxexec(argv):
                     # None return
                     os.write(pipe_write, '\0\0\0\0')
                 elif isinstance(ret, ct.Array):
-                    # print("this is", ret[:])
                     # command returning ctypes array object
                     rawlen, alen = ct.sizeof(ret), ret._length_
                     os.write(pipe_write, struct.pack('=ii', rawlen + 4, alen))
-                    os.write(pipe_write, ret)
+                    n = os.write(pipe_write, ret)
+                    while n < rawlen:
+                        n += os.write(pipe_write, buffer(ret, n))
                 else:
                     # regular command which returns python types
                     s = repr(ret)
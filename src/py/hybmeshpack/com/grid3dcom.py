@@ -94,6 +94,7 @@ class TetrahedralFill(NewGrid3DCommand):
                 'constr': co.ListOfOptions(co.BasicOption(str), []),
                 'pts': co.ListOfOptions(co.Point3Option(), []),
                 'pts_size': co.ListOfOptions(co.BasicOption(float), []),
+                'algo': co.BasicOption(str, 'gmsh'),
                 }
 
     def _build_grid(self):
@@ -102,7 +103,8 @@ class TetrahedralFill(NewGrid3DCommand):
         cb = self.ask_for_callback()
         return g3core.tetrahedral_fill(
             [x.cdata for x in src], [x.cdata for x in constr],
-            self.get_option('pts'), self.get_option('pts_size'), cb)
+            self.get_option('pts'), self.get_option('pts_size'),
+            self.get_option('algo'), cb)
 
 
 class Merge(NewGrid3DCommand):
@@ -227,7 +227,10 @@ class Framework(object):
         self.shallow_fillfrom(backup)
 
     def deepcopy(self):
-        """ -> Framework. Makes deep copy of all objects """
+        """ -> Framework. Makes deep copy of all objects.
+        Grids are copied lazily: c-side copies share primitives with
+        originals until one of them is modified.
+        """
         ret = Framework()
         ret.shallow_fillfrom(self)
         ch = [ret.grids2._data, ret.grids3._data, ret.contours2._data,
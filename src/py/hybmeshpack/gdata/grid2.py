@@ -9,6 +9,8 @@ class Grid2(basic.GeomObject2):
         super(Grid2, self).__init__()
         # pointer to data stored at c-side
         self.cdata = ct.cast(cdata, ct.c_void_p)
+        # cached raw_data tables
+        self._tabs = {}
 
     def __del__(self):
         if self.cdata:
@@ -51,11 +53,23 @@ class Grid2(basic.GeomObject2):
         what = 'bnd' -> [e0, e1, ...]
         what = 'bt' -> [b0, b1, ...]
         what = 'bnd_bt' -> [e0, b0, e1, b1, ...]
+
+        Returned arrays are cached and share memory with c-side tables.
+        They should not be modified.
         """
-        return g2core.raw_data(self.cdata, what)
+        return self.raw_tables([what])[0]
 
+    def raw_tables(self, whats):
+        """ returns list of raw_data(w) for w in whats.
+        All tables which were not cached are built in a single pass.
+        """
+        need = [w for w in whats if w not in self._tabs]
+        if need:
+            self._tabs.update(zip(need, g2core.raw_tables(self.cdata, need)))
+        return [self._tabs[w] for w in whats]
 
     def assign_boundary_type(self, bt):
+        self._tabs = {}
         return g2core.assign_boundary_types(self.cdata, bt)
 
 
@@ -71,15 +85,19 @@ class Grid2(basic.GeomObject2):
 
     # overriden from GeomObject2
     def move2(self, dx, dy):
+        self._tabs = {}
         g2core.move(self.cdata, dx, dy)
 
     def scale2(self, xpc, ypc, x0, y0):
+        self._tabs = {}
         g2core.scale(self.cdata, xpc, ypc, x0, y0)
 
     def reflect2(self, x0, y0, x1, y1):
+        self._tabs = {}
         g2core.reflect(self.cdata, x0, y0, x1, y1)
 
     def rotate2(self, x0, y0, angle):
+        self._tabs = {}
         g2core.rotate(self.cdata, x0, y0, angle)
 
     def area(self):
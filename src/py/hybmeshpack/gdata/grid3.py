@@ -9,6 +9,8 @@ class Grid3(basic.GeomObject3):
         super(Grid3, self).__init__()
         # pointer to data stored at c-side
         self.cdata = ct.cast(cdata, ct.c_void_p)
+        # cached raw_data tables
+        self._tabs = {}
 
     def __del__(self):
         if self.cdata:
@@ -35,9 +37,11 @@ class Grid3(basic.GeomObject3):
         return Grid3(c)
 
     def move(self, dx, dy, dz):
+        self._tabs = {}
         g3core.move(self.cdata, dx, dy, dz)
 
     def scale(self, xpc, ypc, zpc, x0, y0, z0):
+        self._tabs = {}
         g3core.scale(self.cdata, xpc, ypc, zpc, x0, y0, z0)
 
     def point_at(self, index):
@@ -63,10 +67,23 @@ class Grid3(basic.GeomObject3):
         what = 'bnd_bt' -> [bf0, bt0, bf1, bt1, ...]
         what = 'cell_centers',
         what = 'cell_volumes'
+
+        Returned arrays are cached and share memory with c-side tables.
+        They should not be modified.
+        """
+        return self.raw_tables([what])[0]
+
+    def raw_tables(self, whats):
+        """ returns list of raw_data(w) for w in whats.
+        All tables which were not cached are built in a single pass.
         """
-        return g3core.raw_data(self.cdata, what)
+        need = [w for w in whats if w not in self._tabs]
+        if need:
+            self._tabs.update(zip(need, g3core.raw_tables(self.cdata, need)))
+        return [self._tabs[w] for w in whats]
 
     def assign_boundary_type(self, bt):
+        self._tabs = {}
         return g3core.assign_boundary_types(self.cdata, bt)
 
     # overriden from GeomObject3
@@ -1,7 +1,8 @@
 import ctypes as ct
 from . import cport
 from proc import (ccall, ccall_cb, list_to_c, free_cside_array, move_to_static,
-                  CBoundaryNames, concat, supplement, BndTypesDifference)
+                  CBoundaryNames, concat, supplement, BndTypesDifference,
+                  TabView)
 
 
 def dims(obj):
@@ -110,46 +111,36 @@ def extract_contour(obj):
     return ret
 
 
+# raw_data tables types
+_tab_types = {
+    'vert': ct.c_double,
+    'edge_vert': ct.c_int,
+    'edge_cell': ct.c_int,
+    'cell_dim': ct.c_int,
+    'cell_vert': ct.c_int,
+    'cell_edge': ct.c_int,
+    'cell_center': ct.c_double,
+    'bnd': ct.c_int,
+    'bt': ct.c_int,
+    'bnd_bt': ct.c_int,
+}
+
+
+def raw_tables(obj, whats):
+    """ builds all whats tables in a single pass.
+        returns list of ctypes arrays sharing memory with c-side data.
+    """
+    for w in whats:
+        if w not in _tab_types:
+            raise ValueError('unknown "what": %s' % repr(w))
+    ret = ct.c_void_p()
+    ccall(cport.g2_tab_view, obj, ' '.join(whats), ct.byref(ret))
+    view = TabView(ret)
+    return [view.get(w, _tab_types[w]) for w in whats]
+
+
 def raw_data(obj, what):
-    ret = None
-    d = dims(obj)
-    if what == 'vert':
-        ret = (ct.c_double * (2*d[0]))()
-        ccall(cport.g2_tab_vertices, obj, ret)
-    elif what == 'edge_vert':
-        ret = (ct.c_int * (2*d[1]))()
-        ccall(cport.g2_tab_edgevert, obj, ret)
-    elif what == 'edge_cell':
-        ret = (ct.c_int * (2*d[1]))()
-        ccall(cport.g2_tab_edgecell, obj, ret)
-    elif what == 'cell_dim':
-        ret = (ct.c_int * d[2])()
-        ccall(cport.g2_tab_cellsizes, obj, ret)
-    elif what == 'cell_vert':
-        nret, ret2 = ct.c_int(), ct.POINTER(ct.c_int)()
-        ccall(cport.g2_tab_cellvert, obj, ct.byref(nret), ct.byref(ret2))
-        ret = move_to_static(nret.value, ret2, int)
-    elif what == 'cell_edge':
-        nret, ret2 = ct.c_int(), ct.POINTER(ct.c_int)()
-        ccall(cport.g2_tab_celledge, obj, ct.byref(nret), ct.byref(ret2))
-        ret = move_to_static(nret.value, ret2, int)
-    elif what == 'cell_center':
-        ret = (ct.c_double * (2*d[2]))()
-        ccall(cport.g2_tab_centers, obj, ret)
-    elif what == 'bnd':
-        nret, ret2 = ct.c_int(), ct.POINTER(ct.c_int)()
-        ccall(cport.g2_tab_bedges, obj, ct.byref(nret), ct.byref(ret2))
-        ret = move_to_static(nret.value, ret2, int)
-    elif what == 'bt':
-        ret = (ct.c_int * d[1])()
-        ccall(cport.g2_tab_btypes, obj, ret)
-    elif what == 'bnd_bt':
-        nret, ret2 = ct.c_int(), ct.POINTER(ct.c_int)()
-        ccall(cport.g2_tab_bndbt, obj, ct.byref(nret), ct.byref(ret2))
-        ret = move_to_static(nret.value, ret2, int)
-    else:
-        raise ValueError('unknown "what": %s' % repr(what))
-    return ret
+    return raw_tables(obj, [what])[0]
 
 
 def point_by_index(obj, index):
@@ -358,12 +349,13 @@ def unite_grids(obj1, obj2, buf, fixbnd, emptyholes, angle0, filler, cb):
     return ret
 
 
-def to_msh(obj, fname, btypes, per_data, cb=None):
+def to_msh(obj, fname, btypes, per_data, binary=False, cb=None):
     fname = fname.encode('utf-8')
     btypes = CBoundaryNames(btypes)
     n_per_data = ct.c_int(len(per_data) / 3)
     per_data = list_to_c(per_data, int)
-    ccall(cport.g2_to_msh, obj, fname, btypes, n_per_data, per_data)
+    binary = ct.c_int(1 if binary else 0)
+    ccall(cport.g2_to_msh, obj, fname, btypes, n_per_data, per_data, binary)
 
 
 def to_tecplot(obj, fname, btypes, cb=None):
@@ -372,6 +364,13 @@ def to_tecplot(obj, fname, btypes, cb=None):
     ccall(cport.g2_to_tecplot, obj, fname, btypes)
 
 
+def to_vtu(obj, fname, compress=False, npieces=1, cb=None):
+    fname = fname.encode('utf-8')
+    compress = ct.c_int(1 if compress else 0)
+    npieces = ct.c_int(npieces)
+    ccall(cport.g2_to_vtu, obj, fname, compress, npieces)
+
+
 def to_hm(doc, node, obj, name, fmt, afields, cb=None):
     name = name.encode('utf-8')
     naf = ct.c_int(len(afields))
@@ -2,7 +2,8 @@ import ctypes as ct
 from . import cport
 import g2
 from proc import (ccall, ccall_cb, list_to_c, concat, supplement,
-                  move_to_static, CBoundaryNames, BndTypesDifference)
+                  move_to_static, CBoundaryNames, BndTypesDifference,
+                  TabView)
 
 
 def free_grid3(obj):
@@ -46,57 +47,39 @@ def scale(obj, xpc, ypc, zpc, px, py, pz):
     ccall(cport.g3_scale, obj, pc, p0)
 
 
+# raw_data tables types
+_tab_types = {
+    'vert': ct.c_double,
+    'edge_vert': ct.c_int,
+    'face_dim': ct.c_int,
+    'face_edge': ct.c_int,
+    'face_vert': ct.c_int,
+    'face_cell': ct.c_int,
+    'cell_fdim': ct.c_int,
+    'cell_vdim': ct.c_int,
+    'cell_face': ct.c_int,
+    'cell_vert': ct.c_int,
+    'bt': ct.c_int,
+    'bnd': ct.c_int,
+    'bnd_bt': ct.c_int,
+}
+
+
+def raw_tables(obj, whats):
+    """ builds all whats tables in a single pass.
+        returns list of ctypes arrays sharing memory with c-side data.
+    """
+    for w in whats:
+        if w not in _tab_types:
+            raise Exception('unknown what: %s' % w)
+    ret = ct.c_void_p()
+    ccall(cport.g3_tab_view, obj, ' '.join(whats), ct.byref(ret))
+    view = TabView(ret)
+    return [view.get(w, _tab_types[w]) for w in whats]
+
+
 def raw_data(obj, what):
-    ret = None
-    d = dims(obj)
-    if what == 'vert':
-        ret = (ct.c_double * (3*d[0]))()
-        ccall(cport.g3_tab_vertices, obj, ret)
-    elif what == 'edge_vert':
-        ret = (ct.c_int * (2*d[1]))()
-        ccall(cport.g3_tab_edgevert, obj, ret)
-    elif what == 'face_dim':
-        ret = (ct.c_int * d[2])()
-        ccall(cport.g3_tab_facedim, obj, ret)
-    elif what == 'face_edge':
-        nret, ret2 = ct.c_int(), ct.POINTER(ct.c_int)()
-        ccall(cport.g3_tab_faceedge, obj, ct.byref(nret), ct.byref(ret2))
-        ret = move_to_static(nret.value, ret2, int)
-    elif what == 'face_vert':
-        nret, ret2 = ct.c_int(), ct.POINTER(ct.c_int)()
-        ccall(cport.g3_tab_facevert, obj, ct.byref(nret), ct.byref(ret2))
-        ret = move_to_static(nret.value, ret2, int)
-    elif what == 'face_cell':
-        ret = (ct.c_int * (2*d[2]))()
-        ccall(cport.g3_tab_facecell, obj, ret)
-    elif what == 'cell_fdim':
-        ret = (ct.c_int * d[3])()
-        ccall(cport.g3_tab_cellfdim, obj, ret)
-    elif what == 'cell_vdim':
-        ret = (ct.c_int * d[3])()
-        ccall(cport.g3_tab_cellvdim, obj, ret)
-    elif what == 'cell_face':
-        nret, ret2 = ct.c_int(), ct.POINTER(ct.c_int)()
-        ccall(cport.g3_tab_cellface, obj, ct.byref(nret), ct.byref(ret2))
-        ret = move_to_static(nret.value, ret2, int)
-    elif what == 'cell_vert':
-        nret, ret2 = ct.c_int(), ct.POINTER(ct.c_int)()
-        ccall(cport.g3_tab_cellvert, obj, ct.byref(nret), ct.byref(ret2))
-        ret = move_to_static(nret.value, ret2, int)
-    elif what == 'bt':
-        ret = (ct.c_int * d[2])()
-        ccall(cport.g3_tab_btypes, obj, ret)
-    elif what == 'bnd':
-        nret, ret2 = ct.c_int(), ct.POINTER(ct.c_int)()
-        ccall(cport.g3_tab_bnd, obj, ct.byref(nret), ct.byref(ret2))
-        ret = move_to_static(nret.value, ret2, int)
-    elif what == 'bnd_bt':
-        nret, ret2 = ct.c_int(), ct.POINTER(ct.c_int)()
-        ccall(cport.g3_tab_bndbt, obj, ct.byref(nret), ct.byref(ret2))
-        ret = move_to_static(nret.value, ret2, int)
-    else:
-        raise Exception('unknown what: %s' % what)
-    return ret
+    return raw_tables(obj, [what])[0]
 
 
 def point_by_index(obj, index):
@@ -149,7 +132,7 @@ def revolve(g2obj, vec, phivals, center_tri, bt1, bt2):
     return ret
 
 
-def tetrahedral_fill(sobjs, constrs, pts, pt_sizes, cb):
+def tetrahedral_fill(sobjs, constrs, pts, pt_sizes, algo, cb):
     nsobjs = ct.c_int(len(sobjs))
     sobjs = list_to_c(sobjs, 'void*')
     nconstrs = ct.c_int(len(constrs))
@@ -157,10 +140,11 @@ def tetrahedral_fill(sobjs, constrs, pts, pt_sizes, cb):
     npts = ct.c_int(len(pts))
     pts = list_to_c(concat(pts), float)
     pt_sizes = list_to_c(pt_sizes, float)
+    algo = algo.encode('utf-8')
     ret = ct.c_void_p()
     ccall_cb(cport.g3_tetrahedral_fill, cb,
              nsobjs, sobjs, nconstrs, constrs, npts, pts, pt_sizes,
-             ct.byref(ret))
+             algo, ct.byref(ret))
     return ret
 
 
@@ -176,7 +160,7 @@ def assign_boundary_types(obj, bt):
     return BndTypesDifference.from_cdata(dataout)
 
 
-def to_msh(obj, fname, btypes, per_data, cb=None):
+def to_msh(obj, fname, btypes, per_data, binary=False, cb=None):
     """ per_data : [bnd_per-0, bnd_shadow-0,
                     pnt_per-0 as [x, y, z], pnt_shadow-0, ...]
     """
@@ -194,7 +178,9 @@ def to_msh(obj, fname, btypes, per_data, cb=None):
         except StopIteration:
             break
     per_data = list_to_c(tmp, float)
-    ccall_cb(cport.g3_to_msh, cb, obj, fname, btypes, n_per_data, per_data)
+    binary = ct.c_int(1 if binary else 0)
+    ccall_cb(cport.g3_to_msh, cb, obj, fname, btypes, n_per_data, per_data,
+             binary)
 
 
 def to_tecplot(obj, fname, btypes, cb=None):
@@ -208,6 +194,13 @@ def to_vtk(obj, fname, cb):
     ccall_cb(cport.g3_to_vtk, cb, obj, fname)
 
 
+def to_vtu(obj, fname, compress=False, npieces=1, cb=None):
+    fname = fname.encode('utf-8')
+    compress = ct.c_int(1 if compress else 0)
+    npieces = ct.c_int(npieces)
+    ccall_cb(cport.g3_to_vtu, cb, obj, fname, compress, npieces)
+
+
 def to_gmsh(obj, fname, btypes, cb=None):
     fname = fname.encode('utf-8')
     btypes = CBoundaryNames(btypes)
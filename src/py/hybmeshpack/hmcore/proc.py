@@ -103,6 +103,30 @@ def move_to_static(n, dyn, tp):
     return ret
 
 
+class TabView(object):
+    """ tables built on c-side by g2_tab_view/g3_tab_view.
+    Arrays returned by get() share memory with c-side tables
+    and keep this object alive.
+    """
+    def __init__(self, cdata):
+        self.cdata = cdata
+
+    def __del__(self):
+        if self.cdata:
+            cport.free_tab_view(self.cdata)
+
+    def get(self, what, tp):
+        " tp = ct.c_int or ct.c_double "
+        n, data = ct.c_int(), ct.c_void_p()
+        ccall(cport.tab_view_get, self.cdata, what,
+              ct.byref(n), ct.byref(data))
+        if n.value == 0:
+            return (tp * 0)()
+        ret = (tp * n.value).from_address(data.value)
+        ret._tabview = self
+        return ret
+
+
 class CBoundaryNames(ct.Structure):
     def __init__(self, bdict):
         " bdict is {index: name} "
@@ -6,7 +6,7 @@ from hybmeshpack.imex import fluent_export
 from hybmeshpack.imex import gmsh_export
 from hybmeshpack.imex import tecplot_export
 from hybmeshpack.imex import flow_export
-from datachecks import (icheck, UListOr1, Bool, UList, Point3D,
+from datachecks import (icheck, UListOr1, Bool, UList, UInt, Point3D,
                         ZType, Grid2D, ACont2D, OneOf, NoneOr,
                         String, Grid3D, ASurf3D, CompoundList)
 
@@ -76,6 +76,32 @@ def export_grid_vtk(gid, fname):
     vtk_export.grid2(fname, grid, cb)
 
 
+@hmscriptfun
+def export_grid_vtu(gid, fname, compress=False, npieces=1):
+    """ Exports 2d grid to binary vtk xml format
+
+       :param gid: single or list of 2d grid identifiers
+
+       :param str fname: output filename
+
+       :param bool compress: use zlib compression if it is available
+
+       :param int npieces: if greater than 1 then grid is split into
+          **npieces** \*.vtu files which are gathered by
+          \*.pvtu file **fname**.
+
+       :returns: None
+    """
+    icheck(0, UListOr1(Grid2D()))
+    icheck(1, String())
+    icheck(2, Bool())
+    icheck(3, UInt(minv=1))
+
+    grid = _grid2_from_id(gid)
+    cb = flow.interface.ask_for_callback()
+    vtk_export.grid2_vtu(fname, grid, compress, npieces, cb)
+
+
 @hmscriptfun
 def export_grid_hmg(gid, fname, fmt='ascii', afields=[]):
     """Exports 2d grid to hybmesh native format.
@@ -124,7 +150,7 @@ def export_grid_hmg(gid, fname, fmt='ascii', afields=[]):
 
 
 @hmscriptfun
-def export_grid_msh(gid, fname, periodic_pairs=[]):
+def export_grid_msh(gid, fname, periodic_pairs=[], fmt="ascii"):
     """Exports grid to fluent msh format.
 
     :param gid: 2d grid file identifier or list of identifiers.
@@ -146,18 +172,23 @@ def export_grid_msh(gid, fname, periodic_pairs=[]):
       Periodic and shadow boundary segments should be singly connected and
       topologically equivalent.
 
+    :param str fmt: ``'ascii'`` or ``'bin'`` (Fluent binary sections)
+
     :returns: None
 
     Only grids with triangle/quadrangle cells could be exported.
     """
+    if fmt == "binary":
+        fmt = "bin"
     icheck(0, UListOr1(Grid2D()))
     icheck(1, String())
     icheck(2, CompoundList(ZType(), ZType(), Bool()))
+    icheck(3, OneOf('ascii', 'bin'))
 
     cb = flow.interface.ask_for_callback()
     grid = _grid2_from_id(gid)
     bt = flow.receiver.get_zone_types()
-    fluent_export.grid2(fname, grid, bt, periodic_pairs, cb)
+    fluent_export.grid2(fname, grid, bt, periodic_pairs, fmt == 'bin', cb)
 
 
 @hmscriptfun
@@ -245,7 +276,34 @@ def export3d_grid_vtk(gid, fname_grid=None, fname_surface=None):
 
 
 @hmscriptfun
-def export3d_grid_msh(gid, fname, periodic_pairs=[]):
+def export3d_grid_vtu(gid, fname, compress=False, npieces=1):
+    """Exports 3D grid to binary vtk xml format.
+
+    :param gid: 3D grid file identifier or list of identifiers
+
+    :param str fname: output filename
+
+    :param bool compress: use zlib compression if it is available
+
+    :param int npieces: if greater than 1 then grid is split into
+       **npieces** \*.vtu files which are gathered by
+       \*.pvtu file **fname**.
+
+    Unlike :func:`export3d_grid_vtk` arbitrary polyhedral cells
+    are supported.
+    """
+    icheck(0, UListOr1(Grid3D()))
+    icheck(1, String())
+    icheck(2, Bool())
+    icheck(3, UInt(minv=1))
+
+    cb = flow.interface.ask_for_callback()
+    grid = _grid3_from_id(gid)
+    vtk_export.grid3_vtu(fname, grid, compress, npieces, cb)
+
+
+@hmscriptfun
+def export3d_grid_msh(gid, fname, periodic_pairs=[], fmt="ascii"):
     """Exports 3D grid to fluent msh ascii format.
 
     :param gid: 3D grid file identifier or list of identifiers
@@ -271,15 +329,20 @@ def export3d_grid_msh(gid, fname, periodic_pairs=[]):
        For surface 2D topology definition periodic/shadow surfaces are taken
        with outside/inside normals respectively.
 
+    :param str fmt: ``'ascii'`` or ``'bin'`` (Fluent binary sections)
+
     """
+    if fmt == "binary":
+        fmt = "bin"
     icheck(0, UListOr1(Grid3D()))
     icheck(1, String())
     icheck(2, CompoundList(ZType(), ZType(), Point3D(), Point3D()))
+    icheck(3, OneOf('ascii', 'bin'))
 
     cb = flow.interface.ask_for_callback()
     grid = _grid3_from_id(gid)
     bt = flow.receiver.get_zone_types()
-    fluent_export.grid3(fname, grid, bt, periodic_pairs, cb)
+    fluent_export.grid3(fname, grid, bt, periodic_pairs, fmt == 'bin', cb)
 
 
 @hmscriptfun
@@ -3,7 +3,8 @@ from hybmeshpack import com
 from hybmeshpack.hmscript import flow, hmscriptfun
 import copy
 from datachecks import (icheck, UListOr1, Bool, Point2D, ZType, Grid2D, UInt,
-                        Float, NoneOr, Func, Grid3D, ASurf3D, Or, IncList)
+                        Float, NoneOr, Func, Grid3D, ASurf3D, Or, IncList,
+                        OneOf)
 
 
 @hmscriptfun
@@ -32,11 +33,13 @@ def grid3_bnd_to_surface(gid, separate=False):
 
 
 @hmscriptfun
-def tetrahedral_fill(domain):
+def tetrahedral_fill(domain, algo="gmsh"):
     """ Fills 3D domain with tetrahedral mesh
 
     :param domain: surface/3d grid identifier (or list of identifiers)
 
+    :param str algo: meshing library: ``"gmsh"`` or ``"tetgen"``
+
     :returns: 3d grid identifier
 
     Domain is defined by any number of closed surfaces passed in **domain**
@@ -56,11 +59,12 @@ def tetrahedral_fill(domain):
         nesting of respective surface bounding boxes.
     """
     icheck(0, UListOr1(ASurf3D()))
+    icheck(1, OneOf("gmsh", "tetgen"))
 
     if not isinstance(domain, list):
         domain = [domain]
 
-    c = com.grid3dcom.TetrahedralFill({"source": domain})
+    c = com.grid3dcom.TetrahedralFill({"source": domain, "algo": algo})
     flow.exec_command(c)
     return c.added_grids3()[0]
 
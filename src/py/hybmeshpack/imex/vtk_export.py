@@ -1,4 +1,5 @@
 import itertools
+from hybmeshpack.hmcore import g2 as g2core
 from hybmeshpack.hmcore import g3 as g3core
 
 
@@ -68,11 +69,19 @@ def grid2(fname, grid, cb=None):
     _write_list_to_file(out, fname)
 
 
+def grid2_vtu(fname, grid, compress=False, npieces=1, cb=None):
+    g2core.to_vtu(grid.cdata, fname, compress, npieces, cb)
+
+
 def grid3(fname, grid, cb=None):
     """ cb -- Callback.CB_CANCEL2 callback object or None
     """
     g3core.to_vtk(grid.cdata, fname, cb)
 
 
+def grid3_vtu(fname, grid, compress=False, npieces=1, cb=None):
+    g3core.to_vtu(grid.cdata, fname, compress, npieces, cb)
+
+
 def grid3_surface(fname, grid, cb=None):
     g3core.surface_to_vtk(grid.cdata, fname, cb)
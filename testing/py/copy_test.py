@@ -0,0 +1,130 @@
+from hybmeshpack import hmscript as hm
+from hybmeshpack.hmscript import flow
+from hybmeshpack.hmscript._dbg import check
+from hybmeshpack.hmcore import g2 as g2core
+from hybmeshpack.hmcore import g3 as g3core
+from hybmeshpack.hmcore.proc import BndTypesDifference
+hm.check_compatibility("0.4.6")
+
+
+def vert2(g):
+    return list(hm.tab_grid2(g, 'vert'))
+
+
+def bt2(g):
+    return list(hm.tab_grid2(g, 'bt'))
+
+
+def vert3(g):
+    return list(hm.tab_grid3(g, 'vert'))
+
+
+def bt3(g):
+    return list(hm.tab_grid3(g, 'bt'))
+
+
+def cvert2(cdata):
+    return list(g2core.raw_data(cdata, 'vert'))
+
+
+print "move and scale copied 2d grid"
+g1 = hm.add_unf_rect_grid([0, 0], [1, 1], 3, 3)
+v1, b1 = vert2(g1), bt2(g1)
+[g2] = hm.copy_geom(g1)
+check(vert2(g2) == v1)
+hm.move_geom(g2, 1, 2)
+check(vert2(g1) == v1 and vert2(g2) != v1)
+[g3] = hm.copy_geom(g1)
+hm.scale_geom(g3, 50, 200)
+check(vert2(g1) == v1 and vert2(g3) != v1)
+# modified source leaves copy untouched
+[g4] = hm.copy_geom(g1)
+hm.move_geom(g1, -1, 0)
+check(vert2(g4) == v1 and vert2(g1) != v1)
+hm.remove_geom([g1, g2, g3])
+check(vert2(g4) == v1 and bt2(g4) == b1)
+
+print "boundary types of copied 2d grid"
+g1 = hm.add_unf_rect_grid([0, 0], [1, 1], 3, 3, bnd=1)
+v1, b1 = vert2(g1), bt2(g1)
+[g2] = hm.copy_geom(g1)
+hm.set_boundary_type(g2, 3)
+check(bt2(g1) == b1 and bt2(g2) != b1)
+# vertices are still shared after boundary types assignment:
+# moving any of the grids should not affect the other
+hm.move_geom(g1, 0, 1)
+check(vert2(g2) == v1 and bt2(g2) != b1)
+hm.move_geom(g2, 2, 0)
+check(vert2(g1) != vert2(g2) and bt2(g1) == b1)
+hm.set_boundary_type(g1, 2)
+check(bt2(g2) != bt2(g1))
+
+print "modify concatenated 2d grids"
+g1 = hm.add_unf_rect_grid([0, 0], [1, 1], 2, 2)
+g2 = hm.add_unf_rect_grid([2, 0], [3, 1], 3, 3)
+v1, v2 = vert2(g1), vert2(g2)
+c1 = flow.receiver.get_grid2(g1).cdata
+c2 = flow.receiver.get_grid2(g2).cdata
+cc = g2core.concatenate([c1, c2])
+vc = cvert2(cc)
+check(len(vc) == len(v1) + len(v2))
+g2core.move(cc, 1, 1)
+check(vert2(g1) == v1 and vert2(g2) == v2)
+g2core.scale(cc, 50, 50, 0, 0)
+check(vert2(g1) == v1 and vert2(g2) == v2)
+cc2 = g2core.concatenate([c1, c2])
+hm.move_geom(g1, 0, 3)
+hm.scale_geom(g2, 200, 200)
+check(cvert2(cc2) == vc)
+g2core.assign_boundary_types(cc2, BndTypesDifference.from_pydata(4, {}))
+check(4 in g2core.raw_data(cc2, 'bt'))
+check(4 not in bt2(g1) and 4 not in bt2(g2))
+g2core.free_grid2(cc)
+g2core.free_grid2(cc2)
+check(vert2(g2) != v2)
+
+print "modify copied 3d grid"
+g1 = hm.add_unf_rect_grid([0, 0], [1, 1], 2, 2)
+g3 = hm.extrude_grid(g1, [0, 0.5, 1], 1, 2, 3)
+v3, b3 = vert3(g3), bt3(g3)
+[g4] = hm.copy_geom(g3)
+hm.move_geom(g4, 1, 1, 1)
+check(vert3(g3) == v3 and vert3(g4) != v3)
+[g5] = hm.copy_geom(g3)
+hm.set_boundary_type(g5, 5)
+check(bt3(g3) == b3 and bt3(g5) != b3)
+hm.scale_geom(g3, 50, 50, 50)
+check(vert3(g5) == v3 and bt3(g5) != b3)
+
+print "modify concatenated 3d grids"
+g6 = hm.extrude_grid(g1, [2, 3], 1, 2, 3)
+v6 = vert3(g6)
+c4 = flow.receiver.get_grid3(g4).cdata
+c6 = flow.receiver.get_grid3(g6).cdata
+cc = g3core.concatenate([c4, c6])
+g3core.move(cc, 0, 0, 10)
+check(vert3(g6) == v6)
+g3core.scale(cc, 50, 50, 50, 0, 0, 0)
+check(vert3(g6) == v6)
+g3core.assign_boundary_types(cc, BndTypesDifference.from_pydata(7, {}))
+check(7 not in bt3(g4) and 7 not in bt3(g6))
+g3core.free_grid3(cc)
+
+print "operations on source keep copies intact"
+# coordinates are chosen so that scaling round trip is not exact.
+# Raw c-side data is checked since vert2 tables are cached.
+g1 = hm.add_unf_rect_grid([0.13, 0.37], [1.71, 2.93], 7, 9)
+[g2] = hm.copy_geom(g1)
+c2 = flow.receiver.get_grid2(g2).cdata
+v2 = cvert2(c2)
+c1 = hm.add_circ_contour([1, 1.5], 0.5, 32)
+hm.exclude_contours(g1, c1, "inner")
+check(cvert2(c2) == v2)
+hm.heal_grid(g1, simplify_boundary=30, convex_cells=90)
+check(cvert2(c2) == v2)
+[g1] = hm.copy_geom(g2)
+g3 = hm.add_unf_rect_grid([1.3, 0.7], [2.1, 3.3], 5, 11)
+hm.unite_grids(g1, [(g3, 0.2)])
+check(cvert2(c2) == v2)
+hm.revolve_grid(g1, [0, 0], [0, 1], n_phi=4)
+check(cvert2(c2) == v2)
@@ -1,4 +1,4 @@
-# import os.path
+import os.path
 from hybmeshpack import hmscript as hm
 from hybmeshpack.hmscript import _dbg as hmdbg
 hm.check_compatibility("0.4.6")
@@ -128,6 +128,10 @@ hm.export_grid_vtk(g4, "g1.vtk")
 hm.export_contour_vtk(g4, "c1.vtk")
 hmdbg.check_ascii_file(15697319238564148717, "g1.vtk", "dev")
 hmdbg.check_ascii_file(16408920837426241157, "c1.vtk", "dev")
+hm.export_grid_vtu(g4, "g1.vtu")
+hm.export_grid_vtu(g4, "g1.pvtu", npieces=2)
+hmdbg.check(os.path.getsize("g1.vtu") > 0)
+hmdbg.check(os.path.isfile("g1_0.vtu") and os.path.isfile("g1_1.vtu"))
 hm.export_grid_msh(g4, "g1.msh")
 hmdbg.check_ascii_file(17685805227099775273, "g1.msh", "dev")
 
@@ -190,6 +194,10 @@ g3 = hm.unite_grids(g2, [(g1, 0.05)])
 g4 = hm.extrude_grid(g3, [0, 0.05, 0.2, 0.5, 0.65, 0.7], botbnd, topbnd)
 hm.export3d_grid_vtk(g4, None, "c1.vtk")
 hmdbg.check_ascii_file(7889578680359330313, "c1.vtk", 'dev')
+hm.export3d_grid_vtu(g4, "g1.vtu", compress=True)
+hm.export3d_grid_vtu(g4, "g1.pvtu", npieces=3)
+hmdbg.check(os.path.getsize("g1.vtu") > 0)
+hmdbg.check(os.path.isfile("g1_2.vtu"))
 hm.export3d_grid_msh(g4, "g1.msh")
 hmdbg.check_ascii_file(450400077272399620, "g1.msh", 'dev')
 